@@ -134,6 +134,26 @@ class V8EXPORT CpuProfile {
   /** Returns the root node of the top down call tree. */
   const CpuProfileNode* GetTopDownRoot() const;
 
+  /**
+   * Serializes the samples recorded by the profile into a compact binary
+   * trace suitable for building flame graphs. Samples are only recorded
+   * if profiling was started with record_samples set. The chunks passed
+   * to OutputStream::WriteAsciiChunk hold binary data. All numbers are
+   * unsigned LEB128, signed ones are zigzag encoded first:
+   *
+   *  "v8cputrace", version,
+   *  strings count, { length, characters }*,
+   *  nodes count, { parent index + 1 (0 for the root), name prefix id,
+   *                 name id, resource name id, line number }*,
+   *  samples count, start time in microseconds,
+   *  { node index, signed microseconds since the previous sample }*
+   *
+   * Nodes are the nodes of the top down call tree. Every node comes after
+   * its parent, so a sample's stack is found by following the parents of
+   * its node.
+   */
+  void SerializeTrace(OutputStream* stream) const;
+
   /**
    * Deletes the profile and removes it from CpuProfiler's list.
    * All pointers to nodes previously returned become invalid.
@@ -183,8 +203,11 @@ class V8EXPORT CpuProfiler {
    * title are silently ignored. While collecting a profile, functions
    * from all security contexts are included in it. The token-based
    * filtering is only performed when querying for a profile.
+   * If record_samples is set, the profile also keeps every sample along
+   * with its timestamp, see CpuProfile::SerializeTrace.
    */
-  static void StartProfiling(Handle<String> title);
+  static void StartProfiling(Handle<String> title,
+                             bool record_samples = false);
 
   /**
    * Stops collecting CPU profile with a given title and returns it.
@@ -368,6 +391,56 @@ class V8EXPORT HeapSnapshot {
 };
 
 
+/**
+ * AllocationProfileNode represents a node in the top-down tree of
+ * allocation sites collected by the sampling allocation profiler. Sizes
+ * are estimated from the samples.
+ */
+class V8EXPORT AllocationProfileNode {
+ public:
+  /** Returns function name (empty string for anonymous functions.) */
+  Handle<String> GetFunctionName() const;
+
+  /** Returns resource name for script from where the function originates. */
+  Handle<String> GetScriptResourceName() const;
+
+  /**
+   * Returns the number, 1-based, of the line where the function originates.
+   * kNoLineNumberInfo if no line number information is available.
+   */
+  int GetLineNumber() const;
+
+  /** Returns the count of samples taken while the function was allocating. */
+  unsigned GetSamplesCount() const;
+
+  /** Returns the size of objects allocated by the function itself. */
+  size_t GetSelfAllocatedSize() const;
+
+  /**
+   * Returns the size of the sampled objects allocated by the function
+   * itself that have not been garbage collected yet.
+   */
+  size_t GetSelfLiveSize() const;
+
+  /** Returns the size of objects allocated by the function and its callees. */
+  size_t GetTotalAllocatedSize() const;
+
+  /**
+   * Returns the size of the sampled objects allocated by the function and
+   * its callees that have not been garbage collected yet.
+   */
+  size_t GetTotalLiveSize() const;
+
+  /** Returns child nodes count of the node. */
+  int GetChildrenCount() const;
+
+  /** Retrieves a child node by index. */
+  const AllocationProfileNode* GetChild(int index) const;
+
+  static const int kNoLineNumberInfo = Message::kNoLineNumberInfo;
+};
+
+
 class RetainedObjectInfo;
 
 /**
@@ -415,6 +488,38 @@ class V8EXPORT HeapProfiler {
       HeapSnapshot::Type type = HeapSnapshot::kFull,
       ActivityControl* control = NULL);
 
+  /**
+   * Takes a heap snapshot and writes it into the stream provided while the
+   * heap is being traversed, without keeping the snapshot in memory. This
+   * needs only a small fraction of the memory of TakeSnapshot, but the
+   * snapshot can't be inspected through the HeapSnapshot interface. The
+   * stream is written to while V8 is traversing its heap, so it must not
+   * enter V8. Returns false if the stream or |control| aborted the snapshot,
+   * in which case EndOfStream is not called.
+   *
+   * The snapshot is written in a JSON format similar to the one of
+   * HeapSnapshot::Serialize:
+   *
+   *  {
+   *    snapshot: {
+   *      title: "...",
+   *      uid: nnn,
+   *      meta: { meta-info }
+   *    },
+   *    nodes: [nodes array],
+   *    edges: [edges array],
+   *    strings: [strings array],
+   *    node_count: nnn,
+   *    edge_count: nnn
+   *  }
+   *
+   * Nodes have no edge counts and edges are not grouped by node. Instead,
+   * every edge refers to both of its nodes by their ids.
+   */
+  static bool TakeStreamingSnapshot(Handle<String> title,
+                                    OutputStream* stream,
+                                    ActivityControl* control = NULL);
+
   /**
    * Starts tracking of heap objects population statistics. After calling
    * this method, all heap objects relocations done by the garbage collector
@@ -449,6 +554,31 @@ class V8EXPORT HeapProfiler {
    */
   static void DeleteAllSnapshots();
 
+  /**
+   * Starts the sampling allocation profiler. About every sample_interval
+   * bytes of allocation, the JavaScript stack of the allocating code is
+   * recorded. Restarting the profiler discards the collected data.
+   * New-space allocations are sampled, including those of generated code,
+   * as are old-space allocations of the runtime's generic allocation
+   * path. Code, maps, property cells, symbols and some large strings and
+   * arrays are allocated in their spaces directly and are not sampled.
+   */
+  static void StartAllocationSampling(int sample_interval = 512 * 1024);
+
+  /**
+   * Returns the root of the allocation sites tree collected so far, or
+   * NULL if the sampling allocation profiler is not running. The tree
+   * keeps being updated while the profiler runs and remains valid until
+   * StopAllocationSampling is called.
+   */
+  static const AllocationProfileNode* GetAllocationProfile();
+
+  /**
+   * Stops the sampling allocation profiler and deletes the allocation
+   * sites tree.
+   */
+  static void StopAllocationSampling();
+
   /** Binds a callback to embedder's class ID. */
   static void DefineWrapperClass(
       uint16_t class_id,
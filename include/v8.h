@@ -515,6 +515,28 @@ class V8EXPORT Data {
 };
 
 
+/**
+ * Script source that is delivered in chunks, e.g. while it is still being
+ * read from slow storage or decompressed.  Compiling from a stream lets
+ * parsing overlap with loading the source.  The source must be UTF-8
+ * encoded; chunk boundaries may split multi-byte sequences.
+ */
+class V8EXPORT ScriptSourceStream {  // NOLINT
+ public:
+  virtual ~ScriptSourceStream() { }
+
+  /**
+   * Returns the length in bytes of the next chunk of source and stores a
+   * pointer to it in *chunk, or returns 0 when the end of the source has
+   * been reached.  The chunk must stay valid until the next call.  This is
+   * called on the thread that compiles the script whenever the parser has
+   * consumed the previous chunk, so it may block until more data arrives.
+   * It must not call into V8.
+   */
+  virtual size_t GetMoreData(const char** chunk) = 0;
+};
+
+
 /**
  * Pre-compilation data that can be associated with a script.  This
  * data can be calculated for a script in advance of actually
@@ -543,6 +565,16 @@ class V8EXPORT ScriptData {  // NOLINT
    */
   static ScriptData* PreCompile(Handle<String> source);
 
+  /**
+   * Pre-compiles the script read from the stream (context-independent).
+   * Pre-parsing uses the current isolate's caches, stack limit and
+   * counters, and reports stack overflows on its heap, so this must be
+   * called on the isolate's thread, or with a Locker held.
+   *
+   * \param source Stream of UTF-8 script source code, read to the end.
+   */
+  static ScriptData* PreCompile(ScriptSourceStream* source);
+
   /**
    * Load previous pre-compilation data.
    *
@@ -592,6 +624,59 @@ class ScriptOrigin {
 };
 
 
+/**
+ * Compiled code of a script that can be stored between runs of a program.
+ * Compiling a script with code cache data deserializes its code instead of
+ * compiling the source again.  Only code for the same source produced by the
+ * same version of V8, with the same flags and on the same CPU is accepted,
+ * other data is rejected and the source is compiled as usual.
+ *
+ * NOTE: The data is not validated beyond a checksum, it must come from a
+ * trusted source.
+ */
+class V8EXPORT CodeCacheData {  // NOLINT
+ public:
+  virtual ~CodeCacheData() { }
+
+  /**
+   * Compiles the specified script in the current context and returns its
+   * code, or NULL if the code cannot be cached.  The script is not run.
+   * Functions that are compiled lazily are not part of the data.
+   *
+   * \param source Script source code.
+   * \param origin Script origin, owned by caller.
+   */
+  static CodeCacheData* Produce(Handle<String> source,
+                                ScriptOrigin* origin = NULL);
+
+  /**
+   * Load previously produced code cache data.
+   *
+   * \param data Pointer to data returned by a call to Data() of a previous
+   *   CodeCacheData.  The data is copied, ownership is not transferred.
+   * \param length Length of data.
+   */
+  static CodeCacheData* New(const char* data, int length);
+
+  /**
+   * Returns the length of Data().
+   */
+  virtual int Length() = 0;
+
+  /**
+   * Returns a serialized representation of this CodeCacheData that can later
+   * be passed to New().
+   */
+  virtual const char* Data() = 0;
+
+  /**
+   * Returns true if the data was rejected by Script::NewFromCodeCache(),
+   * because it was produced for another source or configuration.
+   */
+  virtual bool Rejected() = 0;
+};
+
+
 /**
  * A compiled JavaScript script.
  */
@@ -630,6 +715,38 @@ class V8EXPORT Script {
   static Local<Script> New(Handle<String> source,
                            Handle<Value> file_name);
 
+  /**
+   * Compiles the script read from the stream (context-independent).  The
+   * script is parsed while the stream delivers its source.
+   *
+   * \param source Stream of UTF-8 script source code, read to the end
+   *   before New() returns.  Owned by caller.
+   * \param origin Script origin, owned by caller, no references are kept
+   *   when New() returns
+   * \return Compiled script object (context independent; when run it
+   *   will use the currently entered context).
+   */
+  static Local<Script> New(ScriptSourceStream* source,
+                           ScriptOrigin* origin = NULL);
+
+  /**
+   * Compiles the specified script (context-independent), using the code
+   * from the code cache if it was produced for the same source.  Otherwise
+   * the code cache data is marked as rejected and the source is compiled.
+   *
+   * \param source Script source code.
+   * \param origin Script origin, owned by caller, no references are kept
+   *   when NewFromCodeCache() returns.
+   * \param code_cache Code cache data, as obtained by
+   *   CodeCacheData::Produce().  Owned by caller, no references are kept
+   *   when NewFromCodeCache() returns.
+   * \return Compiled script object (context independent; when run it
+   *   will use the currently entered context).
+   */
+  static Local<Script> NewFromCodeCache(Handle<String> source,
+                                        ScriptOrigin* origin,
+                                        CodeCacheData* code_cache);
+
   /**
    * Compiles the specified script (bound to current context).
    *
@@ -668,6 +785,21 @@ class V8EXPORT Script {
                                Handle<Value> file_name,
                                Handle<String> script_data = Handle<String>());
 
+  /**
+   * Compiles the script read from the stream (bound to current context).
+   * The script is parsed while the stream delivers its source.
+   *
+   * \param source Stream of UTF-8 script source code, read to the end
+   *   before Compile() returns.  Owned by caller.
+   * \param origin Script origin, owned by caller, no references are kept
+   *   when Compile() returns
+   * \return Compiled script object, bound to the context that was active
+   *   when this function was called.  When run it will always use this
+   *   context.
+   */
+  static Local<Script> Compile(ScriptSourceStream* source,
+                               ScriptOrigin* origin = NULL);
+
   /**
    * Runs the script returning the resulting value.  If the script is
    * context independent (created using ::New) it will be run in the
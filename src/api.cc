@@ -53,6 +53,7 @@
 #include "property.h"
 #include "runtime-profiler.h"
 #include "scanner-character-streams.h"
+#include "serialize.h"
 #include "snapshot.h"
 #include "unicode-inl.h"
 #include "v8threads.h"
@@ -1479,6 +1480,12 @@ ScriptData* ScriptData::PreCompile(v8::Handle<String> source) {
 }
 
 
+ScriptData* ScriptData::PreCompile(ScriptSourceStream* source) {
+  i::ChunkedUtf8ToUtf16CharacterStream stream(source);
+  return i::ParserApi::PreParse(&stream, NULL, i::FLAG_harmony_scoping);
+}
+
+
 ScriptData* ScriptData::New(const char* data, int length) {
   // Return an empty ScriptData if the length is obviously invalid.
   if (length % sizeof(unsigned) != 0) {
@@ -1500,6 +1507,96 @@ ScriptData* ScriptData::New(const char* data, int length) {
 }
 
 
+// --- C o d e C a c h e D a t a ---
+
+
+namespace {
+
+class CodeCacheDataImpl : public CodeCacheData {
+ public:
+  CodeCacheDataImpl(const char* data, int length)
+      : data_(i::NewArray<char>(length)),
+        length_(length),
+        rejected_(false) {
+    i::OS::MemCopy(data_, data, length);
+  }
+
+  virtual ~CodeCacheDataImpl() { i::DeleteArray(data_); }
+
+  virtual int Length() { return length_; }
+  virtual const char* Data() { return data_; }
+  virtual bool Rejected() { return rejected_; }
+
+  i::Vector<const i::byte> bytes() {
+    return i::Vector<const i::byte>(reinterpret_cast<i::byte*>(data_),
+                                    length_);
+  }
+  void set_rejected(bool rejected) { rejected_ = rejected; }
+
+ private:
+  char* data_;
+  int length_;
+  bool rejected_;
+};
+
+}  // namespace
+
+
+static void GetScriptOrigin(v8::ScriptOrigin* origin,
+                            i::Handle<i::Object>* name_obj,
+                            int* line_offset,
+                            int* column_offset) {
+  *line_offset = 0;
+  *column_offset = 0;
+  if (origin != NULL) {
+    if (!origin->ResourceName().IsEmpty()) {
+      *name_obj = Utils::OpenHandle(*origin->ResourceName());
+    }
+    if (!origin->ResourceLineOffset().IsEmpty()) {
+      *line_offset = static_cast<int>(origin->ResourceLineOffset()->Value());
+    }
+    if (!origin->ResourceColumnOffset().IsEmpty()) {
+      *column_offset =
+          static_cast<int>(origin->ResourceColumnOffset()->Value());
+    }
+  }
+}
+
+
+CodeCacheData* CodeCacheData::Produce(v8::Handle<String> source,
+                                      v8::ScriptOrigin* origin) {
+  i::Isolate* isolate = i::Isolate::Current();
+  ON_BAILOUT(isolate, "v8::CodeCacheData::Produce()", return NULL);
+  LOG_API(isolate, "CodeCacheData::Produce");
+  ENTER_V8(isolate);
+  i::HandleScope scope(isolate);
+  i::Handle<i::String> str = Utils::OpenHandle(*source);
+  i::Handle<i::Object> name_obj;
+  int line_offset;
+  int column_offset;
+  GetScriptOrigin(origin, &name_obj, &line_offset, &column_offset);
+  EXCEPTION_PREAMBLE(isolate);
+  i::Handle<i::SharedFunctionInfo> result =
+      i::Compiler::CompileForCodeCache(str,
+                                       name_obj,
+                                       line_offset,
+                                       column_offset,
+                                       isolate->global_context());
+  has_pending_exception = result.is_null();
+  EXCEPTION_BAILOUT_CHECK(isolate, NULL);
+  i::List<i::byte> data;
+  if (!i::CodeSerializer::Serialize(result, &data)) return NULL;
+  i::Vector<i::byte> bytes = data.ToVector();
+  return new CodeCacheDataImpl(reinterpret_cast<const char*>(bytes.start()),
+                               bytes.length());
+}
+
+
+CodeCacheData* CodeCacheData::New(const char* data, int length) {
+  return new CodeCacheDataImpl(data, length);
+}
+
+
 // --- S c r i p t ---
 
 
@@ -1515,20 +1612,9 @@ Local<Script> Script::New(v8::Handle<String> source,
   { i::HandleScope scope(isolate);
     i::Handle<i::String> str = Utils::OpenHandle(*source);
     i::Handle<i::Object> name_obj;
-    int line_offset = 0;
-    int column_offset = 0;
-    if (origin != NULL) {
-      if (!origin->ResourceName().IsEmpty()) {
-        name_obj = Utils::OpenHandle(*origin->ResourceName());
-      }
-      if (!origin->ResourceLineOffset().IsEmpty()) {
-        line_offset = static_cast<int>(origin->ResourceLineOffset()->Value());
-      }
-      if (!origin->ResourceColumnOffset().IsEmpty()) {
-        column_offset =
-            static_cast<int>(origin->ResourceColumnOffset()->Value());
-      }
-    }
+    int line_offset;
+    int column_offset;
+    GetScriptOrigin(origin, &name_obj, &line_offset, &column_offset);
     EXCEPTION_PREAMBLE(isolate);
     i::ScriptDataImpl* pre_data_impl =
         static_cast<i::ScriptDataImpl*>(pre_data);
@@ -1565,6 +1651,72 @@ Local<Script> Script::New(v8::Handle<String> source,
 }
 
 
+Local<Script> Script::New(ScriptSourceStream* source,
+                          v8::ScriptOrigin* origin) {
+  i::Isolate* isolate = i::Isolate::Current();
+  ON_BAILOUT(isolate, "v8::Script::New()", return Local<Script>());
+  LOG_API(isolate, "Script::New");
+  ENTER_V8(isolate);
+  i::SharedFunctionInfo* raw_result = NULL;
+  { i::HandleScope scope(isolate);
+    i::Handle<i::Object> name_obj;
+    int line_offset;
+    int column_offset;
+    GetScriptOrigin(origin, &name_obj, &line_offset, &column_offset);
+    i::ChunkedUtf8ToUtf16CharacterStream stream(source);
+    EXCEPTION_PREAMBLE(isolate);
+    i::Handle<i::SharedFunctionInfo> result =
+        i::Compiler::CompileStreamed(&stream,
+                                     name_obj,
+                                     line_offset,
+                                     column_offset,
+                                     isolate->global_context());
+    has_pending_exception = result.is_null();
+    EXCEPTION_BAILOUT_CHECK(isolate, Local<Script>());
+    raw_result = *result;
+  }
+  i::Handle<i::SharedFunctionInfo> result(raw_result, isolate);
+  return Local<Script>(ToApi<Script>(result));
+}
+
+
+Local<Script> Script::NewFromCodeCache(v8::Handle<String> source,
+                                       v8::ScriptOrigin* origin,
+                                       v8::CodeCacheData* code_cache) {
+  i::Isolate* isolate = i::Isolate::Current();
+  ON_BAILOUT(isolate, "v8::Script::NewFromCodeCache()",
+             return Local<Script>());
+  LOG_API(isolate, "Script::NewFromCodeCache");
+  ENTER_V8(isolate);
+  i::SharedFunctionInfo* raw_result = NULL;
+  { i::HandleScope scope(isolate);
+    i::Handle<i::String> str = Utils::OpenHandle(*source);
+    i::Handle<i::Object> name_obj;
+    int line_offset;
+    int column_offset;
+    GetScriptOrigin(origin, &name_obj, &line_offset, &column_offset);
+    CodeCacheDataImpl* code_cache_impl =
+        static_cast<CodeCacheDataImpl*>(code_cache);
+    bool rejected = false;
+    EXCEPTION_PREAMBLE(isolate);
+    i::Handle<i::SharedFunctionInfo> result =
+        i::Compiler::CompileFromCodeCache(str,
+                                          name_obj,
+                                          line_offset,
+                                          column_offset,
+                                          isolate->global_context(),
+                                          code_cache_impl->bytes(),
+                                          &rejected);
+    code_cache_impl->set_rejected(rejected);
+    has_pending_exception = result.is_null();
+    EXCEPTION_BAILOUT_CHECK(isolate, Local<Script>());
+    raw_result = *result;
+  }
+  i::Handle<i::SharedFunctionInfo> result(raw_result, isolate);
+  return Local<Script>(ToApi<Script>(result));
+}
+
+
 Local<Script> Script::Compile(v8::Handle<String> source,
                               v8::ScriptOrigin* origin,
                               v8::ScriptData* pre_data,
@@ -1595,6 +1747,26 @@ Local<Script> Script::Compile(v8::Handle<String> source,
 }
 
 
+Local<Script> Script::Compile(ScriptSourceStream* source,
+                              v8::ScriptOrigin* origin) {
+  i::Isolate* isolate = i::Isolate::Current();
+  ON_BAILOUT(isolate, "v8::Script::Compile()", return Local<Script>());
+  LOG_API(isolate, "Script::Compile");
+  ENTER_V8(isolate);
+  Local<Script> generic = New(source, origin);
+  if (generic.IsEmpty())
+    return generic;
+  i::Handle<i::Object> obj = Utils::OpenHandle(*generic);
+  i::Handle<i::SharedFunctionInfo> function =
+      i::Handle<i::SharedFunctionInfo>(i::SharedFunctionInfo::cast(*obj));
+  i::Handle<i::JSFunction> result =
+      isolate->factory()->NewFunctionFromSharedFunctionInfo(
+          function,
+          isolate->global_context());
+  return Local<Script>(ToApi<Script>(result));
+}
+
+
 Local<Value> Script::Run() {
   i::Isolate* isolate = i::Isolate::Current();
   ON_BAILOUT(isolate, "v8::Script::Run()", return Local<Value>());
@@ -6102,6 +6274,18 @@ const CpuProfileNode* CpuProfile::GetTopDownRoot() const {
 }
 
 
+void CpuProfile::SerializeTrace(OutputStream* stream) const {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::CpuProfile::SerializeTrace");
+  ApiCheck(stream->GetChunkSize() > 0,
+           "v8::CpuProfile::SerializeTrace",
+           "Invalid stream chunk size");
+  i::CpuProfile* profile =
+      const_cast<i::CpuProfile*>(reinterpret_cast<const i::CpuProfile*>(this));
+  profile->SerializeTrace(stream);
+}
+
+
 int CpuProfiler::GetProfilesCount() {
   i::Isolate* isolate = i::Isolate::Current();
   IsDeadCheck(isolate, "v8::CpuProfiler::GetProfilesCount");
@@ -6131,10 +6315,10 @@ const CpuProfile* CpuProfiler::FindProfile(unsigned uid,
 }
 
 
-void CpuProfiler::StartProfiling(Handle<String> title) {
+void CpuProfiler::StartProfiling(Handle<String> title, bool record_samples) {
   i::Isolate* isolate = i::Isolate::Current();
   IsDeadCheck(isolate, "v8::CpuProfiler::StartProfiling");
-  i::CpuProfiler::StartProfiling(*Utils::OpenHandle(*title));
+  i::CpuProfiler::StartProfiling(*Utils::OpenHandle(*title), record_samples);
 }
 
 
@@ -6361,6 +6545,86 @@ void HeapSnapshot::Serialize(OutputStream* stream,
 }
 
 
+Handle<String> AllocationProfileNode::GetFunctionName() const {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::AllocationProfileNode::GetFunctionName");
+  return Handle<String>(ToApi<String>(isolate->factory()->LookupAsciiSymbol(
+      reinterpret_cast<const i::AllocationSiteNode*>(this)->name())));
+}
+
+
+Handle<String> AllocationProfileNode::GetScriptResourceName() const {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::AllocationProfileNode::GetScriptResourceName");
+  return Handle<String>(ToApi<String>(isolate->factory()->LookupAsciiSymbol(
+      reinterpret_cast<const i::AllocationSiteNode*>(this)->resource_name())));
+}
+
+
+int AllocationProfileNode::GetLineNumber() const {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::AllocationProfileNode::GetLineNumber");
+  return reinterpret_cast<const i::AllocationSiteNode*>(this)->line_number();
+}
+
+
+unsigned AllocationProfileNode::GetSamplesCount() const {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::AllocationProfileNode::GetSamplesCount");
+  return reinterpret_cast<const i::AllocationSiteNode*>(this)->samples_count();
+}
+
+
+size_t AllocationProfileNode::GetSelfAllocatedSize() const {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::AllocationProfileNode::GetSelfAllocatedSize");
+  return reinterpret_cast<const i::AllocationSiteNode*>(this)->
+      self_allocated_size();
+}
+
+
+size_t AllocationProfileNode::GetSelfLiveSize() const {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::AllocationProfileNode::GetSelfLiveSize");
+  return reinterpret_cast<const i::AllocationSiteNode*>(this)->self_live_size();
+}
+
+
+size_t AllocationProfileNode::GetTotalAllocatedSize() const {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::AllocationProfileNode::GetTotalAllocatedSize");
+  return reinterpret_cast<const i::AllocationSiteNode*>(this)->
+      total_allocated_size();
+}
+
+
+size_t AllocationProfileNode::GetTotalLiveSize() const {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::AllocationProfileNode::GetTotalLiveSize");
+  return reinterpret_cast<const i::AllocationSiteNode*>(this)->
+      total_live_size();
+}
+
+
+int AllocationProfileNode::GetChildrenCount() const {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::AllocationProfileNode::GetChildrenCount");
+  return reinterpret_cast<const i::AllocationSiteNode*>(this)->
+      children()->length();
+}
+
+
+const AllocationProfileNode* AllocationProfileNode::GetChild(
+    int index) const {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::AllocationProfileNode::GetChild");
+  const i::AllocationSiteNode* child =
+      reinterpret_cast<const i::AllocationSiteNode*>(this)->
+          children()->at(index);
+  return reinterpret_cast<const AllocationProfileNode*>(child);
+}
+
+
 int HeapProfiler::GetSnapshotsCount() {
   i::Isolate* isolate = i::Isolate::Current();
   IsDeadCheck(isolate, "v8::HeapProfiler::GetSnapshotsCount");
@@ -6411,6 +6675,22 @@ const HeapSnapshot* HeapProfiler::TakeSnapshot(Handle<String> title,
 }
 
 
+bool HeapProfiler::TakeStreamingSnapshot(Handle<String> title,
+                                         OutputStream* stream,
+                                         ActivityControl* control) {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::HeapProfiler::TakeStreamingSnapshot");
+  ApiCheck(stream->GetOutputEncoding() == OutputStream::kAscii,
+           "v8::HeapProfiler::TakeStreamingSnapshot",
+           "Unsupported output encoding");
+  ApiCheck(stream->GetChunkSize() > 0,
+           "v8::HeapProfiler::TakeStreamingSnapshot",
+           "Invalid stream chunk size");
+  return i::HeapProfiler::StreamSnapshot(
+      *Utils::OpenHandle(*title), stream, control);
+}
+
+
 void HeapProfiler::StartHeapObjectsTracking() {
   i::Isolate* isolate = i::Isolate::Current();
   IsDeadCheck(isolate, "v8::HeapProfiler::StartHeapObjectsTracking");
@@ -6439,6 +6719,31 @@ void HeapProfiler::DeleteAllSnapshots() {
 }
 
 
+void HeapProfiler::StartAllocationSampling(int sample_interval) {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::HeapProfiler::StartAllocationSampling");
+  ApiCheck(sample_interval > 0,
+           "v8::HeapProfiler::StartAllocationSampling",
+           "Invalid sample interval");
+  i::HeapProfiler::StartAllocationSampling(sample_interval);
+}
+
+
+const AllocationProfileNode* HeapProfiler::GetAllocationProfile() {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::HeapProfiler::GetAllocationProfile");
+  return reinterpret_cast<const AllocationProfileNode*>(
+      i::HeapProfiler::GetAllocationProfile());
+}
+
+
+void HeapProfiler::StopAllocationSampling() {
+  i::Isolate* isolate = i::Isolate::Current();
+  IsDeadCheck(isolate, "v8::HeapProfiler::StopAllocationSampling");
+  i::HeapProfiler::StopAllocationSampling();
+}
+
+
 void HeapProfiler::DefineWrapperClass(uint16_t class_id,
                                       WrapperInfoCallback callback) {
   i::Isolate::Current()->heap_profiler()->DefineWrapperClass(class_id,
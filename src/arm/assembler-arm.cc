@@ -811,7 +811,7 @@ bool Operand::must_output_reloc_info(const Assembler* assembler) const {
     }
 #endif  // def DEBUG
     if (assembler != NULL && assembler->predictable_code_size()) return true;
-    return Serializer::enabled();
+    return Serializer::code_must_be_relocatable();
   } else if (rmode_ == RelocInfo::NONE) {
     return false;
   }
@@ -2638,14 +2638,14 @@ void Assembler::RecordRelocInfo(RelocInfo::Mode rmode, intptr_t data,
     BlockConstPoolFor(1);
   }
   if (rinfo.rmode() != RelocInfo::NONE) {
-    // Don't record external references unless the heap will be serialized.
+    // Don't record external references unless the code will be serialized.
     if (rmode == RelocInfo::EXTERNAL_REFERENCE) {
 #ifdef DEBUG
       if (!Serializer::enabled()) {
         Serializer::TooLateToEnableNow();
       }
 #endif
-      if (!Serializer::enabled() && !emit_debug_code()) {
+      if (!Serializer::code_must_be_relocatable() && !emit_debug_code()) {
         return;
       }
     }
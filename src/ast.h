@@ -656,6 +656,11 @@ class IterationStatement: public BreakableStatement {
   virtual BailoutId ContinueId() const = 0;
   virtual BailoutId StackCheckId() const = 0;
 
+  // The number of AST nodes in the condition, body and next statement of
+  // the loop, or 0 if unknown.  Used to bound the code growth of peeling.
+  int node_count() const { return node_count_; }
+  void set_node_count(int node_count) { node_count_ = node_count; }
+
   // Code generation
   Label* continue_target()  { return &continue_target_; }
 
@@ -663,6 +668,7 @@ class IterationStatement: public BreakableStatement {
   IterationStatement(Isolate* isolate, ZoneStringList* labels)
       : BreakableStatement(isolate, labels, TARGET_FOR_ANONYMOUS),
         body_(NULL),
+        node_count_(0),
         osr_entry_id_(GetNextId(isolate)) {
   }
 
@@ -672,6 +678,7 @@ class IterationStatement: public BreakableStatement {
 
  private:
   Statement* body_;
+  int node_count_;
   Label continue_target_;
   const BailoutId osr_entry_id_;
 };
@@ -306,6 +306,9 @@ Handle<Context> Bootstrapper::CreateEnvironment(
   Handle<Context> env;
   Genesis genesis(isolate, global_object, global_template, extensions);
   env = genesis.result();
+  // Compiling the natives is a one-off burst of zone allocation, do not
+  // keep its segments around.
+  isolate->zone_segment_pool()->Clear();
   if (!env.is_null()) {
     if (InstallExtensions(env, extensions)) {
       return env;
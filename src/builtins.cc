@@ -613,7 +613,7 @@ BUILTIN(ArrayShift) {
     first = heap->undefined_value();
   }
 
-  if (!heap->lo_space()->Contains(elms)) {
+  if (heap->CanMoveObjectStart(elms)) {
     array->set_elements(LeftTrimFixedArray(heap, elms, 1));
   } else {
     // Shift the elements.
@@ -862,7 +862,7 @@ BUILTIN(ArraySplice) {
   bool elms_changed = false;
   if (item_count < actual_delete_count) {
     // Shrink the array.
-    const bool trim_array = !heap->lo_space()->Contains(elms) &&
+    const bool trim_array = heap->CanMoveObjectStart(elms) &&
       ((actual_start + item_count) <
           (len - actual_delete_count - actual_start));
     if (trim_array) {
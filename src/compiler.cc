@@ -45,6 +45,7 @@
 #include "scanner-character-streams.h"
 #include "scopeinfo.h"
 #include "scopes.h"
+#include "serialize.h"
 #include "vm-state-inl.h"
 
 namespace v8 {
@@ -60,6 +61,7 @@ CompilationInfo::CompilationInfo(Handle<Script> script, Zone* zone)
       script_(script),
       extension_(NULL),
       pre_parse_data_(NULL),
+      source_stream_(NULL),
       osr_ast_id_(BailoutId::None()),
       zone_(zone),
       deferred_handles_(NULL) {
@@ -79,6 +81,7 @@ CompilationInfo::CompilationInfo(Handle<SharedFunctionInfo> shared_info,
       script_(Handle<Script>(Script::cast(shared_info->script()))),
       extension_(NULL),
       pre_parse_data_(NULL),
+      source_stream_(NULL),
       osr_ast_id_(BailoutId::None()),
       zone_(zone),
       deferred_handles_(NULL) {
@@ -98,6 +101,7 @@ CompilationInfo::CompilationInfo(Handle<JSFunction> closure, Zone* zone)
       script_(Handle<Script>(Script::cast(shared_info_->script()))),
       extension_(NULL),
       pre_parse_data_(NULL),
+      source_stream_(NULL),
       context_(closure->context()),
       osr_ast_id_(BailoutId::None()),
       zone_(zone),
@@ -181,6 +185,13 @@ void OptimizingCompiler::RecordOptimizationStats() {
     PrintF(" - took %0.3f, %0.3f, %0.3f ms]\n", ms_creategraph, ms_optimize,
            ms_codegen);
   }
+  if (FLAG_trace_osr && !info()->osr_ast_id().IsNone()) {
+    PrintF("[compiling for on-stack replacement at AST id %d in ",
+           info()->osr_ast_id().ToInt());
+    function->PrintName();
+    PrintF(" took %0.3f, %0.3f, %0.3f ms]\n", ms_creategraph, ms_optimize,
+           ms_codegen);
+  }
   if (FLAG_trace_opt_stats) {
     static double compilation_time = 0.0;
     static int compiled_functions = 0;
@@ -461,6 +472,7 @@ static Handle<SharedFunctionInfo> MakeFunctionInfo(CompilationInfo* info) {
   ASSERT(info->is_eval() || info->is_global());
   ParsingFlags flags = kNoParsingFlags;
   if (info->pre_parse_data() != NULL ||
+      info->source_stream() != NULL ||
       String::cast(script->source())->length() > FLAG_min_preparse_length) {
     flags = kAllowLazy;
   }
@@ -616,6 +628,168 @@ Handle<SharedFunctionInfo> Compiler::Compile(Handle<String> source,
 }
 
 
+Handle<SharedFunctionInfo> Compiler::CompileForCodeCache(
+    Handle<String> source,
+    Handle<Object> script_name,
+    int line_offset,
+    int column_offset,
+    Handle<Context> context) {
+  Isolate* isolate = source->GetIsolate();
+
+  // The VM is in the COMPILER state until exiting this function.
+  VMState state(isolate, COMPILER);
+
+  Handle<Script> script = isolate->factory()->NewScript(source);
+  if (!script_name.is_null()) {
+    script->set_name(*script_name);
+    script->set_line_offset(Smi::FromInt(line_offset));
+    script->set_column_offset(Smi::FromInt(column_offset));
+  }
+
+  Handle<SharedFunctionInfo> result;
+  {
+    // Generate code that does not depend on this process.
+    RelocatableCodeScope relocatable_code;
+    CompilationInfoWithZone info(script);
+    info.MarkAsGlobal();
+    info.SetContext(context);
+    if (FLAG_use_strict) {
+      info.SetLanguageMode(FLAG_harmony_scoping ? EXTENDED_MODE : STRICT_MODE);
+    }
+    result = MakeFunctionInfo(&info);
+  }
+
+  if (result.is_null()) isolate->ReportPendingMessages();
+  return result;
+}
+
+
+Handle<SharedFunctionInfo> Compiler::CompileFromCodeCache(
+    Handle<String> source,
+    Handle<Object> script_name,
+    int line_offset,
+    int column_offset,
+    Handle<Context> context,
+    Vector<const byte> cached_data,
+    bool* rejected) {
+  Isolate* isolate = source->GetIsolate();
+  *rejected = false;
+
+  CompilationCache* compilation_cache = isolate->compilation_cache();
+  Handle<SharedFunctionInfo> result =
+      compilation_cache->LookupScript(source,
+                                      script_name,
+                                      line_offset,
+                                      column_offset,
+                                      context);
+  if (!result.is_null()) {
+    if (result->ic_age() != isolate->heap()->global_ic_age()) {
+      result->ResetForNewContext(isolate->heap()->global_ic_age());
+    }
+    return result;
+  }
+
+  // Cached code has no debug break slots, so compile while debugging.
+  if (!IsDebuggerActive(isolate)) {
+    isolate->counters()->total_load_size()->Increment(source->length());
+    VMState state(isolate, COMPILER);
+
+    Handle<Script> script = isolate->factory()->NewScript(source);
+    if (!script_name.is_null()) {
+      script->set_name(*script_name);
+      script->set_line_offset(Smi::FromInt(line_offset));
+      script->set_column_offset(Smi::FromInt(column_offset));
+    }
+    script->set_context_data((*isolate->native_context())->data());
+
+    result = CodeSerializer::Deserialize(isolate, cached_data, script);
+    if (!result.is_null()) {
+      if (result->ic_age() != isolate->heap()->global_ic_age()) {
+        result->ResetForNewContext(isolate->heap()->global_ic_age());
+      }
+      script->set_compilation_state(
+          Smi::FromInt(Script::COMPILATION_STATE_COMPILED));
+#ifdef ENABLE_DEBUGGER_SUPPORT
+      isolate->debugger()->OnAfterCompile(
+          script, Debugger::NO_AFTER_COMPILE_FLAGS);
+#endif
+      compilation_cache->PutScript(source, context, result);
+      return result;
+    }
+  }
+
+  *rejected = true;
+  return Compile(source,
+                 script_name,
+                 line_offset,
+                 column_offset,
+                 context,
+                 NULL,
+                 NULL,
+                 Handle<String>::null(),
+                 NOT_NATIVES_CODE);
+}
+
+
+Handle<SharedFunctionInfo> Compiler::CompileStreamed(
+    ChunkedUtf8ToUtf16CharacterStream* source_stream,
+    Handle<Object> script_name,
+    int line_offset,
+    int column_offset,
+    Handle<Context> context) {
+  Isolate* isolate = Isolate::Current();
+
+#ifdef ENABLE_DEBUGGER_SUPPORT
+  // The debugger expects to see the source before compilation.
+  if (isolate->debugger()->IsDebuggerActive()) {
+    return Compile(source_stream->Finish(),
+                   script_name,
+                   line_offset,
+                   column_offset,
+                   context,
+                   NULL,
+                   NULL,
+                   Handle<String>::null(),
+                   NOT_NATIVES_CODE);
+  }
+#endif
+
+  // The VM is in the COMPILER state until exiting this function.
+  VMState state(isolate, COMPILER);
+
+  // The parser replaces the empty source once the stream is exhausted.
+  Handle<Script> script =
+      isolate->factory()->NewScript(isolate->factory()->empty_string());
+  if (!script_name.is_null()) {
+    script->set_name(*script_name);
+    script->set_line_offset(Smi::FromInt(line_offset));
+    script->set_column_offset(Smi::FromInt(column_offset));
+  }
+
+  Handle<SharedFunctionInfo> result;
+  {
+    CompilationInfoWithZone info(script);
+    info.MarkAsGlobal();
+    info.SetSourceStream(source_stream);
+    info.SetContext(context);
+    if (FLAG_use_strict) {
+      info.SetLanguageMode(FLAG_harmony_scoping ? EXTENDED_MODE : STRICT_MODE);
+    }
+    result = MakeFunctionInfo(&info);
+  }
+
+  Handle<String> source(String::cast(script->source()));
+  isolate->counters()->total_load_size()->Increment(source->length());
+  isolate->counters()->total_compile_size()->Increment(source->length());
+  if (!result.is_null() && !result->dont_cache()) {
+    isolate->compilation_cache()->PutScript(source, context, result);
+  }
+
+  if (result.is_null()) isolate->ReportPendingMessages();
+  return result;
+}
+
+
 Handle<SharedFunctionInfo> Compiler::CompileEval(Handle<String> source,
                                                  Handle<Context> context,
                                                  bool is_global,
@@ -836,9 +1010,13 @@ bool Compiler::CompileLazy(CompilationInfo* info) {
 }
 
 
-void Compiler::RecompileParallel(Handle<JSFunction> closure) {
-  if (closure->IsInRecompileQueue()) return;
-  ASSERT(closure->IsMarkedForParallelRecompilation());
+void Compiler::RecompileParallel(Handle<JSFunction> closure,
+                                 BailoutId osr_ast_id) {
+  // Code for on-stack replacement is not installed on the closure when it
+  // is done, see OptimizingCompilerThread::InstallOptimizedFunctions.
+  bool is_osr = !osr_ast_id.IsNone();
+  if (!is_osr && closure->IsInRecompileQueue()) return;
+  ASSERT(is_osr || closure->IsMarkedForParallelRecompilation());
 
   Isolate* isolate = closure->GetIsolate();
   if (!isolate->optimizing_compiler_thread()->IsQueueAvailable()) {
@@ -855,7 +1033,12 @@ void Compiler::RecompileParallel(Handle<JSFunction> closure) {
   Handle<SharedFunctionInfo> shared = info->shared_info();
   int compiled_size = shared->end_position() - shared->start_position();
   isolate->counters()->total_compile_size()->Increment(compiled_size);
-  info->SetOptimizing(BailoutId::None());
+  info->SetOptimizing(osr_ast_id);
+
+  // The runtime profiler does not tick functions marked for recompilation,
+  // so the ticks still tell how hot the function was when it was marked.
+  int profiler_ticks = shared->code()->profiler_ticks();
+  if (!is_osr) shared->code()->set_profiler_ticks(0);
 
   {
     CompilationHandleScope handle_scope(*info);
@@ -873,10 +1056,15 @@ void Compiler::RecompileParallel(Handle<JSFunction> closure) {
             new(info->zone()) OptimizingCompiler(*info);
         OptimizingCompiler::Status status = compiler->CreateGraph();
         if (status == OptimizingCompiler::SUCCEEDED) {
-          isolate->optimizing_compiler_thread()->QueueForOptimization(compiler);
+          // The closure must not be optimized once a compiler thread can
+          // pick up the job.
+          if (!is_osr) {
+            closure->ReplaceCode(isolate->builtins()->builtin(
+                Builtins::kInRecompileQueue));
+          }
+          isolate->optimizing_compiler_thread()->QueueForOptimization(
+              compiler, profiler_ticks);
           shared->code()->set_profiler_ticks(0);
-          closure->ReplaceCode(isolate->builtins()->builtin(
-              Builtins::kInRecompileQueue));
           info.Detach();
         } else if (status == OptimizingCompiler::BAILED_OUT) {
           isolate->clear_pending_exception();
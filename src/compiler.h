@@ -35,6 +35,7 @@
 namespace v8 {
 namespace internal {
 
+class ChunkedUtf8ToUtf16CharacterStream;
 class ScriptDataImpl;
 
 // CompilationInfo encapsulates some information known at compile time.  It
@@ -72,6 +73,9 @@ class CompilationInfo {
   Handle<Script> script() const { return script_; }
   v8::Extension* extension() const { return extension_; }
   ScriptDataImpl* pre_parse_data() const { return pre_parse_data_; }
+  ChunkedUtf8ToUtf16CharacterStream* source_stream() const {
+    return source_stream_;
+  }
   Handle<Context> context() const { return context_; }
   BailoutId osr_ast_id() const { return osr_ast_id_; }
 
@@ -120,6 +124,10 @@ class CompilationInfo {
     ASSERT(!is_lazy());
     pre_parse_data_ = pre_parse_data;
   }
+  void SetSourceStream(ChunkedUtf8ToUtf16CharacterStream* source_stream) {
+    ASSERT(!is_lazy());
+    source_stream_ = source_stream;
+  }
   void SetContext(Handle<Context> context) {
     context_ = context;
   }
@@ -260,6 +268,9 @@ class CompilationInfo {
   // Fields possibly needed for eager compilation, NULL by default.
   v8::Extension* extension_;
   ScriptDataImpl* pre_parse_data_;
+  // The source of a streamed script, which is installed on the script once
+  // it has been parsed.
+  ChunkedUtf8ToUtf16CharacterStream* source_stream_;
 
   // The context of the caller for eval code, and the global context for a
   // global script. Will be a null handle otherwise.
@@ -436,6 +447,38 @@ class Compiler : public AllStatic {
                                             Handle<Object> script_data,
                                             NativesFlag is_natives_code);
 
+  // Compile a String source within a context to code that can be written to
+  // the code cache with CodeSerializer::Serialize.  Neither looks up nor
+  // updates the compilation cache.
+  static Handle<SharedFunctionInfo> CompileForCodeCache(
+      Handle<String> source,
+      Handle<Object> script_name,
+      int line_offset,
+      int column_offset,
+      Handle<Context> context);
+
+  // Compile a String source within a context, using the code cache data
+  // if it was produced for the same source.  Otherwise *rejected is set and
+  // the source is compiled as usual.
+  static Handle<SharedFunctionInfo> CompileFromCodeCache(
+      Handle<String> source,
+      Handle<Object> script_name,
+      int line_offset,
+      int column_offset,
+      Handle<Context> context,
+      Vector<const byte> cached_data,
+      bool* rejected);
+
+  // Compile UTF-8 source read from a chunked stream within a context.  The
+  // source is parsed while it is being read.  It is only known afterwards,
+  // so the compilation cache is updated but not consulted.
+  static Handle<SharedFunctionInfo> CompileStreamed(
+      ChunkedUtf8ToUtf16CharacterStream* source_stream,
+      Handle<Object> script_name,
+      int line_offset,
+      int column_offset,
+      Handle<Context> context);
+
   // Compile a String source within a context for Eval.
   static Handle<SharedFunctionInfo> CompileEval(Handle<String> source,
                                                 Handle<Context> context,
@@ -447,7 +490,11 @@ class Compiler : public AllStatic {
   // success and false if the compilation resulted in a stack overflow.
   static bool CompileLazy(CompilationInfo* info);
 
-  static void RecompileParallel(Handle<JSFunction> function);
+  // Queue the function for optimization on the optimizing compiler thread.
+  // If osr_ast_id is not None the code is compiled for on-stack replacement
+  // at that loop.
+  static void RecompileParallel(Handle<JSFunction> function,
+                                BailoutId osr_ast_id);
 
   // Compile a shared function info object (the function is possibly lazily
   // compiled).
@@ -87,9 +87,15 @@ void HistogramTimer::Start() {
 void HistogramTimer::Stop() {
   if (histogram_.Enabled()) {
     stop_time_ = OS::Ticks();
+    AddTimedSample(stop_time_ - start_time_);
+  }
+}
 
-    // Compute the delta between start and stop, in milliseconds.
-    int milliseconds = static_cast<int>(stop_time_ - start_time_) / 1000;
+// Record an interval measured by the caller.
+void HistogramTimer::AddTimedSample(int64_t microseconds) {
+  if (histogram_.Enabled()) {
+    // Convert the interval to milliseconds.
+    int milliseconds = static_cast<int>(microseconds / 1000);
     histogram_.AddSample(milliseconds);
   }
 }
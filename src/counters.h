@@ -192,6 +192,10 @@ struct StatsCounterTimer {
   // Stop the timer and record the results.
   void Stop();
 
+  // Record an interval of the given length, in microseconds, that was
+  // timed elsewhere, e.g. on a background thread.
+  void AddTimedSample(int64_t microseconds);
+
   // Returns true if the timer is running.
   bool Running() {
     return counter_.Enabled() && start_time_ != 0 && stop_time_ == 0;
@@ -252,6 +256,10 @@ struct HistogramTimer {
   // Stop the timer and record the results.
   void Stop();
 
+  // Record an interval of the given length, in microseconds, that was
+  // timed elsewhere, e.g. on a background thread.
+  void AddTimedSample(int64_t microseconds);
+
   // Returns true if the timer is running.
   bool Running() {
     return histogram_.Enabled() && (start_time_ != 0) && (stop_time_ == 0);
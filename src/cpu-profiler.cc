@@ -175,6 +175,7 @@ void ProfilerEventsProcessor::AddCurrentStack() {
   Isolate* isolate = Isolate::Current();
   sample->state = isolate->current_vm_state();
   sample->pc = reinterpret_cast<Address>(sample);  // Not NULL.
+  sample->timestamp = OS::Ticks();
   for (StackTraceFrameIterator it(isolate);
        !it.done() && sample->frames_count < TickSample::kMaxFramesCount;
        it.Advance()) {
@@ -259,15 +260,17 @@ void ProfilerEventsProcessor::Run() {
 }
 
 
-void CpuProfiler::StartProfiling(const char* title) {
+void CpuProfiler::StartProfiling(const char* title, bool record_samples) {
   ASSERT(Isolate::Current()->cpu_profiler() != NULL);
-  Isolate::Current()->cpu_profiler()->StartCollectingProfile(title);
+  Isolate::Current()->cpu_profiler()->StartCollectingProfile(
+      title, record_samples);
 }
 
 
-void CpuProfiler::StartProfiling(String* title) {
+void CpuProfiler::StartProfiling(String* title, bool record_samples) {
   ASSERT(Isolate::Current()->cpu_profiler() != NULL);
-  Isolate::Current()->cpu_profiler()->StartCollectingProfile(title);
+  Isolate::Current()->cpu_profiler()->StartCollectingProfile(
+      title, record_samples);
 }
 
 
@@ -469,16 +472,17 @@ void CpuProfiler::ResetProfiles() {
   profiles_ = new CpuProfilesCollection();
 }
 
-void CpuProfiler::StartCollectingProfile(const char* title) {
-  if (profiles_->StartProfiling(title, next_profile_uid_++)) {
+void CpuProfiler::StartCollectingProfile(const char* title,
+                                         bool record_samples) {
+  if (profiles_->StartProfiling(title, next_profile_uid_++, record_samples)) {
     StartProcessorIfNotStarted();
   }
   processor_->AddCurrentStack();
 }
 
 
-void CpuProfiler::StartCollectingProfile(String* title) {
-  StartCollectingProfile(profiles_->GetName(title));
+void CpuProfiler::StartCollectingProfile(String* title, bool record_samples) {
+  StartCollectingProfile(profiles_->GetName(title), record_samples);
 }
 
 
@@ -371,7 +371,10 @@ Deoptimizer::Deoptimizer(Isolate* isolate,
       output_(NULL),
       deferred_arguments_objects_values_(0),
       deferred_arguments_objects_(0),
-      deferred_heap_numbers_(0) {
+      deferred_heap_numbers_(0),
+      deferred_objects_tagged_values_(0),
+      deferred_objects_double_values_(0),
+      deferred_objects_(0) {
   if (FLAG_trace_deopt && type != OSR) {
     if (type == DEBUGGER) {
       PrintF("**** DEOPT FOR DEBUGGER: ");
@@ -609,6 +612,7 @@ void Deoptimizer::DoComputeOutputFrames() {
       case Translation::DOUBLE_STACK_SLOT:
       case Translation::LITERAL:
       case Translation::ARGUMENTS_OBJECT:
+      case Translation::CAPTURED_OBJECT:
       case Translation::DUPLICATE:
         UNREACHABLE();
         break;
@@ -645,22 +649,80 @@ void Deoptimizer::MaterializeHeapObjects(JavaScriptFrameIterator* it) {
     values.Add(Handle<Object>(deferred_arguments_objects_values_[i]));
   }
 
+  // Handlify all captured object values before triggering any allocation.
+  List<Handle<Object> > object_values(deferred_objects_tagged_values_.length());
+  for (int i = 0; i < deferred_objects_tagged_values_.length(); ++i) {
+    object_values.Add(Handle<Object>(deferred_objects_tagged_values_[i]));
+  }
+
   // Play it safe and clear all unhandlified values before we continue.
   deferred_arguments_objects_values_.Clear();
+  deferred_objects_tagged_values_.Clear();
 
   // Materialize all heap numbers before looking at arguments because when the
   // output frames are used to materialize arguments objects later on they need
   // to already contain valid heap numbers.
   for (int i = 0; i < deferred_heap_numbers_.length(); i++) {
-    HeapNumberMaterializationDescriptor d = deferred_heap_numbers_[i];
+    HeapNumberMaterializationDescriptor<Address> d = deferred_heap_numbers_[i];
     Handle<Object> num = isolate_->factory()->NewNumber(d.value());
     if (FLAG_trace_deopt) {
       PrintF("Materializing a new heap number %p [%e] in slot %p\n",
              reinterpret_cast<void*>(*num),
              d.value(),
-             d.slot_address());
+             d.destination());
+    }
+    Memory::Object_at(d.destination()) = *num;
+  }
+
+  // Materialize the untagged field values of captured objects.
+  for (int i = 0; i < deferred_objects_double_values_.length(); i++) {
+    HeapNumberMaterializationDescriptor<int> d =
+        deferred_objects_double_values_[i];
+    Handle<Object> num = isolate_->factory()->NewNumber(d.value());
+    if (FLAG_trace_deopt) {
+      PrintF("Materializing a new heap number %p [%e] for object field #%d\n",
+             reinterpret_cast<void*>(*num),
+             d.value(),
+             d.destination());
+    }
+    object_values[d.destination()] = num;
+  }
+
+  // Materialize captured objects. All slots that refer to the same captured
+  // object share a single materialized instance.
+  List<Handle<JSObject> > objects(deferred_objects_.length());
+  int value_index = 0;
+  for (int i = 0; i < deferred_objects_.length(); i++) {
+    ObjectMaterializationDescriptor d = deferred_objects_[i];
+    Handle<JSObject> object;
+    for (int j = 0; j < i; j++) {
+      if (deferred_objects_[j].capture_id() == d.capture_id()) {
+        object = objects[j];
+        break;
+      }
+    }
+    if (!d.is_duplicate()) {
+      if (object.is_null()) {
+        Handle<Map> map = Handle<Map>::cast(object_values[value_index]);
+        ASSERT(map->inobject_properties() == d.object_length() - 1);
+        object = isolate_->factory()->NewJSObjectFromMap(map, NOT_TENURED,
+                                                         false);
+        for (int k = 1; k < d.object_length(); k++) {
+          object->InObjectPropertyAtPut(k - 1, *object_values[value_index + k]);
+        }
+      }
+      value_index += d.object_length();
+    }
+    ASSERT(!object.is_null());
+    objects.Add(object);
+    Memory::Object_at(d.slot_address()) = *object;
+    if (FLAG_trace_deopt) {
+      PrintF("Materializing captured object #%d in slot %p: ",
+             d.capture_id(),
+             reinterpret_cast<void*>(d.slot_address()));
+      object->ShortPrint();
+      PrintF("\n");
     }
-    Memory::Object_at(d.slot_address()) = *num;
   }
 
   // Materialize arguments objects one frame at a time.
@@ -723,11 +785,11 @@ void Deoptimizer::MaterializeHeapNumbersForDebuggerInspectableFrame(
   Address parameters_bottom = parameters_top + parameters_size;
   Address expressions_bottom = expressions_top + expressions_size;
   for (int i = 0; i < deferred_heap_numbers_.length(); i++) {
-    HeapNumberMaterializationDescriptor d = deferred_heap_numbers_[i];
+    HeapNumberMaterializationDescriptor<Address> d = deferred_heap_numbers_[i];
 
     // Check of the heap number to materialize actually belong to the frame
     // being extracted.
-    Address slot = d.slot_address();
+    Address slot = d.destination();
     if (parameters_top <= slot && slot < parameters_bottom) {
       Handle<Object> num = isolate_->factory()->NewNumber(d.value());
 
@@ -739,7 +801,7 @@ void Deoptimizer::MaterializeHeapNumbersForDebuggerInspectableFrame(
                "for parameter slot #%d\n",
                reinterpret_cast<void*>(*num),
                d.value(),
-               d.slot_address(),
+               d.destination(),
                index);
       }
 
@@ -755,7 +817,7 @@ void Deoptimizer::MaterializeHeapNumbersForDebuggerInspectableFrame(
                "for expression slot #%d\n",
                reinterpret_cast<void*>(*num),
                d.value(),
-               d.slot_address(),
+               d.destination(),
                index);
       }
 
@@ -1019,6 +1081,155 @@ void Deoptimizer::DoTranslateCommand(TranslationIterator* iterator,
       }
       return;
     }
+
+    case Translation::CAPTURED_OBJECT: {
+      int capture_id = iterator->Next();
+      int length = iterator->Next();
+      if (FLAG_trace_deopt) {
+        PrintF("    0x%08" V8PRIxPTR ": [top + %d] <- ",
+               output_[frame_index]->GetTop() + output_offset,
+               output_offset);
+        isolate_->heap()->arguments_marker()->ShortPrint();
+        PrintF(" ; captured object #%d\n", capture_id);
+      }
+      // Use the arguments marker value as a sentinel and materialize the
+      // captured object after the deoptimized frame is built.
+      intptr_t value = reinterpret_cast<intptr_t>(
+          isolate_->heap()->arguments_marker());
+      AddObject(output_[frame_index]->GetTop() + output_offset,
+                capture_id,
+                length);
+      output_[frame_index]->SetFrameSlot(output_offset, value);
+      for (int i = 0; i < length; i++) {
+        DoTranslateObjectField(iterator);
+      }
+      return;
+    }
+  }
+}
+
+
+void Deoptimizer::DoTranslateObjectField(TranslationIterator* iterator) {
+  // Ignore commands marked as duplicate and act on the first non-duplicate.
+  Translation::Opcode opcode =
+      static_cast<Translation::Opcode>(iterator->Next());
+  while (opcode == Translation::DUPLICATE) {
+    opcode = static_cast<Translation::Opcode>(iterator->Next());
+    iterator->Skip(Translation::NumberOfOperandsFor(opcode));
+    opcode = static_cast<Translation::Opcode>(iterator->Next());
+  }
+
+  // Compute either a tagged value or an untagged double that is boxed once
+  // it is safe to allocate.
+  intptr_t tagged_value = 0;
+  double double_value = 0;
+  bool is_double = false;
+  switch (opcode) {
+    case Translation::BEGIN:
+    case Translation::JS_FRAME:
+    case Translation::ARGUMENTS_ADAPTOR_FRAME:
+    case Translation::CONSTRUCT_STUB_FRAME:
+    case Translation::GETTER_STUB_FRAME:
+    case Translation::SETTER_STUB_FRAME:
+    case Translation::ARGUMENTS_OBJECT:
+    case Translation::CAPTURED_OBJECT:
+    case Translation::DUPLICATE:
+      UNREACHABLE();
+      return;
+
+    case Translation::REGISTER:
+      tagged_value = input_->GetRegister(iterator->Next());
+      break;
+
+    case Translation::INT32_REGISTER: {
+      intptr_t value = input_->GetRegister(iterator->Next());
+      if (Smi::IsValid(value)) {
+        tagged_value = reinterpret_cast<intptr_t>(
+            Smi::FromInt(static_cast<int>(value)));
+      } else {
+        double_value = static_cast<double>(static_cast<int32_t>(value));
+        is_double = true;
+      }
+      break;
+    }
+
+    case Translation::UINT32_REGISTER: {
+      uintptr_t value =
+          static_cast<uintptr_t>(input_->GetRegister(iterator->Next()));
+      if (value <= static_cast<uintptr_t>(Smi::kMaxValue)) {
+        tagged_value = reinterpret_cast<intptr_t>(
+            Smi::FromInt(static_cast<int>(value)));
+      } else {
+        double_value = static_cast<double>(static_cast<uint32_t>(value));
+        is_double = true;
+      }
+      break;
+    }
+
+    case Translation::DOUBLE_REGISTER:
+      double_value = input_->GetDoubleRegister(iterator->Next());
+      is_double = true;
+      break;
+
+    case Translation::STACK_SLOT: {
+      unsigned input_offset = input_->GetOffsetFromSlotIndex(iterator->Next());
+      tagged_value = input_->GetFrameSlot(input_offset);
+      break;
+    }
+
+    case Translation::INT32_STACK_SLOT: {
+      unsigned input_offset = input_->GetOffsetFromSlotIndex(iterator->Next());
+      intptr_t value = input_->GetFrameSlot(input_offset);
+      if (Smi::IsValid(value)) {
+        tagged_value = reinterpret_cast<intptr_t>(
+            Smi::FromInt(static_cast<int>(value)));
+      } else {
+        double_value = static_cast<double>(static_cast<int32_t>(value));
+        is_double = true;
+      }
+      break;
+    }
+
+    case Translation::UINT32_STACK_SLOT: {
+      unsigned input_offset = input_->GetOffsetFromSlotIndex(iterator->Next());
+      uintptr_t value =
+          static_cast<uintptr_t>(input_->GetFrameSlot(input_offset));
+      if (value <= static_cast<uintptr_t>(Smi::kMaxValue)) {
+        tagged_value = reinterpret_cast<intptr_t>(
+            Smi::FromInt(static_cast<int>(value)));
+      } else {
+        double_value = static_cast<double>(static_cast<uint32_t>(value));
+        is_double = true;
+      }
+      break;
+    }
+
+    case Translation::DOUBLE_STACK_SLOT: {
+      unsigned input_offset = input_->GetOffsetFromSlotIndex(iterator->Next());
+      double_value = input_->GetDoubleFrameSlot(input_offset);
+      is_double = true;
+      break;
+    }
+
+    case Translation::LITERAL:
+      tagged_value = reinterpret_cast<intptr_t>(
+          ComputeLiteral(iterator->Next()));
+      break;
+  }
+
+  if (FLAG_trace_deopt) {
+    PrintF("      field #%d <- ", deferred_objects_tagged_values_.length());
+    if (is_double) {
+      PrintF("%e", double_value);
+    } else {
+      reinterpret_cast<Object*>(tagged_value)->ShortPrint();
+    }
+    PrintF("\n");
+  }
+  if (is_double) {
+    AddObjectDoubleValue(double_value);
+  } else {
+    AddObjectTaggedValue(tagged_value);
   }
 }
 
@@ -1254,6 +1465,15 @@ bool Deoptimizer::DoOsrTranslateCommand(TranslationIterator* iterator,
       UNREACHABLE();
       return false;
     }
+
+    case Translation::CAPTURED_OBJECT: {
+      // The unoptimized frame holds the object itself, which cannot be
+      // split back into the field values the optimized code expects.
+      if (FLAG_trace_osr) {
+        PrintF("**** captured object cannot be entered by OSR ****\n");
+      }
+      return false;
+    }
   }
 
   if (!duplicate) *input_offset -= kPointerSize;
@@ -1371,12 +1591,50 @@ void Deoptimizer::AddArgumentsObjectValue(intptr_t value) {
 
 
 void Deoptimizer::AddDoubleValue(intptr_t slot_address, double value) {
-  HeapNumberMaterializationDescriptor value_desc(
+  HeapNumberMaterializationDescriptor<Address> value_desc(
       reinterpret_cast<Address>(slot_address), value);
   deferred_heap_numbers_.Add(value_desc);
 }
 
 
+void Deoptimizer::AddObject(intptr_t slot_address,
+                            int capture_id,
+                            int length) {
+  ObjectMaterializationDescriptor object_desc(
+      reinterpret_cast<Address>(slot_address), capture_id, length);
+  deferred_objects_.Add(object_desc);
+}
+
+
+void Deoptimizer::AddObjectDuplication(intptr_t slot_address,
+                                       intptr_t source_address) {
+  for (int i = 0; i < deferred_objects_.length(); i++) {
+    ObjectMaterializationDescriptor source = deferred_objects_[i];
+    if (source.slot_address() == reinterpret_cast<Address>(source_address)) {
+      ObjectMaterializationDescriptor object_desc(
+          reinterpret_cast<Address>(slot_address), source.capture_id(), -1);
+      deferred_objects_.Add(object_desc);
+      return;
+    }
+  }
+  UNREACHABLE();
+}
+
+
+void Deoptimizer::AddObjectTaggedValue(intptr_t value) {
+  deferred_objects_tagged_values_.Add(reinterpret_cast<Object*>(value));
+}
+
+
+void Deoptimizer::AddObjectDoubleValue(double value) {
+  // Store a GC-safe placeholder that is replaced by a heap number later.
+  deferred_objects_tagged_values_.Add(Smi::FromInt(0));
+  HeapNumberMaterializationDescriptor<int> value_desc(
+      deferred_objects_tagged_values_.length() - 1, value);
+  deferred_objects_double_values_.Add(value_desc);
+}
+
+
 MemoryChunk* Deoptimizer::CreateCode(BailoutType type) {
   // We cannot run this if the serializer is enabled because this will
   // cause us to emit relocation information for the external
@@ -1709,6 +1967,13 @@ void Translation::StoreArgumentsObject(int args_index, int args_length) {
 }
 
 
+void Translation::BeginCapturedObject(int capture_id, int length) {
+  buffer_->Add(CAPTURED_OBJECT, zone());
+  buffer_->Add(capture_id, zone());
+  buffer_->Add(length, zone());
+}
+
+
 void Translation::MarkDuplicate() {
   buffer_->Add(DUPLICATE, zone());
 }
@@ -1734,6 +1999,7 @@ int Translation::NumberOfOperandsFor(Opcode opcode) {
     case ARGUMENTS_ADAPTOR_FRAME:
     case CONSTRUCT_STUB_FRAME:
     case ARGUMENTS_OBJECT:
+    case CAPTURED_OBJECT:
       return 2;
     case JS_FRAME:
       return 3;
@@ -1743,6 +2009,21 @@ int Translation::NumberOfOperandsFor(Opcode opcode) {
 }
 
 
+void Translation::SkipValue(TranslationIterator* iterator) {
+  Opcode opcode = static_cast<Opcode>(iterator->Next());
+  if (opcode == DUPLICATE) {
+    SkipValue(iterator);
+    SkipValue(iterator);
+  } else if (opcode == CAPTURED_OBJECT) {
+    iterator->Next();  // Drop capture id.
+    int length = iterator->Next();
+    for (int i = 0; i < length; i++) SkipValue(iterator);
+  } else {
+    iterator->Skip(NumberOfOperandsFor(opcode));
+  }
+}
+
+
 #if defined(OBJECT_PRINT) || defined(ENABLE_DISASSEMBLER)
 
 const char* Translation::StringFor(Opcode opcode) {
@@ -1779,6 +2060,8 @@ const char* Translation::StringFor(Opcode opcode) {
       return "LITERAL";
     case ARGUMENTS_OBJECT:
       return "ARGUMENTS_OBJECT";
+    case CAPTURED_OBJECT:
+      return "CAPTURED_OBJECT";
     case DUPLICATE:
       return "DUPLICATE";
   }
@@ -1828,6 +2111,16 @@ SlotRef SlotRef::ComputeSlotForNextArgument(TranslationIterator* iterator,
       // This can be only emitted for local slots not for argument slots.
       break;
 
+    case Translation::CAPTURED_OBJECT: {
+      // The object is materialized on demand from the field values that
+      // follow in the translation.
+      int translation_index = iterator->index();
+      iterator->Next();  // Drop capture id.
+      int length = iterator->Next();
+      for (int i = 0; i < length; i++) Translation::SkipValue(iterator);
+      return SlotRef(frame, translation_index);
+    }
+
     case Translation::REGISTER:
     case Translation::INT32_REGISTER:
     case Translation::UINT32_REGISTER:
@@ -1880,8 +2173,7 @@ void SlotRef::ComputeSlotsForArguments(Vector<SlotRef>* args_slots,
   // Process the translation commands for the arguments.
 
   // Skip the translation command for the receiver.
-  it->Skip(Translation::NumberOfOperandsFor(
-      static_cast<Translation::Opcode>(it->Next())));
+  Translation::SkipValue(it);
 
   // Compute slots for arguments.
   for (int i = 0; i < args_slots->length(); ++i) {
@@ -1890,6 +2182,35 @@ void SlotRef::ComputeSlotsForArguments(Vector<SlotRef>* args_slots,
 }
 
 
+Handle<Object> SlotRef::MaterializeDeferredObject() {
+  // Compute the slots of all field values before allocating anything.
+  Vector<SlotRef> field_slots;
+  {
+    AssertNoAllocation no_gc;
+    int deopt_index = Safepoint::kNoDeoptimizationIndex;
+    DeoptimizationInputData* data = static_cast<OptimizedFrame*>(frame_)->
+        GetDeoptimizationData(&deopt_index);
+    TranslationIterator it(data->TranslationByteArray(), translation_index_);
+    it.Next();  // Drop capture id.
+    int length = it.Next();
+    field_slots = Vector<SlotRef>::New(length);
+    for (int i = 0; i < length; ++i) {
+      field_slots[i] = ComputeSlotForNextArgument(&it, data, frame_);
+    }
+  }
+
+  Handle<Map> map = Handle<Map>::cast(field_slots[0].GetValue());
+  Handle<JSObject> object = Isolate::Current()->factory()->NewJSObjectFromMap(
+      map, NOT_TENURED, false);
+  for (int i = 1; i < field_slots.length(); ++i) {
+    Handle<Object> value = field_slots[i].GetValue();
+    object->InObjectPropertyAtPut(i - 1, *value);
+  }
+  field_slots.Dispose();
+  return object;
+}
+
+
 Vector<SlotRef> SlotRef::ComputeSlotMappingForArguments(
     JavaScriptFrame* frame,
     int inlined_jsframe_index,
@@ -43,16 +43,17 @@ class TranslationIterator;
 class DeoptimizingCodeListNode;
 class DeoptimizedFrameInfo;
 
+template<typename T>
 class HeapNumberMaterializationDescriptor BASE_EMBEDDED {
  public:
-  HeapNumberMaterializationDescriptor(Address slot_address, double val)
-      : slot_address_(slot_address), val_(val) { }
+  HeapNumberMaterializationDescriptor(T destination, double val)
+      : destination_(destination), val_(val) { }
 
-  Address slot_address() const { return slot_address_; }
+  T destination() const { return destination_; }
   double value() const { return val_; }
 
  private:
-  Address slot_address_;
+  T destination_;
   double val_;
 };
 
@@ -71,6 +72,30 @@ class ArgumentsObjectMaterializationDescriptor BASE_EMBEDDED {
 };
 
 
+class ObjectMaterializationDescriptor BASE_EMBEDDED {
+ public:
+  ObjectMaterializationDescriptor(Address slot_address,
+                                  int capture_id,
+                                  int length)
+      : slot_address_(slot_address),
+        capture_id_(capture_id),
+        object_length_(length) { }
+
+  Address slot_address() const { return slot_address_; }
+  int capture_id() const { return capture_id_; }
+  int object_length() const { return object_length_; }
+
+  // A duplicate refers to an object that is already described by an earlier
+  // descriptor with the same capture id and has no values of its own.
+  bool is_duplicate() const { return object_length_ < 0; }
+
+ private:
+  Address slot_address_;
+  int capture_id_;
+  int object_length_;
+};
+
+
 class OptimizedFunctionVisitor BASE_EMBEDDED {
  public:
   virtual ~OptimizedFunctionVisitor() {}
@@ -308,6 +333,9 @@ class Deoptimizer : public Malloced {
   void DoTranslateCommand(TranslationIterator* iterator,
                           int frame_index,
                           unsigned output_offset);
+  // Translate a field value of a captured object. The value is saved on the
+  // side and the object is materialized after the output frames are built.
+  void DoTranslateObjectField(TranslationIterator* iterator);
   // Translate a command for OSR.  Updates the input offset to be used for
   // the next command.  Returns false if translation of the command failed
   // (e.g., a number conversion failed) and may or may not have updated the
@@ -326,6 +354,10 @@ class Deoptimizer : public Malloced {
   void AddArgumentsObject(intptr_t slot_address, int argc);
   void AddArgumentsObjectValue(intptr_t value);
   void AddDoubleValue(intptr_t slot_address, double value);
+  void AddObject(intptr_t slot_address, int capture_id, int length);
+  void AddObjectDuplication(intptr_t slot_address, intptr_t source_address);
+  void AddObjectTaggedValue(intptr_t value);
+  void AddObjectDoubleValue(double value);
 
   static MemoryChunk* CreateCode(BailoutType type);
   static void GenerateDeoptimizationEntries(
@@ -362,7 +394,11 @@ class Deoptimizer : public Malloced {
 
   List<Object*> deferred_arguments_objects_values_;
   List<ArgumentsObjectMaterializationDescriptor> deferred_arguments_objects_;
-  List<HeapNumberMaterializationDescriptor> deferred_heap_numbers_;
+  List<HeapNumberMaterializationDescriptor<Address> > deferred_heap_numbers_;
+  List<Object*> deferred_objects_tagged_values_;
+  List<HeapNumberMaterializationDescriptor<int> >
+      deferred_objects_double_values_;
+  List<ObjectMaterializationDescriptor> deferred_objects_;
 
   static const int table_entry_size_;
 
@@ -567,6 +603,7 @@ class TranslationIterator BASE_EMBEDDED {
   int32_t Next();
 
   bool HasNext() const { return index_ < buffer_->length(); }
+  int index() const { return index_; }
 
   void Skip(int n) {
     for (int i = 0; i < n; i++) Next();
@@ -597,6 +634,7 @@ class Translation BASE_EMBEDDED {
     DOUBLE_STACK_SLOT,
     LITERAL,
     ARGUMENTS_OBJECT,
+    CAPTURED_OBJECT,
 
     // A prefix indicating that the next command is a duplicate of the one
     // that follows it.
@@ -631,12 +669,17 @@ class Translation BASE_EMBEDDED {
   void StoreDoubleStackSlot(int index);
   void StoreLiteral(int literal_id);
   void StoreArgumentsObject(int args_index, int args_length);
+  void BeginCapturedObject(int capture_id, int length);
   void MarkDuplicate();
 
   Zone* zone() const { return zone_; }
 
   static int NumberOfOperandsFor(Opcode opcode);
 
+  // Skips the commands describing a single value, including the field values
+  // that follow a captured object.
+  static void SkipValue(TranslationIterator* iterator);
+
 #if defined(OBJECT_PRINT) || defined(ENABLE_DISASSEMBLER)
   static const char* StringFor(Opcode opcode);
 #endif
@@ -679,7 +722,8 @@ class SlotRef BASE_EMBEDDED {
     INT32,
     UINT32,
     DOUBLE,
-    LITERAL
+    LITERAL,
+    DEFERRED_OBJECT
   };
 
   SlotRef()
@@ -691,6 +735,14 @@ class SlotRef BASE_EMBEDDED {
   explicit SlotRef(Object* literal)
       : literal_(literal), representation_(LITERAL) { }
 
+  // A captured object that is materialized from the field values recorded
+  // in the translation starting at |translation_index|.
+  SlotRef(JavaScriptFrame* frame, int translation_index)
+      : addr_(NULL),
+        representation_(DEFERRED_OBJECT),
+        frame_(frame),
+        translation_index_(translation_index) { }
+
   Handle<Object> GetValue() {
     switch (representation_) {
       case TAGGED:
@@ -723,6 +775,9 @@ class SlotRef BASE_EMBEDDED {
       case LITERAL:
         return literal_;
 
+      case DEFERRED_OBJECT:
+        return MaterializeDeferredObject();
+
       default:
         UNREACHABLE();
         return Handle<Object>::null();
@@ -738,6 +793,10 @@ class SlotRef BASE_EMBEDDED {
   Address addr_;
   Handle<Object> literal_;
   SlotRepresentation representation_;
+  JavaScriptFrame* frame_;
+  int translation_index_;
+
+  Handle<Object> MaterializeDeferredObject();
 
   static Address SlotAddress(JavaScriptFrame* frame, int slot_index) {
     if (slot_index >= 0) {
@@ -267,7 +267,9 @@ class Factory {
 
   // JS objects are pretenured when allocated by the bootstrapper and
   // runtime.
-  Handle<JSObject> NewJSObjectFromMap(Handle<Map> map);
+  Handle<JSObject> NewJSObjectFromMap(Handle<Map> map,
+                                      PretenureFlag pretenure = NOT_TENURED,
+                                      bool alloc_props = true);
 
   // JS modules are pretenured.
   Handle<JSModule> NewJSModule(Handle<Context> context,
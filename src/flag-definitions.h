@@ -177,6 +177,9 @@ DEFINE_int(max_inlined_nodes, 196,
 DEFINE_int(max_inlined_nodes_cumulative, 196,
            "maximum cumulative number of AST nodes considered for inlining")
 DEFINE_bool(loop_invariant_code_motion, true, "loop invariant code motion")
+DEFINE_bool(loop_peeling, true, "peel the first iteration of small loops")
+DEFINE_int(max_peeled_loop_nodes, 40,
+           "maximum number of AST nodes considered for loop peeling")
 DEFINE_bool(collect_megamorphic_maps_from_stub_cache,
             true,
             "crankshaft harvests type feedback from stub cache")
@@ -185,9 +188,12 @@ DEFINE_bool(trace_hydrogen, false, "trace generated hydrogen to file")
 DEFINE_string(trace_phase, "Z", "trace generated IR for specified phases")
 DEFINE_bool(trace_inlining, false, "trace inlining decisions")
 DEFINE_bool(trace_alloc, false, "trace register allocator")
+DEFINE_bool(trace_alloc_stats, false,
+            "print register allocator statistics for each function")
 DEFINE_bool(trace_all_uses, false, "trace all use positions")
 DEFINE_bool(trace_range, false, "trace range analysis")
 DEFINE_bool(trace_gvn, false, "trace global value numbering")
+DEFINE_bool(trace_licm, false, "trace loop invariant code motion and peeling")
 DEFINE_bool(trace_representation, false, "trace representation types")
 DEFINE_bool(stress_pointer_maps, false, "pointer map for every instruction")
 DEFINE_bool(stress_environments, false, "environment for every instruction")
@@ -200,8 +206,23 @@ DEFINE_bool(polymorphic_inlining, true, "polymorphic inlining")
 DEFINE_bool(use_osr, true, "use on-stack replacement")
 DEFINE_bool(array_bounds_checks_elimination, true,
             "perform array bounds checks elimination")
+DEFINE_bool(array_bounds_checks_induction, true,
+            "eliminate and hoist array bounds checks on loop induction "
+            "variables")
+DEFINE_bool(trace_array_bounds_checks_induction, false,
+            "trace array bounds checks on loop induction variables")
 DEFINE_bool(array_index_dehoisting, true,
             "perform array index dehoisting")
+DEFINE_bool(use_escape_analysis, true,
+            "replace non-escaping allocations by their fields")
+DEFINE_bool(trace_escape_analysis, false, "trace escape analysis")
+DEFINE_bool(use_allocation_folding, true,
+            "fold adjacent inline allocations into a single allocation")
+DEFINE_bool(trace_allocation_folding, false, "trace allocation folding")
+DEFINE_bool(write_barrier_elimination, true,
+            "eliminate write barriers of stores into young objects")
+DEFINE_bool(trace_write_barrier_elimination, false,
+            "trace write barrier elimination")
 DEFINE_bool(dead_code_elimination, true, "use dead code elimination")
 DEFINE_bool(trace_dead_code_elimination, false, "trace dead code elimination")
 
@@ -229,6 +250,11 @@ DEFINE_bool(parallel_recompilation, false,
 DEFINE_bool(trace_parallel_recompilation, false, "track parallel recompilation")
 DEFINE_int(parallel_recompilation_queue_length, 2,
            "the length of the parallel compilation queue")
+DEFINE_int(parallel_recompilation_threads, 1,
+           "number of threads for parallel recompilation")
+DEFINE_bool(parallel_osr, true,
+            "compile code for on-stack replacement on the parallel "
+            "recompilation thread while the loop keeps running")
 
 // Experimental profiler changes.
 DEFINE_bool(experimental_profiler, true, "enable all profiler experiments")
@@ -396,6 +422,10 @@ DEFINE_bool(trace_incremental_marking, false,
             "trace progress of the incremental marking")
 DEFINE_bool(track_gc_object_stats, false,
             "track object counts and memory usage")
+DEFINE_bool(parallel_scavenge, false,
+            "Scavenge the new space on several threads")
+DEFINE_int(scavenger_threads, 1,
+           "number of threads helping the main thread with parallel scavenges")
 #ifdef VERIFY_HEAP
 DEFINE_bool(verify_heap, false, "verify heap pointers before and after GC")
 #endif
@@ -420,6 +450,14 @@ DEFINE_bool(native_code_counters, false,
 DEFINE_bool(always_compact, false, "Perform compaction on every full GC")
 DEFINE_bool(lazy_sweeping, true,
             "Use lazy sweeping for old pointer and data spaces")
+DEFINE_bool(concurrent_sweeping, false,
+            "Sweep old pointer and data spaces on background threads")
+DEFINE_int(sweeper_threads, 2,
+           "number of threads used for concurrent sweeping")
+DEFINE_bool(parallel_marking, false,
+            "Mark live objects of full GCs on several threads")
+DEFINE_int(marking_threads, 1,
+           "number of threads helping the main thread with parallel marking")
 DEFINE_bool(never_compact, false,
             "Never perform compaction on full GC - testing only")
 DEFINE_bool(compact_code_space, true,
@@ -433,6 +471,10 @@ DEFINE_int(random_seed, 0,
            "Default seed for initializing random generator "
            "(0, the default, means to use system random).")
 
+// json-parser.h
+DEFINE_bool(json_vector_scan, true,
+            "scan JSON strings in blocks of characters instead of one by one")
+
 // objects.cc
 DEFINE_bool(use_verbose_printer, true, "allows verbose printing")
 
@@ -468,8 +510,23 @@ DEFINE_int(hash_seed,
 DEFINE_bool(preemption, false,
             "activate a 100ms timer that switches between V8 threads")
 
+// zone.cc
+DEFINE_int(zone_segment_pool_size, 4096,
+           "maximum size of the zone segment pool of an isolate (in kBytes), "
+           "0 disables the pool")
+
 // Regexp
 DEFINE_bool(regexp_optimization, true, "generate optimized regexp code")
+DEFINE_bool(regexp_shared_cache, false,
+            "share regexp bytecode between isolates")
+DEFINE_int(regexp_shared_cache_size, 1024,
+           "maximum size of the shared regexp cache (in kBytes)")
+DEFINE_bool(regexp_tier_up, true,
+            "interpret regexps first and compile them to native code when hot")
+DEFINE_int(regexp_tier_up_ticks, 1,
+           "number of interpreted executions before a regexp is compiled to "
+           "native code")
+DEFINE_bool(trace_regexp_tier_up, false, "trace regexp tier-up to native code")
 
 // Testing flags test/cctest/test-{flags,api,serialization}.cc
 DEFINE_bool(testing_bool_flag, true, "testing_bool_flag")
@@ -486,8 +543,8 @@ DEFINE_string(testing_serialization_file, "/tmp/serdes",
 #endif
 
 // mksnapshot.cc
-DEFINE_string(extra_code, NULL, "A filename with extra code to be included in"
-                  " the snapshot (mksnapshot only)")
+DEFINE_string(extra_code, NULL, "A comma-separated list of files with extra "
+              "code to be run and included in the snapshot (mksnapshot only)")
 
 //
 // Dev shell flags
@@ -643,11 +700,26 @@ DEFINE_bool(prof_lazy, false,
             " when profiler is active (implies --noprof_auto).")
 DEFINE_bool(prof_browser_mode, true,
             "Used with --prof, turns on browser-compatible mode for profiling.")
+DEFINE_int(prof_sampling_interval, 0,
+           "Interval between stack samples of --prof and the CPU profiler "
+           "in microseconds, 0 for the platform default. Intervals below "
+           "a millisecond are only supported on Linux.")
 DEFINE_bool(log_regexp, false, "Log regular expression execution.")
 DEFINE_bool(sliding_state_window, false,
             "Update sliding state window counters.")
 DEFINE_string(logfile, "v8.log", "Specify the name of the log file.")
+DEFINE_bool(log_binary, false,
+            "Write the log in a compact binary format, buffered in memory "
+            "and written to the log file by a background thread.")
+DEFINE_int(log_buffer_size, 1024,
+           "Size of the in-memory buffer of --log-binary in KB.")
 DEFINE_bool(ll_prof, false, "Enable low-level linux profiler.")
+DEFINE_bool(perf_map, false,
+            "Write /tmp/perf-<pid>.map with symbols of generated code "
+            "for the Linux perf tool.")
+DEFINE_bool(perf_jitdump, false,
+            "Write jit-<pid>.dump with generated code and code moves in the "
+            "jitdump format of the Linux perf tool (see perf inject --jit).")
 DEFINE_string(gc_fake_mmap, "/tmp/__v8_gc__",
               "Specify the name of the file for fake gc mmap used in ll_prof")
 
@@ -91,6 +91,15 @@ namespace internal {
 #error Host architecture was not detected as supported by v8
 #endif
 
+// SSE2 is part of the x64 instruction set. On ia32 it is only used when the
+// compiler targets it, as nothing else is known about the host at compile
+// time.
+#if defined(V8_HOST_ARCH_X64) || \
+    (defined(V8_HOST_ARCH_IA32) && \
+     (defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#define V8_HOST_CAN_USE_SSE2 1
+#endif
+
 // Target architecture detection. This may be set externally. If not, detect
 // in the same way as the host architecture, that is, target the native
 // environment as presented by the compiler.
@@ -224,7 +224,11 @@ MaybeObject* Heap::AllocateRaw(int size_in_bytes,
     ASSERT(MAP_SPACE == space);
     result = map_space_->AllocateRaw(size_in_bytes);
   }
-  if (result->IsFailure()) old_gen_exhausted_ = true;
+  if (result->IsFailure()) {
+    old_gen_exhausted_ = true;
+  } else if (is_sampling_allocations()) {
+    SampleAllocation(result, size_in_bytes, size_in_bytes);
+  }
   return result;
 }
 
@@ -35,11 +35,13 @@ namespace internal {
 
 HeapProfiler::HeapProfiler()
     : snapshots_(new HeapSnapshotsCollection()),
-      next_snapshot_uid_(1) {
+      next_snapshot_uid_(1),
+      allocation_sampler_(NULL) {
 }
 
 
 HeapProfiler::~HeapProfiler() {
+  StopAllocationSamplingImpl();
   delete snapshots_;
 }
 
@@ -85,6 +87,16 @@ HeapSnapshot* HeapProfiler::TakeSnapshot(String* name,
 }
 
 
+bool HeapProfiler::StreamSnapshot(String* name,
+                                  v8::OutputStream* stream,
+                                  v8::ActivityControl* control) {
+  ASSERT(Isolate::Current()->heap_profiler() != NULL);
+  HeapProfiler* profiler = Isolate::Current()->heap_profiler();
+  return profiler->StreamSnapshotImpl(
+      profiler->snapshots_->names()->GetName(name), stream, control);
+}
+
+
 void HeapProfiler::StartHeapObjectsTracking() {
   ASSERT(Isolate::Current()->heap_profiler() != NULL);
   Isolate::Current()->heap_profiler()->StartHeapObjectsTrackingImpl();
@@ -103,6 +115,27 @@ SnapshotObjectId HeapProfiler::PushHeapObjectsStats(v8::OutputStream* stream) {
 }
 
 
+void HeapProfiler::StartAllocationSampling(int sample_interval) {
+  ASSERT(Isolate::Current()->heap_profiler() != NULL);
+  Isolate::Current()->heap_profiler()->StartAllocationSamplingImpl(
+      sample_interval);
+}
+
+
+AllocationSiteNode* HeapProfiler::GetAllocationProfile() {
+  HeapProfiler* profiler = Isolate::Current()->heap_profiler();
+  ASSERT(profiler != NULL);
+  if (profiler->allocation_sampler_ == NULL) return NULL;
+  return profiler->allocation_sampler_->root();
+}
+
+
+void HeapProfiler::StopAllocationSampling() {
+  ASSERT(Isolate::Current()->heap_profiler() != NULL);
+  Isolate::Current()->heap_profiler()->StopAllocationSamplingImpl();
+}
+
+
 void HeapProfiler::DefineWrapperClass(
     uint16_t class_id, v8::HeapProfiler::WrapperInfoCallback callback) {
   ASSERT(class_id != v8::HeapProfiler::kPersistentHandleNoClassId);
@@ -153,6 +186,19 @@ HeapSnapshot* HeapProfiler::TakeSnapshotImpl(String* name,
   return TakeSnapshotImpl(snapshots_->names()->GetName(name), type, control);
 }
 
+
+bool HeapProfiler::StreamSnapshotImpl(const char* name,
+                                      v8::OutputStream* stream,
+                                      v8::ActivityControl* control) {
+  // Keep the ids of streamed nodes stable across snapshots.
+  snapshots_->StartHeapObjectsTracking();
+  HeapSnapshotStreamer streamer(snapshots_, name, next_snapshot_uid_++,
+                                control);
+  bool streaming_completed = streamer.Stream(stream);
+  snapshots_->SnapshotGenerationFinished(NULL);
+  return streaming_completed;
+}
+
 void HeapProfiler::StartHeapObjectsTrackingImpl() {
   snapshots_->StartHeapObjectsTracking();
 }
@@ -168,10 +214,38 @@ void HeapProfiler::StopHeapObjectsTrackingImpl() {
 }
 
 
+void HeapProfiler::StartAllocationSamplingImpl(int sample_interval) {
+  ASSERT(sample_interval > 0);
+  StopAllocationSamplingImpl();
+  Heap* heap = Isolate::Current()->heap();
+  allocation_sampler_ = new AllocationSampler(heap, sample_interval);
+  heap->SetAllocationSamplingStep(sample_interval);
+}
+
+
+void HeapProfiler::StopAllocationSamplingImpl() {
+  if (allocation_sampler_ == NULL) return;
+  Isolate::Current()->heap()->SetAllocationSamplingStep(0);
+  delete allocation_sampler_;
+  allocation_sampler_ = NULL;
+}
+
+
+void HeapProfiler::SampleAllocation(HeapObject* object,
+                                    int object_size,
+                                    intptr_t bytes_allocated) {
+  ASSERT(allocation_sampler_ != NULL);
+  allocation_sampler_->SampleAllocation(object, object_size, bytes_allocated);
+}
+
+
 size_t HeapProfiler::GetMemorySizeUsedByProfiler() {
   HeapProfiler* profiler = Isolate::Current()->heap_profiler();
   ASSERT(profiler != NULL);
   size_t size = profiler->snapshots_->GetUsedMemorySize();
+  if (profiler->allocation_sampler_ != NULL) {
+    size += profiler->allocation_sampler_->GetUsedMemorySize();
+  }
   return size;
 }
 
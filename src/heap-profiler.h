@@ -33,6 +33,8 @@
 namespace v8 {
 namespace internal {
 
+class AllocationSampler;
+class AllocationSiteNode;
 class HeapSnapshot;
 class HeapSnapshotsCollection;
 
@@ -57,6 +59,9 @@ class HeapProfiler {
   static HeapSnapshot* TakeSnapshot(String* name,
                                     int type,
                                     v8::ActivityControl* control);
+  static bool StreamSnapshot(String* name,
+                             v8::OutputStream* stream,
+                             v8::ActivityControl* control);
 
   static void StartHeapObjectsTracking();
   static void StopHeapObjectsTracking();
@@ -67,8 +72,16 @@ class HeapProfiler {
   static SnapshotObjectId GetSnapshotObjectId(Handle<Object> obj);
   static void DeleteAllSnapshots();
 
+  static void StartAllocationSampling(int sample_interval);
+  static AllocationSiteNode* GetAllocationProfile();
+  static void StopAllocationSampling();
+
   void ObjectMoveEvent(Address from, Address to);
 
+  void SampleAllocation(HeapObject* object,
+                        int object_size,
+                        intptr_t bytes_allocated);
+
   void DefineWrapperClass(
       uint16_t class_id, v8::HeapProfiler::WrapperInfoCallback callback);
 
@@ -87,14 +100,21 @@ class HeapProfiler {
   HeapSnapshot* TakeSnapshotImpl(String* name,
                                  int type,
                                  v8::ActivityControl* control);
+  bool StreamSnapshotImpl(const char* name,
+                          v8::OutputStream* stream,
+                          v8::ActivityControl* control);
   void ResetSnapshots();
 
   void StartHeapObjectsTrackingImpl();
   void StopHeapObjectsTrackingImpl();
   SnapshotObjectId PushHeapObjectsStatsImpl(OutputStream* stream);
 
+  void StartAllocationSamplingImpl(int sample_interval);
+  void StopAllocationSamplingImpl();
+
   HeapSnapshotsCollection* snapshots_;
   unsigned next_snapshot_uid_;
+  AllocationSampler* allocation_sampler_;
   List<v8::HeapProfiler::WrapperInfoCallback> wrapper_callbacks_;
 };
 
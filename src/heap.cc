@@ -44,6 +44,7 @@
 #include "objects-visiting-inl.h"
 #include "once.h"
 #include "runtime-profiler.h"
+#include "scavenger-thread.h"
 #include "scopeinfo.h"
 #include "snapshot.h"
 #include "store-buffer.h"
@@ -159,7 +160,12 @@ Heap::Heap()
       promotion_queue_(this),
       configured_(false),
       chunks_queued_for_free_(NULL),
-      relocation_mutex_(NULL) {
+      relocation_mutex_(NULL),
+      relocation_semaphore_(NULL),
+      relocation_sharers_(0),
+      parallel_scavenge_tasks_(NULL),
+      parallel_scavenge_mutex_(NULL),
+      idle_scavenge_tasks_(0) {
   // Allow build-time customization of the max semispace size. Building
   // V8 with snapshots and a non-default max semispace size is much
   // easier if you can define it as part of the build environment.
@@ -1056,6 +1062,41 @@ class ScavengeVisitor: public ObjectVisitor {
 };
 
 
+// Set on the main thread and on the scavenger threads while a parallel
+// scavenge is in progress.
+static Thread::LocalStorageKey parallel_scavenge_task_key;
+
+
+static inline ParallelScavengeTask* CurrentParallelScavengeTask() {
+  return reinterpret_cast<ParallelScavengeTask*>(
+      Thread::GetThreadLocal(parallel_scavenge_task_key));
+}
+
+
+// Visits the roots of a parallel scavenge on the main thread.
+class ParallelScavengeVisitor: public ObjectVisitor {
+ public:
+  explicit ParallelScavengeVisitor(Heap* heap) : heap_(heap) {}
+
+  void VisitPointer(Object** p) { ScavengePointer(p); }
+
+  void VisitPointers(Object** start, Object** end) {
+    for (Object** p = start; p < end; p++) ScavengePointer(p);
+  }
+
+ private:
+  void ScavengePointer(Object** p) {
+    Object* object = *p;
+    if (!heap_->InFromSpace(object)) return;
+    CurrentParallelScavengeTask()->ScavengeObject(
+        reinterpret_cast<HeapObject**>(p),
+        reinterpret_cast<HeapObject*>(object));
+  }
+
+  Heap* heap_;
+};
+
+
 #ifdef VERIFY_HEAP
 // Visitor class to verify pointers in code or data space do not point into
 // new space.
@@ -1282,15 +1323,33 @@ void Heap::Scavenge() {
 #endif
 
   ScavengeVisitor scavenge_visitor(this);
+  ParallelScavengeVisitor parallel_scavenge_visitor(this);
+  ObjectVisitor* root_visitor = &scavenge_visitor;
+  ObjectSlotCallback slot_callback = &ScavengeObject;
+  bool in_parallel = AreScavengerThreadsActivated();
+  if (in_parallel) {
+    int task_count = FLAG_scavenger_threads + 1;
+    if (parallel_scavenge_tasks_ == NULL) {
+      parallel_scavenge_tasks_ = new ParallelScavengeTask[task_count];
+    }
+    for (int i = 0; i < task_count; i++) {
+      parallel_scavenge_tasks_[i].Initialize(this);
+    }
+    Thread::SetThreadLocal(parallel_scavenge_task_key,
+                           &parallel_scavenge_tasks_[0]);
+    root_visitor = &parallel_scavenge_visitor;
+    slot_callback = &ScavengeObjectInParallel;
+  }
+
   // Copy roots.
-  IterateRoots(&scavenge_visitor, VISIT_ALL_IN_SCAVENGE);
+  IterateRoots(root_visitor, VISIT_ALL_IN_SCAVENGE);
 
   // Copy objects reachable from the old generation.
   {
     StoreBufferRebuildScope scope(this,
                                   store_buffer(),
                                   &ScavengeStoreBufferCallback);
-    store_buffer()->IteratePointersToNewSpace(&ScavengeObject);
+    store_buffer()->IteratePointersToNewSpace(slot_callback);
   }
 
   // Copy objects reachable from cells by scavenging cell values directly.
@@ -1301,19 +1360,28 @@ void Heap::Scavenge() {
     if (heap_object->IsJSGlobalPropertyCell()) {
       JSGlobalPropertyCell* cell = JSGlobalPropertyCell::cast(heap_object);
       Address value_address = cell->ValueAddress();
-      scavenge_visitor.VisitPointer(reinterpret_cast<Object**>(value_address));
+      root_visitor->VisitPointer(reinterpret_cast<Object**>(value_address));
     }
   }
 
   // Scavenge object reachable from the native contexts list directly.
-  scavenge_visitor.VisitPointer(BitCast<Object**>(&native_contexts_list_));
+  root_visitor->VisitPointer(BitCast<Object**>(&native_contexts_list_));
 
-  new_space_front = DoScavenge(&scavenge_visitor, new_space_front);
+  if (in_parallel) {
+    new_space_front = DoParallelScavenge();
+  } else {
+    new_space_front = DoScavenge(&scavenge_visitor, new_space_front);
+  }
   isolate_->global_handles()->IdentifyNewSpaceWeakIndependentHandles(
       &IsUnscavengedHeapObject);
   isolate_->global_handles()->IterateNewSpaceWeakIndependentRoots(
-      &scavenge_visitor);
-  new_space_front = DoScavenge(&scavenge_visitor, new_space_front);
+      root_visitor);
+  if (in_parallel) {
+    new_space_front = DoParallelScavenge();
+    Thread::SetThreadLocal(parallel_scavenge_task_key, NULL);
+  } else {
+    new_space_front = DoScavenge(&scavenge_visitor, new_space_front);
+  }
 
   UpdateNewSpaceReferencesInExternalStringTable(
       &UpdateNewSpaceReferenceInExternalStringTableEntry);
@@ -2058,6 +2126,301 @@ void Heap::ScavengeObjectSlow(HeapObject** p, HeapObject* object) {
 }
 
 
+// Scavenges the fields of an object copied during a parallel scavenge.
+// Slots of promoted objects that still point to new space are recorded.
+class ParallelNewSpaceScavenger
+    : public StaticNewSpaceVisitor<ParallelNewSpaceScavenger> {
+ public:
+  static inline void VisitPointer(Heap* heap, Object** p) {
+    Object* object = *p;
+    if (!heap->InFromSpace(object)) return;
+    ParallelScavengeTask* task = CurrentParallelScavengeTask();
+    task->ScavengeObject(reinterpret_cast<HeapObject**>(p),
+                         reinterpret_cast<HeapObject*>(object));
+    if (heap->InNewSpace(*p) &&
+        !heap->InNewSpace(reinterpret_cast<Address>(p))) {
+      task->RecordSlot(p);
+    }
+  }
+};
+
+
+void ParallelScavengeTask::Initialize(Heap* heap) {
+  heap_ = heap;
+  deque_.Initialize(kDequeCapacity);
+  ASSERT(overflow_.is_empty());
+  to_space_buffer_.Reset(NULL, NULL);
+  old_pointer_buffer_.Reset(NULL, NULL);
+  old_data_buffer_.Reset(NULL, NULL);
+  promoted_objects_size_ = 0;
+}
+
+
+void ParallelScavengeTask::Push(HeapObject* object) {
+  if (!deque_.Push(object)) overflow_.Add(object);
+}
+
+
+bool ParallelScavengeTask::Pop(HeapObject** object) {
+  while (!deque_.Pop(object)) {
+    if (overflow_.is_empty()) return false;
+    // Move overflowed objects back to the deque where other tasks can
+    // steal them.
+    while (!overflow_.is_empty() && deque_.Push(overflow_.last())) {
+      overflow_.RemoveLast();
+    }
+  }
+  return true;
+}
+
+
+HeapObject* ParallelScavengeTask::AllocateInToSpace(int size_in_bytes) {
+  HeapObject* object = to_space_buffer_.Allocate(size_in_bytes);
+  if (object != NULL) return object;
+
+  ScopedLock lock(heap_->parallel_scavenge_mutex_);
+  NewSpace* new_space = heap_->new_space();
+  Object* result;
+  if (size_in_bytes <= kMaxBufferedObjectSize &&
+      new_space->AllocateRaw(kBufferSize)->ToObject(&result)) {
+    heap_->CreateFillerObjectAt(to_space_buffer_.top(),
+                                to_space_buffer_.Available());
+    Address start = HeapObject::cast(result)->address();
+    to_space_buffer_.Reset(start, start + kBufferSize);
+    return to_space_buffer_.Allocate(size_in_bytes);
+  }
+  if (!new_space->AllocateRaw(size_in_bytes)->ToObject(&result)) return NULL;
+  return HeapObject::cast(result);
+}
+
+
+HeapObject* ParallelScavengeTask::AllocateInOldSpace(AllocationSpace space,
+                                                     int size_in_bytes) {
+  ScavengeAllocationBuffer* buffer = old_space_buffer(space);
+  HeapObject* object = buffer->Allocate(size_in_bytes);
+  if (object != NULL) return object;
+
+  ScopedLock lock(heap_->parallel_scavenge_mutex_);
+  PagedSpace* old_space = heap_->paged_space(space);
+  Object* result;
+  if (size_in_bytes <= kMaxBufferedObjectSize &&
+      old_space->AllocateRaw(kBufferSize)->ToObject(&result)) {
+    RetireOldSpaceBuffer(space);
+    Address start = HeapObject::cast(result)->address();
+    buffer->Reset(start, start + kBufferSize);
+    object = buffer->Allocate(size_in_bytes);
+  } else if (old_space->AllocateRaw(size_in_bytes)->ToObject(&result)) {
+    object = HeapObject::cast(result);
+  }
+  return object;
+}
+
+
+void ParallelScavengeTask::FreeAllocation(HeapObject* object,
+                                          int size_in_bytes) {
+  if (heap_->InNewSpace(object)) {
+    if (!to_space_buffer_.Undo(object, size_in_bytes)) {
+      heap_->CreateFillerObjectAt(object->address(), size_in_bytes);
+    }
+    return;
+  }
+  AllocationSpace space = heap_->old_data_space()->Contains(object) ?
+      OLD_DATA_SPACE : OLD_POINTER_SPACE;
+  if (!old_space_buffer(space)->Undo(object, size_in_bytes)) {
+    ScopedLock lock(heap_->parallel_scavenge_mutex_);
+    heap_->paged_space(space)->Free(object->address(), size_in_bytes);
+  }
+}
+
+
+void ParallelScavengeTask::RetireOldSpaceBuffer(AllocationSpace space) {
+  ScavengeAllocationBuffer* buffer = old_space_buffer(space);
+  if (buffer->Available() > 0) {
+    heap_->paged_space(space)->Free(buffer->top(), buffer->Available());
+  }
+  buffer->Reset(NULL, NULL);
+}
+
+
+void ParallelScavengeTask::ScavengeObject(HeapObject** slot,
+                                          HeapObject* object) {
+  ASSERT(heap_->InFromSpace(object));
+  MapWord first_word = object->synchronized_map_word();
+  if (first_word.IsForwardingAddress()) {
+    *slot = first_word.ToForwardingAddress();
+    return;
+  }
+
+  Map* map = first_word.ToMap();
+  int object_size = object->SizeFromMap(map);
+  InstanceType type = map->instance_type();
+  AllocationSpace target_space = heap_->TargetSpaceId(type);
+  int allocation_size = object_size;
+  bool double_align =
+      kDoubleAlignment != kObjectAlignment && type == FIXED_DOUBLE_ARRAY_TYPE;
+  if (double_align) allocation_size += kPointerSize;
+
+  HeapObject* allocation = NULL;
+  if (heap_->ShouldBePromoted(object->address(), object_size)) {
+    allocation = AllocateInOldSpace(target_space, allocation_size);
+  }
+  if (allocation == NULL) allocation = AllocateInToSpace(allocation_size);
+  if (allocation == NULL) {
+    // The buffers wasted too much of to space, so the object has to be
+    // promoted even if the old generation is over its limit.
+    ScopedLock lock(heap_->parallel_scavenge_mutex_);
+    heap_->always_allocate_scope_depth_++;
+    Object* result = NULL;
+    if (!heap_->paged_space(target_space)->AllocateRaw(allocation_size)->
+        ToObject(&result)) {
+      V8::FatalProcessOutOfMemory("ParallelScavengeTask::ScavengeObject");
+    }
+    heap_->always_allocate_scope_depth_--;
+    allocation = HeapObject::cast(result);
+  }
+  HeapObject* target = allocation;
+  if (double_align) {
+    target = EnsureDoubleAligned(heap_, target, allocation_size);
+  }
+
+  // Order is important: slot might be inside of the target if target
+  // was allocated over a dead object and slot comes from the store
+  // buffer.  Store buffer slots are only visited before the scavenger
+  // threads start, so there is no race to lose in that case.
+  *slot = target;
+  heap_->CopyBlock(target->address(), object->address(), object_size);
+  MapWord previous = object->CompareAndSwapMapWord(
+      first_word, MapWord::FromForwardingAddress(target));
+  bool promoted = !heap_->InNewSpace(target);
+
+  if (previous.ToRawValue() != first_word.ToRawValue()) {
+    // Another task copied the object first.
+    FreeAllocation(allocation, allocation_size);
+    *slot = previous.ToForwardingAddress();
+  } else {
+    if (promoted) promoted_objects_size_ += object_size;
+    if (target_space == OLD_POINTER_SPACE) Push(target);
+  }
+
+  if (promoted) {
+    // Keep the old space iterable; the store buffer may scan the pages
+    // for pointers to new space.
+    ScavengeAllocationBuffer* buffer = old_space_buffer(target_space);
+    heap_->CreateFillerObjectAt(buffer->top(), buffer->Available());
+  }
+}
+
+
+void ParallelScavengeTask::Finish() {
+  ASSERT(deque_.IsEmpty() && overflow_.is_empty());
+  heap_->CreateFillerObjectAt(to_space_buffer_.top(),
+                              to_space_buffer_.Available());
+  to_space_buffer_.Reset(NULL, NULL);
+  RetireOldSpaceBuffer(OLD_POINTER_SPACE);
+  RetireOldSpaceBuffer(OLD_DATA_SPACE);
+
+  StoreBuffer* store_buffer = heap_->store_buffer();
+  for (int i = 0; i < promoted_slots_.length(); i++) {
+    store_buffer->EnterDirectlyIntoStoreBuffer(promoted_slots_[i]);
+  }
+  promoted_slots_.Clear();
+
+  heap_->tracer()->increment_promoted_objects_size(promoted_objects_size_);
+  promoted_objects_size_ = 0;
+}
+
+
+void Heap::ScavengeObjectInParallel(HeapObject** p, HeapObject* object) {
+  CurrentParallelScavengeTask()->ScavengeObject(p, object);
+}
+
+
+bool Heap::AreScavengerThreadsActivated() {
+  // Mark transfer and the logging and profiling hooks of the sequential
+  // scavenger are not thread-safe.
+  return isolate()->scavenger_threads() != NULL &&
+      !incremental_marking()->IsMarking() &&
+      !isolate()->logger()->is_logging() &&
+      !CpuProfiler::is_profiling(isolate()) &&
+      (isolate()->heap_profiler() == NULL ||
+       !isolate()->heap_profiler()->is_profiling());
+}
+
+
+Address Heap::DoParallelScavenge() {
+  int task_count = FLAG_scavenger_threads + 1;
+
+  // The objects copied so far all sit on the main thread's task.  The
+  // scavenger threads are idle, so the main thread may push to all tasks.
+  List<HeapObject*> copied_objects;
+  HeapObject* object;
+  while (parallel_scavenge_tasks_[0].Pop(&object)) copied_objects.Add(object);
+  for (int i = 0; i < copied_objects.length(); i++) {
+    parallel_scavenge_tasks_[i % task_count].Push(copied_objects[i]);
+  }
+
+  NoBarrier_Store(&idle_scavenge_tasks_, 0);
+  ScavengerThread** threads = isolate()->scavenger_threads();
+  for (int i = 0; i < FLAG_scavenger_threads; i++) {
+    threads[i]->StartScavenging();
+  }
+  ScavengeInParallel(0);
+  for (int i = 0; i < FLAG_scavenger_threads; i++) {
+    threads[i]->WaitForScavengerThread();
+  }
+
+  StoreBufferRebuildScope scope(this,
+                                store_buffer(),
+                                &ScavengeStoreBufferCallback);
+  for (int i = 0; i < task_count; i++) {
+    parallel_scavenge_tasks_[i].Finish();
+  }
+  return new_space_.top();
+}
+
+
+void Heap::ScavengeInParallel(int index) {
+  ParallelScavengeTask* task = &parallel_scavenge_tasks_[index];
+  Thread::SetThreadLocal(parallel_scavenge_task_key, task);
+  while (true) {
+    HeapObject* object;
+    if (!task->Pop(&object) && !StealScavengeWork(index, &object)) {
+      if (OfferScavengeTermination()) break;
+      continue;
+    }
+    ParallelNewSpaceScavenger::IterateBody(object->map(), object);
+  }
+}
+
+
+bool Heap::StealScavengeWork(int index, HeapObject** object) {
+  int task_count = FLAG_scavenger_threads + 1;
+  for (int i = 1; i < task_count; i++) {
+    int victim = (index + i) % task_count;
+    if (parallel_scavenge_tasks_[victim].Steal(object)) return true;
+  }
+  return false;
+}
+
+
+bool Heap::OfferScavengeTermination() {
+  // A task only goes idle once its own work is done, and only busy tasks
+  // push, so no work can appear once every task is idle.
+  int task_count = FLAG_scavenger_threads + 1;
+  NoBarrier_AtomicIncrement(&idle_scavenge_tasks_, 1);
+  while (true) {
+    if (Acquire_Load(&idle_scavenge_tasks_) == task_count) return true;
+    for (int i = 0; i < task_count; i++) {
+      if (!parallel_scavenge_tasks_[i].IsEmpty()) {
+        NoBarrier_AtomicIncrement(&idle_scavenge_tasks_, -1);
+        return false;
+      }
+    }
+    Thread::YieldCPU();
+  }
+}
+
+
 MaybeObject* Heap::AllocatePartialMap(InstanceType instance_type,
                                       int instance_size) {
   Object* result;
@@ -3569,6 +3932,34 @@ void Heap::CreateFillerObjectAt(Address addr, int size) {
 }
 
 
+void Heap::SetAllocationSamplingStep(intptr_t step) {
+  new_space_.SetAllocationSamplingStep(step);
+}
+
+
+void Heap::SampleAllocation(MaybeObject* result,
+                            int object_size,
+                            intptr_t bytes_allocated) {
+  // Objects copied by the garbage collector are not new allocations.
+  if (gc_state_ != NOT_IN_GC) return;
+  HeapObject* object;
+  if (!result->To(&object)) return;
+  isolate_->heap_profiler()->SampleAllocation(
+      object, object_size, bytes_allocated);
+}
+
+
+bool Heap::CanMoveObjectStart(HeapObject* object) {
+  // In large object space the object's start must coincide with the chunk.
+  if (lo_space()->Contains(object)) return false;
+  if (InNewSpace(object)) return true;
+  // A sweeper thread sweeping the page relies on the mark bit and the size
+  // of the object at its original start.
+  return Page::FromAddress(object->address())->parallel_sweeping() ==
+      MemoryChunk::kParallelSweepingDone;
+}
+
+
 MaybeObject* Heap::AllocateExternalArray(int length,
                                          ExternalArrayType array_type,
                                          void* external_pointer,
@@ -3999,7 +4390,9 @@ void Heap::InitializeJSObjectFromMap(JSObject* obj,
 }
 
 
-MaybeObject* Heap::AllocateJSObjectFromMap(Map* map, PretenureFlag pretenure) {
+MaybeObject* Heap::AllocateJSObjectFromMap(Map* map,
+                                           PretenureFlag pretenure,
+                                           bool alloc_props) {
   // JSFunctions should be allocated using AllocateFunction to be
   // properly initialized.
   ASSERT(map->instance_type() != JS_FUNCTION_TYPE);
@@ -4010,13 +4403,14 @@ MaybeObject* Heap::AllocateJSObjectFromMap(Map* map, PretenureFlag pretenure) {
   ASSERT(map->instance_type() != JS_BUILTINS_OBJECT_TYPE);
 
   // Allocate the backing storage for the properties.
-  int prop_size =
-      map->pre_allocated_property_fields() +
-      map->unused_property_fields() -
-      map->inobject_properties();
-  ASSERT(prop_size >= 0);
-  Object* properties;
-  { MaybeObject* maybe_properties = AllocateFixedArray(prop_size, pretenure);
+  Object* properties = empty_fixed_array();
+  if (alloc_props) {
+    int prop_size =
+        map->pre_allocated_property_fields() +
+        map->unused_property_fields() -
+        map->inobject_properties();
+    ASSERT(prop_size >= 0);
+    MaybeObject* maybe_properties = AllocateFixedArray(prop_size, pretenure);
     if (!maybe_properties->ToObject(&properties)) return maybe_properties;
   }
 
@@ -6133,6 +6527,8 @@ V8_DECLARE_ONCE(initialize_gc_once);
 static void InitializeGCOnce() {
   InitializeScavengingVisitorsTables();
   NewSpaceScavenger::Initialize();
+  ParallelNewSpaceScavenger::Initialize();
+  parallel_scavenge_task_key = Thread::CreateThreadLocalKey();
   MarkCompactCollector::Initialize();
 }
 
@@ -6244,7 +6640,11 @@ bool Heap::SetUp(bool create_heap_objects) {
 
   store_buffer()->SetUp();
 
-  if (FLAG_parallel_recompilation) relocation_mutex_ = OS::CreateMutex();
+  if (FLAG_parallel_recompilation) {
+    relocation_mutex_ = OS::CreateMutex();
+    relocation_semaphore_ = OS::CreateSemaphore(1);
+  }
+  if (FLAG_parallel_scavenge) parallel_scavenge_mutex_ = OS::CreateMutex();
 
   return true;
 }
@@ -6334,6 +6734,10 @@ void Heap::TearDown() {
   isolate_->memory_allocator()->TearDown();
 
   delete relocation_mutex_;
+  delete relocation_semaphore_;
+  delete parallel_scavenge_mutex_;
+  delete[] parallel_scavenge_tasks_;
+  parallel_scavenge_tasks_ = NULL;
 
 #ifdef DEBUG
   delete debug_utils_;
@@ -6343,6 +6747,11 @@ void Heap::TearDown() {
 
 
 void Heap::Shrink() {
+  // Pages may only be released once the sweeper threads are done with them.
+  if (mark_compact_collector()->IsConcurrentSweepingInProgress()) {
+    mark_compact_collector()->WaitUntilSweepingCompleted();
+  }
+
   // Try to shrink all paged spaces.
   PagedSpaces spaces;
   for (PagedSpace* space = spaces.next();
@@ -388,6 +388,105 @@ class PromotionQueue {
 };
 
 
+// A linear allocation buffer owned by one parallel scavenge task.  Objects
+// are bump-allocated from it without synchronization.
+class ScavengeAllocationBuffer {
+ public:
+  ScavengeAllocationBuffer() : top_(NULL), limit_(NULL) { }
+
+  void Reset(Address top, Address limit) {
+    top_ = top;
+    limit_ = limit;
+  }
+
+  Address top() { return top_; }
+  int Available() { return static_cast<int>(limit_ - top_); }
+
+  // Returns NULL if the buffer is too small.
+  inline HeapObject* Allocate(int size_in_bytes) {
+    if (limit_ - top_ < size_in_bytes) return NULL;
+    HeapObject* object = HeapObject::FromAddress(top_);
+    top_ += size_in_bytes;
+    return object;
+  }
+
+  // Gives back the most recent allocation.  Returns false if the object
+  // was not allocated from this buffer.
+  inline bool Undo(HeapObject* object, int size_in_bytes) {
+    if (object->address() + size_in_bytes != top_) return false;
+    top_ = object->address();
+    return true;
+  }
+
+ private:
+  Address top_;
+  Address limit_;
+};
+
+
+// The state of one thread during a parallel scavenge.  Every task copies
+// objects into its own to-space and promotion buffers and keeps the copies
+// whose fields still have to be scavenged on a work-stealing deque, from
+// which idle tasks steal.
+class ParallelScavengeTask {
+ public:
+  ParallelScavengeTask() : heap_(NULL), promoted_objects_size_(0) { }
+
+  void Initialize(Heap* heap);
+
+  // Copies the from-space object unless another task already did and
+  // updates the slot.  Forwarding addresses are installed with a
+  // compare-and-swap, so the task that loses the race discards its copy.
+  void ScavengeObject(HeapObject** slot, HeapObject* object);
+
+  // Remembers a slot of a promoted object that still points to new space.
+  void RecordSlot(Object** slot) {
+    promoted_slots_.Add(reinterpret_cast<Address>(slot));
+  }
+
+  // Copied objects waiting to be scavenged.  Push and Pop are only called
+  // by the owning thread.
+  inline void Push(HeapObject* object);
+  inline bool Pop(HeapObject** object);
+  inline bool Steal(HeapObject** object) { return deque_.Steal(object); }
+  inline bool IsEmpty() { return deque_.IsEmpty(); }
+
+  // Gives the unused part of the allocation buffers back to their spaces
+  // and enters the recorded slots into the store buffer.  Called by the
+  // main thread once all tasks are out of work.
+  void Finish();
+
+ private:
+  HeapObject* AllocateInToSpace(int size_in_bytes);
+  HeapObject* AllocateInOldSpace(AllocationSpace space, int size_in_bytes);
+  void FreeAllocation(HeapObject* object, int size_in_bytes);
+  void RetireOldSpaceBuffer(AllocationSpace space);
+
+  ScavengeAllocationBuffer* old_space_buffer(AllocationSpace space) {
+    return space == OLD_DATA_SPACE ? &old_data_buffer_ : &old_pointer_buffer_;
+  }
+
+  // Large enough that the deque rarely overflows into the private list.
+  static const int kDequeCapacity = 16 * KB;
+
+  // Objects larger than this are allocated outside of the buffers, which
+  // bounds the memory lost at the end of each buffer.
+  static const int kBufferSize = 8 * KB;
+  static const int kMaxBufferedObjectSize = kBufferSize / 8;
+
+  Heap* heap_;
+  WorkStealingDeque<HeapObject*> deque_;
+  List<HeapObject*> overflow_;
+  ScavengeAllocationBuffer to_space_buffer_;
+  ScavengeAllocationBuffer old_pointer_buffer_;
+  ScavengeAllocationBuffer old_data_buffer_;
+  List<Address> promoted_slots_;
+  intptr_t promoted_objects_size_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelScavengeTask);
+};
+
+
 typedef void (*ScavengingCallback)(Map* map,
                                    HeapObject** slot,
                                    HeapObject* object);
@@ -629,9 +728,13 @@ class Heap {
   // Allocates and initializes a new JavaScript object based on a map.
   // Returns Failure::RetryAfterGC(requested_bytes, space) if the allocation
   // failed.
+  // If alloc_props is false the object gets an empty properties array, as
+  // objects allocated by optimized code do.
   // Please note this does not perform a garbage collection.
   MUST_USE_RESULT MaybeObject* AllocateJSObjectFromMap(
-      Map* map, PretenureFlag pretenure = NOT_TENURED);
+      Map* map,
+      PretenureFlag pretenure = NOT_TENURED,
+      bool alloc_props = true);
 
   // Allocates a heap object based on the map.
   // Returns Failure::RetryAfterGC(requested_bytes, space) if the allocation
@@ -1007,6 +1110,27 @@ class Heap {
   // when shortening objects.
   void CreateFillerObjectAt(Address addr, int size);
 
+  // Starts reporting about every step bytes of allocation to the allocation
+  // sampler of the heap profiler. Zero stops reporting.
+  void SetAllocationSamplingStep(intptr_t step);
+
+  inline bool is_sampling_allocations() {
+    return new_space_.allocation_sampling_step() != 0;
+  }
+
+  // Reports a successful raw allocation of object_size bytes to the
+  // allocation sampler. bytes_allocated is the number of bytes allocated
+  // since the previous report, including the object.  Allocations that go
+  // directly to a space rather than through Heap::AllocateRaw or new space
+  // are not reported.
+  void SampleAllocation(MaybeObject* result,
+                        int object_size,
+                        intptr_t bytes_allocated);
+
+  // Returns whether the start of the given object may be moved by trimming
+  // it from the left, i.e. whether no sweeper thread can be looking at it.
+  bool CanMoveObjectStart(HeapObject* object);
+
   // Makes a new native code object
   // Returns Failure::RetryAfterGC(requested_bytes, space) if the allocation
   // failed. On success, the pointer to the Code object is stored in the
@@ -1347,6 +1471,11 @@ class Heap {
   static inline void ScavengePointer(HeapObject** p);
   static inline void ScavengeObject(HeapObject** p, HeapObject* object);
 
+  // Scavenges the objects copied by the given parallel scavenge task and
+  // steals work from the other tasks until all of them run out of work.
+  // Called by the main thread for task 0 and by the scavenger threads.
+  void ScavengeInParallel(int index);
+
   // Commits from space if it is uncommitted.
   void EnsureFromSpaceIsCommitted();
 
@@ -1677,17 +1806,46 @@ class Heap {
   void CheckpointObjectStats();
 
   // We don't use a ScopedLock here since we want to lock the heap
-  // only when FLAG_parallel_recompilation is true.
+  // only when FLAG_parallel_recompilation is true.  The collector takes
+  // the lock exclusively while it moves objects; optimizing compiler
+  // threads share it with each other through SharedRelocationLock.
   class RelocationLock {
    public:
     explicit RelocationLock(Heap* heap) : heap_(heap) {
       if (FLAG_parallel_recompilation) {
-        heap_->relocation_mutex_->Lock();
+        heap_->relocation_semaphore_->Wait();
       }
     }
     ~RelocationLock() {
       if (FLAG_parallel_recompilation) {
-        heap_->relocation_mutex_->Unlock();
+        heap_->relocation_semaphore_->Signal();
+      }
+    }
+
+   private:
+    Heap* heap_;
+  };
+
+  // The first compiler thread to enter acquires the relocation lock on
+  // behalf of all of them and the last one to leave releases it.  The
+  // collector cannot starve, since the execution thread that feeds the
+  // compiler threads is the one waiting for the lock.
+  class SharedRelocationLock {
+   public:
+    explicit SharedRelocationLock(Heap* heap) : heap_(heap) {
+      if (FLAG_parallel_recompilation) {
+        ScopedLock lock(heap_->relocation_mutex_);
+        if (heap_->relocation_sharers_++ == 0) {
+          heap_->relocation_semaphore_->Wait();
+        }
+      }
+    }
+    ~SharedRelocationLock() {
+      if (FLAG_parallel_recompilation) {
+        ScopedLock lock(heap_->relocation_mutex_);
+        if (--heap_->relocation_sharers_ == 0) {
+          heap_->relocation_semaphore_->Signal();
+        }
       }
     }
 
@@ -1949,6 +2107,15 @@ class Heap {
       Object** pointer);
 
   Address DoScavenge(ObjectVisitor* scavenge_visitor, Address new_space_front);
+
+  // Parallel scavenging.  The roots are visited by the main thread, which
+  // only copies their direct targets; DoParallelScavenge then spreads the
+  // copies over all tasks and scavenges their transitive closure.
+  bool AreScavengerThreadsActivated();
+  Address DoParallelScavenge();
+  bool StealScavengeWork(int index, HeapObject** object);
+  bool OfferScavengeTermination();
+  static void ScavengeObjectInParallel(HeapObject** p, HeapObject* object);
   static void ScavengeStoreBufferCallback(Heap* heap,
                                           MemoryChunk* page,
                                           StoreBufferEvent event);
@@ -2152,7 +2319,16 @@ class Heap {
 
   MemoryChunk* chunks_queued_for_free_;
 
+  // Guards relocation_sharers_; relocation_semaphore_ is the lock itself.
   Mutex* relocation_mutex_;
+  Semaphore* relocation_semaphore_;
+  int relocation_sharers_;
+
+  // State of parallel scavenges: one task per scavenger thread plus one for
+  // the main thread.  The mutex guards allocation of the tasks' buffers.
+  ParallelScavengeTask* parallel_scavenge_tasks_;
+  Mutex* parallel_scavenge_mutex_;
+  volatile AtomicWord idle_scavenge_tasks_;
 
   friend class Factory;
   friend class GCTracer;
@@ -2163,6 +2339,7 @@ class Heap {
   friend class MarkCompactCollector;
   friend class MarkCompactMarkingVisitor;
   friend class MapCompact;
+  friend class ParallelScavengeTask;
 
   DISALLOW_COPY_AND_ASSIGN(Heap);
 };
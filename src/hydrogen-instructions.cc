@@ -1163,6 +1163,15 @@ Range* HConstant::InferRange(Zone* zone) {
 Range* HPhi::InferRange(Zone* zone) {
   if (representation().IsInteger32()) {
     if (block()->IsLoopHeader()) {
+      // An induction variable never goes below its initial value when it
+      // is incremented, and never above it when it is decremented.
+      int32_t step = InductionVariableStep();
+      Range* initial = OperandAt(0)->range();
+      if (step > 0 && initial != NULL) {
+        return new(zone) Range(initial->lower(), kMaxInt);
+      } else if (step < 0 && initial != NULL) {
+        return new(zone) Range(kMinInt, initial->upper());
+      }
       Range* range = new(zone) Range(kMinInt, kMaxInt);
       return range;
     } else {
@@ -1178,6 +1187,37 @@ Range* HPhi::InferRange(Zone* zone) {
 }
 
 
+int32_t HPhi::InductionVariableStep() {
+  if (!representation().IsInteger32()) return 0;
+  // The first operand flows in from the loop pre-header, the second one
+  // from the back edge.
+  if (!block()->IsLoopHeader() || OperandCount() != 2) return 0;
+  HValue* update = OperandAt(1);
+  if (!update->representation().IsInteger32()) return 0;
+  if (!update->IsAdd() && !update->IsSub()) return 0;
+  HBinaryOperation* operation = HBinaryOperation::cast(update);
+  HValue* step;
+  if (operation->left() == this) {
+    step = operation->right();
+  } else if (update->IsAdd() && operation->right() == this) {
+    step = operation->left();
+  } else {
+    return 0;
+  }
+  if (!step->IsConstant() || !HConstant::cast(step)->HasInteger32Value()) {
+    return 0;
+  }
+  // An update without overflow check wraps around if all its uses truncate.
+  if (!update->CheckFlag(kCanOverflow) &&
+      update->CheckUsesForFlag(kTruncatingToInt32)) {
+    return 0;
+  }
+  int32_t value = HConstant::cast(step)->Integer32Value();
+  if (value == kMinInt) return 0;
+  return update->IsAdd() ? value : -value;
+}
+
+
 Range* HAdd::InferRange(Zone* zone) {
   if (representation().IsInteger32()) {
     Range* a = left()->range();
@@ -1420,6 +1460,29 @@ void HSimulate::PrintDataTo(StringStream* stream) {
 }
 
 
+void HCapturedObject::ReplayEnvironment(HEnvironment* env) {
+  while (env != NULL) {
+    for (int i = 0; i < env->length(); ++i) {
+      HValue* value = env->values()->at(i);
+      if (value->IsCapturedObject() &&
+          HCapturedObject::cast(value)->capture_id() == capture_id()) {
+        env->SetValueAt(i, this);
+      }
+    }
+    env = env->outer();
+  }
+}
+
+
+void HCapturedObject::PrintDataTo(StringStream* stream) {
+  stream->Add("#%d", capture_id());
+  for (int i = 0; i < values_.length(); ++i) {
+    stream->Add(" ");
+    values_[i]->PrintNameTo(stream);
+  }
+}
+
+
 void HDeoptimize::PrintDataTo(StringStream* stream) {
   if (OperandCount() == 0) return;
   OperandAt(0)->PrintNameTo(stream);
@@ -2255,12 +2318,34 @@ HType HAllocateObject::CalculateInferredType() {
 }
 
 
+void HAllocateObject::PrintDataTo(StringStream* stream) {
+  stream->Add("size %d", size());
+  if (IsFolded()) {
+    stream->Add(" folded into ");
+    allocation_base()->PrintNameTo(stream);
+    stream->Add(" @%d", folding_offset());
+  }
+  if (folded_size() != 0) stream->Add(" (reserving %d)", folded_size());
+}
+
+
 HType HFastLiteral::CalculateInferredType() {
   // TODO(mstarzinger): Be smarter, could also be JSArray here.
   return HType::JSObject();
 }
 
 
+void HFastLiteral::PrintDataTo(StringStream* stream) {
+  stream->Add("size %d", total_size());
+  if (IsFolded()) {
+    stream->Add(" folded into ");
+    allocation_base()->PrintNameTo(stream);
+    stream->Add(" @%d", folding_offset());
+  }
+  if (folded_size() != 0) stream->Add(" (reserving %d)", folded_size());
+}
+
+
 HType HArrayLiteral::CalculateInferredType() {
   return HType::JSArray();
 }
@@ -83,6 +83,7 @@ class LChunkBuilder;
   V(CallNew)                                   \
   V(CallRuntime)                               \
   V(CallStub)                                  \
+  V(CapturedObject)                            \
   V(Change)                                    \
   V(CheckFunction)                             \
   V(CheckInstanceType)                         \
@@ -2244,10 +2245,12 @@ class HCheckMaps: public HTemplateInstruction<2> {
 };
 
 
+// Checks that a value is identical to a constant heap object, usually a
+// function but also the initial map of a scalar replaced allocation.
 class HCheckFunction: public HUnaryOperation {
  public:
-  HCheckFunction(HValue* value, Handle<JSFunction> function)
-      : HUnaryOperation(value), target_(function) {
+  HCheckFunction(HValue* value, Handle<HeapObject> target)
+      : HUnaryOperation(value), target_(target) {
     set_representation(Representation::Tagged());
     SetFlag(kUseGVN);
   }
@@ -2262,7 +2265,7 @@ class HCheckFunction: public HUnaryOperation {
   virtual void Verify();
 #endif
 
-  Handle<JSFunction> target() const { return target_; }
+  Handle<HeapObject> target() const { return target_; }
 
   DECLARE_CONCRETE_INSTRUCTION(CheckFunction)
 
@@ -2273,7 +2276,7 @@ class HCheckFunction: public HUnaryOperation {
   }
 
  private:
-  Handle<JSFunction> target_;
+  Handle<HeapObject> target_;
 };
 
 
@@ -2440,6 +2443,10 @@ class HCheckSmi: public HUnaryOperation {
 
 class HPhi: public HValue {
  public:
+  // Phis that do not correspond to an environment slot, e.g. those merging
+  // the fields of a captured object, use this merged index.
+  static const int kInvalidMergedIndex = -1;
+
   HPhi(int merged_index, Zone* zone)
       : inputs_(2, zone),
         merged_index_(merged_index),
@@ -2450,7 +2457,7 @@ class HPhi: public HValue {
       non_phi_uses_[i] = 0;
       indirect_uses_[i] = 0;
     }
-    ASSERT(merged_index >= 0);
+    ASSERT(merged_index >= 0 || merged_index == kInvalidMergedIndex);
     set_representation(Representation::Tagged());
     SetFlag(kFlexibleRepresentation);
   }
@@ -2471,6 +2478,12 @@ class HPhi: public HValue {
   bool IsReceiver() { return merged_index_ == 0; }
 
   int merged_index() const { return merged_index_; }
+  bool HasMergedIndex() const { return merged_index_ != kInvalidMergedIndex; }
+
+  // If this is an integer loop header phi that is updated by adding a
+  // constant on the only back edge, and the update deoptimizes instead of
+  // wrapping around on overflow, returns the constant.  Returns 0 otherwise.
+  int32_t InductionVariableStep();
 
   virtual void PrintTo(StringStream* stream);
 
@@ -2547,6 +2560,46 @@ class HPhi: public HValue {
 };
 
 
+// The state of an allocation that was removed by escape analysis. The
+// operands are the map and the in-object fields of the object at this point
+// of the program, which the deoptimizer uses to materialize it. Each state
+// replaces the earlier states of the same object in the environment.
+class HCapturedObject: public HInstruction {
+ public:
+  HCapturedObject(int capture_id, int length, Zone* zone)
+      : capture_id_(capture_id), values_(length, zone) {
+    values_.AddBlock(NULL, length, zone);
+    set_representation(Representation::Tagged());
+  }
+
+  int capture_id() const { return capture_id_; }
+  int length() const { return values_.length(); }
+
+  // Rebinds all environment slots holding a state of this object.
+  void ReplayEnvironment(HEnvironment* env);
+
+  virtual int OperandCount() { return values_.length(); }
+  virtual HValue* OperandAt(int index) const { return values_[index]; }
+
+  virtual Representation RequiredInputRepresentation(int index) {
+    return Representation::None();
+  }
+
+  virtual void PrintDataTo(StringStream* stream);
+
+  DECLARE_CONCRETE_INSTRUCTION(CapturedObject)
+
+ protected:
+  virtual void InternalSetOperandAt(int index, HValue* value) {
+    values_[index] = value;
+  }
+
+ private:
+  int capture_id_;
+  ZoneList<HValue*> values_;
+};
+
+
 class HArgumentsObject: public HTemplateInstruction<0> {
  public:
   HArgumentsObject() {
@@ -3226,6 +3279,7 @@ class HStringCompareAndBranch: public HTemplateControlInstruction<2, 3> {
     SetOperandAt(1, left);
     SetOperandAt(2, right);
     set_representation(Representation::Tagged());
+    SetGVNFlag(kChangesNewSpacePromotion);
   }
 
   HValue* context() { return OperandAt(0); }
@@ -3918,9 +3972,7 @@ inline bool StoringValueNeedsWriteBarrier(HValue* value) {
 
 
 inline bool ReceiverObjectNeedsWriteBarrier(HValue* object,
-                                            HValue* new_space_dominator) {
-  return !object->IsAllocateObject() || (object != new_space_dominator);
-}
+                                            HValue* new_space_dominator);
 
 
 class HStoreGlobalCell: public HUnaryOperation {
@@ -4482,7 +4534,8 @@ class HStoreNamedField: public HTemplateInstruction<2> {
       : name_(name),
         is_in_object_(in_object),
         offset_(offset),
-        new_space_dominator_(NULL) {
+        new_space_dominator_(NULL),
+        receiver_is_young_(false) {
     SetOperandAt(0, obj);
     SetOperandAt(1, val);
     SetFlag(kTrackSideEffectDominators);
@@ -4515,13 +4568,18 @@ class HStoreNamedField: public HTemplateInstruction<2> {
   void set_transition(Handle<Map> map) { transition_ = map; }
   HValue* new_space_dominator() const { return new_space_dominator_; }
 
+  // The receiver is known to be allocated in new space with no GC since its
+  // allocation.  See HGraph::EliminateWriteBarriers.
+  bool receiver_is_young() const { return receiver_is_young_; }
+  void MarkReceiverAsYoung() { receiver_is_young_ = true; }
+
   bool NeedsWriteBarrier() {
-    return StoringValueNeedsWriteBarrier(value()) &&
-        ReceiverObjectNeedsWriteBarrier(object(), new_space_dominator());
+    return StoringValueNeedsWriteBarrier(value()) && NeedsWriteBarrierForMap();
   }
 
   bool NeedsWriteBarrierForMap() {
-    return ReceiverObjectNeedsWriteBarrier(object(), new_space_dominator());
+    return !receiver_is_young() &&
+        ReceiverObjectNeedsWriteBarrier(object(), new_space_dominator());
   }
 
  private:
@@ -4530,6 +4588,7 @@ class HStoreNamedField: public HTemplateInstruction<2> {
   int offset_;
   Handle<Map> transition_;
   HValue* new_space_dominator_;
+  bool receiver_is_young_;
 };
 
 
@@ -4573,7 +4632,10 @@ class HStoreKeyedFastElement
  public:
   HStoreKeyedFastElement(HValue* obj, HValue* key, HValue* val,
                          ElementsKind elements_kind = FAST_ELEMENTS)
-      : elements_kind_(elements_kind), index_offset_(0), is_dehoisted_(false) {
+      : elements_kind_(elements_kind),
+        index_offset_(0),
+        is_dehoisted_(false),
+        receiver_is_young_(false) {
     SetOperandAt(0, obj);
     SetOperandAt(1, key);
     SetOperandAt(2, val);
@@ -4600,8 +4662,13 @@ class HStoreKeyedFastElement
   bool IsDehoisted() { return is_dehoisted_; }
   void SetDehoisted(bool is_dehoisted) { is_dehoisted_ = is_dehoisted; }
 
+  // The backing store is known to be allocated in new space with no GC since
+  // its allocation.  See HGraph::EliminateWriteBarriers.
+  bool receiver_is_young() const { return receiver_is_young_; }
+  void MarkReceiverAsYoung() { receiver_is_young_ = true; }
+
   bool NeedsWriteBarrier() {
-    if (value_is_smi()) {
+    if (value_is_smi() || receiver_is_young()) {
       return false;
     } else {
       return StoringValueNeedsWriteBarrier(value());
@@ -4616,6 +4683,7 @@ class HStoreKeyedFastElement
   ElementsKind elements_kind_;
   uint32_t index_offset_;
   bool is_dehoisted_;
+  bool receiver_is_young_;
 };
 
 
@@ -4928,11 +4996,25 @@ class HStringLength: public HUnaryOperation {
 };
 
 
-class HAllocateObject: public HTemplateInstruction<1> {
+// Inline allocations that are folded into a dominating allocation do not
+// allocate by themselves.  Their memory is reserved behind the object of the
+// dominating allocation, which is the allocation base, and they only carve
+// out and initialize their object at the given folding offset.  Every
+// allocation in such a group also knows how many bytes are still reserved
+// behind its own object, so that it can cover them with a filler object and
+// keep the heap iterable until the next object of the group is initialized.
+// See HGraph::FoldAllocations.
+class HAllocateObject: public HTemplateInstruction<2> {
  public:
   HAllocateObject(HValue* context, Handle<JSFunction> constructor)
-      : constructor_(constructor) {
+      : constructor_(constructor),
+        initial_map_(constructor->initial_map()),
+        folding_offset_(0),
+        folded_size_(0) {
     SetOperandAt(0, context);
+    // Until the allocation is folded, a copy of the context serves as a dummy
+    // allocation base.
+    SetOperandAt(1, context);
     set_representation(Representation::Tagged());
     SetGVNFlag(kChangesNewSpacePromotion);
   }
@@ -4941,13 +5023,32 @@ class HAllocateObject: public HTemplateInstruction<1> {
   static const int kMaxSize = 64 * kPointerSize;
 
   HValue* context() { return OperandAt(0); }
+  HValue* allocation_base() { return OperandAt(1); }
   Handle<JSFunction> constructor() { return constructor_; }
+  // The initial map of the constructor at compile time.  It can differ from
+  // the one used at runtime once the prototype of the constructor changes.
+  Handle<Map> initial_map() { return initial_map_; }
+  int size() const { return initial_map_->instance_size(); }
+
+  bool IsFolded() const { return folding_offset_ != 0; }
+  int folding_offset() const { return folding_offset_; }
+  int folded_size() const { return folded_size_; }
+  void FoldInto(HValue* base, int offset) {
+    ASSERT(!IsFolded() && folded_size_ == 0 && offset > 0);
+    SetOperandAt(1, base);
+    folding_offset_ = offset;
+    // Nothing is allocated here anymore, so this cannot trigger a GC.
+    ClearGVNFlag(kChangesNewSpacePromotion);
+  }
+  void set_folded_size(int size) { folded_size_ = size; }
 
   virtual Representation RequiredInputRepresentation(int index) {
     return Representation::Tagged();
   }
   virtual HType CalculateInferredType();
 
+  virtual void PrintDataTo(StringStream* stream);
+
   DECLARE_CONCRETE_INSTRUCTION(AllocateObject)
 
  private:
@@ -4955,9 +5056,25 @@ class HAllocateObject: public HTemplateInstruction<1> {
   //  virtual bool IsDeletable() const { return true; }
 
   Handle<JSFunction> constructor_;
+  Handle<Map> initial_map_;
+  int folding_offset_;
+  int folded_size_;
 };
 
 
+inline bool ReceiverObjectNeedsWriteBarrier(HValue* object,
+                                            HValue* new_space_dominator) {
+  if (!object->IsAllocateObject()) return true;
+  // A folded allocation cannot trigger a GC, so its object stays in new space
+  // as long as the allocation base dominates the store.
+  HAllocateObject* allocation = HAllocateObject::cast(object);
+  if (allocation->IsFolded()) {
+    return allocation->allocation_base() != new_space_dominator;
+  }
+  return object != new_space_dominator;
+}
+
+
 template <int V>
 class HMaterializedLiteral: public HTemplateInstruction<V> {
  public:
@@ -4977,18 +5094,30 @@ class HMaterializedLiteral: public HTemplateInstruction<V> {
 };
 
 
-class HFastLiteral: public HMaterializedLiteral<1> {
+// Fast literals take part in allocation folding like HAllocateObject.
+class HFastLiteral: public HMaterializedLiteral<2> {
  public:
   HFastLiteral(HValue* context,
                Handle<JSObject> boilerplate,
                int total_size,
                int literal_index,
                int depth)
-      : HMaterializedLiteral<1>(literal_index, depth),
+      : HMaterializedLiteral<2>(literal_index, depth),
         boilerplate_(boilerplate),
-        total_size_(total_size) {
+        boilerplate_map_(boilerplate->map()),
+        total_size_(total_size),
+        folding_offset_(0),
+        folded_size_(0) {
     SetOperandAt(0, context);
+    // Until the allocation is folded, a copy of the context serves as a dummy
+    // allocation base.
+    SetOperandAt(1, context);
     SetGVNFlag(kChangesNewSpacePromotion);
+    // Only non-empty, non-COW backing stores are copied along with the
+    // literal, see LCodeGen::EmitDeepCopy.
+    FixedArrayBase* elements = boilerplate->elements();
+    has_copied_elements_ = elements->length() > 0 &&
+        elements->map() != boilerplate->GetHeap()->fixed_cow_array_map();
   }
 
   // Maximum depth and total number of elements and properties for literal
@@ -4997,19 +5126,39 @@ class HFastLiteral: public HMaterializedLiteral<1> {
   static const int kMaxLiteralProperties = 8;
 
   HValue* context() { return OperandAt(0); }
+  HValue* allocation_base() { return OperandAt(1); }
   Handle<JSObject> boilerplate() const { return boilerplate_; }
+  Handle<Map> boilerplate_map() const { return boilerplate_map_; }
   int total_size() const { return total_size_; }
+  bool has_copied_elements() const { return has_copied_elements_; }
+
+  bool IsFolded() const { return folding_offset_ != 0; }
+  int folding_offset() const { return folding_offset_; }
+  int folded_size() const { return folded_size_; }
+  void FoldInto(HValue* base, int offset) {
+    ASSERT(!IsFolded() && folded_size_ == 0 && offset > 0);
+    SetOperandAt(1, base);
+    folding_offset_ = offset;
+    ClearGVNFlag(kChangesNewSpacePromotion);
+  }
+  void set_folded_size(int size) { folded_size_ = size; }
 
   virtual Representation RequiredInputRepresentation(int index) {
     return Representation::Tagged();
   }
   virtual HType CalculateInferredType();
 
+  virtual void PrintDataTo(StringStream* stream);
+
   DECLARE_CONCRETE_INSTRUCTION(FastLiteral)
 
  private:
   Handle<JSObject> boilerplate_;
+  Handle<Map> boilerplate_map_;
   int total_size_;
+  bool has_copied_elements_;
+  int folding_offset_;
+  int folded_size_;
 };
 
 
@@ -5160,6 +5309,7 @@ class HTypeof: public HTemplateInstruction<2> {
     SetOperandAt(0, context);
     SetOperandAt(1, value);
     set_representation(Representation::Tagged());
+    SetGVNFlag(kChangesNewSpacePromotion);
   }
 
   HValue* context() { return OperandAt(0); }
@@ -5187,6 +5337,8 @@ class HToFastProperties: public HUnaryOperation {
     // object literals.
     ASSERT(value->IsObjectLiteral() || value->IsFastLiteral());
     set_representation(Representation::Tagged());
+    // It calls the runtime, which may trigger a GC.
+    SetGVNFlag(kChangesNewSpacePromotion);
   }
 
   virtual Representation RequiredInputRepresentation(int index) {
@@ -1665,6 +1665,499 @@ void HStackCheckEliminator::Process() {
 }
 
 
+// Replaces allocations that never escape the optimized code by the values of
+// their fields (scalar replacement).  An allocation escapes unless all its
+// uses are loads and stores of its in-object fields, checks of its map or
+// instance type, or deoptimization environments.  While walking the blocks
+// dominated by the allocation the state of the object is tracked as a list
+// of values, the map first, followed by the in-object properties.  Every
+// time the state changes an HCapturedObject recording it is inserted, so
+// that the deoptimizer can materialize the object when it is needed.
+class HEscapeAnalysis BASE_EMBEDDED {
+ public:
+  explicit HEscapeAnalysis(HGraph* graph)
+      : graph_(graph),
+        zone_(graph->zone()),
+        block_states_(graph->blocks()->length(), graph->zone()) { }
+
+  void Analyze();
+
+ private:
+  class State: public ZoneObject {
+   public:
+    State(int length, Zone* zone)
+        : values_(length, zone),
+          capture_(NULL),
+          map_is_initial_(false) {
+      values_.AddBlock(NULL, length, zone);
+    }
+
+    State* Copy(Zone* zone) {
+      State* copy = new(zone) State(values_.length(), zone);
+      for (int i = 0; i < values_.length(); ++i) {
+        copy->values_[i] = values_[i];
+      }
+      copy->capture_ = capture_;
+      copy->map_ = map_;
+      copy->map_is_initial_ = map_is_initial_;
+      return copy;
+    }
+
+    int length() const { return values_.length(); }
+    HValue* ValueAt(int index) const { return values_[index]; }
+    void SetValueAt(int index, HValue* value) { values_[index] = value; }
+
+    HCapturedObject* capture() const { return capture_; }
+    void set_capture(HCapturedObject* capture) { capture_ = capture; }
+
+    // The map of the object if it is known at compile time.
+    Handle<Map> map() const { return map_; }
+    void set_map(Handle<Map> map) {
+      map_ = map;
+      map_is_initial_ = false;
+    }
+    // Whether the map is still the unchecked initial map of the constructor,
+    // which can change at runtime when its prototype is replaced.
+    bool map_is_initial() const { return map_is_initial_; }
+    void set_map_is_initial() {
+      map_ = Handle<Map>::null();
+      map_is_initial_ = true;
+    }
+
+   private:
+    ZoneList<HValue*> values_;
+    HCapturedObject* capture_;
+    Handle<Map> map_;
+    bool map_is_initial_;
+  };
+
+  bool IsCandidate(HInstruction* instr);
+  HValue* LiteralValue(Object* value);
+  bool HasSupportedUses(HInstruction* allocation);
+  bool ScalarReplace(HInstruction* allocation, bool transform);
+  State* InitialState(HInstruction* allocation, bool transform);
+  State* MergeStates(HBasicBlock* block, bool transform);
+  bool ProcessUse(HInstruction* allocation,
+                  HInstruction* instr,
+                  State** state,
+                  bool transform);
+  void InsertCapture(State* state, HInstruction* allocation,
+                     HInstruction* next);
+  bool IsInLoopOf(HBasicBlock* block, HBasicBlock* other);
+  int FieldIndex(int offset, bool is_in_object, int length);
+  static bool ContainsMap(SmallMapList* maps, Handle<Map> map);
+  void TraceEscape(HInstruction* allocation, HValue* use);
+
+  HGraph* graph_;
+  Zone* zone_;
+  ZoneList<State*> block_states_;
+};
+
+
+void HEscapeAnalysis::Analyze() {
+  HPhase phase("H_Escape analysis", graph_);
+  ZoneList<HInstruction*> candidates(4, zone_);
+  for (int i = 0; i < graph_->blocks()->length(); ++i) {
+    HBasicBlock* block = graph_->blocks()->at(i);
+    for (HInstruction* instr = block->first();
+         instr != NULL;
+         instr = instr->next()) {
+      if (IsCandidate(instr)) candidates.Add(instr, zone_);
+    }
+  }
+
+  for (int i = 0; i < candidates.length(); ++i) {
+    HInstruction* allocation = candidates[i];
+    if (!HasSupportedUses(allocation)) continue;
+    if (!ScalarReplace(allocation, false)) continue;
+    if (FLAG_trace_escape_analysis) {
+      PrintF("[escape analysis] replacing %s %d by its fields\n",
+             allocation->Mnemonic(), allocation->id());
+    }
+    ScalarReplace(allocation, true);
+  }
+}
+
+
+bool HEscapeAnalysis::IsCandidate(HInstruction* instr) {
+  if (instr->IsAllocateObject()) {
+    Handle<Map> map = HAllocateObject::cast(instr)->initial_map();
+    return map->instance_type() == JS_OBJECT_TYPE;
+  }
+  if (instr->IsFastLiteral()) {
+    // Only literals that are a single JSObject without elements, and whose
+    // properties can be expressed as constants without creating handles.
+    HFastLiteral* literal = HFastLiteral::cast(instr);
+    Handle<JSObject> boilerplate = literal->boilerplate();
+    Handle<Map> map = literal->boilerplate_map();
+    if (*map != boilerplate->map()) return false;
+    if (map->instance_type() != JS_OBJECT_TYPE) return false;
+    if (literal->total_size() != map->instance_size()) return false;
+    if (boilerplate->properties()->length() != 0) return false;
+    if (boilerplate->elements()->length() != 0) return false;
+    for (int i = 0; i < map->inobject_properties(); ++i) {
+      Object* value = boilerplate->InObjectPropertyAt(i);
+      if (!value->IsNumber() && !value->IsUndefined() &&
+          !value->IsTrue() && !value->IsFalse()) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+
+HValue* HEscapeAnalysis::LiteralValue(Object* value) {
+  if (value->IsSmi()) {
+    return new(zone_) HConstant(Smi::cast(value)->value(),
+                                Representation::Tagged());
+  }
+  if (value->IsHeapNumber()) {
+    return new(zone_) HConstant(HeapNumber::cast(value)->value(),
+                                Representation::Tagged());
+  }
+  if (value->IsTrue()) return graph_->GetConstantTrue();
+  if (value->IsFalse()) return graph_->GetConstantFalse();
+  ASSERT(value->IsUndefined());
+  return graph_->GetConstantUndefined();
+}
+
+
+bool HEscapeAnalysis::HasSupportedUses(HInstruction* allocation) {
+  for (HUseIterator it(allocation->uses()); !it.Done(); it.Advance()) {
+    HValue* use = it.value();
+    if (use->IsSimulate() || use->IsLoadNamedField()) continue;
+    if (use->IsCheckNonSmi() || use->IsCheckInstanceType()) continue;
+    if (use->IsCheckMaps() && HCheckMaps::cast(use)->value() == allocation) {
+      continue;
+    }
+    if (use->IsStoreNamedField() &&
+        HStoreNamedField::cast(use)->value() != allocation) {
+      continue;
+    }
+    TraceEscape(allocation, use);
+    return false;
+  }
+  return true;
+}
+
+
+void HEscapeAnalysis::TraceEscape(HInstruction* allocation, HValue* use) {
+  if (FLAG_trace_escape_analysis) {
+    PrintF("[escape analysis] %s %d escapes through %s %d\n",
+           allocation->Mnemonic(), allocation->id(),
+           use->Mnemonic(), use->id());
+  }
+}
+
+
+int HEscapeAnalysis::FieldIndex(int offset, bool is_in_object, int length) {
+  if (!is_in_object) return -1;
+  if (offset == HeapObject::kMapOffset) return 0;
+  if (offset < JSObject::kHeaderSize) return -1;
+  ASSERT((offset - JSObject::kHeaderSize) % kPointerSize == 0);
+  int index = (offset - JSObject::kHeaderSize) / kPointerSize + 1;
+  return index < length ? index : -1;
+}
+
+
+bool HEscapeAnalysis::ContainsMap(SmallMapList* maps, Handle<Map> map) {
+  for (int i = 0; i < maps->length(); ++i) {
+    if (maps->at(i).is_identical_to(map)) return true;
+  }
+  return false;
+}
+
+
+bool HEscapeAnalysis::IsInLoopOf(HBasicBlock* block, HBasicBlock* other) {
+  // Returns whether every loop containing |other| also contains |block|.
+  // Loops are nested, so it is enough to check the innermost one.
+  HBasicBlock* header =
+      other->IsLoopHeader() ? other : other->parent_loop_header();
+  if (header == NULL) return true;
+  HBasicBlock* current =
+      block->IsLoopHeader() ? block : block->parent_loop_header();
+  while (current != NULL) {
+    if (current == header) return true;
+    current = current->parent_loop_header();
+  }
+  return false;
+}
+
+
+void HEscapeAnalysis::InsertCapture(State* state,
+                                    HInstruction* allocation,
+                                    HInstruction* next) {
+  HCapturedObject* capture =
+      new(zone_) HCapturedObject(allocation->id(), state->length(), zone_);
+  for (int i = 0; i < state->length(); ++i) {
+    capture->SetOperandAt(i, state->ValueAt(i));
+  }
+  capture->InsertBefore(next);
+  state->set_capture(capture);
+}
+
+
+HEscapeAnalysis::State* HEscapeAnalysis::InitialState(
+    HInstruction* allocation, bool transform) {
+  if (allocation->IsAllocateObject()) {
+    Handle<JSFunction> constructor =
+        HAllocateObject::cast(allocation)->constructor();
+    Handle<Map> initial_map = HAllocateObject::cast(allocation)->initial_map();
+    int length = initial_map->inobject_properties() + 1;
+    State* state = new(zone_) State(length, zone_);
+    state->set_map_is_initial();
+    if (transform) {
+      // The initial map is loaded at runtime; it is only known to be the one
+      // seen at compile time after a check of the map.
+      HConstant* function =
+          new(zone_) HConstant(constructor, Representation::Tagged());
+      function->InsertBefore(allocation);
+      HLoadNamedField* map = new(zone_) HLoadNamedField(
+          function, true, JSFunction::kPrototypeOrInitialMapOffset);
+      map->InsertBefore(allocation);
+      state->SetValueAt(0, map);
+      for (int i = 1; i < length; ++i) {
+        state->SetValueAt(i, graph_->GetConstantUndefined());
+      }
+    }
+    return state;
+  }
+
+  HFastLiteral* literal = HFastLiteral::cast(allocation);
+  Handle<Map> map = literal->boilerplate_map();
+  int length = map->inobject_properties() + 1;
+  State* state = new(zone_) State(length, zone_);
+  state->set_map(map);
+  if (transform) {
+    HConstant* map_constant =
+        new(zone_) HConstant(map, Representation::Tagged());
+    map_constant->InsertBefore(allocation);
+    state->SetValueAt(0, map_constant);
+    for (int i = 1; i < length; ++i) {
+      HValue* value =
+          LiteralValue(literal->boilerplate()->InObjectPropertyAt(i - 1));
+      if (value->block() == NULL) {
+        HInstruction::cast(value)->InsertBefore(literal);
+      }
+      state->SetValueAt(i, value);
+    }
+  }
+  return state;
+}
+
+
+HEscapeAnalysis::State* HEscapeAnalysis::MergeStates(HBasicBlock* block,
+                                                     bool transform) {
+  const ZoneList<HBasicBlock*>* predecessors = block->predecessors();
+  if (predecessors->is_empty()) return NULL;
+  if (block->IsLoopHeader()) {
+    // Stores in loops not containing the allocation have been rejected, so
+    // the state on the back edges is the same as on entry.
+    return block_states_[predecessors->at(0)->block_id()];
+  }
+
+  State* first = block_states_[predecessors->at(0)->block_id()];
+  if (first == NULL) return NULL;
+  bool same_capture = true;
+  for (int i = 1; i < predecessors->length(); ++i) {
+    State* other = block_states_[predecessors->at(i)->block_id()];
+    if (other == NULL) return NULL;
+    if (other->capture() != first->capture()) same_capture = false;
+  }
+  if (predecessors->length() == 1 || (transform && same_capture)) {
+    return first;
+  }
+
+  State* state = first->Copy(zone_);
+  state->set_capture(NULL);
+  for (int i = 1; i < predecessors->length(); ++i) {
+    State* other = block_states_[predecessors->at(i)->block_id()];
+    if (state->map_is_initial() != other->map_is_initial() ||
+        !state->map().is_identical_to(other->map())) {
+      state->set_map(Handle<Map>::null());
+    }
+  }
+  if (!transform) return state;
+
+  for (int j = 0; j < state->length(); ++j) {
+    HValue* value = first->ValueAt(j);
+    bool needs_phi = false;
+    for (int i = 1; i < predecessors->length(); ++i) {
+      State* other = block_states_[predecessors->at(i)->block_id()];
+      if (other->ValueAt(j) != value) needs_phi = true;
+    }
+    if (!needs_phi) continue;
+    HPhi* phi = new(zone_) HPhi(HPhi::kInvalidMergedIndex, zone_);
+    for (int i = 0; i < predecessors->length(); ++i) {
+      State* other = block_states_[predecessors->at(i)->block_id()];
+      phi->AddInput(other->ValueAt(j));
+    }
+    block->AddPhi(phi);
+    state->SetValueAt(j, phi);
+  }
+  return state;
+}
+
+
+bool HEscapeAnalysis::ProcessUse(HInstruction* allocation,
+                                 HInstruction* instr,
+                                 State** state_ref,
+                                 bool transform) {
+  State* state = *state_ref;
+  if (state == NULL) {
+    // The use is not dominated by a tracked state of the object.
+    TraceEscape(allocation, instr);
+    return false;
+  }
+
+  if (instr->IsSimulate()) {
+    if (transform) {
+      for (int i = 0; i < instr->OperandCount(); ++i) {
+        if (instr->OperandAt(i) == allocation) {
+          instr->SetOperandAt(i, state->capture());
+        }
+      }
+    }
+    return true;
+  }
+
+  if (instr->IsLoadNamedField()) {
+    HLoadNamedField* load = HLoadNamedField::cast(instr);
+    int index =
+        FieldIndex(load->offset(), load->is_in_object(), state->length());
+    if (index < 0) {
+      TraceEscape(allocation, instr);
+      return false;
+    }
+    if (transform) load->DeleteAndReplaceWith(state->ValueAt(index));
+    return true;
+  }
+
+  if (instr->IsStoreNamedField()) {
+    HStoreNamedField* store = HStoreNamedField::cast(instr);
+    int index =
+        FieldIndex(store->offset(), store->is_in_object(), state->length());
+    if (index <= 0 || !IsInLoopOf(allocation->block(), store->block())) {
+      TraceEscape(allocation, instr);
+      return false;
+    }
+    state = state->Copy(zone_);
+    if (!store->transition().is_null()) state->set_map(store->transition());
+    if (transform) {
+      if (!store->transition().is_null()) {
+        HConstant* map = new(zone_) HConstant(store->transition(),
+                                              Representation::Tagged());
+        map->InsertBefore(store);
+        state->SetValueAt(0, map);
+      }
+      state->SetValueAt(index, store->value());
+      InsertCapture(state, allocation, store);
+      store->DeleteAndReplaceWith(NULL);
+    }
+    *state_ref = state;
+    return true;
+  }
+
+  if (instr->IsCheckMaps()) {
+    HCheckMaps* check = HCheckMaps::cast(instr);
+    if (!state->map().is_null()) {
+      if (!ContainsMap(check->map_set(), state->map())) {
+        TraceEscape(allocation, instr);
+        return false;
+      }
+      if (transform) check->DeleteAndReplaceWith(NULL);
+      return true;
+    }
+    Handle<Map> map;
+    if (state->map_is_initial()) {
+      map = HAllocateObject::cast(allocation)->initial_map();
+    }
+    if (map.is_null() || !ContainsMap(check->map_set(), map)) {
+      TraceEscape(allocation, instr);
+      return false;
+    }
+    // Guard the initial map of the constructor instead of the object's map.
+    state = state->Copy(zone_);
+    state->set_map(map);
+    if (transform) {
+      HCheckFunction* guard = new(zone_) HCheckFunction(state->ValueAt(0), map);
+      guard->InsertBefore(check);
+      HConstant* map_constant =
+          new(zone_) HConstant(map, Representation::Tagged());
+      map_constant->InsertBefore(check);
+      state->SetValueAt(0, map_constant);
+      InsertCapture(state, allocation, check);
+      check->DeleteAndReplaceWith(NULL);
+    }
+    *state_ref = state;
+    return true;
+  }
+
+  if (instr->IsCheckInstanceType()) {
+    HCheckInstanceType* check = HCheckInstanceType::cast(instr);
+    InstanceType first = FIRST_TYPE;
+    InstanceType last = LAST_TYPE;
+    if (check->is_interval_check()) check->GetCheckInterval(&first, &last);
+    if (!check->is_interval_check() ||
+        first > JS_OBJECT_TYPE || last < JS_OBJECT_TYPE) {
+      TraceEscape(allocation, instr);
+      return false;
+    }
+  }
+
+  // Smi and instance type checks trivially hold for the allocated object.
+  ASSERT(instr->IsCheckNonSmi() || instr->IsCheckInstanceType());
+  if (transform) instr->DeleteAndReplaceWith(NULL);
+  return true;
+}
+
+
+bool HEscapeAnalysis::ScalarReplace(HInstruction* allocation, bool transform) {
+  const ZoneList<HBasicBlock*>* blocks = graph_->blocks();
+  block_states_.Rewind(0);
+  block_states_.AddBlock(NULL, blocks->length(), zone_);
+
+  // Blocks are in reverse post order, so the allocation's block comes before
+  // all blocks it dominates.
+  HBasicBlock* allocation_block = allocation->block();
+  for (int i = allocation_block->block_id(); i < blocks->length(); ++i) {
+    HBasicBlock* block = blocks->at(i);
+    State* state = NULL;
+    if (block != allocation_block) {
+      state = MergeStates(block, transform);
+      if (transform && state != NULL && state->capture() == NULL) {
+        InsertCapture(state, allocation, block->first()->next());
+      }
+    }
+
+    HInstruction* instr = block->first();
+    while (instr != NULL) {
+      HInstruction* next = instr->next();
+      if (instr == allocation) {
+        state = InitialState(allocation, transform);
+        if (transform) InsertCapture(state, allocation, allocation);
+      } else {
+        for (int j = 0; j < instr->OperandCount(); ++j) {
+          if (instr->OperandAt(j) != allocation) continue;
+          if (!ProcessUse(allocation, instr, &state, transform)) {
+            ASSERT(!transform);
+            return false;
+          }
+          break;
+        }
+      }
+      instr = next;
+    }
+    block_states_[i] = state;
+  }
+
+  if (transform) allocation->DeleteAndReplaceWith(NULL);
+  return true;
+}
+
+
 // Simple sparse set with O(1) add, contains, and clear.
 class SparseSet {
  public:
@@ -1734,7 +2227,9 @@ class HGlobalValueNumberer BASE_EMBEDDED {
   void AnalyzeGraph();
   void ComputeBlockSideEffects();
   void LoopInvariantCodeMotion();
-  void ProcessLoopBlock(HBasicBlock* block,
+  bool RemoveTransitionsDoneByPeeledIteration(HBasicBlock* loop_header);
+  bool ProcessLoop(HBasicBlock* loop_header);
+  bool ProcessLoopBlock(HBasicBlock* block,
                         HBasicBlock* before_loop,
                         GVNFlagSet loop_kills,
                         GVNFlagSet* accumulated_first_time_depends,
@@ -1786,6 +2281,7 @@ void HGlobalValueNumberer::ComputeBlockSideEffects() {
     HInstruction* instr = block->first();
     int id = block->block_id();
     GVNFlagSet side_effects;
+    block_side_effects_[id].RemoveAll();
     while (instr != NULL) {
       side_effects.Add(instr->ChangesFlags());
       if (instr->IsSoftDeoptimize()) {
@@ -1905,25 +2401,132 @@ void HGlobalValueNumberer::LoopInvariantCodeMotion() {
   for (int i = graph_->blocks()->length() - 1; i >= 0; --i) {
     HBasicBlock* block = graph_->blocks()->at(i);
     if (block->IsLoopHeader()) {
-      GVNFlagSet side_effects = loop_side_effects_[block->block_id()];
-      TRACE_GVN_2("Try loop invariant motion for block B%d %s\n",
-                  block->block_id(),
-                  *GetGVNFlagsString(side_effects));
-
-      GVNFlagSet accumulated_first_time_depends;
-      GVNFlagSet accumulated_first_time_changes;
-      HBasicBlock* last = block->loop_information()->GetLastBackEdge();
-      for (int j = block->block_id(); j <= last->block_id(); ++j) {
-        ProcessLoopBlock(graph_->blocks()->at(j), block, side_effects,
-                         &accumulated_first_time_depends,
-                         &accumulated_first_time_changes);
+      if (RemoveTransitionsDoneByPeeledIteration(block)) {
+        ComputeBlockSideEffects();
+      }
+      if (ProcessLoop(block)) {
+        // Elements kind transitions were hoisted.  The loop kills less now,
+        // so the instructions depending on the elements kind may be
+        // invariant as well.
+        ComputeBlockSideEffects();
+        ProcessLoop(block);
+      }
+    }
+  }
+}
+
+
+// An elements kind transition in a loop does nothing if the peeled first
+// iteration did the same transition on every path into the loop, and no
+// instruction in the peeled iteration or the loop can give the object its
+// original map back.  Such transitions are removed, so that they no longer
+// kill the map checks of the loop.  Returns true if any were removed.
+bool HGlobalValueNumberer::RemoveTransitionsDoneByPeeledIteration(
+    HBasicBlock* loop_header) {
+  HLoopInformation* loop = loop_header->loop_information();
+  HBasicBlock* peeled_entry = loop->peeled_entry();
+  if (peeled_entry == NULL || !AllowCodeMotion()) return false;
+
+  // Transitions on every path from the peeled iteration into the loop.
+  ZoneList<HTransitionElementsKind*> done(4, zone());
+  HBasicBlock* pre_header = loop_header->predecessors()->at(0);
+  for (HBasicBlock* block = pre_header;
+       block != NULL;
+       block = block->dominator()) {
+    for (HInstruction* instr = block->first();
+         instr != NULL;
+         instr = instr->next()) {
+      if (instr->IsTransitionElementsKind()) {
+        done.Add(HTransitionElementsKind::cast(instr), zone());
+      }
+    }
+    if (block == peeled_entry) break;
+  }
+  if (done.is_empty()) return false;
+
+  // Only transitions may change maps in the peeled iteration and the loop.
+  // Their targets are the maps that objects can be transitioned to.
+  ZoneList<Handle<Map> > targets(4, zone());
+  HBasicBlock* last = loop->GetLastBackEdge();
+  for (int i = peeled_entry->block_id(); i <= last->block_id(); ++i) {
+    HBasicBlock* block = graph_->blocks()->at(i);
+    for (HInstruction* instr = block->first();
+         instr != NULL;
+         instr = instr->next()) {
+      GVNFlagSet changes = instr->ChangesFlags();
+      if (!changes.Contains(kChangesMaps) &&
+          !changes.Contains(kChangesElementsKind)) {
+        continue;
+      }
+      if (!instr->IsTransitionElementsKind()) return false;
+      targets.Add(HTransitionElementsKind::cast(instr)->transitioned_map(),
+                  zone());
+    }
+  }
+
+  bool removed = false;
+  for (int i = loop_header->block_id(); i <= last->block_id(); ++i) {
+    HBasicBlock* block = graph_->blocks()->at(i);
+    HInstruction* instr = block->first();
+    while (instr != NULL) {
+      HInstruction* next = instr->next();
+      if (instr->IsTransitionElementsKind()) {
+        HTransitionElementsKind* transition =
+            HTransitionElementsKind::cast(instr);
+        bool restorable = false;
+        for (int j = 0; j < targets.length(); ++j) {
+          if (targets[j].is_identical_to(transition->original_map())) {
+            restorable = true;
+          }
+        }
+        HTransitionElementsKind* dominator = NULL;
+        for (int j = 0; j < done.length() && dominator == NULL; ++j) {
+          if (transition->Equals(done[j])) dominator = done[j];
+        }
+        if (!restorable && dominator != NULL) {
+          if (FLAG_trace_licm) {
+            PrintF("Removed transition %d in B%d of loop B%d, done by %d "
+                   "in the peeled iteration\n",
+                   transition->id(),
+                   block->block_id(),
+                   loop_header->block_id(),
+                   dominator->id());
+          }
+          transition->DeleteAndReplaceWith(dominator);
+          removed = true;
+        }
       }
+      instr = next;
+    }
+  }
+  return removed;
+}
+
+
+// Hoists the loop invariant instructions of a loop.  Returns true if any
+// elements kind transitions were hoisted.
+bool HGlobalValueNumberer::ProcessLoop(HBasicBlock* loop_header) {
+  GVNFlagSet side_effects = loop_side_effects_[loop_header->block_id()];
+  TRACE_GVN_2("Try loop invariant motion for block B%d %s\n",
+              loop_header->block_id(),
+              *GetGVNFlagsString(side_effects));
+
+  GVNFlagSet accumulated_first_time_depends;
+  GVNFlagSet accumulated_first_time_changes;
+  bool hoisted_transitions = false;
+  HBasicBlock* last = loop_header->loop_information()->GetLastBackEdge();
+  for (int j = loop_header->block_id(); j <= last->block_id(); ++j) {
+    if (ProcessLoopBlock(graph_->blocks()->at(j), loop_header, side_effects,
+                         &accumulated_first_time_depends,
+                         &accumulated_first_time_changes)) {
+      hoisted_transitions = true;
     }
   }
+  return hoisted_transitions;
 }
 
 
-void HGlobalValueNumberer::ProcessLoopBlock(
+bool HGlobalValueNumberer::ProcessLoopBlock(
     HBasicBlock* block,
     HBasicBlock* loop_header,
     GVNFlagSet loop_kills,
@@ -1934,6 +2537,7 @@ void HGlobalValueNumberer::ProcessLoopBlock(
   TRACE_GVN_2("Loop invariant motion for B%d %s\n",
               block->block_id(),
               *GetGVNFlagsString(depends_flags));
+  bool hoisted_transitions = false;
   HInstruction* instr = block->first();
   while (instr != NULL) {
     HInstruction* next = instr->next();
@@ -1945,10 +2549,50 @@ void HGlobalValueNumberer::ProcessLoopBlock(
                   *GetGVNFlagsString(instr->gvn_flags()),
                   *GetGVNFlagsString(loop_kills));
       bool can_hoist = !instr->gvn_flags().ContainsAnyOf(depends_flags);
+      if (!can_hoist && FLAG_trace_licm) {
+        GVNFlagSet killed = instr->gvn_flags();
+        killed.Intersect(depends_flags);
+        PrintF("Not hoisting %d (%s) in B%d out of loop B%d, loop kills %s\n",
+               instr->id(),
+               instr->Mnemonic(),
+               block->block_id(),
+               loop_header->block_id(),
+               *GetGVNFlagsString(killed));
+      }
       if (can_hoist && !graph()->use_optimistic_licm()) {
         can_hoist = block->IsLoopSuccessorDominator();
       }
 
+      if (instr->IsTransitionElementsKind()) {
+        // A transition can be hoisted out of the loop only if it is done in
+        // every iteration, and hoisting does not move it above an earlier
+        // instruction of the loop that depends on or changes what the
+        // transition changes.
+        GVNFlagSet hoist_depends_blockers =
+            HValue::ConvertChangesToDependsFlags(instr->ChangesFlags());
+        GVNFlagSet hoist_change_blockers;
+        hoist_change_blockers.Add(kChangesMaps);
+        hoist_change_blockers.Add(kChangesElementsKind);
+        HTransitionElementsKind* transition =
+            HTransitionElementsKind::cast(instr);
+        if (transition->original_map()->has_fast_double_elements()) {
+          hoist_change_blockers.Add(kChangesElementsPointer);
+          hoist_change_blockers.Add(kChangesDoubleArrayElements);
+        }
+        if (transition->transitioned_map()->has_fast_double_elements()) {
+          hoist_change_blockers.Add(kChangesElementsPointer);
+          hoist_change_blockers.Add(kChangesArrayElements);
+        }
+        bool in_nested_loop = block != loop_header &&
+            (block->parent_loop_header() != loop_header ||
+             block->IsLoopHeader());
+        can_hoist = can_hoist &&
+            !in_nested_loop &&
+            block->IsLoopSuccessorDominator() &&
+            !first_time_depends->ContainsAnyOf(hoist_depends_blockers) &&
+            !first_time_changes->ContainsAnyOf(hoist_change_blockers);
+      }
+
       if (can_hoist) {
         bool inputs_loop_invariant = true;
         for (int i = 0; i < instr->OperandCount(); ++i) {
@@ -1959,10 +2603,18 @@ void HGlobalValueNumberer::ProcessLoopBlock(
 
         if (inputs_loop_invariant && ShouldMove(instr, loop_header)) {
           TRACE_GVN_1("Hoisting loop invariant instruction %d\n", instr->id());
+          if (FLAG_trace_licm) {
+            PrintF("Hoisted %d (%s) from B%d out of loop B%d\n",
+                   instr->id(),
+                   instr->Mnemonic(),
+                   block->block_id(),
+                   loop_header->block_id());
+          }
           // Move the instruction out of the loop.
           instr->Unlink();
           instr->InsertBefore(pre_header->end());
           if (instr->HasSideEffects()) removed_side_effects_ = true;
+          if (instr->IsTransitionElementsKind()) hoisted_transitions = true;
           hoisted = true;
         }
       }
@@ -1985,6 +2637,7 @@ void HGlobalValueNumberer::ProcessLoopBlock(
     }
     instr = next;
   }
+  return hoisted_transitions;
 }
 
 
@@ -3307,6 +3960,13 @@ bool HGraph::Optimize(SmartArrayPointer<char>* bailout_reason) {
     return false;
   }
   if (FLAG_eliminate_dead_phis) EliminateUnreachablePhis();
+
+  // Scalar replacement introduces phis for the fields of replaced objects, so
+  // it has to run before the phis are collected.
+  if (FLAG_use_escape_analysis) {
+    HEscapeAnalysis escape_analysis(this);
+    escape_analysis.Analyze();
+  }
   CollectPhis();
 
   if (has_osr_loop_entry()) {
@@ -3332,6 +3992,10 @@ bool HGraph::Optimize(SmartArrayPointer<char>* bailout_reason) {
 
   Canonicalize();
 
+  // Folding has to happen before value numbering, which computes the
+  // dominating allocations for write barrier elimination.
+  if (FLAG_use_allocation_folding) FoldAllocations();
+
   // Perform common subexpression elimination and loop-invariant code motion.
   if (FLAG_use_gvn) {
     HPhase phase("H_Global value numbering", this);
@@ -3356,9 +4020,11 @@ bool HGraph::Optimize(SmartArrayPointer<char>* bailout_reason) {
   HStackCheckEliminator sce(this);
   sce.Process();
 
+  EliminateInductionVariableBoundsChecks();
   EliminateRedundantBoundsChecks();
   DehoistSimpleArrayIndexComputations();
   if (FLAG_dead_code_elimination) DeadCodeElimination();
+  if (FLAG_write_barrier_elimination) EliminateWriteBarriers();
 
   return true;
 }
@@ -3700,6 +4366,315 @@ void HGraph::EliminateRedundantBoundsChecks() {
 }
 
 
+// Bounds checks on loop induction variables.
+// An induction variable is a loop header phi that is updated by adding a
+// constant step (see HPhi::InductionVariableStep).  Its value is bounded
+// by its initial value on one side, and by the branches that guard the
+// block of a check on the other side:
+//
+//   for (var i = 0; i < a.length; i++) a[i];
+//
+// The check on i is removed if its bounds prove it.  Otherwise, if the
+// bounds are loop invariant, the check is replaced by checks of the bounds
+// in the loop pre-header, so that the loop deoptimizes at most once before
+// it starts instead of checking every iteration.
+class InductionVariableBound {
+ public:
+  InductionVariableBound() : base_(NULL), offset_(0) { }
+  InductionVariableBound(HValue* base, int32_t offset)
+      : base_(base), offset_(offset) { }
+
+  bool IsValid() const { return base_ != NULL; }
+  HValue* base() const { return base_; }
+  int32_t offset() const { return offset_; }
+
+ private:
+  HValue* base_;
+  int32_t offset_;
+};
+
+
+// Splits an integer value into "base + offset" with a constant offset.
+static HValue* SplitOffset(HValue* value, int32_t* offset) {
+  *offset = 0;
+  if (!value->IsAdd() && !value->IsSub()) return value;
+  HBinaryOperation* operation = HBinaryOperation::cast(value);
+  HValue* base = NULL;
+  HValue* constant = NULL;
+  if (operation->right()->IsConstant()) {
+    base = operation->left();
+    constant = operation->right();
+  } else if (value->IsAdd() && operation->left()->IsConstant()) {
+    base = operation->right();
+    constant = operation->left();
+  }
+  if (constant == NULL || !HConstant::cast(constant)->HasInteger32Value()) {
+    return value;
+  }
+  int32_t constant_value = HConstant::cast(constant)->Integer32Value();
+  if (constant_value == kMinInt) return value;
+  *offset = value->IsAdd() ? constant_value : -constant_value;
+  return base;
+}
+
+
+// Returns true if the two loads of the length of the same array read the
+// same value.  They are not merged by GVN when their type checks differ.
+// The first load must reach the second one through single predecessor
+// blocks, without changing array lengths on the way.
+static bool IsSameArrayLength(HJSArrayLength* a, HJSArrayLength* b) {
+  if (a->value() != b->value()) return false;
+  HBasicBlock* block = b->block();
+  HInstruction* instr = b->previous();
+  while (true) {
+    for (; instr != NULL; instr = instr->previous()) {
+      if (instr == a) return true;
+      if (instr->CheckGVNFlag(kChangesArrayLengths)) return false;
+    }
+    if (block->predecessors()->length() != 1) return false;
+    block = block->predecessors()->first();
+    instr = block->last();
+  }
+}
+
+
+// Returns true if the two integer values are known to be equal.
+static bool IsSameInteger32Value(HValue* a, HValue* b) {
+  if (a == b) return true;
+  if (a->IsChange() && b->IsChange()) {
+    HChange* change_a = HChange::cast(a);
+    HChange* change_b = HChange::cast(b);
+    return change_a->from().Equals(change_b->from()) &&
+        change_a->to().Equals(change_b->to()) &&
+        IsSameInteger32Value(change_a->value(), change_b->value());
+  }
+  if (a->IsJSArrayLength() && b->IsJSArrayLength()) {
+    return IsSameArrayLength(HJSArrayLength::cast(a),
+                             HJSArrayLength::cast(b)) ||
+        IsSameArrayLength(HJSArrayLength::cast(b), HJSArrayLength::cast(a));
+  }
+  return false;
+}
+
+
+// Collects the bounds of an induction variable that hold in the given
+// block, from the integer compares that branch to it on the way down from
+// the loop header.  The nearest compare wins.
+static void InferInductionVariableBounds(HPhi* phi,
+                                         HBasicBlock* block,
+                                         InductionVariableBound* lower,
+                                         InductionVariableBound* upper) {
+  HBasicBlock* header = phi->block();
+  for (HBasicBlock* current = block;
+       current != NULL && current != header;
+       current = current->dominator()) {
+    if (current->predecessors()->length() != 1) continue;
+    HBasicBlock* predecessor = current->predecessors()->first();
+    if (!predecessor->end()->IsCompareIDAndBranch()) continue;
+    HCompareIDAndBranch* compare =
+        HCompareIDAndBranch::cast(predecessor->end());
+    if (!compare->GetInputRepresentation().IsInteger32()) continue;
+    if (compare->FirstSuccessor() == compare->SecondSuccessor()) continue;
+    Token::Value op = compare->token();
+    if (compare->SecondSuccessor() == current) {
+      op = Token::NegateCompareOp(op);
+    }
+    // Only ordered compares bound the variable.  "i != n" does not, and
+    // neither does "i == n" on the way to its false successor.
+    if (!Token::IsOrderedRelationalCompareOp(op)) continue;
+    HValue* limit;
+    if (compare->left() == phi) {
+      limit = compare->right();
+    } else if (compare->right() == phi) {
+      limit = compare->left();
+      // Mirror the compare so that the phi is on the left.
+      switch (op) {
+        case Token::LT: op = Token::GT; break;
+        case Token::GT: op = Token::LT; break;
+        case Token::LTE: op = Token::GTE; break;
+        case Token::GTE: op = Token::LTE; break;
+        default: UNREACHABLE();
+      }
+    } else {
+      continue;
+    }
+    int32_t offset;
+    limit = SplitOffset(limit, &offset);
+    bool is_upper = op == Token::LT || op == Token::LTE;
+    bool is_lower = op == Token::GT || op == Token::GTE;
+    if (op == Token::LT) {
+      if (offset == kMinInt) continue;
+      offset--;
+    } else if (op == Token::GT) {
+      if (offset == kMaxInt) continue;
+      offset++;
+    }
+    if (is_upper && !upper->IsValid()) {
+      *upper = InductionVariableBound(limit, offset);
+    }
+    if (is_lower && !lower->IsValid()) {
+      *lower = InductionVariableBound(limit, offset);
+    }
+  }
+}
+
+
+// Returns true if "bound + offset >= 0" is known statically.
+static bool IsProvenNonNegative(InductionVariableBound bound,
+                                int32_t offset) {
+  Range* range = bound.base()->range();
+  if (range == NULL) return false;
+  return static_cast<int64_t>(range->lower()) + bound.offset() + offset >= 0;
+}
+
+
+// Returns true if "bound + offset < length" is known statically.
+static bool IsProvenBelow(InductionVariableBound bound,
+                          int32_t offset,
+                          HValue* length) {
+  int64_t total_offset = static_cast<int64_t>(bound.offset()) + offset;
+  if (IsSameInteger32Value(bound.base(), length)) return total_offset < 0;
+  Range* range = bound.base()->range();
+  Range* length_range = length->range();
+  if (range == NULL || length_range == NULL) return false;
+  return range->upper() + total_offset < length_range->lower();
+}
+
+
+static bool IsInsideLoop(HBasicBlock* block, HBasicBlock* loop_header) {
+  HBasicBlock* last = loop_header->loop_information()->GetLastBackEdge();
+  return loop_header->block_id() <= block->block_id() &&
+      block->block_id() <= last->block_id();
+}
+
+
+// Emits "bound + offset" at the end of the pre-header.  Returns NULL if the
+// sum does not fit in an integer.
+static HValue* BuildBoundInPreHeader(InductionVariableBound bound,
+                                     int32_t offset,
+                                     HValue* context,
+                                     HBasicBlock* pre_header) {
+  int64_t total_offset = static_cast<int64_t>(bound.offset()) + offset;
+  if (total_offset == 0) return bound.base();
+  if (total_offset < kMinInt || total_offset > kMaxInt) return NULL;
+  Zone* zone = pre_header->zone();
+  HConstant* constant = new(zone) HConstant(
+      static_cast<int32_t>(total_offset), Representation::Integer32());
+  constant->InsertBefore(pre_header->end());
+  HAdd* add = new(zone) HAdd(context, bound.base(), constant);
+  add->AssumeRepresentation(Representation::Integer32());
+  add->InsertBefore(pre_header->end());
+  return add;
+}
+
+
+static void TraceInductionVariableBoundsCheck(HBoundsCheck* check,
+                                              const char* action) {
+  if (FLAG_trace_array_bounds_checks_induction) {
+    PrintF("Bounds check %d on induction variable in B%d %s\n",
+           check->id(),
+           check->block()->block_id(),
+           action);
+  }
+}
+
+
+void HGraph::EliminateInductionVariableBoundsChecks() {
+  if (!FLAG_array_bounds_checks_elimination) return;
+  if (!FLAG_array_bounds_checks_induction) return;
+
+  HPhase phase("H_Induction variable bounds checks", this);
+  // Hoisted checks may deoptimize in loops that never reach the original
+  // check, so stop hoisting like GVN does once a function reoptimizes a lot.
+  bool allow_hoisting =
+      info()->shared_info()->opt_count() + 1 < FLAG_max_opt_count;
+  for (int i = 0; i < blocks()->length(); ++i) {
+    HBasicBlock* block = blocks()->at(i);
+    HInstruction* instr = block->first();
+    while (instr != NULL) {
+      HInstruction* next = instr->next();
+      if (instr->IsBoundsCheck()) {
+        HBoundsCheck* check = HBoundsCheck::cast(instr);
+        HValue* length = check->length();
+        int32_t offset;
+        HValue* base = SplitOffset(check->index(), &offset);
+        int32_t step = base->IsPhi()
+            ? HPhi::cast(base)->InductionVariableStep()
+            : 0;
+        if (step != 0 &&
+            check->index()->representation().IsInteger32() &&
+            length->representation().IsInteger32()) {
+          HPhi* phi = HPhi::cast(base);
+          InductionVariableBound lower;
+          InductionVariableBound upper;
+          InferInductionVariableBounds(phi, block, &lower, &upper);
+          int32_t initial_offset;
+          HValue* initial_base =
+              SplitOffset(phi->OperandAt(0), &initial_offset);
+          InductionVariableBound initial(initial_base, initial_offset);
+          if (step > 0 &&
+              (!lower.IsValid() || !IsProvenNonNegative(lower, offset))) {
+            lower = initial;
+          } else if (step < 0 &&
+              (!upper.IsValid() || !IsProvenBelow(upper, offset, length))) {
+            upper = initial;
+          }
+
+          bool lower_proven =
+              lower.IsValid() && IsProvenNonNegative(lower, offset);
+          bool upper_proven =
+              upper.IsValid() && IsProvenBelow(upper, offset, length);
+          if (lower_proven && upper_proven) {
+            TraceInductionVariableBoundsCheck(check, "removed");
+            check->DeleteAndReplaceWith(check->index());
+          } else if (allow_hoisting &&
+                     lower.IsValid() &&
+                     upper.IsValid() &&
+                     !block->IsDeoptimizing() &&
+                     IsInsideLoop(block, phi->block())) {
+            HBasicBlock* pre_header = phi->block()->predecessors()->at(0);
+            HValue* context =
+                HBinaryOperation::cast(phi->OperandAt(1))->context();
+            bool invariant = !length->IsDefinedAfter(pre_header) &&
+                !context->IsDefinedAfter(pre_header) &&
+                (lower_proven || !lower.base()->IsDefinedAfter(pre_header)) &&
+                (upper_proven || !upper.base()->IsDefinedAfter(pre_header)) &&
+                (lower_proven ||
+                 lower.base()->representation().IsInteger32()) &&
+                (upper_proven ||
+                 upper.base()->representation().IsInteger32());
+            if (invariant) {
+              HValue* lower_index = lower_proven
+                  ? NULL
+                  : BuildBoundInPreHeader(lower, offset, context, pre_header);
+              HValue* upper_index = upper_proven
+                  ? NULL
+                  : BuildBoundInPreHeader(upper, offset, context, pre_header);
+              if (lower_proven == (lower_index == NULL) &&
+                  upper_proven == (upper_index == NULL)) {
+                if (lower_index != NULL) {
+                  HBoundsCheck* lower_check =
+                      new(zone()) HBoundsCheck(lower_index, length);
+                  lower_check->InsertBefore(pre_header->end());
+                }
+                if (upper_index != NULL) {
+                  HBoundsCheck* upper_check =
+                      new(zone()) HBoundsCheck(upper_index, length);
+                  upper_check->InsertBefore(pre_header->end());
+                }
+                TraceInductionVariableBoundsCheck(check, "hoisted");
+                check->DeleteAndReplaceWith(check->index());
+              }
+            }
+          }
+        }
+      }
+      instr = next;
+    }
+  }
+}
+
+
 static void DehoistArrayIndex(ArrayInstructionInterface* array_operation) {
   HValue* index = array_operation->GetKey();
   if (!index->representation().IsInteger32()) return;
@@ -3788,6 +4763,235 @@ void HGraph::DehoistSimpleArrayIndexComputations() {
 }
 
 
+// Limit on the combined size of a group of folded allocations.  When new
+// space is exhausted the whole group is allocated through
+// Runtime_AllocateInNewSpace, which only accepts moderate sizes.
+static const int kMaxFoldedAllocationSize = 8 * HAllocateObject::kMaxSize;
+
+
+static int AllocationSize(HInstruction* instr) {
+  if (instr->IsAllocateObject()) return HAllocateObject::cast(instr)->size();
+  return HFastLiteral::cast(instr)->total_size();
+}
+
+
+static void FoldAllocationInto(HInstruction* instr,
+                               HInstruction* base,
+                               int offset) {
+  if (FLAG_trace_allocation_folding) {
+    PrintF("[folding allocation %d (%s) into %d (%s) at offset %d]\n",
+           instr->id(), instr->Mnemonic(), base->id(), base->Mnemonic(),
+           offset);
+  }
+  if (instr->IsAllocateObject()) {
+    HAllocateObject::cast(instr)->FoldInto(base, offset);
+  } else {
+    HFastLiteral::cast(instr)->FoldInto(base, offset);
+  }
+}
+
+
+// Tells every allocation of a finished group how many bytes are reserved
+// behind its object for the allocations that follow it.
+static void FinishAllocationGroup(ZoneList<HInstruction*>* group,
+                                  int group_size) {
+  int reserved = group_size;
+  for (int i = 0; i < group->length(); ++i) {
+    HInstruction* instr = group->at(i);
+    reserved -= AllocationSize(instr);
+    if (instr->IsAllocateObject()) {
+      HAllocateObject::cast(instr)->set_folded_size(reserved);
+    } else {
+      HFastLiteral::cast(instr)->set_folded_size(reserved);
+    }
+  }
+  ASSERT(reserved == 0);
+  group->Rewind(0);
+}
+
+
+// Conservatively determines whether an instruction might trigger a GC, which
+// would move or promote the objects of an allocation group.  Instructions
+// that are lowered to a call into a stub or the runtime must either be calls
+// or set kChangesNewSpacePromotion for this to hold.
+static bool MightTriggerGC(HInstruction* instr) {
+  if (instr->IsChange() && kSmiValueSize == 32) {
+    // Every int32 value is a smi, so tagging it does not allocate.
+    HChange* change = HChange::cast(instr);
+    if (change->from().IsInteger32() && change->to().IsTagged() &&
+        !change->value()->CheckFlag(HValue::kUint32)) {
+      return false;
+    }
+  }
+  return instr->IsCall() || instr->CheckGVNFlag(kChangesNewSpacePromotion);
+}
+
+
+// Folds inline allocations within a basic block into the first allocation
+// of their group, so that only one new space limit check is done for all of
+// them.  The first allocation reserves memory for the whole group and the
+// others just carve their objects out of it.  A group ends at any instruction
+// that might trigger a GC, because the reserved memory is not kept alive by
+// the objects that have been initialized so far.  Inlined calls split basic
+// blocks at the return, so a group continues into a block that is only
+// reached by a goto from the previous one.
+void HGraph::FoldAllocations() {
+  HPhase phase("H_Allocation folding", this);
+  ZoneList<HInstruction*> group(4, zone());
+  int group_size = 0;
+  for (int i = 0; i < blocks()->length(); ++i) {
+    HBasicBlock* block = blocks()->at(i);
+    if (i == 0 ||
+        block->predecessors()->length() != 1 ||
+        block->predecessors()->first() != blocks()->at(i - 1) ||
+        !blocks()->at(i - 1)->end()->IsGoto()) {
+      FinishAllocationGroup(&group, group_size);
+      group_size = 0;
+    }
+    for (HInstruction* instr = block->first();
+         instr != NULL;
+         instr = instr->next()) {
+      if (instr->IsAllocateObject() || instr->IsFastLiteral()) {
+        int size = AllocationSize(instr);
+        if (!group.is_empty() &&
+            group_size + size <= kMaxFoldedAllocationSize) {
+          FoldAllocationInto(instr, group.first(), group_size);
+        } else {
+          FinishAllocationGroup(&group, group_size);
+          group_size = 0;
+        }
+        group.Add(instr, zone());
+        group_size += size;
+      } else if (MightTriggerGC(instr)) {
+        FinishAllocationGroup(&group, group_size);
+        group_size = 0;
+      }
+    }
+  }
+  FinishAllocationGroup(&group, group_size);
+}
+
+
+// Updates the set of young values, i.e. the values that are known to be
+// objects allocated in new space with no GC since their allocation, for the
+// effect of the given instruction.  When |apply| is set, stores into young
+// objects are marked as not needing a write barrier.
+static void UpdateYoungValues(HInstruction* instr,
+                              BitVector* young,
+                              bool apply) {
+  if (apply && instr->IsStoreNamedField()) {
+    HStoreNamedField* store = HStoreNamedField::cast(instr);
+    if (young->Contains(store->object()->id())) {
+      if (FLAG_trace_write_barrier_elimination) {
+        PrintF("[eliminating write barrier of %d (%s) into %d]\n",
+               store->id(), store->Mnemonic(), store->object()->id());
+      }
+      store->MarkReceiverAsYoung();
+    }
+  } else if (apply && instr->IsStoreKeyedFastElement()) {
+    HStoreKeyedFastElement* store = HStoreKeyedFastElement::cast(instr);
+    if (young->Contains(store->object()->id())) {
+      if (FLAG_trace_write_barrier_elimination) {
+        PrintF("[eliminating write barrier of %d (%s) into %d]\n",
+               store->id(), store->Mnemonic(), store->object()->id());
+      }
+      store->MarkReceiverAsYoung();
+    }
+  }
+
+  // Anything that might move or promote objects, or replace the backing
+  // store of an object, ends the lifetime of all young values.
+  if (MightTriggerGC(instr) || instr->CheckGVNFlag(kChangesElementsPointer)) {
+    young->Clear();
+  }
+
+  if (instr->IsAllocateObject() || instr->IsFastLiteral()) {
+    young->Add(instr->id());
+  } else if (instr->IsLoadElements()) {
+    // The backing store of a fast literal is copied into the same allocation
+    // as the literal itself.  It is still the same backing store as long as
+    // the literal is young.
+    HValue* object = HLoadElements::cast(instr)->value();
+    if (object->IsFastLiteral() &&
+        HFastLiteral::cast(object)->has_copied_elements() &&
+        young->Contains(object->id())) {
+      young->Add(instr->id());
+    }
+  }
+}
+
+
+// Computes the young values at the start of a block as the intersection of
+// the young values at the end of its predecessors.  Predecessors that have
+// not been visited yet, i.e. back edges in the first iteration, do not
+// constrain the result.
+static void ComputeYoungValuesAtStart(HBasicBlock* block,
+                                      ZoneList<BitVector*>* young_at_end,
+                                      BitVector* young) {
+  bool first = true;
+  young->Clear();
+  for (int i = 0; i < block->predecessors()->length(); ++i) {
+    BitVector* predecessor_young =
+        young_at_end->at(block->predecessors()->at(i)->block_id());
+    if (predecessor_young == NULL) continue;
+    if (first) {
+      young->CopyFrom(*predecessor_young);
+      first = false;
+    } else {
+      young->Intersect(*predecessor_young);
+    }
+  }
+}
+
+
+// Removes the write barriers of stores into objects and backing stores that
+// are still young, i.e. allocated in new space with no GC since.  This
+// generalizes the new space dominator of HStoreNamedField to any number of
+// interleaved allocations, to fast literals and their backing stores, and to
+// control flow.  The young values are computed with a forward dataflow
+// analysis that is iterated to a fixed point because of loops.
+void HGraph::EliminateWriteBarriers() {
+  HPhase phase("H_Write barrier elimination", this);
+  int block_count = blocks()->length();
+  // The young values at the end of each block, NULL until the block has been
+  // visited.
+  ZoneList<BitVector*> young_at_end(block_count, zone());
+  young_at_end.AddBlock(NULL, block_count, zone());
+  BitVector young(GetMaximumValueID(), zone());
+
+  bool changed;
+  do {
+    changed = false;
+    for (int i = 0; i < block_count; ++i) {
+      HBasicBlock* block = blocks()->at(i);
+      ComputeYoungValuesAtStart(block, &young_at_end, &young);
+      for (HInstruction* instr = block->first();
+           instr != NULL;
+           instr = instr->next()) {
+        UpdateYoungValues(instr, &young, false);
+      }
+      if (young_at_end[i] == NULL) {
+        young_at_end[i] = new(zone()) BitVector(young, zone());
+        changed = true;
+      } else if (!young_at_end[i]->Equals(young)) {
+        young_at_end[i]->CopyFrom(young);
+        changed = true;
+      }
+    }
+  } while (changed);
+
+  for (int i = 0; i < block_count; ++i) {
+    HBasicBlock* block = blocks()->at(i);
+    ComputeYoungValuesAtStart(block, &young_at_end, &young);
+    for (HInstruction* instr = block->first();
+         instr != NULL;
+         instr = instr->next()) {
+      UpdateYoungValues(instr, &young, true);
+    }
+  }
+}
+
+
 void HGraph::DeadCodeElimination() {
   HPhase phase("H_Dead code elimination", this);
   ZoneList<HInstruction*> worklist(blocks_.length(), zone());
@@ -4400,6 +5604,90 @@ void HGraphBuilder::VisitLoopBody(IterationStatement* stmt,
 }
 
 
+bool HGraphBuilder::ShouldPeelLoop(IterationStatement* stmt) {
+  if (!FLAG_loop_peeling) return false;
+  // The OSR entry jumps into the loop header, past a peeled iteration, and
+  // an OSR entry nested in a peeled loop would be built twice.
+  if (!info()->osr_ast_id().IsNone()) return false;
+  return stmt->node_count() > 0 &&
+      stmt->node_count() <= FLAG_max_peeled_loop_nodes;
+}
+
+
+void HGraphBuilder::PeelLoopIteration(IterationStatement* stmt,
+                                      Expression* cond,
+                                      BailoutId body_id,
+                                      Statement* next,
+                                      HBasicBlock** peeled_entry,
+                                      HBasicBlock** peeled_exit) {
+  if (FLAG_trace_licm) {
+    SmartArrayPointer<char> name = function_state()->compilation_info()->
+        function()->debug_name()->ToCString();
+    PrintF("Peeling first iteration of loop at position %d in %s\n",
+           stmt->statement_pos(),
+           *name);
+  }
+  *peeled_entry = graph()->CreateBasicBlock();
+  *peeled_exit = NULL;
+  current_block()->Goto(*peeled_entry);
+  (*peeled_entry)->SetJoinId(stmt->EntryId());
+  set_current_block(*peeled_entry);
+
+  HBasicBlock* loop_successor = NULL;
+  if (cond != NULL && !cond->ToBooleanIsTrue()) {
+    HBasicBlock* body_entry = graph()->CreateBasicBlock();
+    loop_successor = graph()->CreateBasicBlock();
+    CHECK_BAILOUT(VisitForControl(cond, body_entry, loop_successor));
+    if (body_entry->HasPredecessor()) {
+      body_entry->SetJoinId(body_id);
+      set_current_block(body_entry);
+    } else {
+      set_current_block(NULL);
+    }
+    if (loop_successor->HasPredecessor()) {
+      loop_successor->SetJoinId(stmt->ExitId());
+    } else {
+      loop_successor = NULL;
+    }
+  }
+
+  // Breaks and continues in the peeled iteration target the peeled copy.
+  BreakAndContinueInfo break_info(stmt);
+  if (current_block() != NULL) {
+    BreakAndContinueScope push(&break_info, this);
+    CHECK_BAILOUT(Visit(stmt->body()));
+  }
+  HBasicBlock* body_exit =
+      JoinContinue(stmt, current_block(), break_info.continue_block());
+  if (next != NULL && body_exit != NULL) {
+    set_current_block(body_exit);
+    CHECK_BAILOUT(Visit(next));
+    body_exit = current_block();
+  }
+
+  HBasicBlock* break_block = break_info.break_block();
+  if (break_block != NULL) {
+    if (loop_successor != NULL) loop_successor->Goto(break_block);
+    break_block->SetJoinId(stmt->ExitId());
+    loop_successor = break_block;
+  }
+  *peeled_exit = loop_successor;
+  set_current_block(body_exit);
+}
+
+
+void HGraphBuilder::FinishPeeledLoop(IterationStatement* stmt,
+                                     HBasicBlock* loop_entry,
+                                     HBasicBlock* loop_exit,
+                                     HBasicBlock* peeled_entry,
+                                     HBasicBlock* peeled_exit) {
+  if (peeled_entry != NULL && loop_entry->IsLoopHeader()) {
+    loop_entry->loop_information()->set_peeled_entry(peeled_entry);
+  }
+  set_current_block(CreateJoin(loop_exit, peeled_exit, stmt->ExitId()));
+}
+
+
 void HGraphBuilder::VisitDoWhileStatement(DoWhileStatement* stmt) {
   ASSERT(!HasStackOverflow());
   ASSERT(current_block() != NULL);
@@ -4448,6 +5736,16 @@ void HGraphBuilder::VisitWhileStatement(WhileStatement* stmt) {
   ASSERT(current_block() != NULL);
   ASSERT(current_block()->HasPredecessor());
   ASSERT(current_block() != NULL);
+  HBasicBlock* peeled_entry = NULL;
+  HBasicBlock* peeled_exit = NULL;
+  if (ShouldPeelLoop(stmt)) {
+    CHECK_BAILOUT(PeelLoopIteration(stmt, stmt->cond(), stmt->BodyId(), NULL,
+                                    &peeled_entry, &peeled_exit));
+    if (current_block() == NULL) {
+      set_current_block(peeled_exit);
+      return;
+    }
+  }
   bool osr_entry = PreProcessOsrEntry(stmt);
   HBasicBlock* loop_entry = CreateLoopHeaderBlock();
   current_block()->Goto(loop_entry);
@@ -4483,7 +5781,7 @@ void HGraphBuilder::VisitWhileStatement(WhileStatement* stmt) {
                                       body_exit,
                                       loop_successor,
                                       break_info.break_block());
-  set_current_block(loop_exit);
+  FinishPeeledLoop(stmt, loop_entry, loop_exit, peeled_entry, peeled_exit);
 }
 
 
@@ -4495,6 +5793,17 @@ void HGraphBuilder::VisitForStatement(ForStatement* stmt) {
     CHECK_ALIVE(Visit(stmt->init()));
   }
   ASSERT(current_block() != NULL);
+  HBasicBlock* peeled_entry = NULL;
+  HBasicBlock* peeled_exit = NULL;
+  if (ShouldPeelLoop(stmt)) {
+    CHECK_BAILOUT(PeelLoopIteration(stmt, stmt->cond(), stmt->BodyId(),
+                                    stmt->next(), &peeled_entry,
+                                    &peeled_exit));
+    if (current_block() == NULL) {
+      set_current_block(peeled_exit);
+      return;
+    }
+  }
   bool osr_entry = PreProcessOsrEntry(stmt);
   HBasicBlock* loop_entry = CreateLoopHeaderBlock();
   current_block()->Goto(loop_entry);
@@ -4535,7 +5844,7 @@ void HGraphBuilder::VisitForStatement(ForStatement* stmt) {
                                       body_exit,
                                       loop_successor,
                                       break_info.break_block());
-  set_current_block(loop_exit);
+  FinishPeeledLoop(stmt, loop_entry, loop_exit, peeled_entry, peeled_exit);
 }
 
 
@@ -5845,6 +7154,11 @@ void HGraphBuilder::VisitAssignment(Assignment* expr) {
         // We insert a use of the old value to detect unsupported uses of const
         // variables (e.g. initialization inside a loop).
         HValue* old_value = environment()->Lookup(var);
+        // A const that may be initialized already is not supported either,
+        // e.g. one that is initialized in a loop with a peeled iteration.
+        if (old_value != graph()->GetConstantHole()) {
+          return Bailout("reinitialization of const");
+        }
         AddInstruction(new(zone()) HUseConst(old_value));
       }
     } else if (var->mode() == CONST_HARMONY) {
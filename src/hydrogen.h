@@ -214,7 +214,8 @@ class HLoopInformation: public ZoneObject {
       : back_edges_(4, zone),
         loop_header_(loop_header),
         blocks_(8, zone),
-        stack_check_(NULL) {
+        stack_check_(NULL),
+        peeled_entry_(NULL) {
     blocks_.Add(loop_header, zone);
   }
   virtual ~HLoopInformation() {}
@@ -230,6 +231,11 @@ class HLoopInformation: public ZoneObject {
     stack_check_ = stack_check;
   }
 
+  // The first block of the loop's peeled first iteration, or NULL if the
+  // loop was not peeled.
+  HBasicBlock* peeled_entry() const { return peeled_entry_; }
+  void set_peeled_entry(HBasicBlock* block) { peeled_entry_ = block; }
+
  private:
   void AddBlock(HBasicBlock* block);
 
@@ -237,6 +243,7 @@ class HLoopInformation: public ZoneObject {
   HBasicBlock* loop_header_;
   ZoneList<HBasicBlock*> blocks_;
   HStackCheck* stack_check_;
+  HBasicBlock* peeled_entry_;
 };
 
 class BoundsCheckTable;
@@ -266,8 +273,11 @@ class HGraph: public ZoneObject {
   void OrderBlocks();
   void AssignDominators();
   void ReplaceCheckedValues();
+  void EliminateInductionVariableBoundsChecks();
   void EliminateRedundantBoundsChecks();
   void DehoistSimpleArrayIndexComputations();
+  void FoldAllocations();
+  void EliminateWriteBarriers();
   void DeadCodeElimination();
   void PropagateDeoptimizingMark();
 
@@ -976,6 +986,26 @@ class HGraphBuilder: public AstVisitor {
                      HBasicBlock* loop_entry,
                      BreakAndContinueInfo* break_info);
 
+  // Loop peeling emits the first iteration of a small loop (its condition,
+  // body and next statement) ahead of the loop, so that the checks done by
+  // the first iteration dominate the loop.  On return the current block is
+  // the entry to the remaining loop or NULL, *peeled_exit is the block where
+  // the peeled iteration leaves the loop or NULL, and *peeled_entry is the
+  // first block of the peeled iteration.
+  bool ShouldPeelLoop(IterationStatement* stmt);
+  void PeelLoopIteration(IterationStatement* stmt,
+                         Expression* cond,
+                         BailoutId body_id,
+                         Statement* next,
+                         HBasicBlock** peeled_entry,
+                         HBasicBlock** peeled_exit);
+  // Joins the exits of a loop and of its peeled iteration, if any.
+  void FinishPeeledLoop(IterationStatement* stmt,
+                        HBasicBlock* loop_entry,
+                        HBasicBlock* loop_exit,
+                        HBasicBlock* peeled_entry,
+                        HBasicBlock* peeled_exit);
+
   // Create a back edge in the flow graph.  body_exit is the predecessor
   // block and loop_entry is the successor block.  loop_successor is the
   // block where control flow exits the loop normally (e.g., via failure of
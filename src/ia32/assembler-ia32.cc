@@ -2609,14 +2609,14 @@ void Assembler::dd(uint32_t data) {
 
 void Assembler::RecordRelocInfo(RelocInfo::Mode rmode, intptr_t data) {
   ASSERT(rmode != RelocInfo::NONE);
-  // Don't record external references unless the heap will be serialized.
+  // Don't record external references unless the code will be serialized.
   if (rmode == RelocInfo::EXTERNAL_REFERENCE) {
 #ifdef DEBUG
     if (!Serializer::enabled()) {
       Serializer::TooLateToEnableNow();
     }
 #endif
-    if (!Serializer::enabled() && !emit_debug_code()) {
+    if (!Serializer::code_must_be_relocatable() && !emit_debug_code()) {
       return;
     }
   }
@@ -410,7 +410,7 @@ void LCodeGen::WriteTranslation(LEnvironment* environment,
   if (environment == NULL) return;
 
   // The translation includes one command per value in the environment.
-  int translation_size = environment->values()->length();
+  int translation_size = environment->translation_size();
   // The output frame height does not include the parameters.
   int height = translation_size - environment->parameter_count();
 
@@ -461,40 +461,68 @@ void LCodeGen::WriteTranslation(LEnvironment* environment,
   }
 
   for (int i = 0; i < translation_size; ++i) {
-    LOperand* value = environment->values()->at(i);
-    // spilled_registers_ and spilled_double_registers_ are either
-    // both NULL or both set.
-    if (environment->spilled_registers() != NULL && value != NULL) {
-      if (value->IsRegister() &&
-          environment->spilled_registers()[value->index()] != NULL) {
-        translation->MarkDuplicate();
-        AddToTranslation(translation,
-                         environment->spilled_registers()[value->index()],
-                         environment->HasTaggedValueAt(i),
-                         environment->HasUint32ValueAt(i),
-                         *arguments_index,
-                         *arguments_count);
-      } else if (
-          value->IsDoubleRegister() &&
-          environment->spilled_double_registers()[value->index()] != NULL) {
-        translation->MarkDuplicate();
-        AddToTranslation(
-            translation,
-            environment->spilled_double_registers()[value->index()],
-            false,
-            false,
-            *arguments_index,
-            *arguments_count);
+    int object_index = environment->CapturedObjectIndexAt(i);
+    if (object_index >= 0) {
+      int first = environment->captured_object_first_value(object_index);
+      int length = environment->captured_object_length(object_index);
+      translation->BeginCapturedObject(
+          environment->captured_object_id(object_index), length);
+      for (int j = first; j < first + length; ++j) {
+        WriteTranslationValue(environment,
+                              translation,
+                              j,
+                              *arguments_index,
+                              *arguments_count);
       }
+    } else {
+      WriteTranslationValue(environment,
+                            translation,
+                            i,
+                            *arguments_index,
+                            *arguments_count);
     }
+  }
+}
 
-    AddToTranslation(translation,
-                     value,
-                     environment->HasTaggedValueAt(i),
-                     environment->HasUint32ValueAt(i),
-                     *arguments_index,
-                     *arguments_count);
+
+void LCodeGen::WriteTranslationValue(LEnvironment* environment,
+                                     Translation* translation,
+                                     int index,
+                                     int arguments_index,
+                                     int arguments_count) {
+  LOperand* value = environment->values()->at(index);
+  // spilled_registers_ and spilled_double_registers_ are either
+  // both NULL or both set.
+  if (environment->spilled_registers() != NULL && value != NULL) {
+    if (value->IsRegister() &&
+        environment->spilled_registers()[value->index()] != NULL) {
+      translation->MarkDuplicate();
+      AddToTranslation(translation,
+                       environment->spilled_registers()[value->index()],
+                       environment->HasTaggedValueAt(index),
+                       environment->HasUint32ValueAt(index),
+                       arguments_index,
+                       arguments_count);
+    } else if (
+        value->IsDoubleRegister() &&
+        environment->spilled_double_registers()[value->index()] != NULL) {
+      translation->MarkDuplicate();
+      AddToTranslation(
+          translation,
+          environment->spilled_double_registers()[value->index()],
+          false,
+          false,
+          arguments_index,
+          arguments_count);
+    }
   }
+
+  AddToTranslation(translation,
+                   value,
+                   environment->HasTaggedValueAt(index),
+                   environment->HasUint32ValueAt(index),
+                   arguments_index,
+                   arguments_count);
 }
 
 
@@ -4664,7 +4692,7 @@ void LCodeGen::DoCheckInstanceType(LCheckInstanceType* instr) {
 
 
 void LCodeGen::DoCheckFunction(LCheckFunction* instr) {
-  Handle<JSFunction> target = instr->hydrogen()->target();
+  Handle<HeapObject> target = instr->hydrogen()->target();
   if (isolate()->heap()->InNewSpace(*target)) {
     Register reg = ToRegister(instr->value());
     Handle<JSGlobalPropertyCell> cell =
@@ -4804,11 +4832,12 @@ void LCodeGen::DoAllocateObject(LAllocateObject* instr) {
          initial_map->unused_property_fields() -
          initial_map->inobject_properties() == 0);
 
-  // Allocate memory for the object.  The initial map might change when
-  // the constructor's prototype changes, but instance size and property
-  // counts remain unchanged (if slack tracking finished).
+  // Allocate memory for the object and the allocations folded into it.  The
+  // initial map might change when the constructor's prototype changes, but
+  // instance size and property counts remain unchanged (if slack tracking
+  // finished).
   ASSERT(!constructor->shared()->IsInobjectSlackTrackingInProgress());
-  __ AllocateInNewSpace(instance_size,
+  __ AllocateInNewSpace(instance_size + instr->hydrogen()->folded_size(),
                         result,
                         no_reg,
                         scratch,
@@ -4823,6 +4852,45 @@ void LCodeGen::DoAllocateObject(LAllocateObject* instr) {
     __ bind(&is_in_new_space);
   }
 
+  EmitInitializeObject(instr->hydrogen(), result, scratch);
+}
+
+
+void LCodeGen::DoDeferredAllocateObject(LAllocateObject* instr) {
+  Register result = ToRegister(instr->result());
+  Handle<JSFunction> constructor = instr->hydrogen()->constructor();
+  Handle<Map> initial_map(constructor->initial_map());
+  int size = initial_map->instance_size() + instr->hydrogen()->folded_size();
+
+  // TODO(3095996): Get rid of this. For now, we need to make the
+  // result register contain a valid pointer because it is already
+  // contained in the register pointer map.
+  __ Set(result, Immediate(0));
+
+  PushSafepointRegistersScope scope(this);
+  __ push(Immediate(Smi::FromInt(size)));
+  CallRuntimeFromDeferred(
+      Runtime::kAllocateInNewSpace, 1, instr, instr->context());
+  __ StoreToSafepointRegisterSlot(result, eax);
+}
+
+
+void LCodeGen::DoInnerAllocateObject(LInnerAllocateObject* instr) {
+  Register result = ToRegister(instr->result());
+  Register base = ToRegister(instr->base());
+  Register scratch = ToRegister(instr->temp());
+  __ lea(result, Operand(base, instr->hydrogen()->folding_offset()));
+  EmitInitializeObject(instr->hydrogen(), result, scratch);
+}
+
+
+void LCodeGen::EmitInitializeObject(HAllocateObject* allocation,
+                                    Register result,
+                                    Register scratch) {
+  Handle<JSFunction> constructor = allocation->constructor();
+  Handle<Map> initial_map(constructor->initial_map());
+  int instance_size = initial_map->instance_size();
+
   // Load the initial map.
   Register map = scratch;
   __ LoadHeapObject(scratch, constructor);
@@ -4857,25 +4925,21 @@ void LCodeGen::DoAllocateObject(LAllocateObject* instr) {
       __ mov(FieldOperand(result, property_offset), scratch);
     }
   }
-}
 
+  if (allocation->folded_size() != 0) {
+    EmitFreeSpaceFiller(result, instance_size, allocation->folded_size());
+  }
+}
 
-void LCodeGen::DoDeferredAllocateObject(LAllocateObject* instr) {
-  Register result = ToRegister(instr->result());
-  Handle<JSFunction> constructor = instr->hydrogen()->constructor();
-  Handle<Map> initial_map(constructor->initial_map());
-  int instance_size = initial_map->instance_size();
 
-  // TODO(3095996): Get rid of this. For now, we need to make the
-  // result register contain a valid pointer because it is already
-  // contained in the register pointer map.
-  __ Set(result, Immediate(0));
-
-  PushSafepointRegistersScope scope(this);
-  __ push(Immediate(Smi::FromInt(instance_size)));
-  CallRuntimeFromDeferred(
-      Runtime::kAllocateInNewSpace, 1, instr, instr->context());
-  __ StoreToSafepointRegisterSlot(result, eax);
+void LCodeGen::EmitFreeSpaceFiller(Register object, int offset, int size) {
+  // Smaller fillers would need the one and two pointer filler maps, but
+  // every folded allocation is at least as big as a JSObject header.
+  ASSERT(size > 2 * kPointerSize);
+  __ mov(FieldOperand(object, offset),
+         Immediate(factory()->free_space_map()));
+  __ mov(FieldOperand(object, offset + FreeSpace::kSizeOffset),
+         Immediate(Smi::FromInt(size)));
 }
 
 
@@ -5042,18 +5106,17 @@ void LCodeGen::EmitDeepCopy(Handle<JSObject> object,
 }
 
 
-void LCodeGen::DoFastLiteral(LFastLiteral* instr) {
-  ASSERT(ToRegister(instr->context()).is(esi));
-  int size = instr->hydrogen()->total_size();
+void LCodeGen::EmitFastLiteralElementsKindCheck(HFastLiteral* literal,
+                                                LEnvironment* environment) {
   ElementsKind boilerplate_elements_kind =
-      instr->hydrogen()->boilerplate()->GetElementsKind();
+      literal->boilerplate()->GetElementsKind();
 
   // Deopt if the literal boilerplate ElementsKind is of a type different than
   // the expected one. The check isn't necessary if the boilerplate has already
   // already been converted to TERMINAL_FAST_ELEMENTS_KIND.
   if (CanTransitionToMoreGeneralFastElementsKind(
           boilerplate_elements_kind, true)) {
-    __ LoadHeapObject(ebx, instr->hydrogen()->boilerplate());
+    __ LoadHeapObject(ebx, literal->boilerplate());
     __ mov(ecx, FieldOperand(ebx, HeapObject::kMapOffset));
     // Load the map's "bit field 2". We only need the first byte,
     // but the following masking takes care of that anyway.
@@ -5061,17 +5124,26 @@ void LCodeGen::DoFastLiteral(LFastLiteral* instr) {
     // Retrieve elements_kind from bit field 2.
     __ and_(ecx, Map::kElementsKindMask);
     __ cmp(ecx, boilerplate_elements_kind << Map::kElementsKindShift);
-    DeoptimizeIf(not_equal, instr->environment());
+    DeoptimizeIf(not_equal, environment);
   }
+}
 
-  // Allocate all objects that are part of the literal in one big
-  // allocation. This avoids multiple limit checks.
+
+void LCodeGen::DoFastLiteral(LFastLiteral* instr) {
+  ASSERT(ToRegister(instr->context()).is(esi));
+  int size = instr->hydrogen()->total_size();
+  int folded_size = instr->hydrogen()->folded_size();
+  EmitFastLiteralElementsKindCheck(instr->hydrogen(), instr->environment());
+
+  // Allocate all objects that are part of the literal, and the allocations
+  // folded into it, in one big allocation. This avoids multiple limit checks.
   Label allocated, runtime_allocate;
-  __ AllocateInNewSpace(size, eax, ecx, edx, &runtime_allocate, TAG_OBJECT);
+  __ AllocateInNewSpace(size + folded_size, eax, ecx, edx, &runtime_allocate,
+                        TAG_OBJECT);
   __ jmp(&allocated);
 
   __ bind(&runtime_allocate);
-  __ push(Immediate(Smi::FromInt(size)));
+  __ push(Immediate(Smi::FromInt(size + folded_size)));
   CallRuntime(Runtime::kAllocateInNewSpace, 1, instr);
 
   __ bind(&allocated);
@@ -5079,6 +5151,26 @@ void LCodeGen::DoFastLiteral(LFastLiteral* instr) {
   __ LoadHeapObject(ebx, instr->hydrogen()->boilerplate());
   EmitDeepCopy(instr->hydrogen()->boilerplate(), eax, ebx, &offset);
   ASSERT_EQ(size, offset);
+  if (folded_size != 0) EmitFreeSpaceFiller(eax, size, folded_size);
+}
+
+
+void LCodeGen::DoInnerFastLiteral(LInnerFastLiteral* instr) {
+  Register base = ToRegister(instr->base());
+  ASSERT(base.is(edx));
+  ASSERT(ToRegister(instr->result()).is(eax));
+  int size = instr->hydrogen()->total_size();
+  int folded_size = instr->hydrogen()->folded_size();
+  int folding_offset = instr->hydrogen()->folding_offset();
+  EmitFastLiteralElementsKindCheck(instr->hydrogen(), instr->environment());
+
+  // The memory for the literal has been reserved by the allocation base.
+  int offset = folding_offset;
+  __ LoadHeapObject(ebx, instr->hydrogen()->boilerplate());
+  EmitDeepCopy(instr->hydrogen()->boilerplate(), base, ebx, &offset);
+  ASSERT_EQ(folding_offset + size, offset);
+  __ lea(eax, Operand(base, folding_offset));
+  if (folded_size != 0) EmitFreeSpaceFiller(eax, size, folded_size);
 }
 
 
@@ -133,6 +133,11 @@ class LCodeGen BASE_EMBEDDED {
                         Translation* translation,
                         int* arguments_index,
                         int* arguments_count);
+  void WriteTranslationValue(LEnvironment* environment,
+                             Translation* translation,
+                             int index,
+                             int arguments_index,
+                             int arguments_count);
 
   void EnsureRelocSpaceForDeoptimization();
 
@@ -339,6 +344,20 @@ class LCodeGen BASE_EMBEDDED {
                     Register source,
                     int* offset);
 
+  void EmitFastLiteralElementsKindCheck(HFastLiteral* literal,
+                                        LEnvironment* environment);
+
+  // Emits code to initialize a freshly allocated object of the constructor's
+  // initial map, including the filler for the allocations folded into it.
+  void EmitInitializeObject(HAllocateObject* allocation,
+                            Register result,
+                            Register scratch);
+
+  // Covers |size| bytes at |offset| behind |object| with a free space filler
+  // so that the heap stays iterable until the memory reserved for folded
+  // allocations is initialized.
+  void EmitFreeSpaceFiller(Register object, int offset, int size);
+
   void EnsureSpaceForLazyDeopt();
 
   // Emits code for pushing either a tagged constant, a (non-double)
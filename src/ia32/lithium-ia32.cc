@@ -819,7 +819,9 @@ void LChunkBuilder::DoBasicBlock(HBasicBlock* block, HBasicBlock* next_block) {
     HEnvironment* last_environment = pred->last_environment();
     for (int i = 0; i < block->phis()->length(); ++i) {
       HPhi* phi = block->phis()->at(i);
-      last_environment->SetValueAt(phi->merged_index(), phi);
+      if (phi->HasMergedIndex()) {
+        last_environment->SetValueAt(phi->merged_index(), phi);
+      }
     }
     for (int i = 0; i < block->deleted_phis()->length(); ++i) {
       last_environment->SetValueAt(block->deleted_phis()->at(i),
@@ -880,17 +882,27 @@ LEnvironment* LChunkBuilder::CreateEnvironment(
   ASSERT(!ast_id.IsNone() ||
          hydrogen_env->frame_type() != JS_FUNCTION);
   int value_count = hydrogen_env->length();
+  // The field values of captured objects follow the frame values.
+  int field_count = 0;
+  for (int i = 0; i < value_count; ++i) {
+    HValue* value = hydrogen_env->values()->at(i);
+    if (value->IsCapturedObject()) {
+      field_count += HCapturedObject::cast(value)->length();
+    }
+  }
   LEnvironment* result =
       new(zone()) LEnvironment(hydrogen_env->closure(),
                                hydrogen_env->frame_type(),
                                ast_id,
                                hydrogen_env->parameter_count(),
                                argument_count_,
-                               value_count,
+                               value_count + field_count,
                                outer,
                                hydrogen_env->entry(),
                                zone());
   int argument_index = *argument_index_accumulator;
+  ZoneList<HCapturedObject*> captured_objects(0, zone());
+  ZoneList<int> captured_indexes(0, zone());
   for (int i = 0; i < value_count; ++i) {
     if (hydrogen_env->is_special_index(i)) continue;
 
@@ -898,6 +910,11 @@ LEnvironment* LChunkBuilder::CreateEnvironment(
     LOperand* op = NULL;
     if (value->IsArgumentsObject()) {
       op = NULL;
+    } else if (value->IsCapturedObject()) {
+      // Described by the field values added below.
+      captured_objects.Add(HCapturedObject::cast(value), zone());
+      captured_indexes.Add(result->values()->length(), zone());
+      op = NULL;
     } else if (value->IsPushArgument()) {
       op = new(zone()) LArgument(argument_index++);
     } else {
@@ -908,6 +925,19 @@ LEnvironment* LChunkBuilder::CreateEnvironment(
                      value->CheckFlag(HInstruction::kUint32));
   }
 
+  for (int i = 0; i < captured_objects.length(); ++i) {
+    HCapturedObject* object = captured_objects[i];
+    result->AddCapturedObject(captured_indexes[i],
+                              object->capture_id(),
+                              object->length());
+    for (int j = 0; j < object->length(); ++j) {
+      HValue* value = object->OperandAt(j);
+      result->AddValue(UseAny(value),
+                       value->representation(),
+                       value->CheckFlag(HInstruction::kUint32));
+    }
+  }
+
   if (hydrogen_env->frame_type() == JS_FUNCTION) {
     *argument_index_accumulator = argument_index;
   }
@@ -2186,6 +2216,12 @@ LInstruction* LChunkBuilder::DoStringLength(HStringLength* instr) {
 
 
 LInstruction* LChunkBuilder::DoAllocateObject(HAllocateObject* instr) {
+  if (instr->IsFolded()) {
+    LOperand* base = UseRegister(instr->allocation_base());
+    LInnerAllocateObject* result =
+        new(zone()) LInnerAllocateObject(base, TempRegister());
+    return DefineAsRegister(result);
+  }
   LOperand* context = UseFixed(instr->context(), esi);
   LOperand* temp = TempRegister();
   LAllocateObject* result = new(zone()) LAllocateObject(context, temp);
@@ -2194,6 +2230,13 @@ LInstruction* LChunkBuilder::DoAllocateObject(HAllocateObject* instr) {
 
 
 LInstruction* LChunkBuilder::DoFastLiteral(HFastLiteral* instr) {
+  if (instr->IsFolded()) {
+    // The deep copy uses fixed registers, see LCodeGen::EmitDeepCopy.
+    LOperand* base = UseFixed(instr->allocation_base(), edx);
+    LInnerFastLiteral* result =
+        new(zone()) LInnerFastLiteral(base, FixedTemp(ebx), FixedTemp(ecx));
+    return AssignEnvironment(DefineFixed(result, eax));
+  }
   LOperand* context = UseFixed(instr->context(), esi);
   return MarkAsCall(
       DefineFixed(new(zone()) LFastLiteral(context), eax), instr);
@@ -2269,6 +2312,14 @@ LInstruction* LChunkBuilder::DoCallStub(HCallStub* instr) {
 }
 
 
+LInstruction* LChunkBuilder::DoCapturedObject(HCapturedObject* instr) {
+  // Captured objects generate no code, they only update the state of the
+  // object in the deoptimization environment.
+  instr->ReplayEnvironment(current_block_->last_environment());
+  return NULL;
+}
+
+
 LInstruction* LChunkBuilder::DoArgumentsObject(HArgumentsObject* instr) {
   // There are no real uses of the arguments object.
   // arguments.length and element access are supported directly on
@@ -40,15 +40,18 @@
 #include "isolate.h"
 #include "lithium-allocator.h"
 #include "log.h"
+#include "marking-thread.h"
 #include "messages.h"
 #include "platform.h"
 #include "regexp-stack.h"
 #include "runtime-profiler.h"
+#include "scavenger-thread.h"
 #include "scopeinfo.h"
 #include "serialize.h"
 #include "simulator.h"
 #include "spaces.h"
 #include "stub-cache.h"
+#include "sweeper-thread.h"
 #include "version.h"
 #include "vm-state-inl.h"
 
@@ -1530,6 +1533,7 @@ Isolate::Isolate()
       descriptor_lookup_cache_(NULL),
       handle_scope_implementer_(NULL),
       unicode_cache_(NULL),
+      zone_segment_pool_(this),
       runtime_zone_(this),
       in_use_list_(0),
       free_list_(0),
@@ -1547,6 +1551,9 @@ Isolate::Isolate()
       context_exit_happened_(false),
       deferred_handles_head_(NULL),
       optimizing_compiler_thread_(this),
+      sweeper_thread_(NULL),
+      marking_thread_(NULL),
+      scavenger_thread_(NULL),
       abort_on_uncaught_exception_callback_(NULL) {
   TRACE_ISOLATE(constructor);
 
@@ -1630,6 +1637,36 @@ void Isolate::Deinit() {
 
     if (FLAG_parallel_recompilation) optimizing_compiler_thread_.Stop();
 
+    if (sweeper_thread_ != NULL) {
+      if (heap_.mark_compact_collector()->IsConcurrentSweepingInProgress()) {
+        heap_.mark_compact_collector()->WaitUntilSweepingCompleted();
+      }
+      for (int i = 0; i < FLAG_sweeper_threads; i++) {
+        sweeper_thread_[i]->Stop();
+        delete sweeper_thread_[i];
+      }
+      delete[] sweeper_thread_;
+      sweeper_thread_ = NULL;
+    }
+
+    if (marking_thread_ != NULL) {
+      for (int i = 0; i < FLAG_marking_threads; i++) {
+        marking_thread_[i]->Stop();
+        delete marking_thread_[i];
+      }
+      delete[] marking_thread_;
+      marking_thread_ = NULL;
+    }
+
+    if (scavenger_thread_ != NULL) {
+      for (int i = 0; i < FLAG_scavenger_threads; i++) {
+        scavenger_thread_[i]->Stop();
+        delete scavenger_thread_[i];
+      }
+      delete[] scavenger_thread_;
+      scavenger_thread_ = NULL;
+    }
+
     if (FLAG_hydrogen_stats) HStatistics::Instance()->Print();
 
     // We must stop the logger before we tear down other components.
@@ -1659,6 +1696,8 @@ void Isolate::Deinit() {
     heap_.TearDown();
     logger_->TearDown();
 
+    zone_segment_pool_.Clear();
+
     // The default isolate is re-initializable due to legacy API.
     state_ = UNINITIALIZED;
   }
@@ -1957,8 +1996,8 @@ bool Isolate::Init(Deserializer* des) {
   if (create_heap_objects &&
       (FLAG_log_code || FLAG_ll_prof || logger_->is_logging_code_events())) {
     HandleScope scope;
-    LOG(this, LogCodeObjects());
-    LOG(this, LogCompiledFunctions());
+    LOG_CODE_EVENT(this, LogCodeObjects());
+    LOG_CODE_EVENT(this, LogCompiledFunctions());
   }
 
   CHECK_EQ(static_cast<int>(OFFSET_OF(Isolate, state_)),
@@ -1971,6 +2010,30 @@ bool Isolate::Init(Deserializer* des) {
   state_ = INITIALIZED;
   time_millis_at_init_ = OS::TimeCurrentMillis();
   if (FLAG_parallel_recompilation) optimizing_compiler_thread_.Start();
+
+  if (FLAG_concurrent_sweeping && FLAG_sweeper_threads > 0) {
+    sweeper_thread_ = new SweeperThread*[FLAG_sweeper_threads];
+    for (int i = 0; i < FLAG_sweeper_threads; i++) {
+      sweeper_thread_[i] = new SweeperThread(this);
+      sweeper_thread_[i]->Start();
+    }
+  }
+
+  if (FLAG_parallel_marking && FLAG_marking_threads > 0) {
+    marking_thread_ = new MarkingThread*[FLAG_marking_threads];
+    for (int i = 0; i < FLAG_marking_threads; i++) {
+      marking_thread_[i] = new MarkingThread(this, i);
+      marking_thread_[i]->Start();
+    }
+  }
+
+  if (FLAG_parallel_scavenge && FLAG_scavenger_threads > 0) {
+    scavenger_thread_ = new ScavengerThread*[FLAG_scavenger_threads];
+    for (int i = 0; i < FLAG_scavenger_threads; i++) {
+      scavenger_thread_[i] = new ScavengerThread(this, i);
+      scavenger_thread_[i]->Start();
+    }
+  }
   return true;
 }
 
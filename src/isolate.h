@@ -70,13 +70,16 @@ class HeapProfiler;
 class InlineRuntimeFunctionsTable;
 class NoAllocationStringAllocator;
 class InnerPointerToCodeCache;
+class MarkingThread;
 class PreallocatedMemoryThread;
 class RegExpStack;
 class SaveContext;
+class ScavengerThread;
 class UnicodeCache;
 class StringInputBuffer;
 class StringTracker;
 class StubCache;
+class SweeperThread;
 class ThreadManager;
 class ThreadState;
 class ThreadVisitor;  // Defined in v8threads.h
@@ -869,6 +872,7 @@ class Isolate {
     return handle_scope_implementer_;
   }
   Zone* runtime_zone() { return &runtime_zone_; }
+  ZoneSegmentPool* zone_segment_pool() { return &zone_segment_pool_; }
 
   UnicodeCache* unicode_cache() {
     return unicode_cache_;
@@ -1069,6 +1073,24 @@ class Isolate {
     return &optimizing_compiler_thread_;
   }
 
+  // NULL unless concurrent sweeping is enabled; otherwise an array of
+  // FLAG_sweeper_threads threads.
+  SweeperThread** sweeper_threads() {
+    return sweeper_thread_;
+  }
+
+  // NULL unless parallel marking is enabled; otherwise an array of
+  // FLAG_marking_threads threads.
+  MarkingThread** marking_threads() {
+    return marking_thread_;
+  }
+
+  // NULL unless parallel scavenging is enabled; otherwise an array of
+  // FLAG_scavenger_threads threads.
+  ScavengerThread** scavenger_threads() {
+    return scavenger_thread_;
+  }
+
  private:
   Isolate();
 
@@ -1219,6 +1241,8 @@ class Isolate {
   v8::ImplementationUtilities::HandleScopeData handle_scope_data_;
   HandleScopeImplementer* handle_scope_implementer_;
   UnicodeCache* unicode_cache_;
+  // Zones return their segments to the pool, so it must outlive them.
+  ZoneSegmentPool zone_segment_pool_;
   Zone runtime_zone_;
   PreallocatedStorage in_use_list_;
   PreallocatedStorage free_list_;
@@ -1294,16 +1318,22 @@ class Isolate {
 
   DeferredHandles* deferred_handles_head_;
   OptimizingCompilerThread optimizing_compiler_thread_;
+  SweeperThread** sweeper_thread_;
+  MarkingThread** marking_thread_;
+  ScavengerThread** scavenger_thread_;
 
   abort_on_uncaught_exception_t abort_on_uncaught_exception_callback_;
 
   friend class ExecutionAccess;
   friend class HandleScopeImplementer;
   friend class IsolateInitializer;
+  friend class MarkingThread;
   friend class OptimizingCompilerThread;
+  friend class ScavengerThread;
   friend class ThreadManager;
   friend class Simulator;
   friend class StackGuard;
+  friend class SweeperThread;
   friend class ThreadId;
   friend class TestMemoryAllocatorScope;
   friend class v8::Isolate;
@@ -31,14 +31,52 @@
 #include "v8.h"
 
 #include "char-predicates-inl.h"
+#include "compiler-intrinsics.h"
 #include "v8conversions.h"
 #include "messages.h"
 #include "spaces-inl.h"
 #include "token.h"
 
+#ifdef V8_HOST_CAN_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace v8 {
 namespace internal {
 
+// Returns the position of the first quote, backslash or control character
+// in chars[start..end[, or end if there is none. The characters in between
+// can be copied into a JSON string value unchanged.
+inline int ScanJsonStringCharacters(const char* chars, int start, int end) {
+  int position = start;
+#ifdef V8_HOST_CAN_USE_SSE2
+  // Compare 16 characters at a time. ASCII strings only contain characters
+  // up to 0x7f, so the signed comparison finds exactly the control
+  // characters.
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i space = _mm_set1_epi8(0x20);
+  for (; position + 16 <= end; position += 16) {
+    __m128i block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars + position));
+    __m128i special = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(block, quote),
+                     _mm_cmpeq_epi8(block, backslash)),
+        _mm_cmplt_epi8(block, space));
+    int mask = _mm_movemask_epi8(special);
+    if (mask != 0) {
+      return position + CompilerIntrinsics::CountTrailingZeros(mask);
+    }
+  }
+#endif
+  for (; position < end; position++) {
+    char c = chars[position];
+    if (c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20) break;
+  }
+  return position;
+}
+
+
 // A simple json parser.
 template <bool seq_ascii>
 class JsonParser BASE_EMBEDDED {
@@ -502,6 +540,23 @@ Handle<String> JsonParser<seq_ascii>::SlowScanJsonString(
   String::WriteToFlat(*prefix, dest, start, end);
 
   while (c0_ != '"') {
+    if (seq_ascii && FLAG_json_vector_scan) {
+      // Copy the characters up to the next special one in bulk, as far as
+      // they fit into seq_str.
+      int run_end = ScanJsonStringCharacters(
+          seq_source_->GetChars(),
+          position_,
+          Min(source_length_, position_ + length - count));
+      if (run_end > position_) {
+        CopyChars(seq_str->GetChars() + count,
+                  seq_source_->GetChars() + position_,
+                  run_end - position_);
+        count += run_end - position_;
+        position_ = run_end - 1;
+        Advance();
+        continue;
+      }
+    }
     // Check for control character (0x00-0x1f) or unterminated string (<0).
     if (c0_ < 0x20) return Handle<String>::null();
     if (count >= length) {
@@ -654,7 +709,19 @@ Handle<String> JsonParser<seq_ascii>::ScanJsonString() {
 
   int beg_pos = position_;
   // Fast case for ASCII only without escape characters.
-  do {
+  if (seq_ascii && FLAG_json_vector_scan) {
+    position_ = ScanJsonStringCharacters(
+        seq_source_->GetChars(), position_, source_length_) - 1;
+    Advance();
+    if (c0_ == '\\') {
+      return SlowScanJsonString<SeqAsciiString, char>(source_,
+                                                      beg_pos,
+                                                      position_);
+    }
+    // Check for control character (0x00-0x1f) or unterminated string (<0).
+    if (c0_ != '"') return Handle<String>::null();
+  }
+  while (c0_ != '"') {
     // Check for control character (0x00-0x1f) or unterminated string (<0).
     if (c0_ < 0x20) return Handle<String>::null();
     if (c0_ != '\\') {
@@ -670,7 +737,7 @@ Handle<String> JsonParser<seq_ascii>::ScanJsonString() {
                                                       beg_pos,
                                                       position_);
     }
-  } while (c0_ != '"');
+  }
   int length = position_ - beg_pos;
   Handle<String> result;
   if (seq_ascii && is_symbol) {
@@ -0,0 +1,607 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef V8_JSON_STRINGIFIER_H_
+#define V8_JSON_STRINGIFIER_H_
+
+#include "v8.h"
+
+#include "v8conversions.h"
+
+namespace v8 {
+namespace internal {
+
+// Serializes a value the way JSON.stringify does when it is called with
+// neither a replacer nor a gap.
+//
+// The serializer never runs JavaScript code. Whenever the result could
+// depend on user code (toJSON methods, accessors, interceptors, proxies,
+// wrapper objects) or the JavaScript serializer would throw (circular
+// structures, stack overflow, results that are too long) it gives up, and
+// the caller redoes the whole serialization in JavaScript. Since nothing
+// observable has happened at that point, the fallback is transparent.
+class BasicJsonStringifier BASE_EMBEDDED {
+ public:
+  explicit BasicJsonStringifier(Isolate* isolate);
+
+  // Returns the JSON text for the object, undefined if the object has no
+  // JSON representation, or false if the JavaScript serializer has to be
+  // used instead.
+  MaybeObject* Stringify(Handle<Object> object);
+
+ private:
+  static const int kInitialCapacity = 32;
+  static const int kCapacityGrowthFactor = 2;
+
+  enum Result { UNCHANGED, SUCCESS, BAILOUT };
+
+  // Serializes the object. Returns UNCHANGED without writing anything for
+  // undefined and functions, which are left out of objects and turned into
+  // null in arrays.
+  Result Serialize(Handle<Object> object);
+  Result SerializeJSArray(Handle<JSArray> object);
+  Result SerializeJSObject(Handle<JSObject> object);
+  Result SerializeProperty(Handle<String> key,
+                           Handle<Object> value,
+                           bool* comma);
+  void SerializeSmi(Smi* object);
+  void SerializeDouble(double number);
+  void SerializeString(Handle<String> object);
+
+  template <typename SrcChar, typename DestChar>
+  static inline DestChar* WriteQuotedString(Vector<const SrcChar> src,
+                                            DestChar* dest);
+
+  // Returns true if some object on the prototype chain of the object has a
+  // toJSON property, or if that cannot be told without running user code.
+  bool HasToJson(Handle<JSReceiver> object);
+
+  // Returns true if reading a hole of the array gives undefined.
+  bool HolesReadAsUndefined(Handle<JSArray> object);
+
+  // Maintain the stack of objects being serialized for cycle detection.
+  bool StackPush(Handle<JSReceiver> object);
+  void StackPop() { stack_.RemoveLast(); }
+
+  // The output is accumulated in a sequential string that is replaced by a
+  // copy of twice the size when it runs full. It starts out as an ASCII
+  // string and is converted to a two-byte string the first time a
+  // non-ASCII character is written.
+  bool EnsureCapacity(int length);
+  void ChangeEncoding();
+  Handle<String> Finish();
+
+  inline void Append(char c);
+  inline void Append(const char* chars);
+
+  SeqString* buffer() { return SeqString::cast(buffer_holder_->get(0)); }
+
+  Isolate* isolate_;
+  Handle<String> tojson_symbol_;
+  // The buffer is kept in a fixed array allocated in the outermost handle
+  // scope so that it survives being replaced inside nested scopes.
+  Handle<FixedArray> buffer_holder_;
+  int capacity_;
+  int index_;
+  bool is_ascii_;
+  // Set when the result exceeds the maximal string length.
+  bool overflowed_;
+  List<Handle<JSReceiver> > stack_;
+};
+
+
+BasicJsonStringifier::BasicJsonStringifier(Isolate* isolate)
+    : isolate_(isolate),
+      capacity_(kInitialCapacity),
+      index_(0),
+      is_ascii_(true),
+      overflowed_(false) {
+  Factory* factory = isolate->factory();
+  tojson_symbol_ = factory->LookupAsciiSymbol("toJSON");
+  Handle<String> buffer = factory->NewRawAsciiString(kInitialCapacity);
+  buffer_holder_ = factory->NewFixedArray(1);
+  buffer_holder_->set(0, *buffer);
+}
+
+
+MaybeObject* BasicJsonStringifier::Stringify(Handle<Object> object) {
+  Heap* heap = isolate_->heap();
+  switch (Serialize(object)) {
+    case UNCHANGED:
+      return heap->undefined_value();
+    case SUCCESS:
+      if (overflowed_) return heap->false_value();
+      return *Finish();
+    case BAILOUT:
+      return heap->false_value();
+  }
+  UNREACHABLE();
+  return NULL;
+}
+
+
+BasicJsonStringifier::Result BasicJsonStringifier::Serialize(
+    Handle<Object> object) {
+  if (object->IsSmi()) {
+    SerializeSmi(Smi::cast(*object));
+    return SUCCESS;
+  }
+  if (object->IsString()) {
+    SerializeString(Handle<String>::cast(object));
+    return SUCCESS;
+  }
+  switch (HeapObject::cast(*object)->map()->instance_type()) {
+    case HEAP_NUMBER_TYPE:
+      SerializeDouble(HeapNumber::cast(*object)->value());
+      return SUCCESS;
+    case ODDBALL_TYPE:
+      switch (Oddball::cast(*object)->kind()) {
+        case Oddball::kFalse:
+          Append("false");
+          return SUCCESS;
+        case Oddball::kTrue:
+          Append("true");
+          return SUCCESS;
+        case Oddball::kNull:
+          Append("null");
+          return SUCCESS;
+        case Oddball::kUndefined:
+          return UNCHANGED;
+        default:
+          return BAILOUT;
+      }
+    case JS_FUNCTION_TYPE:
+      if (HasToJson(Handle<JSReceiver>::cast(object))) return BAILOUT;
+      return UNCHANGED;
+    case JS_ARRAY_TYPE:
+      return SerializeJSArray(Handle<JSArray>::cast(object));
+    case JS_OBJECT_TYPE:
+      return SerializeJSObject(Handle<JSObject>::cast(object));
+    default:
+      // Wrapper objects are unwrapped by calling valueOf or toString, and
+      // all other receivers are too rare to be worth handling here.
+      return BAILOUT;
+  }
+}
+
+
+BasicJsonStringifier::Result BasicJsonStringifier::SerializeJSArray(
+    Handle<JSArray> object) {
+  if (HasToJson(object)) return BAILOUT;
+  if (!object->length()->IsSmi()) return BAILOUT;
+  int length = Smi::cast(object->length())->value();
+  if (length == 0) {
+    Append("[]");
+    return SUCCESS;
+  }
+  if (!StackPush(object)) return BAILOUT;
+  HandleScope scope(isolate_);
+  Result result = SUCCESS;
+  Append('[');
+  switch (object->GetElementsKind()) {
+    case FAST_SMI_ELEMENTS: {
+      Handle<FixedArray> elements(FixedArray::cast(object->elements()));
+      for (int i = 0; i < length; i++) {
+        if (i > 0) Append(',');
+        SerializeSmi(Smi::cast(elements->get(i)));
+      }
+      break;
+    }
+    case FAST_DOUBLE_ELEMENTS:
+    case FAST_HOLEY_DOUBLE_ELEMENTS: {
+      Handle<FixedDoubleArray> elements(
+          FixedDoubleArray::cast(object->elements()));
+      for (int i = 0; i < length; i++) {
+        if (i > 0) Append(',');
+        if (elements->is_the_hole(i)) {
+          if (!HolesReadAsUndefined(object)) {
+            result = BAILOUT;
+            break;
+          }
+          Append("null");
+        } else {
+          SerializeDouble(elements->get_scalar(i));
+        }
+      }
+      break;
+    }
+    case FAST_HOLEY_SMI_ELEMENTS:
+    case FAST_ELEMENTS:
+    case FAST_HOLEY_ELEMENTS: {
+      Handle<FixedArray> elements(FixedArray::cast(object->elements()));
+      for (int i = 0; i < length; i++) {
+        if (i > 0) Append(',');
+        if (elements->is_the_hole(i)) {
+          if (!HolesReadAsUndefined(object)) {
+            result = BAILOUT;
+            break;
+          }
+          Append("null");
+          continue;
+        }
+        Result element_result =
+            Serialize(Handle<Object>(elements->get(i), isolate_));
+        if (element_result == BAILOUT) {
+          result = BAILOUT;
+          break;
+        }
+        if (element_result == UNCHANGED) Append("null");
+      }
+      break;
+    }
+    default:
+      result = BAILOUT;
+      break;
+  }
+  Append(']');
+  StackPop();
+  return result;
+}
+
+
+BasicJsonStringifier::Result BasicJsonStringifier::SerializeJSObject(
+    Handle<JSObject> object) {
+  if (object->IsAccessCheckNeeded() ||
+      object->map()->has_named_interceptor() ||
+      object->map()->has_indexed_interceptor() ||
+      object->map()->has_instance_call_handler()) {
+    return BAILOUT;
+  }
+  // Elements would have to be serialized before the named properties.
+  if (object->elements()->length() != 0) return BAILOUT;
+  if (HasToJson(object)) return BAILOUT;
+  if (!StackPush(object)) return BAILOUT;
+  HandleScope scope(isolate_);
+  Result result = SUCCESS;
+  bool comma = false;
+  Append('{');
+  if (object->HasFastProperties()) {
+    // The descriptors are in enumeration order.
+    Handle<Map> map(object->map());
+    int limit = map->NumberOfOwnDescriptors();
+    for (int i = 0; i < limit && result != BAILOUT; i++) {
+      DescriptorArray* descs = map->instance_descriptors();
+      PropertyDetails details = descs->GetDetails(i);
+      if (details.IsDontEnum()) continue;
+      Handle<Object> value;
+      switch (details.type()) {
+        case FIELD:
+          value = Handle<Object>(
+              object->FastPropertyAt(descs->GetFieldIndex(i)), isolate_);
+          break;
+        case CONSTANT_FUNCTION:
+          value = Handle<Object>(descs->GetConstantFunction(i), isolate_);
+          break;
+        default:
+          // Accessors have to be called.
+          result = BAILOUT;
+          continue;
+      }
+      Handle<String> key(descs->GetKey(i), isolate_);
+      result = SerializeProperty(key, value, &comma);
+    }
+  } else {
+    Handle<FixedArray> keys = GetEnumPropertyKeys(object, false);
+    for (int i = 0; i < keys->length() && result != BAILOUT; i++) {
+      Handle<String> key(String::cast(keys->get(i)), isolate_);
+      LookupResult lookup(isolate_);
+      object->LocalLookupRealNamedProperty(*key, &lookup);
+      if (!lookup.IsFound() ||
+          !(lookup.IsNormal() || lookup.IsField() ||
+            lookup.IsConstantFunction())) {
+        // Accessors have to be called.
+        result = BAILOUT;
+        continue;
+      }
+      Handle<Object> value(lookup.GetLazyValue(), isolate_);
+      result = SerializeProperty(key, value, &comma);
+    }
+  }
+  Append('}');
+  StackPop();
+  return result;
+}
+
+
+BasicJsonStringifier::Result BasicJsonStringifier::SerializeProperty(
+    Handle<String> key,
+    Handle<Object> value,
+    bool* comma) {
+  // The key is written before it is known whether the value has a JSON
+  // representation, and is dropped again if it does not.
+  int mark = index_;
+  if (*comma) Append(',');
+  SerializeString(key);
+  Append(':');
+  Result result = Serialize(value);
+  if (result == UNCHANGED) {
+    index_ = mark;
+    return SUCCESS;
+  }
+  *comma = true;
+  return result;
+}
+
+
+void BasicJsonStringifier::SerializeSmi(Smi* object) {
+  static const int kBufferSize = 100;
+  char chars[kBufferSize];
+  Vector<char> buffer(chars, kBufferSize);
+  Append(IntToCString(object->value(), buffer));
+}
+
+
+void BasicJsonStringifier::SerializeDouble(double number) {
+  if (isinf(number) || isnan(number)) {
+    Append("null");
+    return;
+  }
+  char chars[kDoubleToCStringMinBufferSize];
+  Vector<char> buffer(chars, kDoubleToCStringMinBufferSize);
+  Append(DoubleToCString(number, buffer));
+}
+
+
+// Characters below the space, quotes and backslashes are escaped; all other
+// characters, including non-ASCII ones, are copied unchanged.
+template <typename Char>
+static inline bool DoNotEscape(Char c) {
+  return c >= 0x20 && c != '"' && c != '\\';
+}
+
+
+template <typename Char>
+static inline int EscapedLength(Char c) {
+  if (DoNotEscape(c)) return 1;
+  switch (c) {
+    case '"':
+    case '\\':
+    case '\b':
+    case '\f':
+    case '\n':
+    case '\r':
+    case '\t':
+      return 2;
+    default:
+      return 6;
+  }
+}
+
+
+template <typename SrcChar, typename DestChar>
+DestChar* BasicJsonStringifier::WriteQuotedString(Vector<const SrcChar> src,
+                                                  DestChar* dest) {
+  static const char kHexChars[] = "0123456789abcdef";
+  *dest++ = '"';
+  for (int i = 0; i < src.length(); i++) {
+    SrcChar c = src[i];
+    if (DoNotEscape(c)) {
+      *dest++ = static_cast<DestChar>(c);
+      continue;
+    }
+    *dest++ = '\\';
+    switch (c) {
+      case '"': *dest++ = '"'; break;
+      case '\\': *dest++ = '\\'; break;
+      case '\b': *dest++ = 'b'; break;
+      case '\f': *dest++ = 'f'; break;
+      case '\n': *dest++ = 'n'; break;
+      case '\r': *dest++ = 'r'; break;
+      case '\t': *dest++ = 't'; break;
+      default:
+        *dest++ = 'u';
+        *dest++ = '0';
+        *dest++ = '0';
+        *dest++ = kHexChars[c >> 4];
+        *dest++ = kHexChars[c & 0xf];
+        break;
+    }
+  }
+  *dest++ = '"';
+  return dest;
+}
+
+
+void BasicJsonStringifier::SerializeString(Handle<String> object) {
+  object = FlattenGetString(object);
+  int length = 2;
+  bool is_ascii = true;
+  {
+    AssertNoAllocation no_allocation;
+    String::FlatContent flat = object->GetFlatContent();
+    if (flat.IsAscii()) {
+      Vector<const char> chars = flat.ToAsciiVector();
+      for (int i = 0; i < chars.length(); i++) {
+        length += EscapedLength(chars[i]);
+      }
+    } else {
+      Vector<const uc16> chars = flat.ToUC16Vector();
+      for (int i = 0; i < chars.length(); i++) {
+        uc16 c = chars[i];
+        if (c > String::kMaxAsciiCharCode) is_ascii = false;
+        length += EscapedLength(c);
+      }
+    }
+  }
+  if (!is_ascii && is_ascii_) ChangeEncoding();
+  if (!EnsureCapacity(length)) return;
+
+  AssertNoAllocation no_allocation;
+  String::FlatContent flat = object->GetFlatContent();
+  if (is_ascii_) {
+    char* dest = SeqAsciiString::cast(buffer())->GetChars() + index_;
+    if (flat.IsAscii()) {
+      WriteQuotedString(flat.ToAsciiVector(), dest);
+    } else {
+      WriteQuotedString(flat.ToUC16Vector(), dest);
+    }
+  } else {
+    uc16* dest = SeqTwoByteString::cast(buffer())->GetChars() + index_;
+    if (flat.IsAscii()) {
+      WriteQuotedString(flat.ToAsciiVector(), dest);
+    } else {
+      WriteQuotedString(flat.ToUC16Vector(), dest);
+    }
+  }
+  index_ += length;
+}
+
+
+bool BasicJsonStringifier::HasToJson(Handle<JSReceiver> object) {
+  LookupResult lookup(isolate_);
+  object->Lookup(*tojson_symbol_, &lookup);
+  // Interceptors and proxies on the prototype chain are found as well.
+  return lookup.IsFound();
+}
+
+
+bool BasicJsonStringifier::HolesReadAsUndefined(Handle<JSArray> object) {
+  Heap* heap = isolate_->heap();
+  for (Object* prototype = object->GetPrototype();
+       !prototype->IsNull();
+       prototype = JSObject::cast(prototype)->GetPrototype()) {
+    if (!prototype->IsJSObject()) return false;
+    JSObject* holder = JSObject::cast(prototype);
+    if (holder->IsAccessCheckNeeded() ||
+        holder->map()->has_indexed_interceptor() ||
+        holder->elements() != heap->empty_fixed_array()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+bool BasicJsonStringifier::StackPush(Handle<JSReceiver> object) {
+  StackLimitCheck check(isolate_);
+  if (check.HasOverflowed()) return false;
+  for (int i = 0; i < stack_.length(); i++) {
+    if (*stack_[i] == *object) return false;
+  }
+  stack_.Add(object);
+  return true;
+}
+
+
+bool BasicJsonStringifier::EnsureCapacity(int length) {
+  if (overflowed_) return false;
+  if (capacity_ - index_ >= length) return true;
+  int max_length = is_ascii_ ? SeqAsciiString::kMaxLength
+                             : SeqTwoByteString::kMaxLength;
+  if (length > max_length - index_) {
+    overflowed_ = true;
+    return false;
+  }
+  int new_capacity = index_ + length;
+  if (capacity_ <= max_length / kCapacityGrowthFactor) {
+    new_capacity = Max(new_capacity, capacity_ * kCapacityGrowthFactor);
+  }
+  Factory* factory = isolate_->factory();
+  if (is_ascii_) {
+    Handle<SeqAsciiString> string = factory->NewRawAsciiString(new_capacity);
+    CopyChars(string->GetChars(),
+              SeqAsciiString::cast(buffer())->GetChars(),
+              index_);
+    buffer_holder_->set(0, *string);
+  } else {
+    Handle<SeqTwoByteString> string =
+        factory->NewRawTwoByteString(new_capacity);
+    CopyChars(string->GetChars(),
+              SeqTwoByteString::cast(buffer())->GetChars(),
+              index_);
+    buffer_holder_->set(0, *string);
+  }
+  capacity_ = new_capacity;
+  return true;
+}
+
+
+void BasicJsonStringifier::ChangeEncoding() {
+  ASSERT(is_ascii_);
+  if (overflowed_) return;
+  if (index_ > SeqTwoByteString::kMaxLength) {
+    overflowed_ = true;
+    return;
+  }
+  int new_capacity = Min(capacity_, SeqTwoByteString::kMaxLength);
+  Handle<SeqTwoByteString> string =
+      isolate_->factory()->NewRawTwoByteString(new_capacity);
+  CopyChars(string->GetChars(),
+            SeqAsciiString::cast(buffer())->GetChars(),
+            index_);
+  buffer_holder_->set(0, *string);
+  capacity_ = new_capacity;
+  is_ascii_ = false;
+}
+
+
+Handle<String> BasicJsonStringifier::Finish() {
+  Factory* factory = isolate_->factory();
+  if (is_ascii_) {
+    Handle<SeqAsciiString> result = factory->NewRawAsciiString(index_);
+    CopyChars(result->GetChars(),
+              SeqAsciiString::cast(buffer())->GetChars(),
+              index_);
+    return result;
+  }
+  Handle<SeqTwoByteString> result = factory->NewRawTwoByteString(index_);
+  CopyChars(result->GetChars(),
+            SeqTwoByteString::cast(buffer())->GetChars(),
+            index_);
+  return result;
+}
+
+
+void BasicJsonStringifier::Append(char c) {
+  if (!EnsureCapacity(1)) return;
+  if (is_ascii_) {
+    SeqAsciiString::cast(buffer())->SeqAsciiStringSet(index_++, c);
+  } else {
+    SeqTwoByteString::cast(buffer())->SeqTwoByteStringSet(index_++, c);
+  }
+}
+
+
+void BasicJsonStringifier::Append(const char* chars) {
+  int length = StrLength(chars);
+  if (!EnsureCapacity(length)) return;
+  if (is_ascii_) {
+    CopyChars(SeqAsciiString::cast(buffer())->GetChars() + index_,
+              chars,
+              length);
+  } else {
+    CopyChars(SeqTwoByteString::cast(buffer())->GetChars() + index_,
+              chars,
+              length);
+  }
+  index_ += length;
+}
+
+} }  // namespace v8::internal
+
+#endif  // V8_JSON_STRINGIFIER_H_
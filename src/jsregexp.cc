@@ -31,6 +31,7 @@
 #include "compiler.h"
 #include "execution.h"
 #include "factory.h"
+#include "hashmap.h"
 #include "jsregexp.h"
 #include "platform.h"
 #include "string-search.h"
@@ -369,12 +370,14 @@ Handle<Object> RegExpImpl::AtomExec(Handle<JSRegExp> re,
 // returns false.
 bool RegExpImpl::EnsureCompiledIrregexp(
     Handle<JSRegExp> re, Handle<String> sample_subject, bool is_ascii) {
+  if (IrregexpUsesBytecode(FixedArray::cast(re->data()))) {
+    if (re->DataAt(JSRegExp::bytecode_index(is_ascii))->IsByteArray()) {
+      return true;
+    }
+    return CompileIrregexp(re, sample_subject, is_ascii);
+  }
   Object* compiled_code = re->DataAt(JSRegExp::code_index(is_ascii));
-#ifdef V8_INTERPRETED_REGEXP
-  if (compiled_code->IsByteArray()) return true;
-#else  // V8_INTERPRETED_REGEXP (RegExp native code)
   if (compiled_code->IsCode()) return true;
-#endif
   // We could potentially have marked this as flushable, but have kept
   // a saved version if we did not flush it yet.
   Object* saved_code = re->DataAt(JSRegExp::saved_code_index(is_ascii));
@@ -438,6 +441,36 @@ bool RegExpImpl::CompileIrregexp(Handle<JSRegExp> re,
 
   Handle<String> pattern(re->Pattern());
   if (!pattern->IsFlat()) FlattenString(pattern);
+
+  bool use_bytecode = IrregexpUsesBytecode(FixedArray::cast(re->data()));
+  if (use_bytecode && UsesNativeRegExp()) {
+    // Native code is only compiled if the regexp turns out to be hot.
+    isolate->counters()->regexp_deferred_compiles()->Increment();
+  }
+
+  // Bytecode compiled by any isolate can be used without compiling again.
+  bool use_shared_cache = FLAG_regexp_shared_cache && use_bytecode;
+  if (use_shared_cache) {
+    int num_registers;
+    Handle<ByteArray> bytecode = SharedRegExpCodeCache::Lookup(
+        isolate, pattern, flags, is_ascii, &num_registers);
+    if (!bytecode.is_null()) {
+      isolate->counters()->regexp_shared_cache_hits()->Increment();
+      SetIrregexpCode(re, is_ascii, *bytecode, num_registers);
+      return true;
+    }
+    isolate->counters()->regexp_shared_cache_misses()->Increment();
+  }
+
+  HistogramTimerScope timer(use_bytecode
+      ? isolate->counters()->regexp_compile_bytecode()
+      : isolate->counters()->regexp_compile_native());
+  if (use_bytecode) {
+    isolate->counters()->regexp_bytecode_compiles()->Increment();
+  } else {
+    isolate->counters()->regexp_native_compiles()->Increment();
+  }
+
   RegExpCompileData compile_data;
   FlatStringReader reader(isolate, pattern);
   Zone* zone = isolate->runtime_zone();
@@ -460,6 +493,7 @@ bool RegExpImpl::CompileIrregexp(Handle<JSRegExp> re,
                             pattern,
                             sample_subject,
                             is_ascii,
+                            use_bytecode,
                             zone);
   if (result.error_message != NULL) {
     // Unable to compile regexp.
@@ -469,17 +503,190 @@ bool RegExpImpl::CompileIrregexp(Handle<JSRegExp> re,
     return false;
   }
 
-  Handle<FixedArray> data = Handle<FixedArray>(FixedArray::cast(re->data()));
-  data->set(JSRegExp::code_index(is_ascii), result.code);
-  int register_max = IrregexpMaxRegisterCount(*data);
-  if (result.num_registers > register_max) {
-    SetIrregexpMaxRegisterCount(*data, result.num_registers);
+  SetIrregexpCode(re, is_ascii, result.code, result.num_registers);
+  if (use_shared_cache && result.code->IsByteArray()) {
+    SharedRegExpCodeCache::Insert(pattern,
+                                  flags,
+                                  is_ascii,
+                                  Handle<ByteArray>(ByteArray::cast(result.code)),
+                                  result.num_registers);
   }
 
   return true;
 }
 
 
+void RegExpImpl::SetIrregexpCode(Handle<JSRegExp> re,
+                                 bool is_ascii,
+                                 Object* code,
+                                 int num_registers) {
+  FixedArray* data = FixedArray::cast(re->data());
+  if (code->IsByteArray()) {
+    data->set(JSRegExp::bytecode_index(is_ascii), code);
+  } else {
+    data->set(JSRegExp::code_index(is_ascii), code);
+  }
+  if (num_registers > IrregexpMaxRegisterCount(data)) {
+    SetIrregexpMaxRegisterCount(data, num_registers);
+  }
+}
+
+
+// -------------------------------------------------------------------
+// Shared regexp code cache.
+
+
+struct SharedRegExpCodeCache::Entry {
+  uint32_t hash;
+  uint32_t flags;
+  bool is_ascii;
+  uc16* pattern;
+  int pattern_length;
+  byte* bytecode;
+  int bytecode_length;
+  int num_registers;
+};
+
+
+static LazyMutex shared_regexp_cache_mutex = LAZY_MUTEX_INITIALIZER;
+static HashMap* shared_regexp_cache = NULL;
+static int shared_regexp_cache_size = 0;
+
+
+bool SharedRegExpCodeCache::Match(void* key1, void* key2) {
+  Entry* a = reinterpret_cast<Entry*>(key1);
+  Entry* b = reinterpret_cast<Entry*>(key2);
+  return a->flags == b->flags &&
+         a->is_ascii == b->is_ascii &&
+         a->pattern_length == b->pattern_length &&
+         CompareChars(a->pattern, b->pattern, a->pattern_length) == 0;
+}
+
+
+// Must be called with the mutex held.  Entries are never removed while
+// isolates are running, so they can be used after releasing the mutex.
+SharedRegExpCodeCache::Entry* SharedRegExpCodeCache::Find(Entry* key,
+                                                          bool insert) {
+  if (shared_regexp_cache == NULL) {
+    if (!insert) return NULL;
+    shared_regexp_cache = new HashMap(&Match);
+  }
+  HashMap::Entry* entry =
+      shared_regexp_cache->Lookup(key, key->hash, insert);
+  if (entry == NULL) return NULL;
+  return reinterpret_cast<Entry*>(entry->key);
+}
+
+
+void SharedRegExpCodeCache::InitializeKey(Handle<String> pattern,
+                                          JSRegExp::Flags flags,
+                                          bool is_ascii,
+                                          ScopedVector<uc16>* chars,
+                                          Entry* key) {
+  ASSERT(pattern->IsFlat());
+  String::WriteToFlat(*pattern, chars->start(), 0, chars->length());
+  key->flags = flags.value();
+  key->is_ascii = is_ascii;
+  key->pattern = chars->start();
+  key->pattern_length = chars->length();
+  key->hash =
+      HashSequentialString(chars->start(), chars->length(), 0) ^
+      ComputeIntegerHash(key->flags << 1 | (is_ascii ? 1 : 0), 0);
+  key->bytecode = NULL;
+  key->bytecode_length = 0;
+  key->num_registers = 0;
+}
+
+
+Handle<ByteArray> SharedRegExpCodeCache::Lookup(Isolate* isolate,
+                                                Handle<String> pattern,
+                                                JSRegExp::Flags flags,
+                                                bool is_ascii,
+                                                int* num_registers) {
+  ScopedVector<uc16> chars(pattern->length());
+  Entry key;
+  InitializeKey(pattern, flags, is_ascii, &chars, &key);
+  Entry* entry;
+  {
+    ScopedLock lock(shared_regexp_cache_mutex.Pointer());
+    entry = Find(&key, false);
+  }
+  if (entry == NULL) return Handle<ByteArray>::null();
+  Handle<ByteArray> bytecode =
+      isolate->factory()->NewByteArray(entry->bytecode_length, TENURED);
+  OS::MemCopy(bytecode->GetDataStartAddress(),
+              entry->bytecode,
+              entry->bytecode_length);
+  *num_registers = entry->num_registers;
+  return bytecode;
+}
+
+
+void SharedRegExpCodeCache::Insert(Handle<String> pattern,
+                                   JSRegExp::Flags flags,
+                                   bool is_ascii,
+                                   Handle<ByteArray> bytecode,
+                                   int num_registers) {
+  ScopedVector<uc16> chars(pattern->length());
+  Entry key;
+  InitializeKey(pattern, flags, is_ascii, &chars, &key);
+  int entry_size = static_cast<int>(sizeof(Entry)) +
+      key.pattern_length * kUC16Size + bytecode->length();
+
+  ScopedLock lock(shared_regexp_cache_mutex.Pointer());
+  if (shared_regexp_cache_size + entry_size >
+      FLAG_regexp_shared_cache_size * KB) {
+    return;
+  }
+  // Another isolate may have compiled the same regexp concurrently.
+  if (Find(&key, false) != NULL) return;
+
+  Entry* entry = new Entry(key);
+  entry->pattern = NewArray<uc16>(key.pattern_length);
+  CopyChars(entry->pattern, key.pattern, key.pattern_length);
+  entry->bytecode = NewArray<byte>(bytecode->length());
+  OS::MemCopy(entry->bytecode,
+              bytecode->GetDataStartAddress(),
+              bytecode->length());
+  entry->bytecode_length = bytecode->length();
+  entry->num_registers = num_registers;
+  Entry* inserted = Find(entry, true);
+  ASSERT(inserted == entry);
+  USE(inserted);
+  shared_regexp_cache_size += entry_size;
+}
+
+
+int SharedRegExpCodeCache::entries() {
+  ScopedLock lock(shared_regexp_cache_mutex.Pointer());
+  if (shared_regexp_cache == NULL) return 0;
+  return shared_regexp_cache->occupancy();
+}
+
+
+int SharedRegExpCodeCache::size() {
+  ScopedLock lock(shared_regexp_cache_mutex.Pointer());
+  return shared_regexp_cache_size;
+}
+
+
+void SharedRegExpCodeCache::TearDown() {
+  ScopedLock lock(shared_regexp_cache_mutex.Pointer());
+  if (shared_regexp_cache == NULL) return;
+  for (HashMap::Entry* p = shared_regexp_cache->Start();
+       p != NULL;
+       p = shared_regexp_cache->Next(p)) {
+    Entry* entry = reinterpret_cast<Entry*>(p->key);
+    DeleteArray(entry->pattern);
+    DeleteArray(entry->bytecode);
+    delete entry;
+  }
+  delete shared_regexp_cache;
+  shared_regexp_cache = NULL;
+  shared_regexp_cache_size = 0;
+}
+
+
 int RegExpImpl::IrregexpMaxRegisterCount(FixedArray* re) {
   return Smi::cast(
       re->get(JSRegExp::kIrregexpMaxRegisterCountIndex))->value();
@@ -502,7 +709,7 @@ int RegExpImpl::IrregexpNumberOfRegisters(FixedArray* re) {
 
 
 ByteArray* RegExpImpl::IrregexpByteCode(FixedArray* re, bool is_ascii) {
-  return ByteArray::cast(re->get(JSRegExp::code_index(is_ascii)));
+  return ByteArray::cast(re->get(JSRegExp::bytecode_index(is_ascii)));
 }
 
 
@@ -511,6 +718,35 @@ Code* RegExpImpl::IrregexpNativeCode(FixedArray* re, bool is_ascii) {
 }
 
 
+bool RegExpImpl::IrregexpUsesBytecode(FixedArray* re) {
+  if (!UsesNativeRegExp()) return true;
+  int ticks =
+      Smi::cast(re->get(JSRegExp::kIrregexpTicksUntilTierUpIndex))->value();
+  return ticks != JSRegExp::kTieredUpValue;
+}
+
+
+void RegExpImpl::TierUpIfHot(Handle<JSRegExp> re) {
+  if (!UsesNativeRegExp()) return;
+  FixedArray* data = FixedArray::cast(re->data());
+  if (Smi::cast(data->get(JSRegExp::kIrregexpTicksUntilTierUpIndex)) !=
+      Smi::FromInt(0)) {
+    return;
+  }
+  if (FLAG_trace_regexp_tier_up) {
+    PrintF("[tiering up regexp /%s/ to native code]\n",
+           *re->Pattern()->ToCString());
+  }
+  re->GetIsolate()->counters()->regexp_tier_ups()->Increment();
+  // The bytecode is not needed any more.
+  Smi* uninitialized = Smi::FromInt(JSRegExp::kUninitializedValue);
+  data->set(JSRegExp::kIrregexpASCIIBytecodeIndex, uninitialized);
+  data->set(JSRegExp::kIrregexpUC16BytecodeIndex, uninitialized);
+  data->set(JSRegExp::kIrregexpTicksUntilTierUpIndex,
+            Smi::FromInt(JSRegExp::kTieredUpValue));
+}
+
+
 void RegExpImpl::IrregexpInitialize(Handle<JSRegExp> re,
                                     Handle<String> pattern,
                                     JSRegExp::Flags flags,
@@ -528,22 +764,26 @@ int RegExpImpl::IrregexpPrepare(Handle<JSRegExp> regexp,
                                 Handle<String> subject) {
   if (!subject->IsFlat()) FlattenString(subject);
 
+  // The regexp only changes tiers here, so that the registers are sized
+  // for the same tier that IrregexpExecRaw uses.
+  TierUpIfHot(regexp);
+
   // Check the asciiness of the underlying storage.
   bool is_ascii = subject->IsAsciiRepresentationUnderneath();
   if (!EnsureCompiledIrregexp(regexp, subject, is_ascii)) return -1;
 
-#ifdef V8_INTERPRETED_REGEXP
-  // Byte-code regexp needs space allocated for all its registers.
-  // The result captures are copied to the start of the registers array
-  // if the match succeeds.  This way those registers are not clobbered
-  // when we set the last match info from last successful match.
-  return IrregexpNumberOfRegisters(FixedArray::cast(regexp->data())) +
-         (IrregexpNumberOfCaptures(FixedArray::cast(regexp->data())) + 1) * 2;
-#else  // V8_INTERPRETED_REGEXP
+  FixedArray* data = FixedArray::cast(regexp->data());
+  if (IrregexpUsesBytecode(data)) {
+    // Byte-code regexp needs space allocated for all its registers.
+    // The result captures are copied to the start of the registers array
+    // if the match succeeds.  This way those registers are not clobbered
+    // when we set the last match info from last successful match.
+    return IrregexpNumberOfRegisters(data) +
+           (IrregexpNumberOfCaptures(data) + 1) * 2;
+  }
   // Native regexp only needs room to output captures. Registers are handled
   // internally.
-  return (IrregexpNumberOfCaptures(FixedArray::cast(regexp->data())) + 1) * 2;
-#endif  // V8_INTERPRETED_REGEXP
+  return (IrregexpNumberOfCaptures(data) + 1) * 2;
 }
 
 
@@ -563,48 +803,62 @@ int RegExpImpl::IrregexpExecRaw(Handle<JSRegExp> regexp,
   bool is_ascii = subject->IsAsciiRepresentationUnderneath();
 
 #ifndef V8_INTERPRETED_REGEXP
-  ASSERT(output_size >= (IrregexpNumberOfCaptures(*irregexp) + 1) * 2);
-  do {
-    EnsureCompiledIrregexp(regexp, subject, is_ascii);
-    Handle<Code> code(IrregexpNativeCode(*irregexp, is_ascii), isolate);
-    // The stack is used to allocate registers for the compiled regexp code.
-    // This means that in case of failure, the output registers array is left
-    // untouched and contains the capture results from the previous successful
-    // match.  We can use that to set the last match info lazily.
-    NativeRegExpMacroAssembler::Result res =
-        NativeRegExpMacroAssembler::Match(code,
-                                          subject,
-                                          output,
-                                          output_size,
-                                          index,
-                                          isolate);
-    if (res != NativeRegExpMacroAssembler::RETRY) {
-      ASSERT(res != NativeRegExpMacroAssembler::EXCEPTION ||
-             isolate->has_pending_exception());
-      STATIC_ASSERT(
-          static_cast<int>(NativeRegExpMacroAssembler::SUCCESS) == RE_SUCCESS);
-      STATIC_ASSERT(
-          static_cast<int>(NativeRegExpMacroAssembler::FAILURE) == RE_FAILURE);
-      STATIC_ASSERT(static_cast<int>(NativeRegExpMacroAssembler::EXCEPTION)
-                    == RE_EXCEPTION);
-      return static_cast<IrregexpResult>(res);
-    }
-    // If result is RETRY, the string has changed representation, and we
-    // must restart from scratch.
-    // In this case, it means we must make sure we are prepared to handle
-    // the, potentially, different subject (the string can switch between
-    // being internal and external, and even between being ASCII and UC16,
-    // but the characters are always the same).
-    IrregexpPrepare(regexp, subject);
-    is_ascii = subject->IsAsciiRepresentationUnderneath();
-  } while (true);
-  UNREACHABLE();
-  return RE_EXCEPTION;
-#else  // V8_INTERPRETED_REGEXP
+  if (!IrregexpUsesBytecode(*irregexp)) {
+    do {
+      EnsureCompiledIrregexp(regexp, subject, is_ascii);
+      ASSERT(output_size >= (IrregexpNumberOfCaptures(*irregexp) + 1) * 2);
+      Handle<Code> code(IrregexpNativeCode(*irregexp, is_ascii), isolate);
+      // The stack is used to allocate registers for the compiled regexp
+      // code.  This means that in case of failure, the output registers
+      // array is left untouched and contains the capture results from the
+      // previous successful match.  We can use that to set the last match
+      // info lazily.
+      NativeRegExpMacroAssembler::Result res =
+          NativeRegExpMacroAssembler::Match(code,
+                                            subject,
+                                            output,
+                                            output_size,
+                                            index,
+                                            isolate);
+      if (res != NativeRegExpMacroAssembler::RETRY) {
+        ASSERT(res != NativeRegExpMacroAssembler::EXCEPTION ||
+               isolate->has_pending_exception());
+        STATIC_ASSERT(static_cast<int>(NativeRegExpMacroAssembler::SUCCESS)
+                      == RE_SUCCESS);
+        STATIC_ASSERT(static_cast<int>(NativeRegExpMacroAssembler::FAILURE)
+                      == RE_FAILURE);
+        STATIC_ASSERT(static_cast<int>(NativeRegExpMacroAssembler::EXCEPTION)
+                      == RE_EXCEPTION);
+        return static_cast<IrregexpResult>(res);
+      }
+      // If result is RETRY, the string has changed representation, and we
+      // must restart from scratch.
+      // In this case, it means we must make sure we are prepared to handle
+      // the, potentially, different subject (the string can switch between
+      // being internal and external, and even between being ASCII and UC16,
+      // but the characters are always the same).
+      IrregexpPrepare(regexp, subject);
+      is_ascii = subject->IsAsciiRepresentationUnderneath();
+    } while (true);
+    UNREACHABLE();
+    return RE_EXCEPTION;
+  }
+
+  // Count the execution towards compiling native code.
+  int ticks =
+      Smi::cast(irregexp->get(JSRegExp::kIrregexpTicksUntilTierUpIndex))->
+          value();
+  if (ticks > 0) {
+    irregexp->set(JSRegExp::kIrregexpTicksUntilTierUpIndex,
+                  Smi::FromInt(ticks - 1));
+  }
+#endif  // V8_INTERPRETED_REGEXP
 
+  // The subject may have changed representation since IrregexpPrepare.
+  if (!EnsureCompiledIrregexp(regexp, subject, is_ascii)) {
+    return RE_EXCEPTION;
+  }
   ASSERT(output_size >= IrregexpNumberOfRegisters(*irregexp));
-  // We must have done EnsureCompiledIrregexp, so we can get the number of
-  // registers.
   int number_of_capture_registers =
       (IrregexpNumberOfCaptures(*irregexp) + 1) * 2;
   int32_t* raw_output = &output[number_of_capture_registers];
@@ -630,7 +884,6 @@ int RegExpImpl::IrregexpExecRaw(Handle<JSRegExp> regexp,
     isolate->StackOverflow();
   }
   return result;
-#endif  // V8_INTERPRETED_REGEXP
 }
 
 
@@ -711,12 +964,7 @@ RegExpImpl::GlobalCache::GlobalCache(Handle<JSRegExp> regexp,
     register_array_size_(0),
     regexp_(regexp),
     subject_(subject) {
-#ifdef V8_INTERPRETED_REGEXP
-  bool interpreted = true;
-#else
-  bool interpreted = false;
-#endif  // V8_INTERPRETED_REGEXP
-
+  bool interpreted;
   if (regexp_->TypeTag() == JSRegExp::ATOM) {
     static const int kAtomRegistersPerMatch = 2;
     registers_per_match_ = kAtomRegistersPerMatch;
@@ -728,6 +976,7 @@ RegExpImpl::GlobalCache::GlobalCache(Handle<JSRegExp> regexp,
       num_matches_ = -1;  // Signal exception.
       return;
     }
+    interpreted = IrregexpUsesBytecode(FixedArray::cast(regexp_->data()));
   }
 
   if (is_global && !interpreted) {
@@ -6047,6 +6296,7 @@ RegExpEngine::CompilationResult RegExpEngine::Compile(
     Handle<String> pattern,
     Handle<String> sample_subject,
     bool is_ascii,
+    bool use_bytecode,
     Zone* zone) {
   if ((data->capture_count + 1) * 2 - 1 > RegExpMacroAssembler::kMaxRegister) {
     return IrregexpRegExpTooBig();
@@ -6116,52 +6366,70 @@ RegExpEngine::CompilationResult RegExpEngine::Compile(
 
   // Create the correct assembler for the architecture.
 #ifndef V8_INTERPRETED_REGEXP
-  // Native regexp implementation.
-
-  NativeRegExpMacroAssembler::Mode mode =
-      is_ascii ? NativeRegExpMacroAssembler::ASCII
-               : NativeRegExpMacroAssembler::UC16;
+  if (!use_bytecode) {
+    // Native regexp implementation.
+    NativeRegExpMacroAssembler::Mode mode =
+        is_ascii ? NativeRegExpMacroAssembler::ASCII
+                 : NativeRegExpMacroAssembler::UC16;
 
 #if V8_TARGET_ARCH_IA32
-  RegExpMacroAssemblerIA32 macro_assembler(mode, (data->capture_count + 1) * 2,
-                                           zone);
+    RegExpMacroAssemblerIA32 macro_assembler(
+        mode, (data->capture_count + 1) * 2, zone);
 #elif V8_TARGET_ARCH_X64
-  RegExpMacroAssemblerX64 macro_assembler(mode, (data->capture_count + 1) * 2,
-                                          zone);
+    RegExpMacroAssemblerX64 macro_assembler(
+        mode, (data->capture_count + 1) * 2, zone);
 #elif V8_TARGET_ARCH_ARM
-  RegExpMacroAssemblerARM macro_assembler(mode, (data->capture_count + 1) * 2,
-                                          zone);
+    RegExpMacroAssemblerARM macro_assembler(
+        mode, (data->capture_count + 1) * 2, zone);
 #elif V8_TARGET_ARCH_MIPS
-  RegExpMacroAssemblerMIPS macro_assembler(mode, (data->capture_count + 1) * 2,
-                                           zone);
+    RegExpMacroAssemblerMIPS macro_assembler(
+        mode, (data->capture_count + 1) * 2, zone);
 #endif
+    return Assemble(&compiler, &macro_assembler, node, data,
+                    is_start_anchored, is_end_anchored, max_length,
+                    is_global, pattern);
+  }
+#endif  // V8_INTERPRETED_REGEXP
 
-#else  // V8_INTERPRETED_REGEXP
   // Interpreted regexp implementation.
   EmbeddedVector<byte, 1024> codes;
   RegExpMacroAssemblerIrregexp macro_assembler(codes, zone);
-#endif  // V8_INTERPRETED_REGEXP
+  return Assemble(&compiler, &macro_assembler, node, data,
+                  is_start_anchored, is_end_anchored, max_length,
+                  is_global, pattern);
+}
 
+
+RegExpEngine::CompilationResult RegExpEngine::Assemble(
+    RegExpCompiler* compiler,
+    RegExpMacroAssembler* macro_assembler,
+    RegExpNode* node,
+    RegExpCompileData* data,
+    bool is_start_anchored,
+    bool is_end_anchored,
+    int max_length,
+    bool is_global,
+    Handle<String> pattern) {
   // Inserted here, instead of in Assembler, because it depends on information
   // in the AST that isn't replicated in the Node structure.
   static const int kMaxBacksearchLimit = 1024;
   if (is_end_anchored &&
       !is_start_anchored &&
       max_length < kMaxBacksearchLimit) {
-    macro_assembler.SetCurrentPositionFromEnd(max_length);
+    macro_assembler->SetCurrentPositionFromEnd(max_length);
   }
 
   if (is_global) {
-    macro_assembler.set_global_mode(
+    macro_assembler->set_global_mode(
         (data->tree->min_match() > 0)
             ? RegExpMacroAssembler::GLOBAL_NO_ZERO_LENGTH_CHECK
             : RegExpMacroAssembler::GLOBAL);
   }
 
-  return compiler.Assemble(&macro_assembler,
-                           node,
-                           data->capture_count,
-                           pattern);
+  return compiler->Assemble(macro_assembler,
+                            node,
+                            data->capture_count,
+                            pattern);
 }
 
 
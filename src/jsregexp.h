@@ -227,6 +227,9 @@ class RegExpImpl {
   static int IrregexpNumberOfRegisters(FixedArray* re);
   static ByteArray* IrregexpByteCode(FixedArray* re, bool is_ascii);
   static Code* IrregexpNativeCode(FixedArray* re, bool is_ascii);
+  // Whether the regexp currently runs bytecode in the interpreter, either
+  // because V8 has no native regexp support or because it is not hot yet.
+  static bool IrregexpUsesBytecode(FixedArray* re);
 
   // Limit the space regexps take up on the heap.  In order to limit this we
   // would like to keep track of the amount of regexp code on the heap.  This
@@ -241,6 +244,55 @@ class RegExpImpl {
       Handle<JSRegExp> re, Handle<String> sample_subject, bool is_ascii);
   static inline bool EnsureCompiledIrregexp(
       Handle<JSRegExp> re, Handle<String> sample_subject, bool is_ascii);
+  // Switches a regexp that has run often enough in the interpreter to
+  // native code.
+  static void TierUpIfHot(Handle<JSRegExp> re);
+  static void SetIrregexpCode(
+      Handle<JSRegExp> re, bool is_ascii, Object* code, int num_registers);
+};
+
+
+// A process-wide cache of irregexp bytecode that is shared by all isolates,
+// keyed by pattern source, flags and subject encoding.  Bytecode does not
+// refer to any heap, so it is kept outside of the heaps and copied into a
+// ByteArray of the isolate that looks it up.  Native code is bound to the
+// isolate that generated it and is not cached.  Entries are never evicted,
+// insertions stop once the cache is full.
+class SharedRegExpCodeCache : public AllStatic {
+ public:
+  // Returns a copy of the bytecode for the flat pattern in the given isolate
+  // and the number of registers it uses, or a null handle if there is none.
+  static Handle<ByteArray> Lookup(Isolate* isolate,
+                                  Handle<String> pattern,
+                                  JSRegExp::Flags flags,
+                                  bool is_ascii,
+                                  int* num_registers);
+
+  static void Insert(Handle<String> pattern,
+                     JSRegExp::Flags flags,
+                     bool is_ascii,
+                     Handle<ByteArray> bytecode,
+                     int num_registers);
+
+  // The number of cached entries and the bytes they use.
+  static int entries();
+  static int size();
+
+  // Frees all entries.  Must only be called when no isolate is running.
+  static void TearDown();
+
+ private:
+  struct Entry;
+
+  // Fills in the key part of an entry.  The pattern is only valid while
+  // chars is alive.
+  static void InitializeKey(Handle<String> pattern,
+                            JSRegExp::Flags flags,
+                            bool is_ascii,
+                            ScopedVector<uc16>* chars,
+                            Entry* key);
+  static Entry* Find(Entry* key, bool insert);
+  static bool Match(void* key1, void* key2);
 };
 
 
@@ -1632,15 +1684,30 @@ class RegExpEngine: public AllStatic {
     int num_registers;
   };
 
+  // Compiles to bytecode for the interpreter if use_bytecode is set or V8
+  // has no native regexp support, otherwise to native code.
   static CompilationResult Compile(RegExpCompileData* input,
                                    bool ignore_case,
                                    bool global,
                                    bool multiline,
                                    Handle<String> pattern,
                                    Handle<String> sample_subject,
-                                   bool is_ascii, Zone* zone);
+                                   bool is_ascii,
+                                   bool use_bytecode,
+                                   Zone* zone);
 
   static void DotPrint(const char* label, RegExpNode* node, bool ignore_case);
+
+ private:
+  static CompilationResult Assemble(RegExpCompiler* compiler,
+                                    RegExpMacroAssembler* macro_assembler,
+                                    RegExpNode* node,
+                                    RegExpCompileData* data,
+                                    bool is_start_anchored,
+                                    bool is_end_anchored,
+                                    int max_length,
+                                    bool is_global,
+                                    Handle<String> pattern);
 };
 
 
@@ -138,6 +138,8 @@ LiveRange::LiveRange(int id, Zone* zone)
       next_(NULL),
       current_interval_(NULL),
       last_processed_use_(NULL),
+      first_hint_candidate_(NULL),
+      first_hint_candidate_valid_(false),
       spill_operand_(new(zone) LOperand()),
       spill_start_index_(kMaxInt) { }
 
@@ -219,8 +221,24 @@ bool LiveRange::CanBeSpilled(LifetimePosition pos) {
 
 
 UsePosition* LiveRange::FirstPosWithHint() const {
-  UsePosition* pos = first_pos_;
-  while (pos != NULL && !pos->HasHint()) pos = pos->next();
+  // Long ranges are asked for their hint every time they are allocated, so
+  // skip the prefix of uses that cannot have a hint only once.
+  UsePosition* pos =
+      first_hint_candidate_valid_ ? first_hint_candidate_ : first_pos_;
+  while (pos != NULL && pos->hint() == NULL) pos = pos->next();
+  first_hint_candidate_ = pos;
+  first_hint_candidate_valid_ = true;
+  // Ranges are allocated in start order, so hints far from the start of a
+  // range usually refer to operands that have not been allocated yet.
+  // Looking at a bounded number of candidates keeps this constant time for
+  // values with thousands of uses.
+  int candidates = 0;
+  while (pos != NULL && !pos->HasHint()) {
+    if (pos->hint() != NULL && ++candidates == kMaxHintCandidates) {
+      return NULL;
+    }
+    pos = pos->next();
+  }
   return pos;
 }
 
@@ -331,6 +349,20 @@ void LiveRange::SplitAt(LifetimePosition position,
     }
   }
 
+  // Hand the first hint candidate over to the part that owns it, so that
+  // repeatedly splitting a long range does not rescan its uses.
+  bool candidate_in_result = first_hint_candidate_valid_;
+  for (UsePosition* pos = first_pos_;
+       candidate_in_result && pos != use_after;
+       pos = pos->next()) {
+    if (pos == first_hint_candidate_) candidate_in_result = false;
+  }
+  if (candidate_in_result) {
+    result->first_hint_candidate_ = first_hint_candidate_;
+    result->first_hint_candidate_valid_ = true;
+    first_hint_candidate_ = NULL;
+  }
+
   // Partition original use positions to the two live ranges.
   if (use_before != NULL) {
     use_before->next_ = NULL;
@@ -462,6 +494,7 @@ UsePosition* LiveRange::AddUsePosition(LifetimePosition pos,
     prev->next_ = use_pos;
   }
 
+  first_hint_candidate_valid_ = false;
   return use_pos;
 }
 
@@ -547,7 +580,8 @@ LAllocator::LAllocator(int num_values, HGraph* graph)
       num_registers_(-1),
       graph_(graph),
       has_osr_entry_(false),
-      allocation_ok_(true) { }
+      allocation_ok_(true),
+      split_count_(0) { }
 
 
 void LAllocator::InitializeLivenessAnalysis() {
@@ -1065,6 +1099,7 @@ void LAllocator::ResolvePhis(HBasicBlock* block) {
 bool LAllocator::Allocate(LChunk* chunk) {
   ASSERT(chunk_ == NULL);
   chunk_ = static_cast<LPlatformChunk*>(chunk);
+  int64_t start_ticks = FLAG_trace_alloc_stats ? OS::Ticks() : 0;
   MeetRegisterConstraints();
   if (!AllocationOk()) return false;
   ResolvePhis();
@@ -1077,10 +1112,26 @@ bool LAllocator::Allocate(LChunk* chunk) {
   if (has_osr_entry_) ProcessOsrEntry();
   ConnectRanges();
   ResolveControlFlow();
+  if (FLAG_trace_alloc_stats) PrintStatistics(start_ticks);
   return true;
 }
 
 
+void LAllocator::PrintStatistics(int64_t start_ticks) {
+  double ms = static_cast<double>(OS::Ticks() - start_ticks) / 1000;
+  SmartArrayPointer<char> name =
+      chunk_->info()->function()->debug_name()->ToCString();
+  PrintF("[register allocation: %s, %d blocks, %d instructions, "
+         "%d virtual registers, %d splits, took %.3f ms]\n",
+         *name,
+         graph_->blocks()->length(),
+         chunk_->instructions()->length(),
+         next_virtual_register_,
+         split_count_,
+         ms);
+}
+
+
 void LAllocator::MeetRegisterConstraints() {
   HPhase phase("L_Register constraints", chunk_);
   first_artificial_register_ = next_virtual_register_;
@@ -1396,7 +1447,11 @@ void LAllocator::PopulatePointerMaps() {
       first_safe_point_index++;
     }
 
-    // Step through the safe points to see whether they are in the range.
+    // Step through the safe points to see whether they are in the range.  Both
+    // the safe points and the children of the range are ordered by position,
+    // so the child covering a safe point is searched from the one found for
+    // the previous safe point.
+    LiveRange* cur = range;
     for (int safe_point_index = first_safe_point_index;
          safe_point_index < pointer_maps->length();
          ++safe_point_index) {
@@ -1409,12 +1464,12 @@ void LAllocator::PopulatePointerMaps() {
       // Advance to the next active range that covers the current
       // safe point position.
       LifetimePosition safe_point_pos =
-          LifetimePosition::FromInstructionIndex(safe_point);
-      LiveRange* cur = range;
-      while (cur != NULL && !cur->Covers(safe_point_pos.PrevInstruction())) {
+          LifetimePosition::FromInstructionIndex(safe_point).PrevInstruction();
+      while (cur != NULL && cur->End().Value() <= safe_point_pos.Value()) {
         cur = cur->next();
       }
-      if (cur == NULL) continue;
+      if (cur == NULL) break;
+      if (!cur->Covers(safe_point_pos)) continue;
 
       // Check if the live range is spilled and the safe point is after
       // the spill position.
@@ -1518,9 +1573,9 @@ void LAllocator::AllocateRegisters() {
   }
 
   while (!unhandled_live_ranges_.is_empty()) {
-    ASSERT(UnhandledIsSorted());
+    SLOW_ASSERT(UnhandledIsSorted());
     LiveRange* current = unhandled_live_ranges_.RemoveLast();
-    ASSERT(UnhandledIsSorted());
+    SLOW_ASSERT(UnhandledIsSorted());
     LifetimePosition position = current->Start();
     TraceAlloc("Processing interval %d start=%d\n",
                current->id(),
@@ -1544,7 +1599,7 @@ void LAllocator::AllocateRegisters() {
         // the register is too close to the start of live range.
         SpillBetween(current, current->Start(), pos->pos());
         if (!AllocationOk()) return;
-        ASSERT(UnhandledIsSorted());
+        SLOW_ASSERT(UnhandledIsSorted());
         continue;
       }
     }
@@ -1552,10 +1607,10 @@ void LAllocator::AllocateRegisters() {
     for (int i = 0; i < active_live_ranges_.length(); ++i) {
       LiveRange* cur_active = active_live_ranges_.at(i);
       if (cur_active->End().Value() <= position.Value()) {
-        ActiveToHandled(cur_active);
+        ActiveToHandled(i);
         --i;  // The live range was removed from the list of active live ranges.
       } else if (!cur_active->Covers(position)) {
-        ActiveToInactive(cur_active);
+        ActiveToInactive(i);
         --i;  // The live range was removed from the list of active live ranges.
       }
     }
@@ -1563,10 +1618,10 @@ void LAllocator::AllocateRegisters() {
     for (int i = 0; i < inactive_live_ranges_.length(); ++i) {
       LiveRange* cur_inactive = inactive_live_ranges_.at(i);
       if (cur_inactive->End().Value() <= position.Value()) {
-        InactiveToHandled(cur_inactive);
+        InactiveToHandled(i);
         --i;  // Live range was removed from the list of inactive live ranges.
       } else if (cur_inactive->Covers(position)) {
-        InactiveToActive(cur_inactive);
+        InactiveToActive(i);
         --i;  // Live range was removed from the list of inactive live ranges.
       }
     }
@@ -1646,18 +1701,21 @@ void LAllocator::AddToInactive(LiveRange* range) {
 void LAllocator::AddToUnhandledSorted(LiveRange* range) {
   if (range == NULL || range->IsEmpty()) return;
   ASSERT(!range->HasRegisterAssigned() && !range->IsSpilled());
-  for (int i = unhandled_live_ranges_.length() - 1; i >= 0; --i) {
-    LiveRange* cur_range = unhandled_live_ranges_.at(i);
-    if (range->ShouldBeAllocatedBefore(cur_range)) {
-      TraceAlloc("Add live range %d to unhandled at %d\n", range->id(), i + 1);
-      unhandled_live_ranges_.InsertAt(i + 1, range, zone());
-      ASSERT(UnhandledIsSorted());
-      return;
+  // The ranges to be allocated first are at the end of the list.  Insert the
+  // range after the last one that it should be allocated before.
+  int low = 0;
+  int high = unhandled_live_ranges_.length();
+  while (low < high) {
+    int mid = low + (high - low) / 2;
+    if (range->ShouldBeAllocatedBefore(unhandled_live_ranges_.at(mid))) {
+      low = mid + 1;
+    } else {
+      high = mid;
     }
   }
-  TraceAlloc("Add live range %d to unhandled at start\n", range->id());
-  unhandled_live_ranges_.InsertAt(0, range, zone());
-  ASSERT(UnhandledIsSorted());
+  TraceAlloc("Add live range %d to unhandled at %d\n", range->id(), low);
+  unhandled_live_ranges_.InsertAt(low, range, zone());
+  SLOW_ASSERT(UnhandledIsSorted());
 }
 
 
@@ -1723,33 +1781,39 @@ LOperand* LAllocator::TryReuseSpillSlot(LiveRange* range) {
 }
 
 
-void LAllocator::ActiveToHandled(LiveRange* range) {
-  ASSERT(active_live_ranges_.Contains(range));
-  active_live_ranges_.RemoveElement(range);
+// Removes the element at the given index in constant time by moving the last
+// element into its place.
+static LiveRange* RemoveUnordered(ZoneList<LiveRange*>* list, int index) {
+  LiveRange* range = list->at(index);
+  LiveRange* last = list->RemoveLast();
+  if (index < list->length()) (*list)[index] = last;
+  return range;
+}
+
+
+void LAllocator::ActiveToHandled(int index) {
+  LiveRange* range = RemoveUnordered(&active_live_ranges_, index);
   TraceAlloc("Moving live range %d from active to handled\n", range->id());
   FreeSpillSlot(range);
 }
 
 
-void LAllocator::ActiveToInactive(LiveRange* range) {
-  ASSERT(active_live_ranges_.Contains(range));
-  active_live_ranges_.RemoveElement(range);
+void LAllocator::ActiveToInactive(int index) {
+  LiveRange* range = RemoveUnordered(&active_live_ranges_, index);
   inactive_live_ranges_.Add(range, zone());
   TraceAlloc("Moving live range %d from active to inactive\n", range->id());
 }
 
 
-void LAllocator::InactiveToHandled(LiveRange* range) {
-  ASSERT(inactive_live_ranges_.Contains(range));
-  inactive_live_ranges_.RemoveElement(range);
+void LAllocator::InactiveToHandled(int index) {
+  LiveRange* range = RemoveUnordered(&inactive_live_ranges_, index);
   TraceAlloc("Moving live range %d from inactive to handled\n", range->id());
   FreeSpillSlot(range);
 }
 
 
-void LAllocator::InactiveToActive(LiveRange* range) {
-  ASSERT(inactive_live_ranges_.Contains(range));
-  inactive_live_ranges_.RemoveElement(range);
+void LAllocator::InactiveToActive(int index) {
+  LiveRange* range = RemoveUnordered(&inactive_live_ranges_, index);
   active_live_ranges_.Add(range, zone());
   TraceAlloc("Moving live range %d from inactive to active\n", range->id());
 }
@@ -1949,7 +2013,7 @@ void LAllocator::SplitAndSpillIntersecting(LiveRange* current) {
       } else {
         SpillBetween(range, split_pos, next_pos->pos());
       }
-      ActiveToHandled(range);
+      ActiveToHandled(i);
       --i;
     }
   }
@@ -1967,7 +2031,7 @@ void LAllocator::SplitAndSpillIntersecting(LiveRange* current) {
           next_intersection = Min(next_intersection, next_pos->pos());
           SpillBetween(range, split_pos, next_intersection);
         }
-        InactiveToHandled(range);
+        InactiveToHandled(i);
         --i;
       }
     }
@@ -1995,6 +2059,7 @@ LiveRange* LAllocator::SplitRangeAt(LiveRange* range, LifetimePosition pos) {
   LiveRange* result = LiveRangeFor(GetVirtualRegister());
   if (!AllocationOk()) return NULL;
   range->SplitAt(pos, result, zone_);
+  split_count_++;
   return result;
 }
 
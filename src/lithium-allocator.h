@@ -325,6 +325,9 @@ class LiveRange: public ZoneObject {
     return assigned_register_ != kInvalidAssignment;
   }
   bool IsSpilled() const { return spilled_; }
+  // Number of uses with unallocated hints FirstPosWithHint() looks past
+  // before giving up.
+  static const int kMaxHintCandidates = 16;
   UsePosition* FirstPosWithHint() const;
 
   LOperand* FirstHint() const {
@@ -394,6 +397,11 @@ class LiveRange: public ZoneObject {
   // This is used as a cache, it doesn't affect correctness.
   mutable UseInterval* current_interval_;
   UsePosition* last_processed_use_;
+  // First use position that might have a hint. Uses without a hint operand
+  // never acquire one, so FirstPosWithHint() can skip them for good. This is
+  // used as a cache, it doesn't affect correctness.
+  mutable UsePosition* first_hint_candidate_;
+  mutable bool first_hint_candidate_valid_;
   LOperand* spill_operand_;
   int spill_start_index_;
 };
@@ -521,10 +529,12 @@ class LAllocator BASE_EMBEDDED {
   void AddToUnhandledUnsorted(LiveRange* range);
   void SortUnhandled();
   bool UnhandledIsSorted();
-  void ActiveToHandled(LiveRange* range);
-  void ActiveToInactive(LiveRange* range);
-  void InactiveToHandled(LiveRange* range);
-  void InactiveToActive(LiveRange* range);
+  // These take the index of the range in the active or inactive list and
+  // do not preserve the order of that list.
+  void ActiveToHandled(int index);
+  void ActiveToInactive(int index);
+  void InactiveToHandled(int index);
+  void InactiveToActive(int index);
   void FreeSpillSlot(LiveRange* range);
   LOperand* TryReuseSpillSlot(LiveRange* range);
 
@@ -590,6 +600,8 @@ class LAllocator BASE_EMBEDDED {
 
   const char* RegisterName(int allocation_index);
 
+  void PrintStatistics(int64_t start_ticks);
+
   inline bool IsGapAt(int index);
 
   inline LInstruction* InstructionAt(int index);
@@ -601,7 +613,8 @@ class LAllocator BASE_EMBEDDED {
   LPlatformChunk* chunk_;
 
   // During liveness analysis keep a mapping from block id to live_in sets
-  // for blocks already analyzed.
+  // for blocks already analyzed.  The sets are dense bit vectors over all
+  // virtual registers, so liveness takes O(blocks * values) time and memory.
   ZoneList<BitVector*> live_in_sets_;
 
   // Liveness analysis results.
@@ -632,6 +645,9 @@ class LAllocator BASE_EMBEDDED {
   // Indicates success or failure during register allocation.
   bool allocation_ok_;
 
+  // Number of times a live range has been split, for --trace-alloc-stats.
+  int split_count_;
+
   DISALLOW_COPY_AND_ASSIGN(LAllocator);
 };
 
@@ -67,7 +67,7 @@ class LOperand: public ZoneObject {
   LITHIUM_OPERAND_PREDICATE(Unallocated, UNALLOCATED)
   LITHIUM_OPERAND_PREDICATE(Ignored, INVALID)
 #undef LITHIUM_OPERAND_PREDICATE
-  bool Equals(LOperand* other) const { return value_ == other->value_; }
+  inline bool Equals(LOperand* other) const;
 
   void PrintTo(StringStream* stream);
   void ConvertTo(Kind kind, int index) {
@@ -117,29 +117,30 @@ class LUnallocated: public LOperand {
     USED_AT_END
   };
 
-  explicit LUnallocated(Policy policy) : LOperand(UNALLOCATED, 0) {
+  explicit LUnallocated(Policy policy)
+      : LOperand(UNALLOCATED, 0), virtual_register_(0) {
     Initialize(policy, 0, USED_AT_END);
   }
 
-  LUnallocated(Policy policy, int fixed_index) : LOperand(UNALLOCATED, 0) {
+  LUnallocated(Policy policy, int fixed_index)
+      : LOperand(UNALLOCATED, 0), virtual_register_(0) {
     Initialize(policy, fixed_index, USED_AT_END);
   }
 
-  LUnallocated(Policy policy, Lifetime lifetime) : LOperand(UNALLOCATED, 0) {
+  LUnallocated(Policy policy, Lifetime lifetime)
+      : LOperand(UNALLOCATED, 0), virtual_register_(0) {
     Initialize(policy, 0, lifetime);
   }
 
   // The superclass has a KindField.  Some policies have a signed fixed
-  // index in the upper bits.
+  // index in the upper bits.  The virtual register is kept in a field of
+  // its own so that it does not limit the size of optimized functions.
   static const int kPolicyWidth = 3;
   static const int kLifetimeWidth = 1;
-  static const int kVirtualRegisterWidth = 15;
 
   static const int kPolicyShift = kKindFieldWidth;
   static const int kLifetimeShift = kPolicyShift + kPolicyWidth;
-  static const int kVirtualRegisterShift = kLifetimeShift + kLifetimeWidth;
-  static const int kFixedIndexShift =
-      kVirtualRegisterShift + kVirtualRegisterWidth;
+  static const int kFixedIndexShift = kLifetimeShift + kLifetimeWidth;
   static const int kFixedIndexWidth = 32 - kFixedIndexShift;
   STATIC_ASSERT(kFixedIndexWidth > 5);
 
@@ -149,13 +150,10 @@ class LUnallocated: public LOperand {
       : public BitField<Lifetime, kLifetimeShift, kLifetimeWidth> {
   };
 
-  class VirtualRegisterField
-      : public BitField<unsigned,
-                        kVirtualRegisterShift,
-                        kVirtualRegisterWidth> {
-  };
-
-  static const int kMaxVirtualRegisters = 1 << kVirtualRegisterWidth;
+  // The liveness analysis of the register allocator uses a bit vector per
+  // basic block that is indexed by virtual register, which bounds the
+  // number of virtual registers it can reasonably handle.
+  static const int kMaxVirtualRegisters = 1 << 18;
   static const int kMaxFixedIndex = (1 << (kFixedIndexWidth - 1)) - 1;
   static const int kMinFixedIndex = -(1 << (kFixedIndexWidth - 1));
 
@@ -181,13 +179,9 @@ class LUnallocated: public LOperand {
     return static_cast<int>(value_) >> kFixedIndexShift;
   }
 
-  int virtual_register() const {
-    return VirtualRegisterField::decode(value_);
-  }
+  int virtual_register() const { return virtual_register_; }
 
-  void set_virtual_register(unsigned id) {
-    value_ = VirtualRegisterField::update(value_, id);
-  }
+  void set_virtual_register(int id) { virtual_register_ = id; }
 
   LUnallocated* CopyUnconstrained(Zone* zone) {
     LUnallocated* result = new(zone) LUnallocated(ANY);
@@ -211,9 +205,19 @@ class LUnallocated: public LOperand {
     value_ |= fixed_index << kFixedIndexShift;
     ASSERT(this->fixed_index() == fixed_index);
   }
+
+  int virtual_register_;
 };
 
 
+bool LOperand::Equals(LOperand* other) const {
+  if (value_ != other->value_) return false;
+  if (kind() != UNALLOCATED) return true;
+  return reinterpret_cast<const LUnallocated*>(this)->virtual_register() ==
+      LUnallocated::cast(other)->virtual_register();
+}
+
+
 class LMoveOperands BASE_EMBEDDED {
  public:
   LMoveOperands(LOperand* source, LOperand* destination)
@@ -477,6 +481,7 @@ class LEnvironment: public ZoneObject {
         is_uint32_(value_count, zone),
         spilled_registers_(NULL),
         spilled_double_registers_(NULL),
+        captured_objects_(0, zone),
         outer_(outer),
         entry_(entry),
         zone_(zone) { }
@@ -519,6 +524,38 @@ class LEnvironment: public ZoneObject {
     return is_uint32_.Contains(index);
   }
 
+  // Records that the frame value at |index| is a captured object whose
+  // field values are added after all frame values.
+  void AddCapturedObject(int index, int capture_id, int length) {
+    CapturedObject object = { index, capture_id, values_.length(), length };
+    captured_objects_.Add(object, zone());
+  }
+
+  // Returns the index of the captured object at frame value |index| or -1.
+  int CapturedObjectIndexAt(int index) const {
+    for (int i = 0; i < captured_objects_.length(); ++i) {
+      if (captured_objects_[i].index == index) return i;
+    }
+    return -1;
+  }
+  int captured_object_id(int i) const {
+    return captured_objects_[i].capture_id;
+  }
+  int captured_object_first_value(int i) const {
+    return captured_objects_[i].first_value;
+  }
+  int captured_object_length(int i) const {
+    return captured_objects_[i].length;
+  }
+
+  // The number of frame values, not counting the field values of captured
+  // objects.
+  int translation_size() const {
+    return captured_objects_.is_empty()
+        ? values_.length()
+        : captured_objects_[0].first_value;
+  }
+
   void Register(int deoptimization_index,
                 int translation_index,
                 int pc_offset) {
@@ -560,6 +597,14 @@ class LEnvironment: public ZoneObject {
   LOperand** spilled_registers_;
   LOperand** spilled_double_registers_;
 
+  struct CapturedObject {
+    int index;
+    int capture_id;
+    int first_value;
+    int length;
+  };
+  ZoneList<CapturedObject> captured_objects_;
+
   LEnvironment* outer_;
   HEnterInlined* entry_;
 
@@ -36,12 +36,131 @@ namespace internal {
 
 
 const char* const Log::kLogToTemporaryFile = "&";
+const char Log::kBinaryLogMagic[] = "v8binlog";
+
+
+// Maximum length of a varint encoding a pointer-sized value.
+static const int kMaxVarintLength = (kPointerSize * 8 + 6) / 7;
+
+
+static int EncodeVarint(uintptr_t value, char* buffer) {
+  int length = 0;
+  do {
+    byte bits = static_cast<byte>(value & 0x7f);
+    value >>= 7;
+    if (value != 0) bits |= 0x80;
+    buffer[length++] = static_cast<char>(bits);
+  } while (value != 0);
+  return length;
+}
+
+
+LogFlusher::LogFlusher(FILE* output, int buffer_size)
+    : Thread("v8:LogFlusher"),
+      output_(output),
+      buffer_(NewArray<char>(buffer_size)),
+      buffer_size_(buffer_size),
+      appended_(0),
+      flushed_(0),
+      flush_semaphore_(OS::CreateSemaphore(0)),
+      space_semaphore_(OS::CreateSemaphore(0)),
+      writer_waiting_(0),
+      running_(0),
+      failed_(false) {
+  ASSERT(IsPowerOf2(buffer_size));
+}
+
+
+LogFlusher::~LogFlusher() {
+  ASSERT(!Acquire_Load(&running_));
+  delete space_semaphore_;
+  delete flush_semaphore_;
+  DeleteArray(buffer_);
+}
+
+
+void LogFlusher::Write(const char* data, int length) {
+  ASSERT(length <= buffer_size_);
+  // Only writers update appended_, and they are serialized by the log mutex.
+  uintptr_t appended = static_cast<uintptr_t>(appended_);
+  uintptr_t pending =
+      appended - static_cast<uintptr_t>(Acquire_Load(&flushed_));
+  while (pending + length > static_cast<uintptr_t>(buffer_size_)) {
+    // The buffer is full, sleep until the flusher thread has written it
+    // out. Nothing is appended meanwhile, so one flush makes enough room.
+    ASSERT(Acquire_Load(&running_));
+    Release_Store(&writer_waiting_, 1);
+    flush_semaphore_->Signal();
+    space_semaphore_->Wait();
+    pending = appended - static_cast<uintptr_t>(Acquire_Load(&flushed_));
+  }
+  int start = static_cast<int>(appended & (buffer_size_ - 1));
+  int head_length = Min(length, buffer_size_ - start);
+  memcpy(buffer_ + start, data, head_length);
+  memcpy(buffer_, data + head_length, length - head_length);
+  Release_Store(&appended_, static_cast<AtomicWord>(appended + length));
+  // Wake up the flusher thread early once the buffer is half full.
+  uintptr_t half = static_cast<uintptr_t>(buffer_size_ / 2);
+  if (pending <= half && pending + length > half) flush_semaphore_->Signal();
+}
+
+
+void LogFlusher::Engage() {
+  Release_Store(&running_, 1);
+  Start();
+}
+
+
+void LogFlusher::Disengage() {
+  if (Acquire_Load(&running_)) {
+    Release_Store(&running_, 0);
+    flush_semaphore_->Signal();
+    Join();
+  }
+  // Write out what has been appended since the last flush.
+  Flush();
+}
+
+
+void LogFlusher::Run() {
+  while (Acquire_Load(&running_)) {
+    flush_semaphore_->Wait(kFlushIntervalUs);
+    Flush();
+  }
+}
+
+
+void LogFlusher::Flush() {
+  // Only the flusher thread updates flushed_.
+  uintptr_t flushed = static_cast<uintptr_t>(flushed_);
+  uintptr_t appended = static_cast<uintptr_t>(Acquire_Load(&appended_));
+  bool written = flushed != appended;
+  while (flushed != appended) {
+    int start = static_cast<int>(flushed & (buffer_size_ - 1));
+    int length = static_cast<int>(
+        Min(appended - flushed, static_cast<uintptr_t>(buffer_size_ - start)));
+    if (!failed_) {
+      size_t rv = fwrite(buffer_ + start, 1, length, output_);
+      if (rv != static_cast<size_t>(length)) failed_ = true;
+    }
+    flushed += length;
+    Release_Store(&flushed_, static_cast<AtomicWord>(flushed));
+  }
+  if (written) fflush(output_);
+  // A writer that found the buffer full sets the flag before signalling
+  // flush_semaphore_, so it is either seen here or on the next flush.
+  if (Acquire_Load(&writer_waiting_)) {
+    Release_Store(&writer_waiting_, 0);
+    space_semaphore_->Signal();
+  }
+}
 
 
 Log::Log(Logger* logger)
   : is_stopped_(false),
     output_handle_(NULL),
     ll_output_handle_(NULL),
+    flusher_(NULL),
     mutex_(NULL),
     message_buffer_(NULL),
     logger_(logger) {
@@ -134,6 +253,17 @@ void Log::Initialize() {
     }
   }
 
+  if (output_handle_ != NULL && FLAG_log_binary) {
+    int buffer_size = static_cast<int>(RoundUpToPowerOf2(
+        Max(FLAG_log_buffer_size * KB, 4 * kMessageBufferSize)));
+    flusher_ = new LogFlusher(output_handle_, buffer_size);
+    char version[kMaxVarintLength];
+    int version_length = EncodeVarint(kBinaryLogVersion, version);
+    flusher_->Write(kBinaryLogMagic, StrLength(kBinaryLogMagic));
+    flusher_->Write(version, version_length);
+    flusher_->Engage();
+  }
+
   if (output_handle_ != NULL) {
     LogMessageBuilder msg(logger_);
     msg.Append("v8-version,%d,%d,%d,%d,%d\n", Version::GetMajor(),
@@ -179,8 +309,37 @@ void Log::OpenFile(const char* name) {
 }
 
 
+void Log::WriteRecordHeader(char tag, int length) {
+  ASSERT(flusher_ != NULL);
+  char header[1 + kMaxVarintLength];
+  header[0] = tag;
+  int header_length = 1 + EncodeVarint(length, header + 1);
+  flusher_->Write(header, header_length);
+}
+
+
+int Log::WriteTextRecord(const char* msg, int length) {
+  WriteRecordHeader(kTextRecordTag, length);
+  flusher_->Write(msg, length);
+  return flusher_->ok() ? length : 0;
+}
+
+
+int Log::WriteRecord(const char* record, int length) {
+  ASSERT(length > 0);
+  WriteRecordHeader(record[0], length - 1);
+  flusher_->Write(record + 1, length - 1);
+  return flusher_->ok() ? length : 0;
+}
+
+
 FILE* Log::Close() {
   FILE* result = NULL;
+  if (flusher_ != NULL) {
+    flusher_->Disengage();
+    delete flusher_;
+    flusher_ = NULL;
+  }
   if (output_handle_ != NULL) {
     if (strcmp(FLAG_logfile, kLogToTemporaryFile) != 0) {
       fclose(output_handle_);
@@ -306,6 +465,20 @@ void LogMessageBuilder::AppendStringPart(const char* str, int len) {
 }
 
 
+void LogMessageBuilder::AppendVarint(uintptr_t value) {
+  char buffer[kMaxVarintLength];
+  int length = EncodeVarint(value, buffer);
+  for (int i = 0; i < length; i++) Append(buffer[i]);
+}
+
+
+void LogMessageBuilder::AppendSignedVarint(intptr_t value) {
+  const int kShift = kPointerSize * 8 - 1;
+  AppendVarint((static_cast<uintptr_t>(value) << 1) ^
+               static_cast<uintptr_t>(value >> kShift));
+}
+
+
 void LogMessageBuilder::WriteToLogFile() {
   ASSERT(pos_ <= Log::kMessageBufferSize);
   const int written = log_->WriteToFile(log_->message_buffer_, pos_);
@@ -316,4 +489,14 @@ void LogMessageBuilder::WriteToLogFile() {
 }
 
 
+void LogMessageBuilder::WriteRecordToLogFile() {
+  ASSERT(pos_ <= Log::kMessageBufferSize);
+  const int written = log_->WriteRecord(log_->message_buffer_, pos_);
+  if (written != pos_) {
+    log_->stop();
+    log_->logger_->LogFailure();
+  }
+}
+
+
 } }  // namespace v8::internal
@@ -35,6 +35,58 @@ namespace internal {
 
 class Logger;
 
+
+// Background thread writing out the binary log. Log records are appended to
+// a ring buffer under the log mutex and written to the log file by this
+// thread, so logging threads never wait for file I/O unless the buffer fills
+// up.
+class LogFlusher: public Thread {
+ public:
+  LogFlusher(FILE* output, int buffer_size);
+  virtual ~LogFlusher();
+
+  // Appends data to the ring buffer. If the buffer is full, blocks until
+  // the flusher thread has written it out. Callers must be serialized by
+  // the log mutex.
+  void Write(const char* data, int length);
+
+  // Returns whether all data has been written to the output so far.
+  bool ok() const { return !failed_; }
+
+  // Starts the flusher thread.
+  void Engage();
+
+  // Writes out the remaining data and terminates the flusher thread.
+  void Disengage();
+
+  virtual void Run();
+
+ private:
+  // Writes out everything appended to the buffer so far.
+  void Flush();
+
+  // Interval between periodic flushes, in microseconds.
+  static const int kFlushIntervalUs = 100000;
+
+  FILE* output_;
+  char* buffer_;
+  // Size of the ring buffer. Always a power of 2.
+  int buffer_size_;
+  // Total number of bytes appended to and written out of the buffer. The
+  // difference of the two is the amount of data waiting to be written.
+  AtomicWord appended_;
+  AtomicWord flushed_;
+  // Signalled when the buffer is getting full or the thread should stop.
+  Semaphore* flush_semaphore_;
+  // Signalled by the flusher thread once it has made room for a writer
+  // that found the buffer full and set writer_waiting_.
+  Semaphore* space_semaphore_;
+  Atomic32 writer_waiting_;
+  Atomic32 running_;
+  bool failed_;
+};
+
+
 // Functions and data for performing output of log messages.
 class Log {
  public:
@@ -54,6 +106,9 @@ class Log {
     return !is_stopped_ && output_handle_ != NULL;
   }
 
+  // Returns whether the log is written in the binary format (--log-binary).
+  bool is_binary() const { return flusher_ != NULL; }
+
   // Size of buffer used for formatting log messages.
   static const int kMessageBufferSize = 2048;
 
@@ -61,6 +116,16 @@ class Log {
   // deleted on close and thus can't be accessed afterwards.
   static const char* const kLogToTemporaryFile;
 
+  // A binary log starts with this magic string followed by the format
+  // version as a varint, then a sequence of records. Each record is a one
+  // byte tag, the varint length of its fields and the fields. Integers are
+  // encoded as unsigned LEB128 varints, signed ones are zigzag-encoded
+  // first. Messages that have no binary encoding are written as text
+  // records tagged kTextRecordTag. See tools/logreader.js for a decoder.
+  static const char kBinaryLogMagic[];
+  static const int kBinaryLogVersion = 2;
+  static const char kTextRecordTag = 'T';
+
  private:
   explicit Log(Logger* logger);
 
@@ -76,6 +141,7 @@ class Log {
   // Implementation of writing to a log file.
   int WriteToFile(const char* msg, int length) {
     ASSERT(output_handle_ != NULL);
+    if (flusher_ != NULL) return WriteTextRecord(msg, length);
     size_t rv = fwrite(msg, 1, length, output_handle_);
     ASSERT(static_cast<size_t>(length) == rv);
     USE(rv);
@@ -83,6 +149,16 @@ class Log {
     return length;
   }
 
+  // Appends a text message to the binary log as a text record.
+  int WriteTextRecord(const char* msg, int length);
+
+  // Appends a record to the binary log. The record starts with its tag,
+  // which is followed by the length of the rest of the record.
+  int WriteRecord(const char* record, int length);
+
+  // Appends a record header: the tag and the length of the fields.
+  void WriteRecordHeader(char tag, int length);
+
   // Whether logging is stopped (e.g. due to insufficient resources).
   bool is_stopped_;
 
@@ -93,6 +169,9 @@ class Log {
   // Used when low-level profiling is active.
   FILE* ll_output_handle_;
 
+  // Used when the log is written in the binary format.
+  LogFlusher* flusher_;
+
   // mutex_ is a Mutex used for enforcing exclusive
   // access to the formatting buffer and the log file or log memory buffer.
   Mutex* mutex_;
@@ -137,9 +216,20 @@ class LogMessageBuilder BASE_EMBEDDED {
   // Append a portion of a string.
   void AppendStringPart(const char* str, int len);
 
+  // Append an unsigned LEB128 varint to a binary log record.
+  void AppendVarint(uintptr_t value);
+
+  // Append a zigzag-encoded signed varint to a binary log record.
+  void AppendSignedVarint(intptr_t value);
+
   // Write the log message to the log file currently opened.
   void WriteToLogFile();
 
+  // Write the binary log record to the log file currently opened. Records
+  // that did not fit into the buffer are cut short; readers rely on the
+  // record length rather than on the terminator of the trailing string.
+  void WriteRecordToLogFile();
+
  private:
   Log* log_;
   ScopedLock sl;
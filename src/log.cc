@@ -367,6 +367,15 @@ struct LowLevelSnapshotPositionStruct {
 static const char kCodeMovingGCTag = 'G';
 
 
+// Binary log (--log-binary) record tags. Log::kTextRecordTag is used for
+// the remaining messages.
+static const char kBinaryEventNamesTag = 'N';
+static const char kBinaryCodeCreateTag = 'C';
+static const char kBinaryMoveTag = 'M';
+static const char kBinaryDeleteTag = 'D';
+static const char kBinaryTickTag = 't';
+
+
 //
 // Logger class implementation.
 //
@@ -446,6 +455,267 @@ class Logger::NameMap {
 };
 
 
+// Writes /tmp/perf-<pid>.map for Linux perf. Each line gives the start,
+// size and name of the instructions of a code object. Code moved by the
+// compacting collector gets a new line at its new address, which is why
+// the names are kept around.
+class Logger::PerfBasicLogger {
+ public:
+  PerfBasicLogger() {
+    ScopedVector<char> file_name(kFileNameSize);
+    OS::SNPrintF(file_name, "/tmp/perf-%d.map", OS::GetCurrentProcessId());
+    output_handle_ = OS::FOpen(file_name.start(), OS::LogFileOpenMode);
+    // Line buffering keeps the map usable while the process is running.
+    if (output_handle_ != NULL) setvbuf(output_handle_, NULL, _IOLBF, 0);
+  }
+
+  ~PerfBasicLogger() {
+    if (output_handle_ != NULL) fclose(output_handle_);
+  }
+
+  void CodeCreateEvent(Code* code, const char* name, int name_size) {
+    if (output_handle_ == NULL) return;
+    // Code deletion is not reported, so drop the name of any dead code
+    // that used to live at this address.
+    names_.Remove(code->address());
+    names_.Insert(code->address(), name, name_size);
+    WriteEntry(code->instruction_start(), code->instruction_size(),
+               name, name_size);
+  }
+
+  void CodeMoveEvent(Address from, Address to) {
+    if (output_handle_ == NULL || from == to) return;
+    const char* name = names_.Lookup(from);
+    if (name == NULL) return;
+    // The code has not been copied yet, so read it at the old address.
+    Code* code = Code::cast(HeapObject::FromAddress(from));
+    WriteEntry(code->instruction_start() + (to - from),
+               code->instruction_size(),
+               name, StrLength(name));
+    names_.Remove(to);
+    names_.Move(from, to);
+  }
+
+  void CodeDeleteEvent(Address from) {
+    names_.Remove(from);
+  }
+
+ private:
+  void WriteEntry(Address start, int size, const char* name, int name_size) {
+    OS::FPrint(output_handle_, "%" V8PRIxPTR " %x %.*s\n",
+               reinterpret_cast<uintptr_t>(start), size, name_size, name);
+  }
+
+  static const int kFileNameSize = 64;
+
+  FILE* output_handle_;
+  NameMap names_;
+
+  DISALLOW_COPY_AND_ASSIGN(PerfBasicLogger);
+};
+
+
+// Jitdump file structures, see tools/perf/Documentation/
+// jitdump-specification.txt in the Linux sources.
+
+struct PerfJitHeader {
+  static const uint32_t kMagic = 0x4A695444;
+  static const uint32_t kVersion = 1;
+
+  uint32_t magic;
+  uint32_t version;
+  uint32_t size;
+  uint32_t elf_mach;
+  uint32_t reserved;
+  uint32_t process_id;
+  uint64_t time_stamp;
+  uint64_t flags;
+};
+
+
+struct PerfJitRecordHeader {
+  uint32_t id;
+  uint32_t size;
+  uint64_t time_stamp;
+};
+
+
+struct PerfJitCodeLoad {
+  static const uint32_t kId = 0;
+
+  PerfJitRecordHeader header;
+  uint32_t process_id;
+  uint32_t thread_id;
+  uint64_t vma;
+  uint64_t code_address;
+  uint64_t code_size;
+  uint64_t code_id;
+  // Followed by the NUL-terminated name and the code.
+};
+
+
+struct PerfJitCodeMove {
+  static const uint32_t kId = 1;
+
+  PerfJitRecordHeader header;
+  uint32_t process_id;
+  uint32_t thread_id;
+  uint64_t vma;
+  uint64_t old_code_address;
+  uint64_t new_code_address;
+  uint64_t code_size;
+  uint64_t code_id;
+};
+
+
+struct PerfJitCodeClose {
+  static const uint32_t kId = 3;
+
+  PerfJitRecordHeader header;
+};
+
+
+// Writes jit-<pid>.dump in the jitdump format of Linux perf. Running
+// "perf inject --jit" on a profile recorded with "perf record -k mono"
+// turns the dump into ELF images of the generated code, which perf report
+// can then symbolize and annotate.
+class Logger::PerfJitLogger {
+ public:
+  PerfJitLogger()
+      : code_ids_(&PointerEquals),
+        next_code_id_(0),
+        process_id_(OS::GetCurrentProcessId()) {
+    ScopedVector<char> file_name(kFileNameSize);
+    OS::SNPrintF(file_name, "jit-%d.dump", process_id_);
+    output_handle_ = OS::FOpen(file_name.start(), "w+");
+    if (output_handle_ == NULL) return;
+    setvbuf(output_handle_, NULL, _IOFBF, kBufferSize);
+
+    PerfJitHeader header;
+    header.magic = PerfJitHeader::kMagic;
+    header.version = PerfJitHeader::kVersion;
+    header.size = sizeof(header);
+    header.elf_mach = GetElfMach();
+    header.reserved = 0;
+    header.process_id = process_id_;
+    header.time_stamp = OS::JitDumpTimestamp();
+    header.flags = 0;
+    WriteBytes(&header, sizeof(header));
+    OS::SignalJitDumpFile(output_handle_);
+  }
+
+  ~PerfJitLogger() {
+    if (output_handle_ == NULL) return;
+    PerfJitCodeClose close;
+    InitRecordHeader(&close.header, PerfJitCodeClose::kId, sizeof(close));
+    WriteBytes(&close, sizeof(close));
+    fclose(output_handle_);
+  }
+
+  void CodeCreateEvent(Code* code, const char* name, int name_size) {
+    if (output_handle_ == NULL) return;
+    uint64_t code_id = next_code_id_++;
+    SetCodeId(code->address(), code_id);
+
+    int code_size = code->instruction_size();
+    PerfJitCodeLoad load;
+    InitRecordHeader(&load.header, PerfJitCodeLoad::kId,
+                     sizeof(load) + name_size + 1 + code_size);
+    load.process_id = process_id_;
+    load.thread_id = process_id_;
+    load.vma = reinterpret_cast<uintptr_t>(code->instruction_start());
+    load.code_address = load.vma;
+    load.code_size = code_size;
+    load.code_id = code_id;
+    WriteBytes(&load, sizeof(load));
+    WriteBytes(name, name_size);
+    WriteBytes("", 1);
+    WriteBytes(code->instruction_start(), code_size);
+  }
+
+  void CodeMoveEvent(Address from, Address to) {
+    if (output_handle_ == NULL || from == to) return;
+    HashMap::Entry* entry =
+        code_ids_.Lookup(from, ComputePointerHash(from), false);
+    if (entry == NULL) return;
+    uint64_t code_id = reinterpret_cast<uintptr_t>(entry->value);
+    code_ids_.Remove(from, ComputePointerHash(from));
+    SetCodeId(to, code_id);
+
+    // The code has not been copied yet, so read it at the old address.
+    Code* code = Code::cast(HeapObject::FromAddress(from));
+    PerfJitCodeMove move;
+    InitRecordHeader(&move.header, PerfJitCodeMove::kId, sizeof(move));
+    move.process_id = process_id_;
+    move.thread_id = process_id_;
+    move.old_code_address =
+        reinterpret_cast<uintptr_t>(code->instruction_start());
+    move.new_code_address = move.old_code_address + (to - from);
+    move.vma = move.new_code_address;
+    move.code_size = code->instruction_size();
+    move.code_id = code_id;
+    WriteBytes(&move, sizeof(move));
+  }
+
+  void CodeDeleteEvent(Address from) {
+    code_ids_.Remove(from, ComputePointerHash(from));
+  }
+
+ private:
+  static bool PointerEquals(void* lhs, void* rhs) {
+    return lhs == rhs;
+  }
+
+  static uint32_t GetElfMach() {
+#if V8_TARGET_ARCH_IA32
+    return 3;  // EM_386
+#elif V8_TARGET_ARCH_X64
+    return 62;  // EM_X86_64
+#elif V8_TARGET_ARCH_ARM
+    return 40;  // EM_ARM
+#elif V8_TARGET_ARCH_MIPS
+    return 8;  // EM_MIPS
+#else
+    return 0;  // EM_NONE
+#endif
+  }
+
+  static void InitRecordHeader(PerfJitRecordHeader* header,
+                               uint32_t id,
+                               size_t size) {
+    header->id = id;
+    header->size = static_cast<uint32_t>(size);
+    header->time_stamp = OS::JitDumpTimestamp();
+  }
+
+  void SetCodeId(Address code_address, uint64_t code_id) {
+    // Ids are only used to match moves with loads, so they may safely
+    // be truncated to pointer size.
+    HashMap::Entry* entry = code_ids_.Lookup(
+        code_address, ComputePointerHash(code_address), true);
+    entry->value = reinterpret_cast<void*>(static_cast<uintptr_t>(code_id));
+  }
+
+  void WriteBytes(const void* bytes, size_t size) {
+    size_t rv = fwrite(bytes, 1, size, output_handle_);
+    ASSERT(size == rv);
+    USE(rv);
+  }
+
+  static const int kFileNameSize = 64;
+  // File buffer size of the dump, it is only read after the process exits.
+  static const int kBufferSize = 2 * MB;
+
+  FILE* output_handle_;
+  // Maps code object addresses to the ids of their load records.
+  HashMap code_ids_;
+  uint64_t next_code_id_;
+  int process_id_;
+
+  DISALLOW_COPY_AND_ASSIGN(PerfJitLogger);
+};
+
+
 class Logger::NameBuffer {
  public:
   NameBuffer() { Reset(); }
@@ -525,6 +795,8 @@ Logger::Logger()
     log_(new Log(this)),
     name_buffer_(new NameBuffer),
     address_to_name_map_(NULL),
+    perf_basic_logger_(NULL),
+    perf_jit_logger_(NULL),
     is_initialized_(false),
     code_event_handler_(NULL),
     last_address_(NULL),
@@ -536,6 +808,8 @@ Logger::Logger()
 
 
 Logger::~Logger() {
+  delete perf_basic_logger_;
+  delete perf_jit_logger_;
   delete address_to_name_map_;
   delete name_buffer_;
   delete log_;
@@ -603,6 +877,19 @@ void Logger::ProfilerBeginEvent() {
 }
 
 
+void Logger::BinaryEventNamesEvent() {
+  if (!log_->IsEnabled() || !log_->is_binary()) return;
+  LogMessageBuilder msg(this);
+  msg.Append(kBinaryEventNamesTag);
+  msg.AppendVarint(NUMBER_OF_LOG_EVENTS);
+  for (int i = 0; i < NUMBER_OF_LOG_EVENTS; i++) {
+    msg.AppendStringPart(kLogEventsNames[i], StrLength(kLogEventsNames[i]));
+    msg.Append('\0');
+  }
+  msg.WriteRecordToLogFile();
+}
+
+
 void Logger::StringEvent(const char* name, const char* value) {
   if (FLAG_log) UncheckedStringEvent(name, value);
 }
@@ -912,7 +1199,8 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
                              Code* code,
                              const char* comment) {
   if (!is_logging_code_events()) return;
-  if (FLAG_ll_prof || Serializer::enabled() || code_event_handler_ != NULL) {
+  if (FLAG_ll_prof || Serializer::enabled() || code_event_handler_ != NULL ||
+      is_logging_perf_events()) {
     name_buffer_->Reset();
     name_buffer_->AppendBytes(kLogEventsNames[tag]);
     name_buffer_->AppendByte(':');
@@ -921,6 +1209,9 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
   if (code_event_handler_ != NULL) {
     IssueCodeAddedEvent(code, name_buffer_->get(), name_buffer_->size());
   }
+  if (is_logging_perf_events()) {
+    PerfCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
+  }
   if (!log_->IsEnabled()) return;
   if (FLAG_ll_prof) {
     LowLevelCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
@@ -930,20 +1221,14 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
   }
   if (!FLAG_log_code) return;
   LogMessageBuilder msg(this);
-  msg.Append("%s,%s,",
-             kLogEventsNames[CODE_CREATION_EVENT],
-             kLogEventsNames[tag]);
-  msg.AppendAddress(code->address());
-  msg.Append(",%d,\"", code->ExecutableSize());
+  AppendCodeCreateHeader(&msg, tag, code, NULL);
   for (const char* p = comment; *p != '\0'; p++) {
     if (*p == '"') {
       msg.Append('\\');
     }
     msg.Append(*p);
   }
-  msg.Append('"');
-  msg.Append('\n');
-  msg.WriteToLogFile();
+  AppendCodeCreateFooter(&msg, code, NULL);
 }
 
 
@@ -951,7 +1236,8 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
                              Code* code,
                              String* name) {
   if (!is_logging_code_events()) return;
-  if (FLAG_ll_prof || Serializer::enabled() || code_event_handler_ != NULL) {
+  if (FLAG_ll_prof || Serializer::enabled() || code_event_handler_ != NULL ||
+      is_logging_perf_events()) {
     name_buffer_->Reset();
     name_buffer_->AppendBytes(kLogEventsNames[tag]);
     name_buffer_->AppendByte(':');
@@ -960,6 +1246,9 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
   if (code_event_handler_ != NULL) {
     IssueCodeAddedEvent(code, name_buffer_->get(), name_buffer_->size());
   }
+  if (is_logging_perf_events()) {
+    PerfCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
+  }
   if (!log_->IsEnabled()) return;
   if (FLAG_ll_prof) {
     LowLevelCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
@@ -969,15 +1258,9 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
   }
   if (!FLAG_log_code) return;
   LogMessageBuilder msg(this);
-  msg.Append("%s,%s,",
-             kLogEventsNames[CODE_CREATION_EVENT],
-             kLogEventsNames[tag]);
-  msg.AppendAddress(code->address());
-  msg.Append(",%d,\"", code->ExecutableSize());
+  AppendCodeCreateHeader(&msg, tag, code, NULL);
   msg.AppendDetailed(name, false);
-  msg.Append('"');
-  msg.Append('\n');
-  msg.WriteToLogFile();
+  AppendCodeCreateFooter(&msg, code, NULL);
 }
 
 
@@ -991,12 +1274,60 @@ static const char* ComputeMarker(Code* code) {
 }
 
 
+void Logger::AppendCodeCreateHeader(LogMessageBuilder* msg,
+                                    LogEventsAndTags tag,
+                                    Code* code,
+                                    SharedFunctionInfo* shared) {
+  if (log_->is_binary()) {
+    // The code name is the last field of the record, so that a name cut
+    // short by the buffer size does not corrupt the log.
+    msg->Append(kBinaryCodeCreateTag);
+    msg->AppendVarint(tag);
+    msg->AppendVarint(reinterpret_cast<uintptr_t>(code->address()));
+    msg->AppendVarint(code->ExecutableSize());
+    if (shared != NULL) {
+      msg->AppendVarint(reinterpret_cast<uintptr_t>(shared->address()));
+      msg->Append("%s", ComputeMarker(code));
+      msg->Append('\0');
+    } else {
+      msg->AppendVarint(0);
+    }
+    return;
+  }
+  msg->Append("%s,%s,",
+              kLogEventsNames[CODE_CREATION_EVENT],
+              kLogEventsNames[tag]);
+  msg->AppendAddress(code->address());
+  msg->Append(",%d,\"", code->ExecutableSize());
+}
+
+
+void Logger::AppendCodeCreateFooter(LogMessageBuilder* msg,
+                                    Code* code,
+                                    SharedFunctionInfo* shared) {
+  if (log_->is_binary()) {
+    msg->Append('\0');
+    msg->WriteRecordToLogFile();
+    return;
+  }
+  msg->Append('"');
+  if (shared != NULL) {
+    msg->Append(',');
+    msg->AppendAddress(shared->address());
+    msg->Append(",%s", ComputeMarker(code));
+  }
+  msg->Append('\n');
+  msg->WriteToLogFile();
+}
+
+
 void Logger::CodeCreateEvent(LogEventsAndTags tag,
                              Code* code,
                              SharedFunctionInfo* shared,
                              String* name) {
   if (!is_logging_code_events()) return;
-  if (FLAG_ll_prof || Serializer::enabled() || code_event_handler_ != NULL) {
+  if (FLAG_ll_prof || Serializer::enabled() || code_event_handler_ != NULL ||
+      is_logging_perf_events()) {
     name_buffer_->Reset();
     name_buffer_->AppendBytes(kLogEventsNames[tag]);
     name_buffer_->AppendByte(':');
@@ -1006,6 +1337,9 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
   if (code_event_handler_ != NULL) {
     IssueCodeAddedEvent(code, name_buffer_->get(), name_buffer_->size());
   }
+  if (is_logging_perf_events()) {
+    PerfCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
+  }
   if (!log_->IsEnabled()) return;
   if (FLAG_ll_prof) {
     LowLevelCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
@@ -1021,15 +1355,9 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
   LogMessageBuilder msg(this);
   SmartArrayPointer<char> str =
       name->ToCString(DISALLOW_NULLS, ROBUST_STRING_TRAVERSAL);
-  msg.Append("%s,%s,",
-             kLogEventsNames[CODE_CREATION_EVENT],
-             kLogEventsNames[tag]);
-  msg.AppendAddress(code->address());
-  msg.Append(",%d,\"%s\",", code->ExecutableSize(), *str);
-  msg.AppendAddress(shared->address());
-  msg.Append(",%s", ComputeMarker(code));
-  msg.Append('\n');
-  msg.WriteToLogFile();
+  AppendCodeCreateHeader(&msg, tag, code, shared);
+  msg.Append("%s", *str);
+  AppendCodeCreateFooter(&msg, code, shared);
 }
 
 
@@ -1041,7 +1369,8 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
                              SharedFunctionInfo* shared,
                              String* source, int line) {
   if (!is_logging_code_events()) return;
-  if (FLAG_ll_prof || Serializer::enabled() || code_event_handler_ != NULL) {
+  if (FLAG_ll_prof || Serializer::enabled() || code_event_handler_ != NULL ||
+      is_logging_perf_events()) {
     name_buffer_->Reset();
     name_buffer_->AppendBytes(kLogEventsNames[tag]);
     name_buffer_->AppendByte(':');
@@ -1055,6 +1384,9 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
   if (code_event_handler_ != NULL) {
     IssueCodeAddedEvent(code, name_buffer_->get(), name_buffer_->size());
   }
+  if (is_logging_perf_events()) {
+    PerfCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
+  }
   if (!log_->IsEnabled()) return;
   if (FLAG_ll_prof) {
     LowLevelCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
@@ -1068,25 +1400,16 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
       shared->DebugName()->ToCString(DISALLOW_NULLS, ROBUST_STRING_TRAVERSAL);
   SmartArrayPointer<char> sourcestr =
       source->ToCString(DISALLOW_NULLS, ROBUST_STRING_TRAVERSAL);
-  msg.Append("%s,%s,",
-             kLogEventsNames[CODE_CREATION_EVENT],
-             kLogEventsNames[tag]);
-  msg.AppendAddress(code->address());
-  msg.Append(",%d,\"%s %s:%d\",",
-             code->ExecutableSize(),
-             *name,
-             *sourcestr,
-             line);
-  msg.AppendAddress(shared->address());
-  msg.Append(",%s", ComputeMarker(code));
-  msg.Append('\n');
-  msg.WriteToLogFile();
+  AppendCodeCreateHeader(&msg, tag, code, shared);
+  msg.Append("%s %s:%d", *name, *sourcestr, line);
+  AppendCodeCreateFooter(&msg, code, shared);
 }
 
 
 void Logger::CodeCreateEvent(LogEventsAndTags tag, Code* code, int args_count) {
   if (!is_logging_code_events()) return;
-  if (FLAG_ll_prof || Serializer::enabled() || code_event_handler_ != NULL) {
+  if (FLAG_ll_prof || Serializer::enabled() || code_event_handler_ != NULL ||
+      is_logging_perf_events()) {
     name_buffer_->Reset();
     name_buffer_->AppendBytes(kLogEventsNames[tag]);
     name_buffer_->AppendByte(':');
@@ -1095,6 +1418,9 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag, Code* code, int args_count) {
   if (code_event_handler_ != NULL) {
     IssueCodeAddedEvent(code, name_buffer_->get(), name_buffer_->size());
   }
+  if (is_logging_perf_events()) {
+    PerfCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
+  }
   if (!log_->IsEnabled()) return;
   if (FLAG_ll_prof) {
     LowLevelCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
@@ -1104,13 +1430,9 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag, Code* code, int args_count) {
   }
   if (!FLAG_log_code) return;
   LogMessageBuilder msg(this);
-  msg.Append("%s,%s,",
-             kLogEventsNames[CODE_CREATION_EVENT],
-             kLogEventsNames[tag]);
-  msg.AppendAddress(code->address());
-  msg.Append(",%d,\"args_count: %d\"", code->ExecutableSize(), args_count);
-  msg.Append('\n');
-  msg.WriteToLogFile();
+  AppendCodeCreateHeader(&msg, tag, code, NULL);
+  msg.Append("args_count: %d", args_count);
+  AppendCodeCreateFooter(&msg, code, NULL);
 }
 
 
@@ -1123,7 +1445,8 @@ void Logger::CodeMovingGCEvent() {
 
 void Logger::RegExpCodeCreateEvent(Code* code, String* source) {
   if (!is_logging_code_events()) return;
-  if (FLAG_ll_prof || Serializer::enabled() || code_event_handler_ != NULL) {
+  if (FLAG_ll_prof || Serializer::enabled() || code_event_handler_ != NULL ||
+      is_logging_perf_events()) {
     name_buffer_->Reset();
     name_buffer_->AppendBytes(kLogEventsNames[REG_EXP_TAG]);
     name_buffer_->AppendByte(':');
@@ -1132,6 +1455,9 @@ void Logger::RegExpCodeCreateEvent(Code* code, String* source) {
   if (code_event_handler_ != NULL) {
     IssueCodeAddedEvent(code, name_buffer_->get(), name_buffer_->size());
   }
+  if (is_logging_perf_events()) {
+    PerfCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
+  }
   if (!log_->IsEnabled()) return;
   if (FLAG_ll_prof) {
     LowLevelCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
@@ -1141,20 +1467,15 @@ void Logger::RegExpCodeCreateEvent(Code* code, String* source) {
   }
   if (!FLAG_log_code) return;
   LogMessageBuilder msg(this);
-  msg.Append("%s,%s,",
-             kLogEventsNames[CODE_CREATION_EVENT],
-             kLogEventsNames[REG_EXP_TAG]);
-  msg.AppendAddress(code->address());
-  msg.Append(",%d,\"", code->ExecutableSize());
+  AppendCodeCreateHeader(&msg, REG_EXP_TAG, code, NULL);
   msg.AppendDetailed(source, false);
-  msg.Append('\"');
-  msg.Append('\n');
-  msg.WriteToLogFile();
+  AppendCodeCreateFooter(&msg, code, NULL);
 }
 
 
 void Logger::CodeMoveEvent(Address from, Address to) {
   if (code_event_handler_ != NULL) IssueCodeMovedEvent(from, to);
+  if (is_logging_perf_events()) PerfCodeMoveEvent(from, to);
   if (!log_->IsEnabled()) return;
   if (FLAG_ll_prof) LowLevelCodeMoveEvent(from, to);
   if (Serializer::enabled() && address_to_name_map_ != NULL) {
@@ -1166,6 +1487,7 @@ void Logger::CodeMoveEvent(Address from, Address to) {
 
 void Logger::CodeDeleteEvent(Address from) {
   if (code_event_handler_ != NULL) IssueCodeRemovedEvent(from);
+  if (is_logging_perf_events()) PerfCodeDeleteEvent(from);
   if (!log_->IsEnabled()) return;
   if (FLAG_ll_prof) LowLevelCodeDeleteEvent(from);
   if (Serializer::enabled() && address_to_name_map_ != NULL) {
@@ -1210,6 +1532,14 @@ void Logger::MoveEventInternal(LogEventsAndTags event,
                                Address to) {
   if (!log_->IsEnabled() || !FLAG_log_code) return;
   LogMessageBuilder msg(this);
+  if (log_->is_binary()) {
+    msg.Append(kBinaryMoveTag);
+    msg.AppendVarint(event);
+    msg.AppendVarint(reinterpret_cast<uintptr_t>(from));
+    msg.AppendVarint(reinterpret_cast<uintptr_t>(to));
+    msg.WriteRecordToLogFile();
+    return;
+  }
   msg.Append("%s,", kLogEventsNames[event]);
   msg.AppendAddress(from);
   msg.Append(',');
@@ -1222,6 +1552,13 @@ void Logger::MoveEventInternal(LogEventsAndTags event,
 void Logger::DeleteEventInternal(LogEventsAndTags event, Address from) {
   if (!log_->IsEnabled() || !FLAG_log_code) return;
   LogMessageBuilder msg(this);
+  if (log_->is_binary()) {
+    msg.Append(kBinaryDeleteTag);
+    msg.AppendVarint(event);
+    msg.AppendVarint(reinterpret_cast<uintptr_t>(from));
+    msg.WriteRecordToLogFile();
+    return;
+  }
   msg.Append("%s,", kLogEventsNames[event]);
   msg.AppendAddress(from);
   msg.Append('\n');
@@ -1317,6 +1654,27 @@ void Logger::DebugEvent(const char* event_type, Vector<uint16_t> parameter) {
 void Logger::TickEvent(TickSample* sample, bool overflow) {
   if (!log_->IsEnabled() || !FLAG_prof) return;
   LogMessageBuilder msg(this);
+  if (log_->is_binary()) {
+    msg.Append(kBinaryTickTag);
+    msg.AppendVarint(reinterpret_cast<uintptr_t>(sample->pc));
+    msg.AppendVarint(reinterpret_cast<uintptr_t>(sample->sp));
+    msg.Append(static_cast<char>((sample->has_external_callback ? 1 : 0) |
+                                 (overflow ? 2 : 0)));
+    msg.AppendVarint(reinterpret_cast<uintptr_t>(
+        sample->has_external_callback ? sample->external_callback
+                                      : sample->tos));
+    msg.AppendVarint(static_cast<int>(sample->state));
+    msg.AppendVarint(sample->frames_count);
+    // Frames are mostly close to each other, so write each one as the
+    // offset from the previous one.
+    Address previous = sample->pc;
+    for (int i = 0; i < sample->frames_count; ++i) {
+      msg.AppendSignedVarint(sample->stack[i] - previous);
+      previous = sample->stack[i];
+    }
+    msg.WriteRecordToLogFile();
+    return;
+  }
   msg.Append("%s,", kLogEventsNames[TICK_EVENT]);
   msg.AppendAddress(sample->pc);
   msg.Append(',');
@@ -1600,6 +1958,30 @@ void Logger::LowLevelLogWriteBytes(const char* bytes, int size) {
 }
 
 
+void Logger::PerfCodeCreateEvent(Code* code,
+                                 const char* name,
+                                 int name_size) {
+  if (perf_basic_logger_ != NULL) {
+    perf_basic_logger_->CodeCreateEvent(code, name, name_size);
+  }
+  if (perf_jit_logger_ != NULL) {
+    perf_jit_logger_->CodeCreateEvent(code, name, name_size);
+  }
+}
+
+
+void Logger::PerfCodeMoveEvent(Address from, Address to) {
+  if (perf_basic_logger_ != NULL) perf_basic_logger_->CodeMoveEvent(from, to);
+  if (perf_jit_logger_ != NULL) perf_jit_logger_->CodeMoveEvent(from, to);
+}
+
+
+void Logger::PerfCodeDeleteEvent(Address from) {
+  if (perf_basic_logger_ != NULL) perf_basic_logger_->CodeDeleteEvent(from);
+  if (perf_jit_logger_ != NULL) perf_jit_logger_->CodeDeleteEvent(from);
+}
+
+
 void Logger::LogCodeObjects() {
   HEAP->CollectAllGarbage(Heap::kMakeHeapIterableMask,
                           "Logger::LogCodeObjects");
@@ -1719,11 +2101,19 @@ bool Logger::SetUp() {
   // ASSERT(VMState::is_outermost_external());
 
   log_->Initialize();
+  BinaryEventNamesEvent();
 
   if (FLAG_ll_prof) LogCodeInfo();
 
   Isolate* isolate = Isolate::Current();
-  ticker_ = new Ticker(isolate, kSamplingIntervalMs);
+
+  // The perf files are named after the process, so only the default
+  // isolate writes them.
+  if (isolate->IsDefaultIsolate()) {
+    if (FLAG_perf_map) perf_basic_logger_ = new PerfBasicLogger();
+    if (FLAG_perf_jitdump) perf_jit_logger_ = new PerfJitLogger();
+  }
+  ticker_ = new Ticker(isolate, SamplingIntervalUs());
 
   if (FLAG_sliding_state_window && sliding_state_window_ == NULL) {
     sliding_state_window_ = new SlidingStateWindow(isolate);
@@ -1798,6 +2188,11 @@ FILE* Logger::TearDown() {
   delete ticker_;
   ticker_ = NULL;
 
+  delete perf_basic_logger_;
+  perf_basic_logger_ = NULL;
+  delete perf_jit_logger_;
+  perf_jit_logger_ = NULL;
+
   return log_->Close();
 }
 
@@ -1818,10 +2213,11 @@ void Logger::EnableSlidingStateWindow() {
   }
 }
 
-// Protects the state below.
+// Serializes updates of the state below.
 static Mutex* active_samplers_mutex = NULL;
 
-List<Sampler*>* SamplerRegistry::active_samplers_ = NULL;
+AtomicWord SamplerRegistry::active_samplers_ = 0;
+Atomic32 SamplerRegistry::iterations_in_progress_ = 0;
 
 
 void SamplerRegistry::SetUp() {
@@ -1832,13 +2228,16 @@ void SamplerRegistry::SetUp() {
 
 
 bool SamplerRegistry::IterateActiveSamplers(VisitSampler func, void* param) {
-  ScopedLock lock(active_samplers_mutex);
-  for (int i = 0;
-       ActiveSamplersExist() && i < active_samplers_->length();
-       ++i) {
-    func(active_samplers_->at(i), param);
+  // The full barrier orders the increment before loading the list, which
+  // ReplaceActiveSamplers relies on.
+  Barrier_AtomicIncrement(&iterations_in_progress_, 1);
+  List<Sampler*>* samplers = active_samplers();
+  bool exist = samplers != NULL && !samplers->is_empty();
+  for (int i = 0; exist && i < samplers->length(); ++i) {
+    func(samplers->at(i), param);
   }
-  return ActiveSamplersExist();
+  Barrier_AtomicIncrement(&iterations_in_progress_, -1);
+  return exist;
 }
 
 
@@ -1860,22 +2259,37 @@ SamplerRegistry::State SamplerRegistry::GetState() {
 void SamplerRegistry::AddActiveSampler(Sampler* sampler) {
   ASSERT(sampler->IsActive());
   ScopedLock lock(active_samplers_mutex);
-  if (active_samplers_ == NULL) {
-    active_samplers_ = new List<Sampler*>;
-  } else {
-    ASSERT(!active_samplers_->Contains(sampler));
+  List<Sampler*>* samplers = new List<Sampler*>;
+  if (active_samplers() != NULL) {
+    ASSERT(!active_samplers()->Contains(sampler));
+    samplers->AddAll(*active_samplers());
   }
-  active_samplers_->Add(sampler);
+  samplers->Add(sampler);
+  ReplaceActiveSamplers(samplers);
 }
 
 
 void SamplerRegistry::RemoveActiveSampler(Sampler* sampler) {
   ASSERT(sampler->IsActive());
   ScopedLock lock(active_samplers_mutex);
-  ASSERT(active_samplers_ != NULL);
-  bool removed = active_samplers_->RemoveElement(sampler);
+  ASSERT(active_samplers() != NULL);
+  List<Sampler*>* samplers = new List<Sampler*>;
+  samplers->AddAll(*active_samplers());
+  bool removed = samplers->RemoveElement(sampler);
   ASSERT(removed);
   USE(removed);
+  ReplaceActiveSamplers(samplers);
+}
+
+
+void SamplerRegistry::ReplaceActiveSamplers(List<Sampler*>* samplers) {
+  List<Sampler*>* old_samplers = active_samplers();
+  Release_Store(&active_samplers_, reinterpret_cast<AtomicWord>(samplers));
+  // Wait for iterations that may have loaded the old list. Iterations
+  // starting from now on see the new one.
+  MemoryBarrier();
+  while (Acquire_Load(&iterations_in_progress_) > 0) Thread::YieldCPU();
+  delete old_samplers;
 }
 
 } }  // namespace v8::internal
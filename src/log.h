@@ -288,7 +288,8 @@ class Logger {
   }
 
   bool is_logging_code_events() {
-    return is_logging() || code_event_handler_ != NULL;
+    return is_logging() || code_event_handler_ != NULL ||
+        is_logging_perf_events();
   }
 
   // Pause/Resume collection of profiling data.
@@ -319,12 +320,22 @@ class Logger {
   static const int kSamplingIntervalMs = 1;
 #endif
 
+  // Interval between stack samples in microseconds, as set by
+  // --prof-sampling-interval.
+  static int SamplingIntervalUs() {
+    return FLAG_prof_sampling_interval > 0
+        ? FLAG_prof_sampling_interval
+        : kSamplingIntervalMs * 1000;
+  }
+
   // Callback from Log, stops profiling in case of insufficient resources.
   void LogFailure();
 
  private:
   class NameBuffer;
   class NameMap;
+  class PerfBasicLogger;
+  class PerfJitLogger;
 
   Logger();
   ~Logger();
@@ -337,6 +348,20 @@ class Logger {
   // Emits the profiler's first message.
   void ProfilerBeginEvent();
 
+  // Emits the table of event names referenced by binary log records.
+  void BinaryEventNamesEvent();
+
+  // Emits the fields of a code creation event preceding and following the
+  // code name, in the text or the binary format of the log. shared may be
+  // NULL.
+  void AppendCodeCreateHeader(LogMessageBuilder* msg,
+                              LogEventsAndTags tag,
+                              Code* code,
+                              SharedFunctionInfo* shared);
+  void AppendCodeCreateFooter(LogMessageBuilder* msg,
+                              Code* code,
+                              SharedFunctionInfo* shared);
+
   // Emits callback event messages.
   void CallbackEventInternal(const char* prefix,
                              const char* name,
@@ -378,6 +403,18 @@ class Logger {
     LowLevelLogWriteBytes(reinterpret_cast<const char*>(&s), sizeof(s));
   }
 
+  // Linux perf support (--perf-map and --perf-jitdump).
+
+  bool is_logging_perf_events() {
+    return perf_basic_logger_ != NULL || perf_jit_logger_ != NULL;
+  }
+
+  void PerfCodeCreateEvent(Code* code, const char* name, int name_size);
+
+  void PerfCodeMoveEvent(Address from, Address to);
+
+  void PerfCodeDeleteEvent(Address from);
+
   // Emits a profiler tick event. Used by the profiler thread.
   void TickEvent(TickSample* sample, bool overflow);
 
@@ -431,6 +468,9 @@ class Logger {
 
   NameMap* address_to_name_map_;
 
+  PerfBasicLogger* perf_basic_logger_;
+  PerfJitLogger* perf_jit_logger_;
+
   // Guards against multiple calls to TearDown() that can happen in some tests.
   // 'true' between SetUp() and TearDown().
   bool is_initialized_;
@@ -468,20 +508,26 @@ class SamplerRegistry : public AllStatic {
 
   static State GetState();
 
-  // Iterates over all active samplers keeping the internal lock held.
+  // Iterates over all active samplers without taking the internal lock.
   // Returns whether there are any active samplers.
   static bool IterateActiveSamplers(VisitSampler func, void* param);
 
-  // Adds/Removes an active sampler.
+  // Adds/Removes an active sampler. A removed sampler is no longer visited
+  // once this returns.
   static void AddActiveSampler(Sampler* sampler);
   static void RemoveActiveSampler(Sampler* sampler);
 
  private:
-  static bool ActiveSamplersExist() {
-    return active_samplers_ != NULL && !active_samplers_->is_empty();
+  static List<Sampler*>* active_samplers() {
+    return reinterpret_cast<List<Sampler*>*>(Acquire_Load(&active_samplers_));
   }
+  static void ReplaceActiveSamplers(List<Sampler*>* samplers);
 
-  static List<Sampler*>* active_samplers_;
+  // The active samplers are published as an immutable list, so that
+  // sampler threads never contend with isolates adding and removing
+  // samplers. A replaced list is freed once no iteration can see it.
+  static AtomicWord active_samplers_;
+  static Atomic32 iterations_in_progress_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(SamplerRegistry);
 };
@@ -54,6 +54,14 @@ void MarkCompactCollector::SetFlags(int flags) {
 
 void MarkCompactCollector::MarkObject(HeapObject* obj, MarkBit mark_bit) {
   ASSERT(Marking::MarkBitFrom(obj) == mark_bit);
+  if (parallel_marking_active_) {
+    if (mark_bit.AtomicSet()) {
+      MemoryChunk::AtomicIncrementLiveBytesFromGC(obj->address(), obj->Size());
+      ASSERT(HEAP->Contains(obj));
+      current_parallel_marking_deque()->PushBlack(obj);
+    }
+    return;
+  }
   if (!mark_bit.Get()) {
     mark_bit.Set();
     MemoryChunk::IncrementLiveBytesFromGC(obj->address(), obj->Size());
@@ -72,6 +80,19 @@ void MarkCompactCollector::SetMark(HeapObject* obj, MarkBit mark_bit) {
 }
 
 
+bool MarkCompactCollector::TrySetMark(HeapObject* obj, MarkBit mark_bit) {
+  ASSERT(Marking::MarkBitFrom(obj) == mark_bit);
+  if (parallel_marking_active_) {
+    if (!mark_bit.AtomicSet()) return false;
+    MemoryChunk::AtomicIncrementLiveBytesFromGC(obj->address(), obj->Size());
+    return true;
+  }
+  if (mark_bit.Get()) return false;
+  SetMark(obj, mark_bit);
+  return true;
+}
+
+
 bool MarkCompactCollector::IsMarked(Object* obj) {
   ASSERT(obj->IsHeapObject());
   HeapObject* heap_object = HeapObject::cast(obj);
@@ -85,6 +106,9 @@ void MarkCompactCollector::RecordSlot(Object** anchor_slot,
   Page* object_page = Page::FromAddress(reinterpret_cast<Address>(object));
   if (object_page->IsEvacuationCandidate() &&
       !ShouldSkipEvacuationSlotRecording(anchor_slot)) {
+    ParallelMarkingLock lock(this);
+    // Another marking thread may have evicted the page in the meantime.
+    if (!object_page->IsEvacuationCandidate()) return;
     if (!SlotsBuffer::AddTo(&slots_buffer_allocator_,
                             object_page->slots_buffer_address(),
                             slot,
@@ -95,6 +119,18 @@ void MarkCompactCollector::RecordSlot(Object** anchor_slot,
 }
 
 
+ParallelMarkingLock::ParallelMarkingLock(MarkCompactCollector* collector)
+    : mutex_(collector->is_parallel_marking_active() ?
+             collector->parallel_marking_mutex() : NULL) {
+  if (mutex_ != NULL) mutex_->Lock();
+}
+
+
+ParallelMarkingLock::~ParallelMarkingLock() {
+  if (mutex_ != NULL) mutex_->Unlock();
+}
+
+
 } }  // namespace v8::internal
 
 #endif  // V8_MARK_COMPACT_INL_H_
@@ -38,9 +38,11 @@
 #include "incremental-marking.h"
 #include "liveobjectlist-inl.h"
 #include "mark-compact.h"
+#include "marking-thread.h"
 #include "objects-visiting.h"
 #include "objects-visiting-inl.h"
 #include "stub-cache.h"
+#include "sweeper-thread.h"
 
 namespace v8 {
 namespace internal {
@@ -64,6 +66,11 @@ MarkCompactCollector::MarkCompactCollector() :  // NOLINT
       abort_incremental_marking_(false),
       compacting_(false),
       was_marked_incrementally_(false),
+      sweeping_pending_(false),
+      parallel_marking_active_(false),
+      parallel_marking_mutex_(OS::CreateMutex()),
+      parallel_marking_deques_(NULL),
+      idle_marking_threads_(0),
       tracer_(NULL),
       migration_slots_buffer_(NULL),
       heap_(NULL),
@@ -776,6 +783,12 @@ void MarkCompactCollector::AbortCompaction() {
 void MarkCompactCollector::Prepare(GCTracer* tracer) {
   was_marked_incrementally_ = heap()->incremental_marking()->IsMarking();
 
+  // The sweeper threads must be done with the pages of the previous cycle
+  // before free lists and mark bits are reset below.
+  if (IsConcurrentSweepingInProgress()) {
+    WaitUntilSweepingCompleted();
+  }
+
   // Rather than passing the tracer around we stash it in a static member
   // variable.
   tracer_ = tracer;
@@ -931,6 +944,8 @@ MarkCompactCollector::~MarkCompactCollector() {
     delete code_flusher_;
     code_flusher_ = NULL;
   }
+  delete[] parallel_marking_deques_;
+  delete parallel_marking_mutex_;
 }
 
 
@@ -996,11 +1011,15 @@ class MarkCompactMarkingVisitor
   INLINE(static void VisitPointers(Heap* heap, Object** start, Object** end)) {
     // Mark all objects pointed to in [start, end).
     const int kMinRangeForMarkingRecursion = 64;
-    if (end - start >= kMinRangeForMarkingRecursion) {
+    MarkCompactCollector* collector = heap->mark_compact_collector();
+    // The stack limit check does not work on the marking threads, and
+    // recursion would bypass the atomic marking, so the parallel marker
+    // always goes through the marking deques.
+    if (end - start >= kMinRangeForMarkingRecursion &&
+        !collector->is_parallel_marking_active()) {
       if (VisitUnmarkedObjects(heap, start, end)) return;
       // We are close to a stack overflow, so just mark the objects.
     }
-    MarkCompactCollector* collector = heap->mark_compact_collector();
     for (Object** p = start; p < end; p++) {
       MarkObjectByPointer(collector, start, p);
     }
@@ -1016,11 +1035,7 @@ class MarkCompactMarkingVisitor
   // Returns true if object needed marking and false otherwise.
   INLINE(static bool MarkObjectWithoutPush(Heap* heap, HeapObject* object)) {
     MarkBit mark_bit = Marking::MarkBitFrom(object);
-    if (!mark_bit.Get()) {
-      heap->mark_compact_collector()->SetMark(object, mark_bit);
-      return true;
-    }
-    return false;
+    return heap->mark_compact_collector()->TrySetMark(object, mark_bit);
   }
 
   // Mark object pointed to by p.
@@ -1075,6 +1090,15 @@ class MarkCompactMarkingVisitor
     return true;
   }
 
+  INLINE(static void VisitCodeTarget(Heap* heap, RelocInfo* rinfo)) {
+    // Clearing an inline cache patches the code and goes through caches
+    // shared by the whole isolate, so the parallel marker visits code
+    // targets one thread at a time.
+    ParallelMarkingLock lock(heap->mark_compact_collector());
+    StaticMarkingVisitor<MarkCompactMarkingVisitor>::VisitCodeTarget(heap,
+                                                                      rinfo);
+  }
+
   INLINE(static void BeforeVisitingSharedFunctionInfo(HeapObject* object)) {
     SharedFunctionInfo* shared = SharedFunctionInfo::cast(object);
     shared->BeforeVisitingPointers();
@@ -1085,9 +1109,12 @@ class MarkCompactMarkingVisitor
     JSWeakMap* weak_map = reinterpret_cast<JSWeakMap*>(object);
 
     // Enqueue weak map in linked list of encountered weak maps.
-    if (weak_map->next() == Smi::FromInt(0)) {
-      weak_map->set_next(collector->encountered_weak_maps());
-      collector->set_encountered_weak_maps(weak_map);
+    {
+      ParallelMarkingLock lock(collector);
+      if (weak_map->next() == Smi::FromInt(0)) {
+        weak_map->set_next(collector->encountered_weak_maps());
+        collector->set_encountered_weak_maps(weak_map);
+      }
     }
 
     // Skip visiting the backing hash table containing the mappings.
@@ -1111,7 +1138,7 @@ class MarkCompactMarkingVisitor
         HeapObject::RawField(weak_map, JSWeakMap::kTableOffset);
     MarkBit table_mark = Marking::MarkBitFrom(table);
     collector->RecordSlot(table_slot, table_slot, table);
-    if (!table_mark.Get()) collector->SetMark(table, table_mark);
+    collector->TrySetMark(table, table_mark);
     // Recording the map slot can be skipped, because maps are not compacted.
     collector->MarkObject(table->map(), Marking::MarkBitFrom(table->map()));
     ASSERT(MarkCompactCollector::IsMarked(table->map()));
@@ -1494,6 +1521,13 @@ class RootMarkingVisitor : public ObjectVisitor {
     MarkBit mark_bit = Marking::MarkBitFrom(object);
     if (mark_bit.Get()) return;
 
+    if (collector_->AreMarkingThreadsActivated()) {
+      // Leave the transitive closure to the parallel marker instead of
+      // emptying the marking stack for every single root.
+      collector_->MarkObject(object, mark_bit);
+      return;
+    }
+
     Map* map = object->map();
     // Mark the object.
     collector_->SetMark(object, mark_bit);
@@ -1789,6 +1823,8 @@ void MarkCompactCollector::MarkImplicitRefGroups() {
 // marking stack have been marked, or are overflowed in the heap.
 void MarkCompactCollector::EmptyMarkingDeque() {
   while (!marking_deque_.IsEmpty()) {
+    if (AreMarkingThreadsActivated()) EmptyMarkingDequeInParallel();
+
     while (!marking_deque_.IsEmpty()) {
       HeapObject* object = marking_deque_.Pop();
       ASSERT(object->IsHeapObject());
@@ -1809,6 +1845,110 @@ void MarkCompactCollector::EmptyMarkingDeque() {
 }
 
 
+void MarkCompactCollector::EmptyMarkingDequeInParallel() {
+  // Large enough that the deques rarely overflow, which would force a
+  // sequential rescan of the heap.
+  static const int kParallelMarkingDequeCapacity = 64 * KB;
+
+  int deque_count = FLAG_marking_threads + 1;
+  if (parallel_marking_deques_ == NULL) {
+    parallel_marking_deques_ = new ParallelMarkingDeque[deque_count];
+  }
+  int capacity = FLAG_force_marking_deque_overflows ?
+      64 : kParallelMarkingDequeCapacity;
+  for (int i = 0; i < deque_count; i++) {
+    parallel_marking_deques_[i].Initialize(capacity);
+  }
+
+  // The marking threads are idle, so the main thread may push to all deques.
+  int next = 0;
+  while (!marking_deque_.IsEmpty()) {
+    parallel_marking_deques_[next].PushBlack(marking_deque_.Pop());
+    next = (next + 1) % deque_count;
+  }
+
+  NoBarrier_Store(&idle_marking_threads_, 0);
+  parallel_marking_active_ = true;
+  MarkingThread** threads = heap()->isolate()->marking_threads();
+  for (int i = 0; i < FLAG_marking_threads; i++) {
+    threads[i]->StartMarking();
+  }
+  MarkInParallel(0);
+  for (int i = 0; i < FLAG_marking_threads; i++) {
+    threads[i]->WaitForMarkingThread();
+  }
+  parallel_marking_active_ = false;
+
+  for (int i = 0; i < deque_count; i++) {
+    ASSERT(parallel_marking_deques_[i].IsEmpty());
+    if (parallel_marking_deques_[i].overflowed()) {
+      marking_deque_.SetOverflowed();
+    }
+  }
+}
+
+
+void MarkCompactCollector::MarkInParallel(int index) {
+  ASSERT(parallel_marking_active_);
+  ParallelMarkingDeque* marking_deque = &parallel_marking_deques_[index];
+  Thread::SetThreadLocal(parallel_marking_deque_key_, marking_deque);
+  while (true) {
+    HeapObject* object = marking_deque->Pop();
+    if (object == NULL) object = StealMarkingWork(index);
+    if (object == NULL) {
+      if (OfferMarkingTermination()) break;
+      continue;
+    }
+    ASSERT(object->IsHeapObject());
+    ASSERT(heap()->Contains(object));
+    ASSERT(Marking::IsBlack(Marking::MarkBitFrom(object)));
+
+    Map* map = object->map();
+    MarkBit map_mark = Marking::MarkBitFrom(map);
+    MarkObject(map, map_mark);
+
+    MarkCompactMarkingVisitor::IterateBody(map, object);
+  }
+  Thread::SetThreadLocal(parallel_marking_deque_key_, NULL);
+}
+
+
+HeapObject* MarkCompactCollector::StealMarkingWork(int index) {
+  int deque_count = FLAG_marking_threads + 1;
+  for (int i = 1; i < deque_count; i++) {
+    int victim = (index + i) % deque_count;
+    HeapObject* object = parallel_marking_deques_[victim].Steal();
+    if (object != NULL) return object;
+  }
+  return NULL;
+}
+
+
+bool MarkCompactCollector::OfferMarkingTermination() {
+  // A thread only goes idle once its own deque is empty, and only busy
+  // threads push, so no work can appear once every thread is idle.
+  int deque_count = FLAG_marking_threads + 1;
+  NoBarrier_AtomicIncrement(&idle_marking_threads_, 1);
+  while (true) {
+    if (Acquire_Load(&idle_marking_threads_) == deque_count) return true;
+    for (int i = 0; i < deque_count; i++) {
+      if (!parallel_marking_deques_[i].IsEmpty()) {
+        NoBarrier_AtomicIncrement(&idle_marking_threads_, -1);
+        return false;
+      }
+    }
+    Thread::YieldCPU();
+  }
+}
+
+
+bool MarkCompactCollector::AreMarkingThreadsActivated() {
+  // Object statistics are gathered without synchronization.
+  return heap()->isolate()->marking_threads() != NULL &&
+      !FLAG_track_gc_object_stats;
+}
+
+
 // Sweep the heap for overflowed objects, clear their overflow bits, and
 // push them on the marking stack.  Stop early if the marking stack fills
 // before sweeping completes.  If sweeping completes, there are no remaining
@@ -1964,10 +2104,7 @@ void MarkCompactCollector::MarkLiveObjects() {
       &IsUnmarkedHeapObject);
   // Then we mark the objects and process the transitive closure.
   heap()->isolate()->global_handles()->IterateWeakRoots(&root_visitor);
-  while (marking_deque_.overflowed()) {
-    RefillMarkingDeque();
-    EmptyMarkingDeque();
-  }
+  ProcessMarkingDeque();
 
   // Repeat host application specific marking to mark unmarked objects
   // reachable from the weak roots.
@@ -3334,6 +3471,29 @@ static inline Address StartOfLiveObject(Address block_address, uint32_t cell) {
 }
 
 
+enum SweepingParallelism {
+  SWEEP_SEQUENTIALLY,
+  SWEEP_IN_PARALLEL
+};
+
+
+// Returns the memory between start and start + size to the free list.  When
+// sweeping sequentially the space's free list and accounting stats are
+// updated; a parallel sweep only touches the given (thread-private) free
+// list and leaves the accounting to whoever takes the memory from it.
+template<SweepingParallelism mode>
+static intptr_t Free(PagedSpace* space,
+                     FreeList* free_list,
+                     Address start,
+                     int size) {
+  if (mode == SWEEP_SEQUENTIALLY) {
+    return space->Free(start, size);
+  } else {
+    return size - free_list->Free(start, size);
+  }
+}
+
+
 // Sweeps a space conservatively.  After this has been done the larger free
 // spaces have been put on the free list and the smaller ones have been
 // ignored and left untouched.  A free space is always either ignored or put
@@ -3341,10 +3501,18 @@ static inline Address StartOfLiveObject(Address block_address, uint32_t cell) {
 // because it means that any FreeSpace maps left actually describe a region of
 // memory that can be ignored when scanning.  Dead objects other than free
 // spaces will not contain the free space map.
-intptr_t MarkCompactCollector::SweepConservatively(PagedSpace* space, Page* p) {
-  ASSERT(!p->IsEvacuationCandidate() && !p->WasSwept());
+template<SweepingParallelism mode>
+static intptr_t SweepConservatively(PagedSpace* space,
+                                    FreeList* free_list,
+                                    Page* p) {
+  ASSERT(!p->IsEvacuationCandidate());
+  ASSERT((mode == SWEEP_SEQUENTIALLY && !p->WasSwept()) ||
+         (mode == SWEEP_IN_PARALLEL && p->WasSweptConservatively() &&
+          p->parallel_sweeping() == MemoryChunk::kParallelSweepingInProgress));
   MarkBit::CellType* cells = p->markbits()->cells();
-  p->MarkSweptConservatively();
+  // In parallel mode the main thread has already updated the page flags and
+  // live bytes when it queued the page.
+  if (mode == SWEEP_SEQUENTIALLY) p->MarkSweptConservatively();
 
   int last_cell_index =
       Bitmap::IndexToCell(
@@ -3369,9 +3537,9 @@ intptr_t MarkCompactCollector::SweepConservatively(PagedSpace* space, Page* p) {
   }
   size_t size = block_address - p->area_start();
   if (cell_index == last_cell_index) {
-    freed_bytes += static_cast<int>(space->Free(p->area_start(),
-                                                static_cast<int>(size)));
-    ASSERT_EQ(0, p->LiveBytes());
+    freed_bytes += Free<mode>(space, free_list, p->area_start(),
+                              static_cast<int>(size));
+    ASSERT(mode == SWEEP_IN_PARALLEL || p->LiveBytes() == 0);
     return freed_bytes;
   }
   // Grow the size of the start-of-page free space a little to get up to the
@@ -3379,8 +3547,8 @@ intptr_t MarkCompactCollector::SweepConservatively(PagedSpace* space, Page* p) {
   Address free_end = StartOfLiveObject(block_address, cells[cell_index]);
   // Free the first free space.
   size = free_end - p->area_start();
-  freed_bytes += space->Free(p->area_start(),
-                             static_cast<int>(size));
+  freed_bytes += Free<mode>(space, free_list, p->area_start(),
+                            static_cast<int>(size));
   // The start of the current free area is represented in undigested form by
   // the address of the last 32-word section that contained a live object and
   // the marking bitmap for that cell, which describes where the live object
@@ -3409,8 +3577,8 @@ intptr_t MarkCompactCollector::SweepConservatively(PagedSpace* space, Page* p) {
           // so now we need to find the start of the first live object at the
           // end of the free space.
           free_end = StartOfLiveObject(block_address, cell);
-          freed_bytes += space->Free(free_start,
-                                     static_cast<int>(free_end - free_start));
+          freed_bytes += Free<mode>(space, free_list, free_start,
+                                    static_cast<int>(free_end - free_start));
         }
       }
       // Update our undigested record of where the current free area started.
@@ -3424,18 +3592,53 @@ intptr_t MarkCompactCollector::SweepConservatively(PagedSpace* space, Page* p) {
   // Handle the free space at the end of the page.
   if (block_address - free_start > 32 * kPointerSize) {
     free_start = DigestFreeStart(free_start, free_start_cell);
-    freed_bytes += space->Free(free_start,
-                               static_cast<int>(block_address - free_start));
+    freed_bytes += Free<mode>(space, free_list, free_start,
+                              static_cast<int>(block_address - free_start));
   }
 
-  p->ResetLiveBytes();
+  if (mode == SWEEP_SEQUENTIALLY) p->ResetLiveBytes();
+  return freed_bytes;
+}
+
+
+intptr_t MarkCompactCollector::SweepConservatively(PagedSpace* space,
+                                                   Page* p) {
+  return v8::internal::SweepConservatively<SWEEP_SEQUENTIALLY>(space, NULL, p);
+}
+
+
+intptr_t MarkCompactCollector::SweepConservativelyInParallel(
+    PagedSpace* space, FreeList* free_list, Page* p) {
+  return v8::internal::SweepConservatively<SWEEP_IN_PARALLEL>(
+      space, free_list, p);
+}
+
+
+intptr_t MarkCompactCollector::SweepInParallel(PagedSpace* space,
+                                               FreeList* private_free_list,
+                                               FreeList* free_list,
+                                               intptr_t max_freed_bytes) {
+  intptr_t freed_bytes = 0;
+  PageIterator it(space);
+  while (it.has_next() && freed_bytes < max_freed_bytes) {
+    Page* p = it.next();
+    if (!p->TryParallelSweeping()) continue;
+    if (private_free_list == NULL) {
+      freed_bytes += SweepConservativelyInParallel(space, free_list, p);
+    } else {
+      freed_bytes += SweepConservativelyInParallel(space, private_free_list, p);
+      free_list->Concatenate(private_free_list);
+    }
+    p->set_parallel_sweeping(MemoryChunk::kParallelSweepingDone);
+  }
   return freed_bytes;
 }
 
 
 void MarkCompactCollector::SweepSpace(PagedSpace* space, SweeperType sweeper) {
   space->set_was_swept_conservatively(sweeper == CONSERVATIVE ||
-                                      sweeper == LAZY_CONSERVATIVE);
+                                      sweeper == LAZY_CONSERVATIVE ||
+                                      sweeper == CONCURRENT_CONSERVATIVE);
 
   space->ClearStats();
 
@@ -3445,6 +3648,7 @@ void MarkCompactCollector::SweepSpace(PagedSpace* space, SweeperType sweeper) {
   int pages_swept = 0;
   intptr_t newspace_size = space->heap()->new_space()->Size();
   bool lazy_sweeping_active = false;
+  bool parallel_sweeping_active = false;
   bool unused_page_present = false;
 
   while (it.has_next()) {
@@ -3489,6 +3693,20 @@ void MarkCompactCollector::SweepSpace(PagedSpace* space, SweeperType sweeper) {
       continue;
     }
 
+    if (parallel_sweeping_active) {
+      if (FLAG_gc_verbose) {
+        PrintF("Sweeping 0x%" V8PRIxPTR " queued for sweeper threads.\n",
+               reinterpret_cast<intptr_t>(p));
+      }
+      // Everything the sweeper threads would otherwise have to write to the
+      // page header is done here, while the main thread still owns the page.
+      space->IncreaseUnsweptFreeBytes(p);
+      p->MarkSweptConservatively();
+      p->ResetLiveBytes();
+      p->set_parallel_sweeping(MemoryChunk::kParallelSweepingPending);
+      continue;
+    }
+
     switch (sweeper) {
       case CONSERVATIVE: {
         if (FLAG_gc_verbose) {
@@ -3517,6 +3735,21 @@ void MarkCompactCollector::SweepSpace(PagedSpace* space, SweeperType sweeper) {
         }
         break;
       }
+      case CONCURRENT_CONSERVATIVE: {
+        // Sweep enough pages on the main thread to satisfy promotion during
+        // evacuation and leave the rest to the sweeper threads.
+        if (FLAG_gc_verbose) {
+          PrintF("Sweeping 0x%" V8PRIxPTR " conservatively before "
+                 "starting sweeper threads.\n",
+                 reinterpret_cast<intptr_t>(p));
+        }
+        freed_bytes += SweepConservatively(space, p);
+        pages_swept++;
+        if (freed_bytes > 2 * newspace_size) {
+          parallel_sweeping_active = true;
+        }
+        break;
+      }
       case PRECISE: {
         if (FLAG_gc_verbose) {
           PrintF("Sweeping 0x%" V8PRIxPTR " precisely.\n",
@@ -3554,6 +3787,7 @@ void MarkCompactCollector::SweepSpaces() {
 #endif
   SweeperType how_to_sweep =
       FLAG_lazy_sweeping ? LAZY_CONSERVATIVE : CONSERVATIVE;
+  if (AreSweeperThreadsActivated()) how_to_sweep = CONCURRENT_CONSERVATIVE;
   if (FLAG_expose_gc) how_to_sweep = CONSERVATIVE;
   if (sweep_precisely_) how_to_sweep = PRECISE;
   // Noncompacting collections simply sweep the spaces to clear the mark
@@ -3578,6 +3812,57 @@ void MarkCompactCollector::SweepSpaces() {
 
   // Deallocate unmarked objects and clear marked bits for marked objects.
   heap_->lo_space()->FreeUnmarkedObjects();
+
+  // The sweeper threads are only started once evacuation is done, so they
+  // never race with pointer updating on the pages they sweep.
+  if (how_to_sweep == CONCURRENT_CONSERVATIVE) {
+    StartSweeperThreads();
+  }
+}
+
+
+bool MarkCompactCollector::AreSweeperThreadsActivated() {
+  return heap()->isolate()->sweeper_threads() != NULL;
+}
+
+
+void MarkCompactCollector::StartSweeperThreads() {
+  ASSERT(!sweeping_pending_);
+  sweeping_pending_ = true;
+  SweeperThread** threads = heap()->isolate()->sweeper_threads();
+  for (int i = 0; i < FLAG_sweeper_threads; i++) {
+    threads[i]->StartSweeping();
+  }
+}
+
+
+void MarkCompactCollector::WaitUntilSweepingCompleted() {
+  ASSERT(sweeping_pending_);
+  SweeperThread** threads = heap()->isolate()->sweeper_threads();
+  for (int i = 0; i < FLAG_sweeper_threads; i++) {
+    threads[i]->WaitForSweeperThread();
+  }
+  sweeping_pending_ = false;
+  StealMemoryFromSweeperThreads(heap()->old_data_space());
+  StealMemoryFromSweeperThreads(heap()->old_pointer_space());
+  // The unswept free bytes were an estimate based on the live bytes of the
+  // queued pages; now that every page has been swept the free lists are
+  // exact.
+  heap()->old_data_space()->ResetUnsweptFreeBytes();
+  heap()->old_pointer_space()->ResetUnsweptFreeBytes();
+}
+
+
+intptr_t MarkCompactCollector::StealMemoryFromSweeperThreads(
+    PagedSpace* space) {
+  intptr_t freed_bytes = 0;
+  SweeperThread** threads = heap()->isolate()->sweeper_threads();
+  for (int i = 0; i < FLAG_sweeper_threads; i++) {
+    freed_bytes += threads[i]->StealMemory(space);
+  }
+  space->AddToAccountingStats(freed_bytes);
+  space->DecrementUnsweptFreeBytes(freed_bytes);
+  return freed_bytes;
 }
 
 
@@ -3609,9 +3894,13 @@ void MarkCompactCollector::ReportDeleteIfNeeded(HeapObject* obj,
 }
 
 
+Thread::LocalStorageKey MarkCompactCollector::parallel_marking_deque_key_;
+
+
 void MarkCompactCollector::Initialize() {
   MarkCompactMarkingVisitor::Initialize();
   IncrementalMarking::Initialize();
+  parallel_marking_deque_key_ = Thread::CreateThreadLocalKey();
 }
 
 
@@ -3661,6 +3950,8 @@ void MarkCompactCollector::RecordRelocSlot(RelocInfo* rinfo, Object* target) {
   if (target_page->IsEvacuationCandidate() &&
       (rinfo->host() == NULL ||
        !ShouldSkipEvacuationSlotRecording(rinfo->host()))) {
+    ParallelMarkingLock lock(this);
+    if (!target_page->IsEvacuationCandidate()) return;
     if (!SlotsBuffer::AddTo(&slots_buffer_allocator_,
                             target_page->slots_buffer_address(),
                             SlotTypeForRMode(rinfo->rmode()),
@@ -3676,6 +3967,8 @@ void MarkCompactCollector::RecordCodeEntrySlot(Address slot, Code* target) {
   Page* target_page = Page::FromAddress(reinterpret_cast<Address>(target));
   if (target_page->IsEvacuationCandidate() &&
       !ShouldSkipEvacuationSlotRecording(reinterpret_cast<Object**>(slot))) {
+    ParallelMarkingLock lock(this);
+    if (!target_page->IsEvacuationCandidate()) return;
     if (!SlotsBuffer::AddTo(&slots_buffer_allocator_,
                             target_page->slots_buffer_address(),
                             SlotsBuffer::CODE_ENTRY_SLOT,
@@ -30,6 +30,7 @@
 
 #include "compiler-intrinsics.h"
 #include "spaces.h"
+#include "work-stealing-deque.h"
 
 namespace v8 {
 namespace internal {
@@ -254,6 +255,63 @@ class MarkingDeque {
 };
 
 
+// The work-stealing deque used by the parallel marker.  Like MarkingDeque
+// it does not grow when full; instead the object is turned grey and the
+// deque is marked as overflowed, so the object will be found again by a
+// rescan of the heap.
+class ParallelMarkingDeque {
+ public:
+  ParallelMarkingDeque() : overflowed_(false) { }
+
+  // The capacity must be a power of two.
+  void Initialize(int capacity) {
+    deque_.Initialize(capacity);
+    overflowed_ = false;
+  }
+
+  // May be called by any thread.
+  inline bool IsEmpty() { return deque_.IsEmpty(); }
+
+  // Only called by the owning thread.
+  bool overflowed() const { return overflowed_; }
+
+  void ClearOverflowed() { overflowed_ = false; }
+
+  // Pushes the (marked) object if there is room, otherwise turns it grey
+  // so that it is rediscovered when the heap is scanned for overflowed
+  // objects.  Only called by the owning thread.
+  inline void PushBlack(HeapObject* object) {
+    ASSERT(object->IsHeapObject());
+    if (!deque_.Push(object)) {
+      Marking::MarkBitFrom(object).Next().AtomicSet();
+      MemoryChunk::AtomicIncrementLiveBytesFromGC(object->address(),
+                                                  -object->Size());
+      overflowed_ = true;
+    }
+  }
+
+  // Returns NULL if the deque is empty or the last object was stolen.
+  // Only called by the owning thread.
+  inline HeapObject* Pop() {
+    HeapObject* object;
+    return deque_.Pop(&object) ? object : NULL;
+  }
+
+  // Returns NULL if the deque is empty or another thread won the race for
+  // the bottom object.  May be called by any thread.
+  inline HeapObject* Steal() {
+    HeapObject* object;
+    return deque_.Steal(&object) ? object : NULL;
+  }
+
+ private:
+  WorkStealingDeque<HeapObject*> deque_;
+  bool overflowed_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelMarkingDeque);
+};
+
+
 class SlotsBufferAllocator {
  public:
   SlotsBuffer* AllocateBuffer(SlotsBuffer* next_buffer);
@@ -417,9 +475,14 @@ class CodeFlusher {
   explicit CodeFlusher(Isolate* isolate)
       : isolate_(isolate),
         jsfunction_candidates_head_(NULL),
-        shared_function_info_candidates_head_(NULL) {}
+        shared_function_info_candidates_head_(NULL),
+        mutex_(OS::CreateMutex()) {}
 
+  ~CodeFlusher() { delete mutex_; }
+
+  // Candidates may be added by several marking threads at once.
   void AddCandidate(SharedFunctionInfo* shared_info) {
+    ScopedLock lock(mutex_);
     SetNextCandidate(shared_info, shared_function_info_candidates_head_);
     shared_function_info_candidates_head_ = shared_info;
   }
@@ -427,6 +490,7 @@ class CodeFlusher {
   void AddCandidate(JSFunction* function) {
     ASSERT(function->code() == function->shared()->code());
     ASSERT(function->next_function_link()->IsUndefined());
+    ScopedLock lock(mutex_);
     SetNextCandidate(function, jsfunction_candidates_head_);
     jsfunction_candidates_head_ = function;
   }
@@ -472,6 +536,7 @@ class CodeFlusher {
   Isolate* isolate_;
   JSFunction* jsfunction_candidates_head_;
   SharedFunctionInfo* shared_function_info_candidates_head_;
+  Mutex* mutex_;
 
   DISALLOW_COPY_AND_ASSIGN(CodeFlusher);
 };
@@ -568,6 +633,7 @@ class MarkCompactCollector {
   enum SweeperType {
     CONSERVATIVE,
     LAZY_CONSERVATIVE,
+    CONCURRENT_CONSERVATIVE,
     PRECISE
   };
 
@@ -581,6 +647,14 @@ class MarkCompactCollector {
   // Return a number of reclaimed bytes.
   static intptr_t SweepConservatively(PagedSpace* space, Page* p);
 
+  // Sweep a single page claimed for concurrent sweeping conservatively.
+  // Freed memory is put on the given free list; neither the page flags nor
+  // the accounting stats of the space are touched, so this can be called
+  // from a sweeper thread.  Return a number of reclaimed bytes.
+  static intptr_t SweepConservativelyInParallel(PagedSpace* space,
+                                                FreeList* free_list,
+                                                Page* p);
+
   INLINE(static bool ShouldSkipEvacuationSlotRecording(Object** anchor)) {
     return Page::FromAddress(reinterpret_cast<Address>(anchor))->
         ShouldSkipEvacuationSlotRecording();
@@ -641,6 +715,48 @@ class MarkCompactCollector {
 
   bool is_compacting() const { return compacting_; }
 
+  // Concurrent sweeping of the old pointer and old data spaces.  Pages are
+  // queued during SweepSpaces and handed to the sweeper threads once the
+  // rest of the collection is done.
+
+  // Sweeps queued pages of the given space until at least max_freed_bytes
+  // have been freed or no queued pages are left and returns the number of
+  // freed bytes.  Each page is swept into private_free_list, which is then
+  // moved to free_list.  If private_free_list is NULL the pages are swept
+  // into free_list directly; only the main thread may do that.
+  intptr_t SweepInParallel(PagedSpace* space,
+                           FreeList* private_free_list,
+                           FreeList* free_list,
+                           intptr_t max_freed_bytes);
+
+  // Moves the memory the sweeper threads have freed for the given space to
+  // its free list and returns the number of bytes moved.
+  intptr_t StealMemoryFromSweeperThreads(PagedSpace* space);
+
+  // Blocks until the sweeper threads are done and hands their memory to the
+  // spaces.  Must only be called while concurrent sweeping is in progress.
+  void WaitUntilSweepingCompleted();
+
+  bool AreSweeperThreadsActivated();
+
+  bool IsConcurrentSweepingInProgress() { return sweeping_pending_; }
+
+  // Parallel marking.  While the parallel marker is active the transitive
+  // closure is computed by the main thread and the marking threads
+  // together.  Each of them owns a ParallelMarkingDeque and steals from the
+  // others when its own deque runs dry.
+
+  // Marks objects reachable from the parallel marking deque with the given
+  // index, stealing work from the other deques, until all deques are empty.
+  // The main thread uses index 0, marking thread i uses index i + 1.
+  void MarkInParallel(int index);
+
+  bool AreMarkingThreadsActivated();
+
+  bool is_parallel_marking_active() const { return parallel_marking_active_; }
+
+  Mutex* parallel_marking_mutex() { return parallel_marking_mutex_; }
+
  private:
   MarkCompactCollector();
   ~MarkCompactCollector();
@@ -679,6 +795,28 @@ class MarkCompactCollector {
 
   bool was_marked_incrementally_;
 
+  // True from the moment the sweeper threads are started until their freed
+  // memory has been handed to the spaces.
+  bool sweeping_pending_;
+
+  // True while the marking threads are working on the parallel marking
+  // deques.
+  bool parallel_marking_active_;
+
+  // Protects the slots buffers and the list of encountered weak maps while
+  // the parallel marker is active.
+  Mutex* parallel_marking_mutex_;
+
+  // FLAG_marking_threads + 1 deques, allocated on first use.
+  ParallelMarkingDeque* parallel_marking_deques_;
+
+  // Number of marking threads (including the main thread) that ran out of
+  // work; marking is complete once all of them have.
+  volatile AtomicWord idle_marking_threads_;
+
+  // Holds the ParallelMarkingDeque owned by the current thread.
+  static Thread::LocalStorageKey parallel_marking_deque_key_;
+
   // A pointer to the current stack-allocated GC tracer object during a full
   // collection (NULL before and after).
   GCTracer* tracer_;
@@ -724,6 +862,16 @@ class MarkCompactCollector {
   // This is for non-incremental marking only.
   INLINE(void SetMark(HeapObject* obj, MarkBit mark_bit));
 
+  // Marks the object black unless it is already marked and returns whether
+  // it was marked by this call.  Safe to call from the marking threads.
+  // This is for non-incremental marking only.
+  INLINE(bool TrySetMark(HeapObject* obj, MarkBit mark_bit));
+
+  INLINE(ParallelMarkingDeque* current_parallel_marking_deque()) {
+    return reinterpret_cast<ParallelMarkingDeque*>(
+        Thread::GetThreadLocal(parallel_marking_deque_key_));
+  }
+
   // Mark the heap roots and all objects reachable from them.
   void MarkRoots(RootMarkingVisitor* visitor);
 
@@ -758,6 +906,20 @@ class MarkCompactCollector {
   // flag on the marking stack.
   void RefillMarkingDeque();
 
+  // Distributes the marking stack over the parallel marking deques and
+  // empties them with the help of the marking threads.  May leave
+  // overflowed objects in the heap, in which case the marking stack's
+  // overflow flag will be set.
+  void EmptyMarkingDequeInParallel();
+
+  // Steals an object from any parallel marking deque other than the one
+  // with the given index.  Returns NULL if none was found.
+  HeapObject* StealMarkingWork(int index);
+
+  // Called by a marking thread that found no work.  Returns true once all
+  // marking threads are idle and false if there is work to steal again.
+  bool OfferMarkingTermination();
+
   // After reachable maps have been marked process per context object
   // literal map caches removing unmarked entries.
   void ProcessMapCaches();
@@ -814,6 +976,8 @@ class MarkCompactCollector {
 
   void SweepSpace(PagedSpace* space, SweeperType sweeper);
 
+  void StartSweeperThreads();
+
 #ifdef DEBUG
   friend class MarkObjectVisitor;
   static void VisitObject(HeapObject* obj);
@@ -834,6 +998,21 @@ class MarkCompactCollector {
 };
 
 
+// Holds the collector's parallel marking mutex while the parallel marker is
+// active and does nothing otherwise, so the sequential marker does not pay
+// for locking.
+class ParallelMarkingLock {
+ public:
+  explicit inline ParallelMarkingLock(MarkCompactCollector* collector);
+  inline ~ParallelMarkingLock();
+
+ private:
+  Mutex* mutex_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelMarkingLock);
+};
+
+
 const char* AllocationSpaceName(AllocationSpace space);
 
 } }  // namespace v8::internal
@@ -27,6 +27,7 @@
 
 #include <errno.h>
 #include <stdio.h>
+#include <string.h>
 #ifdef COMPRESS_STARTUP_DATA_BZ2
 #include <bzlib.h>
 #endif
@@ -39,6 +40,7 @@
 #include "natives.h"
 #include "platform.h"
 #include "serialize.h"
+#include "snapshot.h"
 #include "list.h"
 
 using namespace v8;
@@ -291,6 +293,60 @@ class BZip2Decompressor : public StartupDataDecompressor {
 #endif
 
 
+// Compiles and runs a file of extra code in the current context, and exits
+// if that fails.
+static void RunExtraCode(const char* name) {
+  HandleScope scope;
+  FILE* file = i::OS::FOpen(name, "rb");
+  if (file == NULL) {
+    fprintf(stderr, "Failed to open '%s': errno %d\n", name, errno);
+    exit(1);
+  }
+
+  fseek(file, 0, SEEK_END);
+  int size = ftell(file);
+  rewind(file);
+
+  char* chars = new char[size + 1];
+  chars[size] = '\0';
+  for (int i = 0; i < size;) {
+    int read = static_cast<int>(fread(&chars[i], 1, size - i, file));
+    if (read <= 0) {
+      fprintf(stderr, "Failed to read '%s': errno %d\n", name, errno);
+      exit(1);
+    }
+    i += read;
+  }
+  fclose(file);
+  Local<String> source = String::New(chars, size);
+  delete[] chars;
+  TryCatch try_catch;
+  ScriptOrigin origin(String::New(name));
+  Local<Script> script = Script::Compile(source, &origin);
+  if (try_catch.HasCaught()) {
+    fprintf(stderr, "Failure compiling '%s' (see above)\n", name);
+    exit(1);
+  }
+  script->Run();
+  if (try_catch.HasCaught()) {
+    fprintf(stderr, "Failure running '%s'\n", name);
+    Local<Message> message = try_catch.Message();
+    String::Utf8Value message_string(message->Get());
+    String::Utf8Value message_line(message->GetSourceLine());
+    fprintf(stderr, "%s at line %d\n", *message_string,
+            message->GetLineNumber());
+    fprintf(stderr, "%s\n", *message_line);
+    int from = message->GetStartColumn();
+    int to = message->GetEndColumn();
+    int i;
+    for (i = 0; i < from; i++) fprintf(stderr, " ");
+    for ( ; i <= to; i++) fprintf(stderr, "^");
+    fprintf(stderr, "\n");
+    exit(1);
+  }
+}
+
+
 int main(int argc, char** argv) {
   // By default, log code create information in the snapshot.
   i::FLAG_log_code = true;
@@ -318,59 +374,19 @@ int main(int argc, char** argv) {
             "\nException thrown while compiling natives - see above.\n\n");
     exit(1);
   }
+  // Run the application code, so that the objects it sets up are part of
+  // the context in the snapshot.
   if (i::FLAG_extra_code != NULL) {
     context->Enter();
     // Capture 100 frames if anything happens.
     V8::SetCaptureStackTraceForUncaughtExceptions(true, 100);
-    HandleScope scope;
-    const char* name = i::FLAG_extra_code;
-    FILE* file = i::OS::FOpen(name, "rb");
-    if (file == NULL) {
-      fprintf(stderr, "Failed to open '%s': errno %d\n", name, errno);
-      exit(1);
-    }
-
-    fseek(file, 0, SEEK_END);
-    int size = ftell(file);
-    rewind(file);
-
-    char* chars = new char[size + 1];
-    chars[size] = '\0';
-    for (int i = 0; i < size;) {
-      int read = static_cast<int>(fread(&chars[i], 1, size - i, file));
-      if (read < 0) {
-        fprintf(stderr, "Failed to read '%s': errno %d\n", name, errno);
-        exit(1);
-      }
-      i += read;
-    }
-    fclose(file);
-    Local<String> source = String::New(chars);
-    TryCatch try_catch;
-    Local<Script> script = Script::Compile(source);
-    if (try_catch.HasCaught()) {
-      fprintf(stderr, "Failure compiling '%s' (see above)\n", name);
-      exit(1);
-    }
-    script->Run();
-    if (try_catch.HasCaught()) {
-      fprintf(stderr, "Failure running '%s'\n", name);
-      Local<Message> message = try_catch.Message();
-      Local<String> message_string = message->Get();
-      Local<String> message_line = message->GetSourceLine();
-      int len = 2 + message_string->Utf8Length() + message_line->Utf8Length();
-      char* buf = new char(len);
-      message_string->WriteUtf8(buf);
-      fprintf(stderr, "%s at line %d\n", buf, message->GetLineNumber());
-      message_line->WriteUtf8(buf);
-      fprintf(stderr, "%s\n", buf);
-      int from = message->GetStartColumn();
-      int to = message->GetEndColumn();
-      int i;
-      for (i = 0; i < from; i++) fprintf(stderr, " ");
-      for ( ; i <= to; i++) fprintf(stderr, "^");
-      fprintf(stderr, "\n");
-      exit(1);
+    // The files are run in order.
+    i::List<i::Vector<const char> > files;
+    i::Snapshot::SplitFileList(i::FLAG_extra_code, &files);
+    for (int j = 0; j < files.length(); j++) {
+      i::SmartArrayPointer<char> name(
+          i::StrNDup(files[j].start(), files[j].length()));
+      RunExtraCode(*name);
     }
     context->Exit();
   }
@@ -396,6 +412,15 @@ int main(int argc, char** argv) {
 
   ser.SerializeWeakReferences();
 
+  for (int space = i::NEW_SPACE; space < i::LO_SPACE; space++) {
+    if (!ser.FitsOnOnePage(space) || !partial_ser.FitsOnOnePage(space)) {
+      fprintf(stderr,
+              "The snapshot does not fit in the heap on startup, "
+              "include less extra code.\n");
+      exit(1);
+    }
+  }
+
 #ifdef COMPRESS_STARTUP_DATA_BZ2
   BZip2Compressor compressor;
   if (!sink.Compress(&compressor))
@@ -638,12 +638,16 @@ void JSRegExp::JSRegExpVerify() {
       Object* ascii_data = arr->get(JSRegExp::kIrregexpASCIICodeIndex);
       // Smi : Not compiled yet (-1) or code prepared for flushing.
       // JSObject: Compilation error.
-      // Code/ByteArray: Compiled code.
-      CHECK(ascii_data->IsSmi() ||
-             (is_native ? ascii_data->IsCode() : ascii_data->IsByteArray()));
+      // Code: Compiled code.
+      CHECK(ascii_data->IsSmi() || (is_native && ascii_data->IsCode()));
       Object* uc16_data = arr->get(JSRegExp::kIrregexpUC16CodeIndex);
-      CHECK(uc16_data->IsSmi() ||
-             (is_native ? uc16_data->IsCode() : uc16_data->IsByteArray()));
+      CHECK(uc16_data->IsSmi() || (is_native && uc16_data->IsCode()));
+
+      Object* ascii_bytecode = arr->get(JSRegExp::kIrregexpASCIIBytecodeIndex);
+      CHECK(ascii_bytecode->IsSmi() || ascii_bytecode->IsByteArray());
+      Object* uc16_bytecode = arr->get(JSRegExp::kIrregexpUC16BytecodeIndex);
+      CHECK(uc16_bytecode->IsSmi() || uc16_bytecode->IsByteArray());
+      CHECK(arr->get(JSRegExp::kIrregexpTicksUntilTierUpIndex)->IsSmi());
 
       Object* ascii_saved = arr->get(JSRegExp::kIrregexpASCIICodeSavedIndex);
       CHECK(ascii_saved->IsSmi() || ascii_saved->IsString() ||
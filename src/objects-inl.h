@@ -1168,6 +1168,24 @@ void HeapObject::set_map_word(MapWord map_word) {
 }
 
 
+MapWord HeapObject::synchronized_map_word() {
+  return MapWord(static_cast<uintptr_t>(Acquire_Load(
+      reinterpret_cast<AtomicWord*>(FIELD_ADDR(this, kMapOffset)))));
+}
+
+
+MapWord HeapObject::CompareAndSwapMapWord(MapWord old_map_word,
+                                          MapWord new_map_word) {
+  // Release semantics make the contents of a copied object visible to any
+  // thread that reads its forwarding address.
+  AtomicWord result = Release_CompareAndSwap(
+      reinterpret_cast<AtomicWord*>(FIELD_ADDR(this, kMapOffset)),
+      static_cast<AtomicWord>(old_map_word.value_),
+      static_cast<AtomicWord>(new_map_word.value_));
+  return MapWord(static_cast<uintptr_t>(result));
+}
+
+
 HeapObject* HeapObject::FromAddress(Address address) {
   ASSERT_TAG_ALIGNED(address);
   return reinterpret_cast<HeapObject*>(address + kHeapObjectTag);
@@ -6994,43 +6994,13 @@ static inline bool CompareStringContents(IteratorA* ia, IteratorB* ib) {
 
 
 // Compares the contents of two strings by reading and comparing
-// int-sized blocks of characters.
+// word-sized blocks of characters, or vector-sized blocks where SSE2 is
+// available.
 template <typename Char>
 static inline bool CompareRawStringContents(Vector<Char> a, Vector<Char> b) {
   int length = a.length();
   ASSERT_EQ(length, b.length());
-  const Char* pa = a.start();
-  const Char* pb = b.start();
-  int i = 0;
-#ifndef V8_HOST_CAN_READ_UNALIGNED
-  // If this architecture isn't comfortable reading unaligned ints
-  // then we have to check that the strings are aligned before
-  // comparing them blockwise.
-  const int kAlignmentMask = sizeof(uint32_t) - 1;  // NOLINT
-  uint32_t pa_addr = reinterpret_cast<uint32_t>(pa);
-  uint32_t pb_addr = reinterpret_cast<uint32_t>(pb);
-  if (((pa_addr & kAlignmentMask) | (pb_addr & kAlignmentMask)) == 0) {
-#endif
-    const int kStepSize = sizeof(int) / sizeof(Char);  // NOLINT
-    int endpoint = length - kStepSize;
-    // Compare blocks until we reach near the end of the string.
-    for (; i <= endpoint; i += kStepSize) {
-      uint32_t wa = *reinterpret_cast<const uint32_t*>(pa + i);
-      uint32_t wb = *reinterpret_cast<const uint32_t*>(pb + i);
-      if (wa != wb) {
-        return false;
-      }
-    }
-#ifndef V8_HOST_CAN_READ_UNALIGNED
-  }
-#endif
-  // Compare the remaining characters that didn't fit into a block.
-  for (; i < length; i++) {
-    if (a[i] != b[i]) {
-      return false;
-    }
-  }
-  return true;
+  return FindFirstMismatch(a.start(), b.start(), length) == length;
 }
 
 
@@ -7107,9 +7077,8 @@ bool String::SlowEquals(String* other) {
           Vector<const char> vec2 = rhs_content.ToAsciiVector();
           return CompareRawStringContents(vec1, vec2);
         } else {
-          VectorIterator<char> buf1(vec1);
-          VectorIterator<uc16> ib(rhs_content.ToUC16Vector());
-          return CompareStringContents(&buf1, &ib);
+          Vector<const uc16> vec2 = rhs_content.ToUC16Vector();
+          return CompareChars(vec1.start(), vec2.start(), len) == 0;
         }
       } else {
         VectorIterator<char> buf1(vec1);
@@ -7121,9 +7090,8 @@ bool String::SlowEquals(String* other) {
       Vector<const uc16> vec1 = lhs_content.ToUC16Vector();
       if (rhs_content.IsFlat()) {
         if (rhs_content.IsAscii()) {
-          VectorIterator<uc16> buf1(vec1);
-          VectorIterator<char> ib(rhs_content.ToAsciiVector());
-          return CompareStringContents(&buf1, &ib);
+          Vector<const char> vec2 = rhs_content.ToAsciiVector();
+          return CompareChars(vec1.start(), vec2.start(), len) == 0;
         } else {
           Vector<const uc16> vec2(rhs_content.ToUC16Vector());
           return CompareRawStringContents(vec1, vec2);
@@ -7548,9 +7516,9 @@ void JSFunction::MarkForParallelRecompilation() {
 
   // Unlike MarkForLazyRecompilation, after queuing a function for
   // recompilation on the compiler thread, we actually tail-call into
-  // the full code.  We reset the profiler ticks here so that the
+  // the full code.  The profiler ticks are kept until the function is
+  // queued, where they set its priority, and reset there so that the
   // function doesn't bother the runtime profiler too much.
-  shared()->code()->set_profiler_ticks(0);
 }
 
 static bool CompileLazyHelper(CompilationInfo* info,
@@ -8633,6 +8601,13 @@ void DeoptimizationInputData::DeoptimizationInputDataPrint(FILE* out) {
 
         case Translation::ARGUMENTS_OBJECT:
           break;
+
+        case Translation::CAPTURED_OBJECT: {
+          int capture_id = iterator.Next();
+          int length = iterator.Next();
+          PrintF(out, "{capture_id=%d, length=%d}", capture_id, length);
+          break;
+        }
       }
       PrintF(out, "\n");
     }
@@ -1190,6 +1190,14 @@ class HeapObject: public Object {
   inline MapWord map_word();
   inline void set_map_word(MapWord map_word);
 
+  // Variants used by the parallel scavenger, where several threads race to
+  // install a forwarding address.  The compare-and-swap stores
+  // |new_map_word| only if the map word still is |old_map_word| and returns
+  // the map word it found.
+  inline MapWord synchronized_map_word();
+  inline MapWord CompareAndSwapMapWord(MapWord old_map_word,
+                                       MapWord new_map_word);
+
   // The Heap the object was allocated in. Used also to access Isolate.
   inline Heap* GetHeap();
 
@@ -6619,6 +6627,14 @@ class JSRegExp: public JSObject {
     }
   }
 
+  static int bytecode_index(bool is_ascii) {
+    if (is_ascii) {
+      return kIrregexpASCIIBytecodeIndex;
+    } else {
+      return kIrregexpUC16BytecodeIndex;
+    }
+  }
+
   static inline JSRegExp* cast(Object* obj);
 
   // Dispatched behavior.
@@ -6639,19 +6655,19 @@ class JSRegExp: public JSObject {
 
   static const int kAtomDataSize = kAtomPatternIndex + 1;
 
-  // Irregexp compiled code or bytecode for ASCII. If compilation
+  // Irregexp compiled code for ASCII. If compilation
   // fails, this fields hold an exception object that should be
   // thrown if the regexp is used again.
   static const int kIrregexpASCIICodeIndex = kDataIndex;
-  // Irregexp compiled code or bytecode for UC16.  If compilation
+  // Irregexp compiled code for UC16.  If compilation
   // fails, this fields hold an exception object that should be
   // thrown if the regexp is used again.
   static const int kIrregexpUC16CodeIndex = kDataIndex + 1;
 
-  // Saved instance of Irregexp compiled code or bytecode for ASCII that
+  // Saved instance of Irregexp compiled code for ASCII that
   // is a potential candidate for flushing.
   static const int kIrregexpASCIICodeSavedIndex = kDataIndex + 2;
-  // Saved instance of Irregexp compiled code or bytecode for UC16 that is
+  // Saved instance of Irregexp compiled code for UC16 that is
   // a potential candidate for flushing.
   static const int kIrregexpUC16CodeSavedIndex = kDataIndex + 3;
 
@@ -6661,7 +6677,17 @@ class JSRegExp: public JSObject {
   // Number of captures in the compiled regexp.
   static const int kIrregexpCaptureCountIndex = kDataIndex + 5;
 
-  static const int kIrregexpDataSize = kIrregexpCaptureCountIndex + 1;
+  // Irregexp bytecode for ASCII and UC16, run by the interpreter.  Bytecode
+  // is never flushed.
+  static const int kIrregexpASCIIBytecodeIndex = kDataIndex + 6;
+  static const int kIrregexpUC16BytecodeIndex = kDataIndex + 7;
+
+  // The number of executions left in the interpreter before the regexp is
+  // compiled to native code, or kTieredUpValue once it uses native code.
+  // Only used when V8 is compiled with native regexp support.
+  static const int kIrregexpTicksUntilTierUpIndex = kDataIndex + 8;
+
+  static const int kIrregexpDataSize = kIrregexpTicksUntilTierUpIndex + 1;
 
   // Offsets directly into the data fixed array.
   static const int kDataTagOffset =
@@ -6688,6 +6714,9 @@ class JSRegExp: public JSObject {
   // object is in the saved code field.
   static const int kCompilationErrorValue = -2;
 
+  // The tier-up ticks value of a regexp that runs native code.
+  static const int kTieredUpValue = -1;
+
   // When we store the sweep generation at which we moved the code from the
   // code index to the saved code index we mask it of to be in the [0:255]
   // range.
@@ -31,77 +31,190 @@
 
 #include "hydrogen.h"
 #include "isolate.h"
+#include "runtime-profiler.h"
 #include "v8threads.h"
 
 namespace v8 {
 namespace internal {
 
 
-void OptimizingCompilerThread::Run() {
+void RecompilationQueue::Enqueue(OptimizingCompiler* compiler,
+                                 int ticks,
+                                 int size,
+                                 int64_t queued_at) {
+  Job job = { compiler, ticks, size, sequence_++, queued_at };
+  jobs_.Add(job);
+  // Sift the new job up to its place in the heap.
+  int i = jobs_.length() - 1;
+  while (i > 0) {
+    int parent = (i - 1) / 2;
+    if (!HasPriorityOver(jobs_[i], jobs_[parent])) break;
+    Swap(i, parent);
+    i = parent;
+  }
+}
+
+
+bool RecompilationQueue::Dequeue(Job* job) {
+  if (jobs_.is_empty()) return false;
+  *job = jobs_[0];
+  Job last = jobs_.RemoveLast();
+  if (jobs_.is_empty()) return true;
+  jobs_[0] = last;
+  // Sift the former last job down to its place in the heap.
+  int i = 0;
+  int length = jobs_.length();
+  while (true) {
+    int child = 2 * i + 1;
+    if (child >= length) break;
+    if (child + 1 < length && HasPriorityOver(jobs_[child + 1], jobs_[child])) {
+      child++;
+    }
+    if (!HasPriorityOver(jobs_[child], jobs_[i])) break;
+    Swap(i, child);
+    i = child;
+  }
+  return true;
+}
+
+
+bool RecompilationQueue::HasPriorityOver(const Job& a, const Job& b) {
+  if (a.ticks != b.ticks) return a.ticks > b.ticks;
+  if (a.size != b.size) return a.size < b.size;
+  return a.sequence < b.sequence;
+}
+
+
+void RecompilationQueue::Swap(int i, int j) {
+  Job temp = jobs_[i];
+  jobs_[i] = jobs_[j];
+  jobs_[j] = temp;
+}
+
+
+void OptimizingCompilerThread::Start() {
+  thread_count_ = Max(FLAG_parallel_recompilation_threads, 1);
+  threads_ = new CompilerThread*[thread_count_];
 #ifdef DEBUG
-  thread_id_ = ThreadId::Current().ToInteger();
+  thread_ids_ = new int[thread_count_];
+  for (int i = 0; i < thread_count_; i++) {
+    thread_ids_[i] = ThreadId::Invalid().ToInteger();
+  }
 #endif
-  Isolate::SetIsolateThreadLocals(isolate_, NULL);
+  if (FLAG_trace_parallel_recompilation) start_time_ = OS::Ticks();
+  for (int i = 0; i < thread_count_; i++) {
+    threads_[i] = new CompilerThread(this, i);
+    threads_[i]->Start();
+  }
+}
 
-  int64_t epoch = 0;
-  if (FLAG_trace_parallel_recompilation) epoch = OS::Ticks();
+
+void OptimizingCompilerThread::Run(int id) {
+#ifdef DEBUG
+  thread_ids_[id] = ThreadId::Current().ToInteger();
+#endif
+  Isolate::SetIsolateThreadLocals(isolate_, NULL);
 
   while (true) {
     input_queue_semaphore_->Wait();
     if (Acquire_Load(&stop_thread_)) {
       stop_semaphore_->Signal();
-      if (FLAG_trace_parallel_recompilation) {
-        time_spent_total_ = OS::Ticks() - epoch;
-      }
       return;
     }
 
-    int64_t compiling_start = 0;
-    if (FLAG_trace_parallel_recompilation) compiling_start = OS::Ticks();
-
-    Heap::RelocationLock relocation_lock(isolate_->heap());
-    OptimizingCompiler* optimizing_compiler = NULL;
-    input_queue_.Dequeue(&optimizing_compiler);
+    RecompilationQueue::Job job;
+    {
+      ScopedLock lock(input_queue_mutex_);
+      bool dequeued = input_queue_.Dequeue(&job);
+      ASSERT(dequeued);
+      USE(dequeued);
+    }
     Barrier_AtomicIncrement(&queue_length_, static_cast<Atomic32>(-1));
 
-    ASSERT(!optimizing_compiler->info()->closure()->IsOptimized());
-
-    OptimizingCompiler::Status status = optimizing_compiler->OptimizeGraph();
-    ASSERT(status != OptimizingCompiler::FAILED);
-    // Prevent an unused-variable error in release mode.
-    USE(status);
+    int64_t compiling_start = OS::Ticks();
+    OptimizingCompiler* optimizing_compiler = job.compiler;
+    ASSERT(!optimizing_compiler->info()->osr_ast_id().IsNone() ||
+           !optimizing_compiler->info()->closure()->IsOptimized());
 
-    output_queue_.Enqueue(optimizing_compiler);
-    isolate_->stack_guard()->RequestCodeReadyEvent();
+    {
+      // Compiler threads only need to keep the GC from moving objects
+      // under them, not from each other.
+      Heap::SharedRelocationLock relocation_lock(isolate_->heap());
+      OptimizingCompiler::Status status = optimizing_compiler->OptimizeGraph();
+      ASSERT(status != OptimizingCompiler::FAILED);
+      // Prevent an unused-variable error in release mode.
+      USE(status);
+    }
 
-    if (FLAG_trace_parallel_recompilation) {
-      time_spent_compiling_ += OS::Ticks() - compiling_start;
+    int64_t compiling_end = OS::Ticks();
+    CompletedJob completed = { optimizing_compiler,
+                               compiling_start - job.queued_at,
+                               compiling_end - compiling_start };
+    {
+      // The output queue has a single consumer, but one producer per
+      // compiler thread.
+      ScopedLock lock(output_queue_mutex_);
+      output_queue_.Enqueue(completed);
+      time_spent_compiling_ += completed.compile_time;
     }
+    isolate_->stack_guard()->RequestCodeReadyEvent();
   }
 }
 
 
 void OptimizingCompilerThread::Stop() {
   Release_Store(&stop_thread_, static_cast<AtomicWord>(true));
-  input_queue_semaphore_->Signal();
-  stop_semaphore_->Wait();
+  for (int i = 0; i < thread_count_; i++) input_queue_semaphore_->Signal();
+  for (int i = 0; i < thread_count_; i++) stop_semaphore_->Wait();
+  for (int i = 0; i < thread_count_; i++) {
+    threads_[i]->Join();
+    delete threads_[i];
+  }
+  delete[] threads_;
+  threads_ = NULL;
+  while (!osr_buffer_.is_empty()) RemoveFromOSRBuffer(0);
+#ifdef DEBUG
+  delete[] thread_ids_;
+  thread_ids_ = NULL;
+#endif
 
   if (FLAG_trace_parallel_recompilation) {
+    time_spent_total_ = (OS::Ticks() - start_time_) * thread_count_;
     double compile_time = static_cast<double>(time_spent_compiling_);
     double total_time = static_cast<double>(time_spent_total_);
     double percentage = (compile_time * 100) / total_time;
-    PrintF("  ** Compiler thread did %.2f%% useful work\n", percentage);
+    PrintF("  ** Compiler threads (%d) did %.2f%% useful work\n",
+           thread_count_, percentage);
   }
+  thread_count_ = 0;
 }
 
 
 void OptimizingCompilerThread::InstallOptimizedFunctions() {
   HandleScope handle_scope(isolate_);
+  Counters* counters = isolate_->counters();
   int functions_installed = 0;
   while (!output_queue_.IsEmpty()) {
-    OptimizingCompiler* compiler = NULL;
-    output_queue_.Dequeue(&compiler);
-    Compiler::InstallOptimizedCode(compiler);
+    CompletedJob job;
+    output_queue_.Dequeue(&job);
+    // Samples are recorded here rather than on the compiler threads
+    // since histograms are created lazily and not thread-safe.
+    counters->parallel_recompilation_queue_wait()->AddTimedSample(
+        job.queue_wait);
+    counters->parallel_recompilation()->AddTimedSample(job.compile_time);
+    if (job.compiler->info()->osr_ast_id().IsNone()) {
+      Compiler::InstallOptimizedCode(job.compiler);
+    } else {
+      if (FLAG_trace_osr) {
+        PrintF("[on-stack replacement code for ");
+        job.compiler->info()->closure()->PrintName();
+        PrintF(" waited %0.3f ms in the queue and took %0.3f ms to "
+               "optimize]\n",
+               static_cast<double>(job.queue_wait) / 1000,
+               static_cast<double>(job.compile_time) / 1000);
+      }
+      InstallOSRCode(job.compiler);
+    }
     functions_installed++;
   }
   if (FLAG_trace_parallel_recompilation && functions_installed != 0) {
@@ -110,16 +223,92 @@ void OptimizingCompilerThread::InstallOptimizedFunctions() {
 }
 
 
-void OptimizingCompilerThread::QueueForOptimization(
+void OptimizingCompilerThread::InstallOSRCode(
     OptimizingCompiler* optimizing_compiler) {
-  input_queue_.Enqueue(optimizing_compiler);
+  CompilationInfo* info = optimizing_compiler->info();
+  OptimizingCompiler::Status status = optimizing_compiler->last_status();
+  if (status != OptimizingCompiler::SUCCEEDED) {
+    info->set_bailout_reason("failed/bailed out last time");
+    status = optimizing_compiler->AbortOptimization();
+  } else {
+    status = optimizing_compiler->GenerateAndInstallCode();
+  }
+  if (status != OptimizingCompiler::SUCCEEDED) {
+    for (int i = 0; i < osr_buffer_.length(); i++) {
+      if (osr_buffer_[i] == optimizing_compiler) RemoveFromOSRBuffer(i);
+    }
+    return;
+  }
+  // The loop that asked for the code kept running in unoptimized code.
+  // Make its back edges call into the runtime again to pick it up.
+  isolate_->runtime_profiler()->RequestOnStackReplacement(*info->closure());
+}
+
+
+bool OptimizingCompilerThread::IsQueuedForOSR(JSFunction* function,
+                                              BailoutId osr_ast_id) {
+  for (int i = 0; i < osr_buffer_.length(); i++) {
+    CompilationInfo* info = osr_buffer_[i]->info();
+    if (*info->closure() == function && info->osr_ast_id() == osr_ast_id) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+Code* OptimizingCompilerThread::TakeOSRCode(JSFunction* function,
+                                            BailoutId osr_ast_id) {
+  for (int i = 0; i < osr_buffer_.length(); i++) {
+    CompilationInfo* info = osr_buffer_[i]->info();
+    if (*info->closure() == function &&
+        info->osr_ast_id() == osr_ast_id &&
+        !info->code().is_null()) {
+      Code* code = *info->code();
+      RemoveFromOSRBuffer(i);
+      return code;
+    }
+  }
+  return NULL;
+}
+
+
+void OptimizingCompilerThread::RemoveFromOSRBuffer(int index) {
+  delete osr_buffer_[index]->info();
+  osr_buffer_.Remove(index);
+}
+
+
+void OptimizingCompilerThread::QueueForOptimization(
+    OptimizingCompiler* optimizing_compiler,
+    int profiler_ticks) {
+  if (!optimizing_compiler->info()->osr_ast_id().IsNone()) {
+    // Discard the oldest finished jobs whose loops have not come back.
+    int finished = 0;
+    for (int i = osr_buffer_.length() - 1; i >= 0; i--) {
+      if (osr_buffer_[i]->info()->code().is_null()) continue;
+      if (++finished >= kOSRBufferSize) RemoveFromOSRBuffer(i);
+    }
+    osr_buffer_.Add(optimizing_compiler);
+  }
+  int size = optimizing_compiler->info()->shared_info()->SourceSize();
+  Barrier_AtomicIncrement(&queue_length_, static_cast<Atomic32>(1));
+  {
+    ScopedLock lock(input_queue_mutex_);
+    input_queue_.Enqueue(
+        optimizing_compiler, profiler_ticks, size, OS::Ticks());
+  }
   input_queue_semaphore_->Signal();
 }
 
 #ifdef DEBUG
 bool OptimizingCompilerThread::IsOptimizerThread() {
-  if (!FLAG_parallel_recompilation) return false;
-  return ThreadId::Current().ToInteger() == thread_id_;
+  if (!FLAG_parallel_recompilation || thread_ids_ == NULL) return false;
+  int current = ThreadId::Current().ToInteger();
+  for (int i = 0; i < thread_count_; i++) {
+    if (thread_ids_[i] == current) return true;
+  }
+  return false;
 }
 #endif
 
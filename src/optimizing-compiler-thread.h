@@ -31,32 +31,93 @@
 #include "atomicops.h"
 #include "platform.h"
 #include "flags.h"
+#include "list.h"
 #include "unbound-queue.h"
 
 namespace v8 {
 namespace internal {
 
+class Code;
 class HGraphBuilder;
+class JSFunction;
 class OptimizingCompiler;
 
-class OptimizingCompilerThread : public Thread {
+// Priority queue of pending recompilation jobs, implemented as a binary
+// heap.  Jobs are ordered by the hotness the runtime profiler observed for
+// the function: more profiler ticks first, then smaller functions first,
+// then in the order they were queued.  Not thread-safe on its own; the
+// OptimizingCompilerThread guards it with a mutex.
+class RecompilationQueue {
+ public:
+  struct Job {
+    OptimizingCompiler* compiler;
+    int ticks;
+    int size;
+    int sequence;
+    int64_t queued_at;
+  };
+
+  RecompilationQueue() : sequence_(0) { }
+
+  bool IsEmpty() const { return jobs_.is_empty(); }
+  int length() const { return jobs_.length(); }
+
+  void Enqueue(OptimizingCompiler* compiler,
+               int ticks,
+               int size,
+               int64_t queued_at);
+  bool Dequeue(Job* job);
+
+ private:
+  static bool HasPriorityOver(const Job& a, const Job& b);
+  void Swap(int i, int j);
+
+  List<Job> jobs_;
+  int sequence_;
+};
+
+
+// Pool of background threads that run the OptimizeGraph phase of parallel
+// recompilation.  The execution thread builds the graph, queues the job
+// here, and later installs the finished code from the output queue.
+class OptimizingCompilerThread {
  public:
   explicit OptimizingCompilerThread(Isolate *isolate) :
-      Thread("OptimizingCompilerThread"),
       isolate_(isolate),
+      threads_(NULL),
+      thread_count_(0),
       stop_semaphore_(OS::CreateSemaphore(0)),
       input_queue_semaphore_(OS::CreateSemaphore(0)),
+      input_queue_mutex_(OS::CreateMutex()),
+      output_queue_mutex_(OS::CreateMutex()),
+      start_time_(0),
       time_spent_compiling_(0),
       time_spent_total_(0) {
     NoBarrier_Store(&stop_thread_, static_cast<AtomicWord>(false));
     NoBarrier_Store(&queue_length_, static_cast<AtomicWord>(0));
+#ifdef DEBUG
+    thread_ids_ = NULL;
+#endif
   }
 
-  void Run();
+  void Start();
   void Stop();
-  void QueueForOptimization(OptimizingCompiler* optimizing_compiler);
+  // Queues a job whose graph has been built.  profiler_ticks is the
+  // function's tick count when it was picked for recompilation, and makes
+  // hotter functions compile first.
+  void QueueForOptimization(OptimizingCompiler* optimizing_compiler,
+                            int profiler_ticks);
   void InstallOptimizedFunctions();
 
+  // Jobs compiling code for on-stack replacement are kept in an OSR buffer
+  // until the loop they were compiled for reaches a back edge again, since
+  // the function may have moved on to a different loop in the meantime.
+  // Returns whether such a job is queued or finished for the loop.
+  bool IsQueuedForOSR(JSFunction* function, BailoutId osr_ast_id);
+  // Removes a finished job for the loop from the OSR buffer and returns its
+  // code, or NULL if there is none.
+  Code* TakeOSRCode(JSFunction* function, BailoutId osr_ast_id);
+
   inline bool IsQueueAvailable() {
     // We don't need a barrier since we have a data dependency right
     // after.
@@ -76,23 +137,59 @@ class OptimizingCompilerThread : public Thread {
 #endif
 
   ~OptimizingCompilerThread() {
+    delete output_queue_mutex_;
+    delete input_queue_mutex_;
     delete input_queue_semaphore_;
     delete stop_semaphore_;
   }
 
  private:
+  class CompilerThread : public Thread {
+   public:
+    CompilerThread(OptimizingCompilerThread* owner, int id)
+        : Thread("OptimizingCompilerThread"), owner_(owner), id_(id) { }
+    void Run() { owner_->Run(id_); }
+
+   private:
+    OptimizingCompilerThread* owner_;
+    int id_;
+  };
+
+  // A job whose graph has been optimized, along with the time it spent
+  // waiting in the input queue and being optimized, in microseconds.
+  struct CompletedJob {
+    OptimizingCompiler* compiler;
+    int64_t queue_wait;
+    int64_t compile_time;
+  };
+
+  void Run(int id);
+
+  void InstallOSRCode(OptimizingCompiler* optimizing_compiler);
+  void RemoveFromOSRBuffer(int index);
+
+  // Number of finished OSR jobs kept before the oldest one is discarded.
+  static const int kOSRBufferSize = 4;
+
   Isolate* isolate_;
+  CompilerThread** threads_;
+  int thread_count_;
   Semaphore* stop_semaphore_;
   Semaphore* input_queue_semaphore_;
-  UnboundQueue<OptimizingCompiler*> input_queue_;
-  UnboundQueue<OptimizingCompiler*> output_queue_;
+  Mutex* input_queue_mutex_;
+  Mutex* output_queue_mutex_;
+  RecompilationQueue input_queue_;
+  UnboundQueue<CompletedJob> output_queue_;
+  // Only accessed from the execution thread.
+  List<OptimizingCompiler*> osr_buffer_;
   volatile AtomicWord stop_thread_;
   volatile Atomic32 queue_length_;
+  int64_t start_time_;
   int64_t time_spent_compiling_;
   int64_t time_spent_total_;
 
 #ifdef DEBUG
-  int thread_id_;
+  int* thread_ids_;
 #endif
 };
 
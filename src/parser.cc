@@ -569,14 +569,23 @@ FunctionLiteral* Parser::ParseProgram() {
   ZoneScope zone_scope(zone(), DONT_DELETE_ON_EXIT);
   HistogramTimerScope timer(isolate()->counters()->parse());
   Handle<String> source(String::cast(script_->source()));
-  isolate()->counters()->total_parse_size()->Increment(source->length());
   int64_t start = FLAG_trace_parse ? OS::Ticks() : 0;
   fni_ = new(zone()) FuncNameInferrer(isolate(), zone());
 
   // Initialize parser state.
   source->TryFlatten();
   FunctionLiteral* result;
-  if (source->IsExternalTwoByteString()) {
+  if (info()->source_stream() != NULL) {
+    // The script has no source yet, it is decoded from the stream as the
+    // scanner advances.  Install it once the stream is exhausted, also when
+    // parsing fails so that error messages can show the source.
+    ChunkedUtf8ToUtf16CharacterStream* stream = info()->source_stream();
+    scanner_.Initialize(stream);
+    result = DoParseProgram(info(), source, &zone_scope);
+    source = stream->Finish();
+    script_->set_source(*source);
+    if (result != NULL) result->scope()->set_end_position(source->length());
+  } else if (source->IsExternalTwoByteString()) {
     // Notice that the stream is destroyed at the end of the branch block.
     // The last line of the blocks can't be moved outside, even though they're
     // identical calls.
@@ -589,6 +598,7 @@ FunctionLiteral* Parser::ParseProgram() {
     scanner_.Initialize(&stream);
     result = DoParseProgram(info(), source, &zone_scope);
   }
+  isolate()->counters()->total_parse_size()->Increment(source->length());
 
   if (FLAG_trace_parse && result != NULL) {
     double ms = static_cast<double>(OS::Ticks() - start) / 1000;
@@ -2753,6 +2763,7 @@ DoWhileStatement* Parser::ParseDoWhileStatement(ZoneStringList* labels,
   // ExpectSemicolon() functionality here.
   if (peek() == Token::SEMICOLON) Consume(Token::SEMICOLON);
 
+  // Do-while loops are never peeled, so their node count is not needed.
   if (loop != NULL) loop->Initialize(cond, body);
   return loop;
 }
@@ -2764,6 +2775,7 @@ WhileStatement* Parser::ParseWhileStatement(ZoneStringList* labels, bool* ok) {
 
   WhileStatement* loop = factory()->NewWhileStatement(labels);
   Target target(&this->target_stack_, loop);
+  int node_count = factory()->visitor()->ast_properties()->node_count();
 
   Expect(Token::WHILE, CHECK_OK);
   Expect(Token::LPAREN, CHECK_OK);
@@ -2771,7 +2783,11 @@ WhileStatement* Parser::ParseWhileStatement(ZoneStringList* labels, bool* ok) {
   Expect(Token::RPAREN, CHECK_OK);
   Statement* body = ParseStatement(NULL, CHECK_OK);
 
-  if (loop != NULL) loop->Initialize(cond, body);
+  if (loop != NULL) {
+    loop->Initialize(cond, body);
+    loop->set_node_count(
+        factory()->visitor()->ast_properties()->node_count() - node_count);
+  }
   return loop;
 }
 
@@ -2921,6 +2937,7 @@ Statement* Parser::ParseForStatement(ZoneStringList* labels, bool* ok) {
   // Standard 'for' loop
   ForStatement* loop = factory()->NewForStatement(labels);
   Target target(&this->target_stack_, loop);
+  int node_count = factory()->visitor()->ast_properties()->node_count();
 
   // Parsed initializer at this point.
   Expect(Token::SEMICOLON, CHECK_OK);
@@ -2939,6 +2956,10 @@ Statement* Parser::ParseForStatement(ZoneStringList* labels, bool* ok) {
   Expect(Token::RPAREN, CHECK_OK);
 
   Statement* body = ParseStatement(NULL, CHECK_OK);
+  if (loop != NULL) {
+    loop->set_node_count(
+        factory()->visitor()->ast_properties()->node_count() - node_count);
+  }
   top_scope_ = saved_scope;
   for_scope->set_end_position(scanner().location().end_pos);
   for_scope = for_scope->FinalizeBlockScope();
@@ -301,6 +301,15 @@ void OS::SignalCodeMovingGC() {
 }
 
 
+void OS::SignalJitDumpFile(FILE* file) {
+}
+
+
+int64_t OS::JitDumpTimestamp() {
+  return Ticks() * 1000;
+}
+
+
 int OS::StackWalk(Vector<OS::StackFrame> frames) {
   // Not supported on Cygwin.
   return 0;
@@ -667,7 +676,8 @@ class SamplerThread : public Thread {
           return;
         }
       }
-      OS::Sleep(interval_);
+      // The interval is in microseconds; sleep at least a millisecond.
+      OS::Sleep(Max(1, interval_ / 1000));
     }
   }
 
@@ -711,6 +721,7 @@ class SamplerThread : public Thread {
       sample->sp = reinterpret_cast<Address>(context.Esp);
       sample->fp = reinterpret_cast<Address>(context.Ebp);
 #endif
+      sample->timestamp = OS::Ticks();
       sampler->SampleStack(sample);
       sampler->Tick(sample);
     }
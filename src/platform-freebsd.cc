@@ -295,6 +295,15 @@ void OS::SignalCodeMovingGC() {
 }
 
 
+void OS::SignalJitDumpFile(FILE* file) {
+}
+
+
+int64_t OS::JitDumpTimestamp() {
+  return Ticks() * 1000;
+}
+
+
 int OS::StackWalk(Vector<OS::StackFrame> frames) {
   int frames_size = frames.length();
   ScopedVector<void*> addresses(frames_size);
@@ -694,6 +703,7 @@ static void ProfilerSignalHandler(int signal, siginfo_t* info, void* context) {
   sample->sp = reinterpret_cast<Address>(mcontext.mc_r13);
   sample->fp = reinterpret_cast<Address>(mcontext.mc_r11);
 #endif
+  sample->timestamp = OS::Ticks();
   sampler->SampleStack(sample);
   sampler->Tick(sample);
 }
@@ -808,9 +818,9 @@ class SignalSender : public Thread {
   }
 
   void Sleep(SleepInterval full_or_half) {
-    // Convert ms to us and subtract 100 us to compensate delays
-    // occuring during signal delivery.
-    useconds_t interval = interval_ * 1000 - 100;
+    // Sample at most once a millisecond and subtract 100 us to compensate
+    // delays occuring during signal delivery.
+    useconds_t interval = Max(interval_, 1000) - 100;
     if (full_or_half == HALF_INTERVAL) interval /= 2;
     int result = usleep(interval);
 #ifdef DEBUG
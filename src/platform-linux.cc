@@ -556,6 +556,29 @@ void OS::SignalCodeMovingGC() {
 }
 
 
+void OS::SignalJitDumpFile(FILE* file) {
+  // perf inject only picks up a jitdump file once it has seen an
+  // executable mmap of it, so map the first page and unmap it right away.
+  fflush(file);
+  int size = sysconf(_SC_PAGESIZE);
+  void* addr = mmap(NULL,
+                    size,
+                    PROT_READ | PROT_EXEC,
+                    MAP_PRIVATE,
+                    fileno(file),
+                    0);
+  if (addr != MAP_FAILED) OS::Free(addr, size);
+}
+
+
+int64_t OS::JitDumpTimestamp() {
+  // Use the system call directly so that we don't need to link librt.
+  struct timespec ts;
+  if (syscall(__NR_clock_gettime, CLOCK_MONOTONIC, &ts) != 0) return 0;
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+
 int OS::StackWalk(Vector<OS::StackFrame> frames) {
   // backtrace is a glibc extension.
 #if defined(__GLIBC__) && !defined(__UCLIBC__)
@@ -1031,6 +1054,7 @@ static void ProfilerSignalHandler(int signal, siginfo_t* info, void* context) {
   TickSample sample_obj;
   TickSample* sample = CpuProfiler::TickSampleEvent(isolate);
   if (sample == NULL) sample = &sample_obj;
+  sample->timestamp = OS::Ticks();
 
   // Extracting the sample from the context is extremely machine dependent.
   ucontext_t* ucontext = reinterpret_cast<ucontext_t*>(context);
@@ -1083,7 +1107,8 @@ class SignalSender : public Thread {
  public:
   enum SleepInterval {
     HALF_INTERVAL,
-    FULL_INTERVAL
+    FULL_INTERVAL,
+    RUNTIME_PROFILER_INTERVAL
   };
 
   static const int kSignalSenderStackSize = 64 * KB;
@@ -1091,7 +1116,10 @@ class SignalSender : public Thread {
   explicit SignalSender(int interval)
       : Thread(Thread::Options("SignalSender", kSignalSenderStackSize)),
         vm_tgid_(getpid()),
-        interval_(interval) {}
+        interval_(interval),
+        ticks_per_runtime_profiler_tick_(
+            Max(1, kRuntimeProfilerIntervalUs / interval)),
+        ticks_until_runtime_profiler_tick_(0) {}
 
   static void SetUp() { if (!mutex_) mutex_ = OS::CreateMutex(); }
   static void TearDown() { delete mutex_; }
@@ -1154,7 +1182,26 @@ class SignalSender : public Thread {
       if (!cpu_profiling_enabled) {
         if (rate_limiter_.SuspendIfNecessary()) continue;
       }
-      if (cpu_profiling_enabled && runtime_profiler_enabled) {
+      if (interval_ < kRuntimeProfilerIntervalUs) {
+        // Sample as often as requested, but keep ticking the runtime
+        // profiler at its usual rate.
+        if (cpu_profiling_enabled) {
+          if (!SamplerRegistry::IterateActiveSamplers(&DoCpuProfile, this)) {
+            return;
+          }
+        }
+        if (runtime_profiler_enabled &&
+            (!cpu_profiling_enabled ||
+             --ticks_until_runtime_profiler_tick_ <= 0)) {
+          ticks_until_runtime_profiler_tick_ = ticks_per_runtime_profiler_tick_;
+          if (!SamplerRegistry::IterateActiveSamplers(&DoRuntimeProfile,
+                                                      NULL)) {
+            return;
+          }
+        }
+        Sleep(cpu_profiling_enabled ? FULL_INTERVAL
+                                    : RUNTIME_PROFILER_INTERVAL);
+      } else if (cpu_profiling_enabled && runtime_profiler_enabled) {
         if (!SamplerRegistry::IterateActiveSamplers(&DoCpuProfile, this)) {
           return;
         }
@@ -1203,10 +1250,16 @@ class SignalSender : public Thread {
   }
 
   void Sleep(SleepInterval full_or_half) {
-    // Convert ms to us and subtract 100 us to compensate delays
-    // occuring during signal delivery.
-    useconds_t interval = interval_ * 1000 - 100;
+    // Subtract 100 us to compensate delays occuring during signal delivery,
+    // unless the interval is too short for that.
+    useconds_t interval =
+        interval_ > kSignalDeliveryDelayUs * 2
+            ? interval_ - kSignalDeliveryDelayUs
+            : interval_;
     if (full_or_half == HALF_INTERVAL) interval /= 2;
+    if (full_or_half == RUNTIME_PROFILER_INTERVAL) {
+      interval = kRuntimeProfilerIntervalUs - kSignalDeliveryDelayUs;
+    }
 #if defined(ANDROID)
     usleep(interval);
 #else
@@ -1224,8 +1277,13 @@ class SignalSender : public Thread {
 #endif  // ANDROID
   }
 
+  static const int kRuntimeProfilerIntervalUs = 1000;
+  static const int kSignalDeliveryDelayUs = 100;
+
   const int vm_tgid_;
   const int interval_;
+  const int ticks_per_runtime_profiler_tick_;
+  int ticks_until_runtime_profiler_tick_;
   RuntimeProfilerRateLimiter rate_limiter_;
 
   // Protects the process wide state below.
@@ -269,6 +269,15 @@ void OS::SignalCodeMovingGC() {
 }
 
 
+void OS::SignalJitDumpFile(FILE* file) {
+}
+
+
+int64_t OS::JitDumpTimestamp() {
+  return Ticks() * 1000;
+}
+
+
 uint64_t OS::CpuFeaturesImpliedByPlatform() {
   // MacOSX requires all these to install so we can assume they are present.
   // These constants are defined by the CPUid instructions.
@@ -795,7 +804,8 @@ class SamplerThread : public Thread {
           return;
         }
       }
-      OS::Sleep(interval_);
+      // The interval is in microseconds; sleep at least a millisecond.
+      OS::Sleep(Max(1, interval_ / 1000));
     }
   }
 
@@ -850,6 +860,7 @@ class SamplerThread : public Thread {
       sample->pc = reinterpret_cast<Address>(state.REGISTER_FIELD(ip));
       sample->sp = reinterpret_cast<Address>(state.REGISTER_FIELD(sp));
       sample->fp = reinterpret_cast<Address>(state.REGISTER_FIELD(bp));
+      sample->timestamp = OS::Ticks();
       sampler->SampleStack(sample);
       sampler->Tick(sample);
     }
@@ -300,6 +300,17 @@ void OS::SignalCodeMovingGC() {
 }
 
 
+void OS::SignalJitDumpFile(FILE* file) {
+  UNIMPLEMENTED();
+}
+
+
+int64_t OS::JitDumpTimestamp() {
+  UNIMPLEMENTED();
+  return 0;
+}
+
+
 int OS::StackWalk(Vector<OS::StackFrame> frames) {
   UNIMPLEMENTED();
   return 0;
@@ -1285,6 +1285,15 @@ void OS::SignalCodeMovingGC() {
 }
 
 
+void OS::SignalJitDumpFile(FILE* file) {
+}
+
+
+int64_t OS::JitDumpTimestamp() {
+  return Ticks() * 1000;
+}
+
+
 // Walk the stack using the facilities in dbghelp.dll and tlhelp32.dll
 
 // Switch off warning 4748 (/GS can not protect parameters and local variables
@@ -1410,6 +1419,8 @@ int OS::StackWalk(Vector<OS::StackFrame> frames) {
 #else  // __MINGW32__
 void OS::LogSharedLibraryAddresses() { }
 void OS::SignalCodeMovingGC() { }
+void OS::SignalJitDumpFile(FILE* file) { }
+int64_t OS::JitDumpTimestamp() { return Ticks() * 1000; }
 int OS::StackWalk(Vector<OS::StackFrame> frames) { return 0; }
 #endif  // __MINGW32__
 
@@ -2013,7 +2024,8 @@ class SamplerThread : public Thread {
           return;
         }
       }
-      OS::Sleep(interval_);
+      // The interval is in microseconds; sleep at least a millisecond.
+      OS::Sleep(Max(1, interval_ / 1000));
     }
   }
 
@@ -2057,6 +2069,7 @@ class SamplerThread : public Thread {
       sample->sp = reinterpret_cast<Address>(context.Esp);
       sample->fp = reinterpret_cast<Address>(context.Ebp);
 #endif
+      sample->timestamp = OS::Ticks();
       sampler->SampleStack(sample);
       sampler->Tick(sample);
     }
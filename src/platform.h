@@ -293,6 +293,15 @@ class OS {
   // using --never-compact) if accurate profiling is desired.
   static void SignalCodeMovingGC();
 
+  // Support for Linux perf's jitdump format (--perf-jitdump).  Announces
+  // the dump file to perf by mapping it executable, as perf inject looks
+  // for such a mapping.  Can do nothing on other platforms.
+  static void SignalJitDumpFile(FILE* file);
+
+  // Returns the time in nanoseconds on the clock that perf record uses
+  // with "-k mono", for timestamping jitdump records.
+  static int64_t JitDumpTimestamp();
+
   // The return value indicates the CPU features we are sure of because of the
   // OS.  For example MacOSX doesn't run on any x86 CPUs that don't have SSE2
   // instructions.
@@ -714,6 +723,7 @@ class TickSample {
         sp(NULL),
         fp(NULL),
         tos(NULL),
+        timestamp(0),
         frames_count(0),
         has_external_callback(false) {}
   StateTag state;  // The state of the VM.
@@ -724,6 +734,7 @@ class TickSample {
     Address tos;   // Top stack value (*sp).
     Address external_callback;
   };
+  int64_t timestamp;  // Time of sampling in microseconds, see OS::Ticks.
   static const int kMaxFramesCount = 64;
   Address stack[kMaxFramesCount];  // Call stack.
   int frames_count : 8;  // Number of captured frames.
@@ -732,13 +743,13 @@ class TickSample {
 
 class Sampler {
  public:
-  // Initialize sampler.
+  // Initialize sampler. The interval is in microseconds.
   Sampler(Isolate* isolate, int interval);
   virtual ~Sampler();
 
   int interval() const { return interval_; }
 
-  // Performs stack sampling.
+  // Performs stack sampling.  The caller sets the sample's timestamp.
   void SampleStack(TickSample* sample) {
     DoSampleStack(sample);
     IncSamplesTaken();
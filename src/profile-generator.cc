@@ -29,6 +29,7 @@
 
 #include "profile-generator-inl.h"
 
+#include "frames-inl.h"
 #include "global-handles.h"
 #include "heap-profiler.h"
 #include "scopeinfo.h"
@@ -301,7 +302,7 @@ ProfileTree::~ProfileTree() {
 }
 
 
-void ProfileTree::AddPathFromEnd(const Vector<CodeEntry*>& path) {
+ProfileNode* ProfileTree::AddPathFromEnd(const Vector<CodeEntry*>& path) {
   ProfileNode* node = root_;
   for (CodeEntry** entry = path.start() + path.length() - 1;
        entry != path.start() - 1;
@@ -311,6 +312,7 @@ void ProfileTree::AddPathFromEnd(const Vector<CodeEntry*>& path) {
     }
   }
   node->IncrementSelfTicks();
+  return node;
 }
 
 
@@ -337,9 +339,12 @@ struct NodesPair {
 
 class FilteredCloneCallback {
  public:
-  FilteredCloneCallback(ProfileNode* dst_root, int security_token_id)
+  FilteredCloneCallback(ProfileNode* dst_root,
+                        int security_token_id,
+                        HashMap* node_map)
       : stack_(10),
-        security_token_id_(security_token_id) {
+        security_token_id_(security_token_id),
+        node_map_(node_map) {
     stack_.Add(NodesPair(NULL, dst_root));
   }
 
@@ -353,6 +358,11 @@ class FilteredCloneCallback {
       // Attribute ticks to parent node.
       stack_.last().dst->IncreaseSelfTicks(child->self_ticks());
     }
+    // Samples of a filtered out node go to the node its ticks went to.
+    if (node_map_ != NULL) {
+      node_map_->Lookup(child, ComputePointerHash(child), true)->value =
+          stack_.last().dst;
+    }
   }
 
   void AfterAllChildrenTraversed(ProfileNode* parent) { }
@@ -377,11 +387,19 @@ class FilteredCloneCallback {
 
   List<NodesPair> stack_;
   int security_token_id_;
+  HashMap* node_map_;
 };
 
-void ProfileTree::FilteredClone(ProfileTree* src, int security_token_id) {
+void ProfileTree::FilteredClone(ProfileTree* src,
+                                int security_token_id,
+                                HashMap* node_map) {
   ms_to_ticks_scale_ = src->ms_to_ticks_scale_;
-  FilteredCloneCallback cb(root_, security_token_id);
+  if (node_map != NULL) {
+    ProfileNode* src_root = src->root();
+    node_map->Lookup(src_root, ComputePointerHash(src_root), true)->value =
+        root_;
+  }
+  FilteredCloneCallback cb(root_, security_token_id, node_map);
   src->TraverseDepthFirst(&cb);
   CalculateTotalTicks();
 }
@@ -461,9 +479,13 @@ void ProfileTree::ShortPrint() {
 }
 
 
-void CpuProfile::AddPath(const Vector<CodeEntry*>& path) {
-  top_down_.AddPathFromEnd(path);
+void CpuProfile::AddPath(const Vector<CodeEntry*>& path, int64_t timestamp) {
+  ProfileNode* top_frame_node = top_down_.AddPathFromEnd(path);
   bottom_up_.AddPathFromStart(path);
+  if (record_samples_) {
+    samples_.Add(top_frame_node);
+    timestamps_.Add(timestamp);
+  }
 }
 
 
@@ -479,11 +501,26 @@ void CpuProfile::SetActualSamplingRate(double actual_sampling_rate) {
 }
 
 
+static bool ProfileNodesMatch(void* key1, void* key2) {
+  return key1 == key2;
+}
+
+
 CpuProfile* CpuProfile::FilteredClone(int security_token_id) {
   ASSERT(security_token_id != TokenEnumerator::kNoSecurityToken);
-  CpuProfile* clone = new CpuProfile(title_, uid_);
-  clone->top_down_.FilteredClone(&top_down_, security_token_id);
+  CpuProfile* clone = new CpuProfile(title_, uid_, record_samples_);
+  clone->start_time_ = start_time_;
+  HashMap node_map(ProfileNodesMatch);
+  clone->top_down_.FilteredClone(&top_down_, security_token_id, &node_map);
   clone->bottom_up_.FilteredClone(&bottom_up_, security_token_id);
+  for (int i = 0; i < samples_.length(); ++i) {
+    ProfileNode* node = samples_[i];
+    HashMap::Entry* entry =
+        node_map.Lookup(node, ComputePointerHash(node), false);
+    ASSERT(entry != NULL);
+    clone->samples_.Add(reinterpret_cast<ProfileNode*>(entry->value));
+    clone->timestamps_.Add(timestamps_[i]);
+  }
   return clone;
 }
 
@@ -612,7 +649,9 @@ CpuProfilesCollection::~CpuProfilesCollection() {
 }
 
 
-bool CpuProfilesCollection::StartProfiling(const char* title, unsigned uid) {
+bool CpuProfilesCollection::StartProfiling(const char* title,
+                                           unsigned uid,
+                                           bool record_samples) {
   ASSERT(uid > 0);
   current_profiles_semaphore_->Wait();
   if (current_profiles_.length() >= kMaxSimultaneousProfiles) {
@@ -626,14 +665,16 @@ bool CpuProfilesCollection::StartProfiling(const char* title, unsigned uid) {
       return false;
     }
   }
-  current_profiles_.Add(new CpuProfile(title, uid));
+  current_profiles_.Add(new CpuProfile(title, uid, record_samples));
   current_profiles_semaphore_->Signal();
   return true;
 }
 
 
-bool CpuProfilesCollection::StartProfiling(String* title, unsigned uid) {
-  return StartProfiling(GetName(title), uid);
+bool CpuProfilesCollection::StartProfiling(String* title,
+                                           unsigned uid,
+                                           bool record_samples) {
+  return StartProfiling(GetName(title), uid, record_samples);
 }
 
 
@@ -835,13 +876,13 @@ CodeEntry* CpuProfilesCollection::NewCodeEntry(Logger::LogEventsAndTags tag,
 
 
 void CpuProfilesCollection::AddPathToCurrentProfiles(
-    const Vector<CodeEntry*>& path) {
+    const Vector<CodeEntry*>& path, int64_t timestamp) {
   // As starting / stopping profiles is rare relatively to this
   // method, we don't bother minimizing the duration of lock holding,
   // e.g. copying contents of the list to a local vector.
   current_profiles_semaphore_->Wait();
   for (int i = 0; i < current_profiles_.length(); ++i) {
-    current_profiles_[i]->AddPath(path);
+    current_profiles_[i]->AddPath(path, timestamp);
   }
   current_profiles_semaphore_->Signal();
 }
@@ -936,7 +977,7 @@ void ProfileGenerator::RecordTickSample(const TickSample& sample) {
     }
   }
 
-  profiles_->AddPathToCurrentProfiles(entries);
+  profiles_->AddPathToCurrentProfiles(entries, sample.timestamp);
 }
 
 
@@ -2425,6 +2466,7 @@ bool V8HeapExplorer::IterateAndExtractReferences(
        obj = iterator.next(), progress_->ProgressStep()) {
     if (!interrupted) {
       ExtractReferences(obj);
+      filler_->ReferencesExtracted();
       if (!progress_->ProgressReport(false)) interrupted = true;
     }
   }
@@ -3066,6 +3108,7 @@ class SnapshotFiller : public SnapshotFillerInterface {
         collection_->names()->GetName(index),
         child_entry);
   }
+  void ReferencesExtracted() { }
 
  private:
   HeapSnapshot* snapshot_;
@@ -3187,9 +3230,11 @@ class OutputStreamWriter {
         aborted_(false) {
     ASSERT(chunk_size_ > 0);
   }
+  // Once the stream has aborted, everything that is added is dropped.
   bool aborted() { return aborted_; }
   void AddCharacter(char c) {
     ASSERT(c != '\0');
+    if (aborted_) return;
     ASSERT(chunk_pos_ < chunk_size_);
     chunk_[chunk_pos_++] = c;
     MaybeWriteChunk();
@@ -3201,7 +3246,7 @@ class OutputStreamWriter {
     if (n <= 0) return;
     ASSERT(static_cast<size_t>(n) <= strlen(s));
     const char* s_end = s + n;
-    while (s < s_end) {
+    while (s < s_end && !aborted_) {
       int s_chunk_size = Min(
           chunk_size_ - chunk_pos_, static_cast<int>(s_end - s));
       ASSERT(s_chunk_size > 0);
@@ -3212,6 +3257,12 @@ class OutputStreamWriter {
     }
   }
   void AddNumber(unsigned n) { AddNumberImpl<unsigned>(n, "%u"); }
+  void AddByte(byte b) {
+    if (aborted_) return;
+    ASSERT(chunk_pos_ < chunk_size_);
+    chunk_[chunk_pos_++] = static_cast<char>(b);
+    MaybeWriteChunk();
+  }
   void Finalize() {
     if (aborted_) return;
     ASSERT(chunk_pos_ < chunk_size_);
@@ -3227,6 +3278,7 @@ class OutputStreamWriter {
     // Buffer for the longest value plus trailing \0
     static const int kMaxNumberSize =
         MaxDecimalDigitsIn<sizeof(T)>::kUnsigned + 1;
+    if (aborted_) return;
     if (chunk_size_ - chunk_pos_ >= kMaxNumberSize) {
       int result = OS::SNPrintF(
           chunk_.SubVector(chunk_pos_, chunk_size_), format, n);
@@ -3248,7 +3300,7 @@ class OutputStreamWriter {
     }
   }
   void WriteChunk() {
-    if (aborted_) return;
+    ASSERT(!aborted_);
     if (stream_->WriteAsciiChunk(chunk_.start(), chunk_pos_) ==
         v8::OutputStream::kAbort) aborted_ = true;
     chunk_pos_ = 0;
@@ -3503,53 +3555,59 @@ static void WriteUChar(OutputStreamWriter* w, unibrow::uchar u) {
   w->AddCharacter(hex_chars[u & 0xf]);
 }
 
-void HeapSnapshotJSONSerializer::SerializeString(const unsigned char* s) {
-  writer_->AddCharacter('\n');
-  writer_->AddCharacter('\"');
+static void SerializeJSONString(OutputStreamWriter* writer,
+                                const unsigned char* s) {
+  writer->AddCharacter('\n');
+  writer->AddCharacter('\"');
   for ( ; *s != '\0'; ++s) {
     switch (*s) {
       case '\b':
-        writer_->AddString("\\b");
+        writer->AddString("\\b");
         continue;
       case '\f':
-        writer_->AddString("\\f");
+        writer->AddString("\\f");
         continue;
       case '\n':
-        writer_->AddString("\\n");
+        writer->AddString("\\n");
         continue;
       case '\r':
-        writer_->AddString("\\r");
+        writer->AddString("\\r");
         continue;
       case '\t':
-        writer_->AddString("\\t");
+        writer->AddString("\\t");
         continue;
       case '\"':
       case '\\':
-        writer_->AddCharacter('\\');
-        writer_->AddCharacter(*s);
+        writer->AddCharacter('\\');
+        writer->AddCharacter(*s);
         continue;
       default:
         if (*s > 31 && *s < 128) {
-          writer_->AddCharacter(*s);
+          writer->AddCharacter(*s);
         } else if (*s <= 31) {
           // Special character with no dedicated literal.
-          WriteUChar(writer_, *s);
+          WriteUChar(writer, *s);
         } else {
           // Convert UTF-8 into \u UTF-16 literal.
           unsigned length = 1, cursor = 0;
           for ( ; length <= 4 && *(s + length) != '\0'; ++length) { }
           unibrow::uchar c = unibrow::Utf8::CalculateValue(s, length, &cursor);
           if (c != unibrow::Utf8::kBadChar) {
-            WriteUChar(writer_, c);
+            WriteUChar(writer, c);
             ASSERT(cursor != 0);
             s += cursor - 1;
           } else {
-            writer_->AddCharacter('?');
+            writer->AddCharacter('?');
           }
         }
     }
   }
-  writer_->AddCharacter('\"');
+  writer->AddCharacter('\"');
+}
+
+
+void HeapSnapshotJSONSerializer::SerializeString(const unsigned char* s) {
+  SerializeJSONString(writer_, s);
 }
 
 
@@ -3587,4 +3645,673 @@ void HeapSnapshotJSONSerializer::SortHashMap(
   sorted_entries->Sort(SortUsingEntryValue);
 }
 
+
+// A filler that hands the nodes and edges of the heap graph over to a
+// HeapSnapshotStreamer instead of storing them in the snapshot.  Entries for
+// synthetic and native things are retained for the whole exploration.  Entries
+// for heap objects are only kept while the references of one heap object are
+// extracted and are created again whenever the object is referenced.
+class StreamingSnapshotFiller : public SnapshotFillerInterface {
+ public:
+  StreamingSnapshotFiller(HeapSnapshotStreamer* streamer,
+                          HeapSnapshot* snapshot,
+                          HeapEntriesAllocator* heap_entries_allocator,
+                          bool edges)
+      : streamer_(streamer),
+        snapshot_(snapshot),
+        collection_(snapshot->collection()),
+        heap_entries_allocator_(heap_entries_allocator),
+        edges_(edges),
+        retained_entries_count_(0) { }
+  HeapEntry* AddEntry(HeapThing ptr, HeapEntriesAllocator* allocator) {
+    HeapEntry* entry = allocator->AllocateEntry(ptr);
+    if (allocator != heap_entries_allocator_ ||
+        entry->id() < HeapObjectsMap::kFirstAvailableObjectId) {
+      retained_entries_.Pair(ptr, entry->index());
+      retained_entries_count_ = entry->index() + 1;
+      if (!edges_) streamer_->SerializeNode(entry);
+    } else if (!edges_ && MarkAsSerialized(entry->id())) {
+      streamer_->SerializeNode(entry);
+    }
+    return entry;
+  }
+  HeapEntry* FindEntry(HeapThing ptr) {
+    int index = retained_entries_.Map(ptr);
+    if (index != HeapEntry::kNoEntry) return &snapshot_->entries()[index];
+    // Every heap object has an entry, it just is not retained.
+    if (reinterpret_cast<Object*>(ptr)->IsHeapObject()) {
+      return AddEntry(ptr, heap_entries_allocator_);
+    }
+    return NULL;
+  }
+  HeapEntry* FindOrAddEntry(HeapThing ptr, HeapEntriesAllocator* allocator) {
+    HeapEntry* entry = FindEntry(ptr);
+    return entry != NULL ? entry : AddEntry(ptr, allocator);
+  }
+  void SetIndexedReference(HeapGraphEdge::Type type,
+                           int parent,
+                           int index,
+                           HeapEntry* child_entry) {
+    if (!edges_) return;
+    CountChild(parent);
+    streamer_->SerializeEdge(
+        type, index, &snapshot_->entries()[parent], child_entry);
+  }
+  void SetIndexedAutoIndexReference(HeapGraphEdge::Type type,
+                                    int parent,
+                                    HeapEntry* child_entry) {
+    if (!edges_) return;
+    int index = CountChild(parent);
+    streamer_->SerializeEdge(
+        type, index, &snapshot_->entries()[parent], child_entry);
+  }
+  void SetNamedReference(HeapGraphEdge::Type type,
+                         int parent,
+                         const char* reference_name,
+                         HeapEntry* child_entry) {
+    if (!edges_) return;
+    CountChild(parent);
+    streamer_->SerializeEdge(type,
+                             streamer_->GetStringId(reference_name),
+                             &snapshot_->entries()[parent],
+                             child_entry);
+  }
+  void SetNamedAutoIndexReference(HeapGraphEdge::Type type,
+                                  int parent,
+                                  HeapEntry* child_entry) {
+    if (!edges_) return;
+    int index = CountChild(parent);
+    streamer_->SerializeEdge(
+        type,
+        streamer_->GetStringId(collection_->names()->GetName(index)),
+        &snapshot_->entries()[parent],
+        child_entry);
+  }
+  void ReferencesExtracted() {
+    // While heap objects are explored, all retained entries are synthetic
+    // root entries that precede the entries of heap objects.
+    snapshot_->entries().Rewind(retained_entries_count_);
+    if (children_counts_.length() > retained_entries_count_) {
+      children_counts_.Rewind(retained_entries_count_);
+    }
+  }
+
+ private:
+  // Returns the number of children of the parent entry including the new
+  // one, which is the index of auto indexed references.
+  int CountChild(int parent) {
+    while (children_counts_.length() <= parent) children_counts_.Add(0);
+    return ++children_counts_[parent];
+  }
+
+  // Returns whether the node with the given id has not been serialized yet.
+  // Heap object ids are allocated densely, so a bit per id suffices.
+  bool MarkAsSerialized(SnapshotObjectId id) {
+    uint32_t bit = id / HeapObjectsMap::kObjectIdStep;
+    int word = static_cast<int>(bit / kBitsPerInt);
+    uint32_t mask = 1u << (bit % kBitsPerInt);
+    if (serialized_ids_.length() <= word) {
+      serialized_ids_.AddBlock(0, word - serialized_ids_.length() + 1);
+    }
+    if ((serialized_ids_[word] & mask) != 0) return false;
+    serialized_ids_[word] |= mask;
+    return true;
+  }
+
+  HeapSnapshotStreamer* streamer_;
+  HeapSnapshot* snapshot_;
+  HeapSnapshotsCollection* collection_;
+  HeapEntriesAllocator* heap_entries_allocator_;
+  bool edges_;
+  // Mapping from synthetic and native HeapThings to their entries.
+  HeapEntriesMap retained_entries_;
+  int retained_entries_count_;
+  List<int> children_counts_;
+  List<uint32_t> serialized_ids_;
+};
+
+
+// type, name, id, self_size.
+const int HeapSnapshotStreamer::kNodeFieldsCount = 4;
+// type, name|index, from_node, to_node.
+const int HeapSnapshotStreamer::kEdgeFieldsCount = 4;
+
+bool HeapSnapshotStreamer::Stream(v8::OutputStream* stream) {
+  HeapSnapshot nodes_snapshot(collection_, HeapSnapshot::kFull, title_, uid_);
+  HeapSnapshot edges_snapshot(collection_, HeapSnapshot::kFull, title_, uid_);
+  V8HeapExplorer nodes_v8_heap_explorer(&nodes_snapshot, this);
+  V8HeapExplorer edges_v8_heap_explorer(&edges_snapshot, this);
+  NativeObjectsExplorer nodes_dom_explorer(&nodes_snapshot, this);
+  NativeObjectsExplorer edges_dom_explorer(&edges_snapshot, this);
+  nodes_v8_heap_explorer.TagGlobalObjects();
+  edges_v8_heap_explorer.TagGlobalObjects();
+
+  // See HeapSnapshotGenerator::GenerateSnapshot.
+  Isolate::Current()->heap()->CollectAllGarbage(
+      Heap::kMakeHeapIterableMask,
+      "HeapSnapshotStreamer::Stream");
+  Isolate::Current()->heap()->CollectAllGarbage(
+      Heap::kMakeHeapIterableMask,
+      "HeapSnapshotStreamer::Stream");
+
+  // Both explorations have to see the same heap, so nothing must be
+  // allocated until the edges have been streamed.
+  AssertNoAllocation no_alloc;
+
+  SetProgressTotal(2, &nodes_v8_heap_explorer);  // 2 passes.
+
+  ASSERT(writer_ == NULL);
+  writer_ = new OutputStreamWriter(stream);
+  writer_->AddCharacter('{');
+  writer_->AddString("\"snapshot\":{");
+  SerializeSnapshot();
+  writer_->AddString("},\n");
+  writer_->AddString("\"nodes\":[");
+  // Exploring the heap stops as soon as the stream aborts, see
+  // ProgressReport.
+  bool completed = !writer_->aborted() && StreamEntries(
+      &nodes_snapshot, &nodes_v8_heap_explorer, &nodes_dom_explorer, false);
+  if (completed) {
+    writer_->AddString("],\n");
+    writer_->AddString("\"edges\":[");
+    completed = StreamEntries(
+        &edges_snapshot, &edges_v8_heap_explorer, &edges_dom_explorer, true);
+  }
+  if (completed) {
+    writer_->AddString("],\n");
+    writer_->AddString("\"strings\":[");
+    SerializeStrings();
+    writer_->AddString("],\n");
+    writer_->AddString("\"node_count\":");
+    writer_->AddNumber(node_count_);
+    writer_->AddString(",\"edge_count\":");
+    writer_->AddNumber(edge_count_);
+    writer_->AddCharacter('}');
+    completed = !writer_->aborted();
+    writer_->Finalize();
+  }
+
+  delete writer_;
+  writer_ = NULL;
+  if (!completed) return false;
+
+  progress_counter_ = progress_total_;
+  return ProgressReport(true);
+}
+
+
+bool HeapSnapshotStreamer::StreamEntries(HeapSnapshot* snapshot,
+                                         V8HeapExplorer* v8_heap_explorer,
+                                         NativeObjectsExplorer* dom_explorer,
+                                         bool edges) {
+  StreamingSnapshotFiller filler(this, snapshot, v8_heap_explorer, edges);
+  v8_heap_explorer->AddRootEntries(&filler);
+  return v8_heap_explorer->IterateAndExtractReferences(&filler)
+      && dom_explorer->IterateAndExtractReferences(&filler)
+      && !writer_->aborted();
+}
+
+
+void HeapSnapshotStreamer::ProgressStep() {
+  ++progress_counter_;
+}
+
+
+bool HeapSnapshotStreamer::ProgressReport(bool force) {
+  // Stop exploring the heap once the stream has been aborted.
+  if (writer_ != NULL && writer_->aborted()) return false;
+  const int kProgressReportGranularity = 10000;
+  if (control_ != NULL
+      && (force || progress_counter_ % kProgressReportGranularity == 0)) {
+      return
+          control_->ReportProgressValue(progress_counter_, progress_total_) ==
+          v8::ActivityControl::kContinue;
+  }
+  return true;
+}
+
+
+void HeapSnapshotStreamer::SetProgressTotal(int iterations_count,
+                                            V8HeapExplorer* explorer) {
+  progress_counter_ = 0;
+  progress_total_ = 0;
+  if (control_ == NULL) return;
+  HeapIterator iterator(HeapIterator::kFilterUnreachable);
+  progress_total_ =
+      iterations_count * explorer->EstimateObjectsCount(&iterator);
+}
+
+
+int HeapSnapshotStreamer::GetStringId(const char* s) {
+  HashMap::Entry* cache_entry = strings_.Lookup(
+      const_cast<char*>(s), ObjectHash(s), true);
+  if (cache_entry->value == NULL) {
+    cache_entry->value = reinterpret_cast<void*>(next_string_id_++);
+  }
+  return static_cast<int>(reinterpret_cast<intptr_t>(cache_entry->value));
+}
+
+
+void HeapSnapshotStreamer::SerializeNode(HeapEntry* entry) {
+  if (writer_->aborted()) return;
+  // The buffer needs space for 4 unsigned ints, 4 commas, \n and \0
+  static const int kBufferSize =
+      4 * MaxDecimalDigitsIn<sizeof(unsigned)>::kUnsigned  // NOLINT
+      + 4 + 1 + 1;
+  EmbeddedVector<char, kBufferSize> buffer;
+  int buffer_pos = 0;
+  if (node_count_++ != 0) {
+    buffer[buffer_pos++] = ',';
+  }
+  buffer_pos = utoa(entry->type(), buffer, buffer_pos);
+  buffer[buffer_pos++] = ',';
+  buffer_pos = utoa(GetStringId(entry->name()), buffer, buffer_pos);
+  buffer[buffer_pos++] = ',';
+  buffer_pos = utoa(entry->id(), buffer, buffer_pos);
+  buffer[buffer_pos++] = ',';
+  buffer_pos = utoa(entry->self_size(), buffer, buffer_pos);
+  buffer[buffer_pos++] = '\n';
+  buffer[buffer_pos++] = '\0';
+  writer_->AddString(buffer.start());
+}
+
+
+void HeapSnapshotStreamer::SerializeEdge(HeapGraphEdge::Type type,
+                                         int name_or_index,
+                                         HeapEntry* from,
+                                         HeapEntry* to) {
+  if (writer_->aborted()) return;
+  // The buffer needs space for 4 unsigned ints, 4 commas, \n and \0
+  static const int kBufferSize =
+      4 * MaxDecimalDigitsIn<sizeof(unsigned)>::kUnsigned  // NOLINT
+      + 4 + 1 + 1;
+  EmbeddedVector<char, kBufferSize> buffer;
+  int buffer_pos = 0;
+  if (edge_count_++ != 0) {
+    buffer[buffer_pos++] = ',';
+  }
+  buffer_pos = utoa(type, buffer, buffer_pos);
+  buffer[buffer_pos++] = ',';
+  buffer_pos = utoa(name_or_index, buffer, buffer_pos);
+  buffer[buffer_pos++] = ',';
+  buffer_pos = utoa(from->id(), buffer, buffer_pos);
+  buffer[buffer_pos++] = ',';
+  buffer_pos = utoa(to->id(), buffer, buffer_pos);
+  buffer[buffer_pos++] = '\n';
+  buffer[buffer_pos++] = '\0';
+  writer_->AddString(buffer.start());
+}
+
+
+void HeapSnapshotStreamer::SerializeSnapshot() {
+  writer_->AddString("\"title\":\"");
+  writer_->AddString(title_);
+  writer_->AddString("\"");
+  writer_->AddString(",\"uid\":");
+  writer_->AddNumber(uid_);
+  writer_->AddString(",\"meta\":");
+  // Unlike in the format of HeapSnapshotJSONSerializer, nodes carry no edge
+  // counts and edges refer to both of their nodes by id.
+#define JSON_A(s) "[" s "]"
+#define JSON_O(s) "{" s "}"
+#define JSON_S(s) "\"" s "\""
+  writer_->AddString(JSON_O(
+    JSON_S("node_fields") ":" JSON_A(
+        JSON_S("type") ","
+        JSON_S("name") ","
+        JSON_S("id") ","
+        JSON_S("self_size")) ","
+    JSON_S("node_types") ":" JSON_A(
+        JSON_A(
+            JSON_S("hidden") ","
+            JSON_S("array") ","
+            JSON_S("string") ","
+            JSON_S("object") ","
+            JSON_S("code") ","
+            JSON_S("closure") ","
+            JSON_S("regexp") ","
+            JSON_S("number") ","
+            JSON_S("native") ","
+            JSON_S("synthetic")) ","
+        JSON_S("string") ","
+        JSON_S("number") ","
+        JSON_S("number")) ","
+    JSON_S("edge_fields") ":" JSON_A(
+        JSON_S("type") ","
+        JSON_S("name_or_index") ","
+        JSON_S("from_node") ","
+        JSON_S("to_node")) ","
+    JSON_S("edge_types") ":" JSON_A(
+        JSON_A(
+            JSON_S("context") ","
+            JSON_S("element") ","
+            JSON_S("property") ","
+            JSON_S("internal") ","
+            JSON_S("hidden") ","
+            JSON_S("shortcut") ","
+            JSON_S("weak")) ","
+        JSON_S("string_or_number") ","
+        JSON_S("node_id") ","
+        JSON_S("node_id"))));
+#undef JSON_S
+#undef JSON_O
+#undef JSON_A
+}
+
+
+void HeapSnapshotStreamer::SerializeStrings() {
+  List<HashMap::Entry*> sorted_strings;
+  for (HashMap::Entry* p = strings_.Start(); p != NULL; p = strings_.Next(p)) {
+    sorted_strings.Add(p);
+  }
+  sorted_strings.Sort(SortUsingEntryValue);
+  writer_->AddString("\"<dummy>\"");
+  for (int i = 0; i < sorted_strings.length(); ++i) {
+    writer_->AddCharacter(',');
+    SerializeJSONString(
+        writer_,
+        reinterpret_cast<const unsigned char*>(sorted_strings[i]->key));
+    if (writer_->aborted()) return;
+  }
+}
+
+
+static const char kCpuTraceMagic[] = "v8cputrace";
+static const int kCpuTraceVersion = 1;
+
+
+static void WriteTraceVarint(OutputStreamWriter* writer, uint64_t value) {
+  do {
+    byte b = static_cast<byte>(value & 0x7f);
+    value >>= 7;
+    if (value != 0) b |= 0x80;
+    writer->AddByte(b);
+  } while (value != 0);
+}
+
+
+static void WriteTraceSignedVarint(OutputStreamWriter* writer,
+                                   int64_t value) {
+  // Zigzag encoding keeps small negative values short.
+  WriteTraceVarint(writer,
+                   static_cast<uint64_t>((value << 1) ^ (value >> 63)));
+}
+
+
+static bool TracePointersMatch(void* key1, void* key2) {
+  return key1 == key2;
+}
+
+
+static int GetTraceId(HashMap* ids, void* key) {
+  HashMap::Entry* entry = ids->Lookup(key, ComputePointerHash(key), false);
+  ASSERT(entry != NULL);
+  return static_cast<int>(reinterpret_cast<intptr_t>(entry->value));
+}
+
+
+static void AddTraceString(HashMap* ids,
+                           List<const char*>* strings,
+                           const char* s) {
+  void* key = const_cast<char*>(s);
+  HashMap::Entry* entry = ids->Lookup(key, ComputePointerHash(key), true);
+  if (entry->value == NULL) {
+    strings->Add(s);
+    entry->value = reinterpret_cast<void*>(strings->length());
+  }
+}
+
+
+static int GetTraceStringId(HashMap* ids, const char* s) {
+  return GetTraceId(ids, const_cast<char*>(s)) - 1;
+}
+
+
+void CpuProfile::SerializeTrace(v8::OutputStream* stream) {
+  // Number the nodes so that every node follows its parent, and the
+  // strings they refer to in the order of first use. String ids start at
+  // one so that zero marks a missing entry in the maps.
+  List<ProfileNode*> nodes;
+  List<int> parents;
+  HashMap node_ids(TracePointersMatch);
+  HashMap string_ids(TracePointersMatch);
+  List<const char*> strings;
+  nodes.Add(top_down_.root());
+  parents.Add(-1);
+  for (int i = 0; i < nodes.length(); ++i) {
+    ProfileNode* node = nodes[i];
+    node_ids.Lookup(node, ComputePointerHash(node), true)->value =
+        reinterpret_cast<void*>(i);
+    AddTraceString(&string_ids, &strings, node->entry()->name_prefix());
+    AddTraceString(&string_ids, &strings, node->entry()->name());
+    AddTraceString(&string_ids, &strings, node->entry()->resource_name());
+    const List<ProfileNode*>* children = node->children();
+    for (int j = 0; j < children->length(); ++j) {
+      nodes.Add(children->at(j));
+      parents.Add(i);
+    }
+  }
+
+  OutputStreamWriter writer(stream);
+  writer.AddString(kCpuTraceMagic);
+  WriteTraceVarint(&writer, kCpuTraceVersion);
+  WriteTraceVarint(&writer, strings.length());
+  for (int i = 0; i < strings.length() && !writer.aborted(); ++i) {
+    int length = StrLength(strings[i]);
+    WriteTraceVarint(&writer, length);
+    writer.AddSubstring(strings[i], length);
+  }
+  WriteTraceVarint(&writer, nodes.length());
+  for (int i = 0; i < nodes.length() && !writer.aborted(); ++i) {
+    CodeEntry* entry = nodes[i]->entry();
+    WriteTraceVarint(&writer, parents[i] + 1);
+    WriteTraceVarint(&writer,
+                     GetTraceStringId(&string_ids, entry->name_prefix()));
+    WriteTraceVarint(&writer, GetTraceStringId(&string_ids, entry->name()));
+    WriteTraceVarint(&writer,
+                     GetTraceStringId(&string_ids, entry->resource_name()));
+    WriteTraceVarint(&writer, Max(0, entry->line_number()));
+  }
+  WriteTraceVarint(&writer, samples_.length());
+  WriteTraceVarint(&writer, start_time_);
+  int64_t previous_timestamp = start_time_;
+  for (int i = 0; i < samples_.length() && !writer.aborted(); ++i) {
+    WriteTraceVarint(&writer, GetTraceId(&node_ids, samples_[i]));
+    WriteTraceSignedVarint(&writer, timestamps_[i] - previous_timestamp);
+    previous_timestamp = timestamps_[i];
+  }
+  writer.Finalize();
+}
+
+
+AllocationSiteNode::AllocationSiteNode(AllocationSiteNode* parent,
+                                       const char* name,
+                                       const char* resource_name,
+                                       int line_number,
+                                       int script_id,
+                                       int start_position)
+    : parent_(parent),
+      name_(name),
+      resource_name_(resource_name),
+      line_number_(line_number),
+      script_id_(script_id),
+      start_position_(start_position),
+      samples_count_(0),
+      self_allocated_size_(0),
+      self_live_size_(0),
+      total_allocated_size_(0),
+      total_live_size_(0),
+      children_(4) {
+}
+
+
+AllocationSiteNode::~AllocationSiteNode() {
+  for (int i = 0; i < children_.length(); ++i) delete children_[i];
+}
+
+
+AllocationSiteNode* AllocationSiteNode::FindChild(const char* name,
+                                                  int script_id,
+                                                  int start_position) {
+  for (int i = 0; i < children_.length(); ++i) {
+    AllocationSiteNode* child = children_[i];
+    if (child->start_position_ == start_position &&
+        child->script_id_ == script_id &&
+        child->name_ == name) {
+      return child;
+    }
+  }
+  return NULL;
+}
+
+
+AllocationSiteNode* AllocationSiteNode::AddChild(const char* name,
+                                                 const char* resource_name,
+                                                 int line_number,
+                                                 int script_id,
+                                                 int start_position) {
+  AllocationSiteNode* child = new AllocationSiteNode(
+      this, name, resource_name, line_number, script_id, start_position);
+  children_.Add(child);
+  return child;
+}
+
+
+void AllocationSiteNode::AddSample(size_t allocated_size, size_t live_size) {
+  ++samples_count_;
+  self_allocated_size_ += allocated_size;
+  self_live_size_ += live_size;
+  for (AllocationSiteNode* node = this; node != NULL; node = node->parent_) {
+    node->total_allocated_size_ += allocated_size;
+    node->total_live_size_ += live_size;
+  }
+}
+
+
+void AllocationSiteNode::RemoveLiveSample(size_t size) {
+  ASSERT(self_live_size_ >= size);
+  self_live_size_ -= size;
+  for (AllocationSiteNode* node = this; node != NULL; node = node->parent_) {
+    node->total_live_size_ -= size;
+  }
+}
+
+
+AllocationSampler::AllocationSampler(Heap* heap, intptr_t sample_interval)
+    : heap_(heap),
+      sample_interval_(sample_interval),
+      bytes_since_sample_(0),
+      root_(NULL, "(root)", "", v8::AllocationProfileNode::kNoLineNumberInfo,
+            -1, -1),
+      nodes_count_(1) {
+}
+
+
+AllocationSampler::~AllocationSampler() {
+  GlobalHandles* global_handles = heap_->isolate()->global_handles();
+  for (int i = 0; i < samples_.length(); ++i) {
+    global_handles->Destroy(samples_[i]->location);
+    delete samples_[i];
+  }
+}
+
+
+void AllocationSampler::SampleAllocation(HeapObject* object,
+                                         int object_size,
+                                         intptr_t bytes_allocated) {
+  bytes_since_sample_ += bytes_allocated;
+  if (bytes_since_sample_ < sample_interval_) return;
+
+  // The object has only been reserved. Global handles look at its map
+  // when it is made weak, so give it one until its owner initializes it.
+  heap_->CreateFillerObjectAt(object->address(), object_size);
+  Sample* sample = new Sample;
+  sample->sampler = this;
+  sample->node = AddStack();
+  sample->size = static_cast<size_t>(object_size);
+  sample->index = samples_.length();
+  sample->node->AddSample(static_cast<size_t>(bytes_since_sample_),
+                          sample->size);
+  bytes_since_sample_ = 0;
+
+  GlobalHandles* global_handles = heap_->isolate()->global_handles();
+  sample->location = global_handles->Create(object).location();
+  global_handles->MakeWeak(sample->location, sample, SampleWeakCallback);
+  // Let scavenges collect sampled objects that die young.
+  global_handles->MarkIndependent(sample->location);
+  samples_.Add(sample);
+}
+
+
+AllocationSiteNode* AllocationSampler::AddStack() {
+  Isolate* isolate = heap_->isolate();
+  HandleScope scope(isolate);
+  // Collect the innermost frames first, then add the path from the
+  // outermost one.
+  JSFunction* functions[kMaxStackDepth];
+  int depth = 0;
+  for (JavaScriptFrameIterator it(isolate);
+       !it.done() && depth < kMaxStackDepth;
+       it.Advance()) {
+    functions[depth++] = JSFunction::cast(it.frame()->function());
+  }
+  AllocationSiteNode* node = &root_;
+  while (depth > 0) {
+    SharedFunctionInfo* shared = functions[--depth]->shared();
+    const char* name = names_.GetFunctionName(shared->DebugName());
+    int script_id = -1;
+    if (shared->script()->IsScript()) {
+      Object* id = Script::cast(shared->script())->id();
+      if (id->IsSmi()) script_id = Smi::cast(id)->value();
+    }
+    int start_position = shared->start_position();
+    AllocationSiteNode* child =
+        node->FindChild(name, script_id, start_position);
+    if (child == NULL) {
+      const char* resource_name = "";
+      int line_number = v8::AllocationProfileNode::kNoLineNumberInfo;
+      if (shared->script()->IsScript()) {
+        Handle<Script> script(Script::cast(shared->script()));
+        if (script->name()->IsString()) {
+          resource_name = names_.GetName(String::cast(script->name()));
+        }
+        line_number = GetScriptLineNumberSafe(script, start_position) + 1;
+      }
+      child = node->AddChild(
+          name, resource_name, line_number, script_id, start_position);
+      ++nodes_count_;
+    }
+    node = child;
+  }
+  return node;
+}
+
+
+void AllocationSampler::RemoveSample(Sample* sample) {
+  Sample* last = samples_.RemoveLast();
+  if (last != sample) {
+    last->index = sample->index;
+    samples_[sample->index] = last;
+  }
+  heap_->isolate()->global_handles()->Destroy(sample->location);
+  delete sample;
+}
+
+
+void AllocationSampler::SampleWeakCallback(v8::Persistent<v8::Value> handle,
+                                           void* parameter) {
+  Sample* sample = reinterpret_cast<Sample*>(parameter);
+  ASSERT(sample->location == Utils::OpenHandle(*handle).location());
+  sample->node->RemoveLiveSample(sample->size);
+  sample->sampler->RemoveSample(sample);
+}
+
+
+size_t AllocationSampler::GetUsedMemorySize() const {
+  return sizeof(*this) +
+      nodes_count_ * sizeof(AllocationSiteNode) +
+      samples_.length() * sizeof(Sample) +
+      names_.GetUsedMemorySize();
+}
+
 } }  // namespace v8::internal
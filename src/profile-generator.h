@@ -179,10 +179,14 @@ class ProfileTree {
   ProfileTree();
   ~ProfileTree();
 
-  void AddPathFromEnd(const Vector<CodeEntry*>& path);
+  ProfileNode* AddPathFromEnd(const Vector<CodeEntry*>& path);
   void AddPathFromStart(const Vector<CodeEntry*>& path);
   void CalculateTotalTicks();
-  void FilteredClone(ProfileTree* src, int security_token_id);
+  // If node_map is not NULL, it receives the clone node every node of src
+  // was merged into.
+  void FilteredClone(ProfileTree* src,
+                     int security_token_id,
+                     HashMap* node_map = NULL);
 
   double TicksToMillis(unsigned ticks) const {
     return ticks * ms_to_ticks_scale_;
@@ -209,19 +213,30 @@ class ProfileTree {
 
 class CpuProfile {
  public:
-  CpuProfile(const char* title, unsigned uid)
-      : title_(title), uid_(uid) { }
+  CpuProfile(const char* title, unsigned uid, bool record_samples)
+      : title_(title),
+        uid_(uid),
+        record_samples_(record_samples),
+        start_time_(OS::Ticks()) { }
 
   // Add pc -> ... -> main() call path to the profile.
-  void AddPath(const Vector<CodeEntry*>& path);
+  void AddPath(const Vector<CodeEntry*>& path, int64_t timestamp);
   void CalculateTotalTicks();
   void SetActualSamplingRate(double actual_sampling_rate);
   CpuProfile* FilteredClone(int security_token_id);
+  // Writes the recorded samples as a compact binary trace, see
+  // v8::CpuProfile::SerializeTrace for the format.
+  void SerializeTrace(v8::OutputStream* stream);
 
   INLINE(const char* title() const) { return title_; }
   INLINE(unsigned uid() const) { return uid_; }
   INLINE(const ProfileTree* top_down() const) { return &top_down_; }
   INLINE(const ProfileTree* bottom_up() const) { return &bottom_up_; }
+  INLINE(int samples_count() const) { return samples_.length(); }
+  INLINE(ProfileNode* sample(int index) const) { return samples_[index]; }
+  INLINE(int64_t sample_timestamp(int index) const) {
+    return timestamps_[index];
+  }
 
   void UpdateTicksScale();
 
@@ -231,8 +246,13 @@ class CpuProfile {
  private:
   const char* title_;
   unsigned uid_;
+  bool record_samples_;
+  int64_t start_time_;
   ProfileTree top_down_;
   ProfileTree bottom_up_;
+  // Top-down tree nodes of the recorded samples and their timestamps.
+  List<ProfileNode*> samples_;
+  List<int64_t> timestamps_;
 
   DISALLOW_COPY_AND_ASSIGN(CpuProfile);
 };
@@ -289,8 +309,12 @@ class CpuProfilesCollection {
   CpuProfilesCollection();
   ~CpuProfilesCollection();
 
-  bool StartProfiling(const char* title, unsigned uid);
-  bool StartProfiling(String* title, unsigned uid);
+  bool StartProfiling(const char* title,
+                      unsigned uid,
+                      bool record_samples = false);
+  bool StartProfiling(String* title,
+                      unsigned uid,
+                      bool record_samples = false);
   CpuProfile* StopProfiling(int security_token_id,
                             const char* title,
                             double actual_sampling_rate);
@@ -315,7 +339,8 @@ class CpuProfilesCollection {
   CodeEntry* NewCodeEntry(int security_token_id);
 
   // Called from profile generator thread.
-  void AddPathToCurrentProfiles(const Vector<CodeEntry*>& path);
+  void AddPathToCurrentProfiles(const Vector<CodeEntry*>& path,
+                                int64_t timestamp);
 
   // Limits the number of profiles that can be simultaneously collected.
   static const int kMaxSimultaneousProfiles = 100;
@@ -836,6 +861,10 @@ class SnapshotFillerInterface {
   virtual void SetNamedAutoIndexReference(HeapGraphEdge::Type type,
                                           int parent_entry,
                                           HeapEntry* child_entry) = 0;
+  // Called after all references of a heap object have been extracted.
+  // Entries for heap objects that were handed out before are no longer
+  // used by the explorer afterwards.
+  virtual void ReferencesExtracted() = 0;
 };
 
 
@@ -1045,6 +1074,80 @@ class HeapSnapshotGenerator : public SnapshottingProgressReportingInterface {
 
 class OutputStreamWriter;
 
+// HeapSnapshotStreamer writes a heap snapshot to an output stream while
+// the heap is being explored, instead of building a HeapSnapshot first.
+// The heap is explored twice, once for the nodes and once for the edges.
+// Edges refer to nodes by their ids, so apart from the ids kept by the
+// HeapObjectsMap only the entries of synthetic and native nodes, a bit per
+// id and the string table stay resident.
+class HeapSnapshotStreamer : public SnapshottingProgressReportingInterface {
+ public:
+  HeapSnapshotStreamer(HeapSnapshotsCollection* collection,
+                       const char* title,
+                       unsigned uid,
+                       v8::ActivityControl* control)
+      : collection_(collection),
+        title_(title),
+        uid_(uid),
+        control_(control),
+        strings_(ObjectsMatch),
+        next_string_id_(1),
+        node_count_(0),
+        edge_count_(0),
+        writer_(NULL) {
+  }
+  // Returns false if the stream or the activity control aborted streaming.
+  bool Stream(v8::OutputStream* stream);
+
+ private:
+  INLINE(static bool ObjectsMatch(void* key1, void* key2)) {
+    return key1 == key2;
+  }
+
+  INLINE(static uint32_t ObjectHash(const void* key)) {
+    return ComputeIntegerHash(
+        static_cast<uint32_t>(reinterpret_cast<uintptr_t>(key)),
+        v8::internal::kZeroHashSeed);
+  }
+
+  bool StreamEntries(HeapSnapshot* snapshot,
+                     V8HeapExplorer* v8_heap_explorer,
+                     NativeObjectsExplorer* dom_explorer,
+                     bool edges);
+  void ProgressStep();
+  bool ProgressReport(bool force = false);
+  void SetProgressTotal(int iterations_count, V8HeapExplorer* explorer);
+
+  int GetStringId(const char* s);
+  void SerializeNode(HeapEntry* entry);
+  void SerializeEdge(HeapGraphEdge::Type type,
+                     int name_or_index,
+                     HeapEntry* from,
+                     HeapEntry* to);
+  void SerializeSnapshot();
+  void SerializeStrings();
+
+  static const int kEdgeFieldsCount;
+  static const int kNodeFieldsCount;
+
+  HeapSnapshotsCollection* collection_;
+  const char* title_;
+  unsigned uid_;
+  v8::ActivityControl* control_;
+  HashMap strings_;
+  int next_string_id_;
+  int node_count_;
+  int edge_count_;
+  OutputStreamWriter* writer_;
+  int progress_counter_;
+  int progress_total_;
+
+  friend class StreamingSnapshotFiller;
+
+  DISALLOW_COPY_AND_ASSIGN(HeapSnapshotStreamer);
+};
+
+
 class HeapSnapshotJSONSerializer {
  public:
   explicit HeapSnapshotJSONSerializer(HeapSnapshot* snapshot)
@@ -1095,6 +1198,108 @@ class HeapSnapshotJSONSerializer {
   DISALLOW_COPY_AND_ASSIGN(HeapSnapshotJSONSerializer);
 };
 
+
+// A node of the top-down tree of allocation sites built by
+// AllocationSampler. Every node stands for a JavaScript function called
+// along the path from the root; the sizes are estimated from the samples.
+class AllocationSiteNode {
+ public:
+  AllocationSiteNode(AllocationSiteNode* parent,
+                     const char* name,
+                     const char* resource_name,
+                     int line_number,
+                     int script_id,
+                     int start_position);
+  ~AllocationSiteNode();
+
+  AllocationSiteNode* FindChild(const char* name,
+                                int script_id,
+                                int start_position);
+  AllocationSiteNode* AddChild(const char* name,
+                               const char* resource_name,
+                               int line_number,
+                               int script_id,
+                               int start_position);
+  // Accounts a sample standing for allocated_size bytes of allocation to
+  // this node and to all of its ancestors. live_size is the size of the
+  // sampled object, which counts as live until it is collected.
+  void AddSample(size_t allocated_size, size_t live_size);
+  // Removes a sampled object that has been collected from the live size.
+  void RemoveLiveSample(size_t size);
+
+  AllocationSiteNode* parent() const { return parent_; }
+  const char* name() const { return name_; }
+  const char* resource_name() const { return resource_name_; }
+  int line_number() const { return line_number_; }
+  unsigned samples_count() const { return samples_count_; }
+  size_t self_allocated_size() const { return self_allocated_size_; }
+  size_t self_live_size() const { return self_live_size_; }
+  size_t total_allocated_size() const { return total_allocated_size_; }
+  size_t total_live_size() const { return total_live_size_; }
+  const List<AllocationSiteNode*>* children() const { return &children_; }
+
+ private:
+  AllocationSiteNode* parent_;
+  const char* name_;
+  const char* resource_name_;
+  int line_number_;
+  int script_id_;
+  int start_position_;
+  unsigned samples_count_;
+  size_t self_allocated_size_;
+  size_t self_live_size_;
+  size_t total_allocated_size_;
+  size_t total_live_size_;
+  List<AllocationSiteNode*> children_;
+
+  DISALLOW_COPY_AND_ASSIGN(AllocationSiteNode);
+};
+
+
+// Samples the object that crosses every sample_interval bytes of
+// allocation and attributes those bytes to the JavaScript stack at the
+// point of allocation. Sampled objects are held by weak global handles, so
+// the sizes of the collected ones are removed from the live sizes of their
+// allocation sites.
+class AllocationSampler {
+ public:
+  AllocationSampler(Heap* heap, intptr_t sample_interval);
+  ~AllocationSampler();
+
+  void SampleAllocation(HeapObject* object,
+                        int object_size,
+                        intptr_t bytes_allocated);
+
+  AllocationSiteNode* root() { return &root_; }
+  size_t GetUsedMemorySize() const;
+
+ private:
+  struct Sample {
+    AllocationSampler* sampler;
+    AllocationSiteNode* node;
+    size_t size;
+    int index;
+    Object** location;
+  };
+
+  static const int kMaxStackDepth = 64;
+
+  AllocationSiteNode* AddStack();
+  void RemoveSample(Sample* sample);
+  static void SampleWeakCallback(v8::Persistent<v8::Value> handle,
+                                 void* parameter);
+
+  Heap* heap_;
+  intptr_t sample_interval_;
+  intptr_t bytes_since_sample_;
+  StringsStorage names_;
+  AllocationSiteNode root_;
+  int nodes_count_;
+  List<Sample*> samples_;
+
+  DISALLOW_COPY_AND_ASSIGN(AllocationSampler);
+};
+
 } }  // namespace v8::internal
 
 #endif  // V8_PROFILE_GENERATOR_H_
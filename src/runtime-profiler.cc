@@ -163,24 +163,44 @@ void RuntimeProfiler::Optimize(JSFunction* function, const char* reason) {
 
 
 void RuntimeProfiler::AttemptOnStackReplacement(JSFunction* function) {
-  // See AlwaysFullCompiler (in compiler.cc) comment on why we need
-  // Debug::has_break_points().
   ASSERT(function->IsMarkedForLazyRecompilation() ||
          function->IsMarkedForParallelRecompilation());
+  PatchStackChecksForOnStackReplacement(function);
+}
+
+
+void RuntimeProfiler::RequestOnStackReplacement(JSFunction* function) {
+  Code* unoptimized_code = function->shared()->code();
+  if (unoptimized_code->kind() != Code::FUNCTION) return;
+  // The stack checks are never patched while the nesting level is zero,
+  // see Runtime_CompileForOnStackReplacement.
+  if (unoptimized_code->allow_osr_at_loop_nesting_level() == 0 &&
+      !PatchStackChecksForOnStackReplacement(function)) {
+    return;
+  }
+  unoptimized_code->set_allow_osr_at_loop_nesting_level(
+      Code::kMaxLoopNestingMarker);
+}
+
+
+bool RuntimeProfiler::PatchStackChecksForOnStackReplacement(
+    JSFunction* function) {
+  // See AlwaysFullCompiler (in compiler.cc) comment on why we need
+  // Debug::has_break_points().
   if (!FLAG_use_osr ||
       isolate_->DebuggerHasBreakPoints() ||
       function->IsBuiltin()) {
-    return;
+    return false;
   }
 
   SharedFunctionInfo* shared = function->shared();
   // If the code is not optimizable, don't try OSR.
-  if (!shared->code()->optimizable()) return;
+  if (!shared->code()->optimizable()) return false;
 
   // We are not prepared to do OSR for a function that already has an
   // allocated arguments object.  The optimized code would bypass it for
   // arguments accesses, which is unsound.  Don't try OSR.
-  if (shared->uses_arguments()) return;
+  if (shared->uses_arguments()) return false;
 
   // We're using on-stack replacement: patch the unoptimized code so that
   // any back edge in any unoptimized frame will trigger on-stack
@@ -203,14 +223,14 @@ void RuntimeProfiler::AttemptOnStackReplacement(JSFunction* function) {
     StackCheckStub check_stub;
     found_code = check_stub.FindCodeInCache(&stack_check_code);
   }
-  if (found_code) {
-    Code* replacement_code =
-        isolate_->builtins()->builtin(Builtins::kOnStackReplacement);
-    Code* unoptimized_code = shared->code();
-    Deoptimizer::PatchStackCheckCode(unoptimized_code,
-                                     stack_check_code,
-                                     replacement_code);
-  }
+  if (!found_code) return false;
+  Code* replacement_code =
+      isolate_->builtins()->builtin(Builtins::kOnStackReplacement);
+  Code* unoptimized_code = shared->code();
+  Deoptimizer::PatchStackCheckCode(unoptimized_code,
+                                   stack_check_code,
+                                   replacement_code);
+  return true;
 }
 
 
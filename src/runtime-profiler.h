@@ -96,6 +96,11 @@ class RuntimeProfiler {
 
   void AttemptOnStackReplacement(JSFunction* function);
 
+  // Makes every back edge in the unoptimized code of the function call into
+  // the runtime, so that a loop running in an unoptimized frame picks up
+  // code that was compiled for on-stack replacement in the background.
+  void RequestOnStackReplacement(JSFunction* function);
+
  private:
   static const int kSamplerWindowSize = 16;
 
@@ -103,6 +108,8 @@ class RuntimeProfiler {
 
   void Optimize(JSFunction* function, const char* reason);
 
+  bool PatchStackChecksForOnStackReplacement(JSFunction* function);
+
   void ClearSampleBuffer();
 
   void ClearSampleBufferNewSpaceEntries();
@@ -46,6 +46,7 @@
 #include "isolate-inl.h"
 #include "jsregexp.h"
 #include "json-parser.h"
+#include "json-stringifier.h"
 #include "liveedit.h"
 #include "liveobjectlist-inl.h"
 #include "misc-intrinsics.h"
@@ -5760,6 +5761,14 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_QuoteJSONStringArray) {
 }
 
 
+RUNTIME_FUNCTION(MaybeObject*, Runtime_BasicJSONStringify) {
+  HandleScope scope(isolate);
+  ASSERT(args.length() == 1);
+  BasicJsonStringifier stringifier(isolate);
+  return stringifier.Stringify(args.at<Object>(0));
+}
+
+
 RUNTIME_FUNCTION(MaybeObject*, Runtime_StringParseInt) {
   NoHandleAllocation ha;
 
@@ -7932,7 +7941,7 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_LazyRecompile) {
 RUNTIME_FUNCTION(MaybeObject*, Runtime_ParallelRecompile) {
   HandleScope handle_scope(isolate);
   ASSERT(FLAG_parallel_recompilation);
-  Compiler::RecompileParallel(args.at<JSFunction>(0));
+  Compiler::RecompileParallel(args.at<JSFunction>(0), BailoutId::None());
   return *isolate->factory()->undefined_value();
 }
 
@@ -8119,6 +8128,17 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_GetOptimizationCount) {
 }
 
 
+// Returns whether the optimized code can be entered from the loop with the
+// given AST id in an unoptimized frame.
+static bool HasOsrEntryAt(Code* code, BailoutId ast_id) {
+  ASSERT(code->kind() == Code::OPTIMIZED_FUNCTION);
+  DeoptimizationInputData* data =
+      DeoptimizationInputData::cast(code->deoptimization_data());
+  return data->OsrPcOffset()->value() >= 0 &&
+      BailoutId(data->OsrAstId()->value()) == ast_id;
+}
+
+
 RUNTIME_FUNCTION(MaybeObject*, Runtime_CompileForOnStackReplacement) {
   HandleScope scope(isolate);
   ASSERT(args.length() == 1);
@@ -8179,26 +8199,43 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_CompileForOnStackReplacement) {
       PrintF("]\n");
     }
 
-    // Try to compile the optimized code.  A true return value from
-    // CompileOptimized means that compilation succeeded, not necessarily
-    // that optimization succeeded.
-    if (JSFunction::CompileOptimized(function, ast_id, CLEAR_EXCEPTION) &&
-        function->IsOptimized()) {
-      DeoptimizationInputData* data = DeoptimizationInputData::cast(
-          function->code()->deoptimization_data());
-      if (data->OsrPcOffset()->value() >= 0) {
-        if (FLAG_trace_osr) {
-          PrintF("[on-stack replacement offset %d in optimized code]\n",
-               data->OsrPcOffset()->value());
-        }
-        ASSERT(BailoutId(data->OsrAstId()->value()) == ast_id);
+    if (FLAG_parallel_recompilation && FLAG_parallel_osr) {
+      // Enter code that was compiled in the background for this loop if it
+      // is ready.  Otherwise queue the compilation and keep running the
+      // loop in unoptimized code; the back edges call back here once the
+      // code is ready.
+      OptimizingCompilerThread* thread = isolate->optimizing_compiler_thread();
+      Code* code = thread->TakeOSRCode(*function, ast_id);
+      if (code != NULL) {
+        function->ReplaceCode(code);
+        succeeded = HasOsrEntryAt(code, ast_id);
       } else {
-        // We may never generate the desired OSR entry if we emit an
-        // early deoptimize.
         succeeded = false;
+        if (!thread->IsQueuedForOSR(*function, ast_id)) {
+          Compiler::RecompileParallel(function, ast_id);
+          if (FLAG_trace_osr && thread->IsQueuedForOSR(*function, ast_id)) {
+            PrintF("[queued ");
+            function->PrintName();
+            PrintF(" for on-stack replacement at AST id %d]\n",
+                   ast_id.ToInt());
+          }
+        }
       }
     } else {
-      succeeded = false;
+      // Try to compile the optimized code.  A true return value from
+      // CompileOptimized means that compilation succeeded, not necessarily
+      // that optimization succeeded.  We may never generate the desired OSR
+      // entry if we emit an early deoptimize.
+      succeeded =
+          JSFunction::CompileOptimized(function, ast_id, CLEAR_EXCEPTION) &&
+          function->IsOptimized() &&
+          HasOsrEntryAt(function->code(), ast_id);
+    }
+    if (succeeded && FLAG_trace_osr) {
+      DeoptimizationInputData* data = DeoptimizationInputData::cast(
+          function->code()->deoptimization_data());
+      PrintF("[on-stack replacement offset %d in optimized code]\n",
+             data->OsrPcOffset()->value());
     }
   }
 
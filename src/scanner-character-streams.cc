@@ -300,6 +300,171 @@ void Utf8ToUtf16CharacterStream::SetRawPosition(unsigned target_position) {
 }
 
 
+// ----------------------------------------------------------------------------
+// ChunkedUtf8ToUtf16CharacterStream
+
+ChunkedUtf8ToUtf16CharacterStream::ChunkedUtf8ToUtf16CharacterStream(
+    v8::ScriptSourceStream* source)
+    : Utf16CharacterStream(),
+      source_(source),
+      decoded_(kInitialCapacity),
+      pending_length_(0),
+      exhausted_(false),
+      is_ascii_(true) {
+  buffer_cursor_ = NULL;
+  buffer_end_ = NULL;
+}
+
+
+ChunkedUtf8ToUtf16CharacterStream::~ChunkedUtf8ToUtf16CharacterStream() { }
+
+
+void ChunkedUtf8ToUtf16CharacterStream::PushBack(uc32 character) {
+  // Advance() does not move the cursor when returning kEndOfInput.
+  if (character != kEndOfInput) {
+    ASSERT(buffer_cursor_ > decoded_.ToConstVector().start());
+    ASSERT(buffer_cursor_[-1] == character);
+    buffer_cursor_--;
+  }
+  pos_--;
+}
+
+
+unsigned ChunkedUtf8ToUtf16CharacterStream::SlowSeekForward(unsigned delta) {
+  unsigned old_pos = pos_;
+  if (delta == 0) return 0;
+  EnsureDecoded(pos_ + delta - 1);
+  pos_ = Min(pos_ + delta, static_cast<unsigned>(decoded_.length()));
+  UpdateBufferPointers();
+  return pos_ - old_pos;
+}
+
+
+bool ChunkedUtf8ToUtf16CharacterStream::ReadBlock() {
+  bool available = EnsureDecoded(pos_);
+  UpdateBufferPointers();
+  return available;
+}
+
+
+void ChunkedUtf8ToUtf16CharacterStream::UpdateBufferPointers() {
+  // The decoded code units move when the list grows.
+  const uc16* start = decoded_.ToConstVector().start();
+  unsigned length = static_cast<unsigned>(decoded_.length());
+  buffer_cursor_ = start + Min(pos_, length);
+  buffer_end_ = start + length;
+}
+
+
+bool ChunkedUtf8ToUtf16CharacterStream::EnsureDecoded(unsigned position) {
+  while (static_cast<unsigned>(decoded_.length()) <= position) {
+    if (exhausted_) return false;
+    const char* chunk = NULL;
+    size_t length = source_->GetMoreData(&chunk);
+    if (length == 0) {
+      exhausted_ = true;
+      // Decode a truncated sequence at the end of the source.
+      unsigned used = 0;
+      while (used < pending_length_) {
+        used += DecodeSequence(pending_ + used, pending_length_ - used);
+      }
+      pending_length_ = 0;
+    } else {
+      ASSERT(length <= static_cast<size_t>(kMaxInt));
+      DecodeChunk(reinterpret_cast<const byte*>(chunk),
+                  static_cast<unsigned>(length));
+    }
+  }
+  return true;
+}
+
+
+// Returns the length of the sequence started by the given byte, or 1 if
+// the byte does not start a valid sequence.
+static inline unsigned Utf8SequenceLength(byte first) {
+  if (first < 0xC0) return 1;
+  if (first < 0xE0) return 2;
+  if (first < 0xF0) return 3;
+  if (first < 0xF8) return 4;
+  return 1;
+}
+
+
+void ChunkedUtf8ToUtf16CharacterStream::DecodeChunk(const byte* chunk,
+                                                    unsigned length) {
+  unsigned pos = 0;
+  // Complete a sequence split across chunks.  An invalid sequence may
+  // consume only part of the pending bytes, so the remaining ones are
+  // decoded again from the start.
+  while (pending_length_ > 0) {
+    unsigned needed = Utf8SequenceLength(pending_[0]);
+    while (pending_length_ < needed && pos < length) {
+      pending_[pending_length_++] = chunk[pos++];
+    }
+    if (pending_length_ < needed) return;
+    unsigned used = DecodeSequence(pending_, needed);
+    pending_length_ -= used;
+    memmove(pending_, pending_ + used, pending_length_);
+  }
+  while (pos < length) {
+    byte c = chunk[pos];
+    if (c <= unibrow::Utf8::kMaxOneByteChar) {
+      decoded_.Add(c);
+      pos++;
+      continue;
+    }
+    unsigned needed = Utf8SequenceLength(c);
+    if (length - pos < needed) {
+      // Wait for the rest of the sequence in the next chunk.
+      pending_length_ = length - pos;
+      memcpy(pending_, chunk + pos, pending_length_);
+      return;
+    }
+    pos += DecodeSequence(chunk + pos, needed);
+  }
+}
+
+
+unsigned ChunkedUtf8ToUtf16CharacterStream::DecodeSequence(const byte* data,
+                                                           unsigned length) {
+  static const unibrow::uchar kMaxUtf16Character = 0xffff;
+  unsigned used = 0;
+  unibrow::uchar c = data[0];
+  if (c <= unibrow::Utf8::kMaxOneByteChar) {
+    used = 1;
+  } else {
+    c = unibrow::Utf8::CalculateValue(data, length, &used);
+  }
+  if (c > static_cast<unibrow::uchar>(String::kMaxAsciiCharCode)) {
+    is_ascii_ = false;
+  }
+  if (c > kMaxUtf16Character) {
+    decoded_.Add(unibrow::Utf16::LeadSurrogate(c));
+    decoded_.Add(unibrow::Utf16::TrailSurrogate(c));
+  } else {
+    decoded_.Add(static_cast<uc16>(c));
+  }
+  return used;
+}
+
+
+Handle<String> ChunkedUtf8ToUtf16CharacterStream::Finish() {
+  EnsureDecoded(kMaxInt);
+  UpdateBufferPointers();
+  Vector<const uc16> chars = decoded_.ToConstVector();
+  if (is_ascii_) {
+    Handle<SeqAsciiString> result =
+        FACTORY->NewRawAsciiString(chars.length());
+    CopyChars(result->GetChars(), chars.start(), chars.length());
+    return result;
+  }
+  Handle<SeqTwoByteString> result =
+      FACTORY->NewRawTwoByteString(chars.length());
+  CopyChars(result->GetChars(), chars.start(), chars.length());
+  return result;
+}
+
+
 // ----------------------------------------------------------------------------
 // ExternalTwoByteStringUtf16CharacterStream
 
@@ -97,6 +97,52 @@ class Utf8ToUtf16CharacterStream: public BufferedUtf16CharacterStream {
 };
 
 
+// Utf16 stream decoding UTF-8 source that arrives in chunks from an
+// embedder supplied v8::ScriptSourceStream.  Chunks are only requested
+// when the scanner runs out of characters, so scanning can start before
+// the whole source is available.  Chunk boundaries may split multi-byte
+// sequences.  All decoded code units are kept, both to allow pushback and
+// seeking, and so that the complete source can be materialized afterwards.
+// Apart from Finish() the stream does not touch the heap.
+class ChunkedUtf8ToUtf16CharacterStream: public Utf16CharacterStream {
+ public:
+  explicit ChunkedUtf8ToUtf16CharacterStream(v8::ScriptSourceStream* source);
+  virtual ~ChunkedUtf8ToUtf16CharacterStream();
+
+  virtual void PushBack(uc32 character);
+
+  // Reads and decodes the remaining chunks and returns the complete source
+  // decoded so far as a string, which is ASCII if every decoded code unit
+  // is.
+  Handle<String> Finish();
+
+ protected:
+  virtual unsigned SlowSeekForward(unsigned delta);
+  virtual bool ReadBlock();
+
+  // Requests chunks until the code unit at position is decoded or the
+  // source is exhausted.  Returns whether position is within the source.
+  bool EnsureDecoded(unsigned position);
+  void DecodeChunk(const byte* chunk, unsigned length);
+  // Decodes the first length bytes of data, which hold a complete sequence
+  // unless the source is exhausted, and returns the number of bytes used.
+  unsigned DecodeSequence(const byte* data, unsigned length);
+  void UpdateBufferPointers();
+
+  static const int kInitialCapacity = 4 * KB;
+  static const unsigned kMaxSequenceLength = 4;
+
+  v8::ScriptSourceStream* source_;
+  List<uc16> decoded_;
+  // Leading bytes of a multi-byte sequence split across chunks.
+  byte pending_[kMaxSequenceLength];
+  unsigned pending_length_;
+  bool exhausted_;
+  // Whether every code unit decoded so far is ASCII.
+  bool is_ascii_;
+};
+
+
 // UTF16 buffer to read characters from an external string.
 class ExternalTwoByteStringUtf16CharacterStream: public Utf16CharacterStream {
  public:
@@ -0,0 +1,90 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "v8.h"
+
+#include "scavenger-thread.h"
+
+#include "isolate.h"
+
+namespace v8 {
+namespace internal {
+
+ScavengerThread::ScavengerThread(Isolate* isolate, int id)
+    : Thread("ScavengerThread"),
+      isolate_(isolate),
+      heap_(isolate->heap()),
+      start_scavenging_semaphore_(OS::CreateSemaphore(0)),
+      end_scavenging_semaphore_(OS::CreateSemaphore(0)),
+      stop_semaphore_(OS::CreateSemaphore(0)),
+      id_(id) {
+  NoBarrier_Store(&stop_thread_, static_cast<AtomicWord>(false));
+}
+
+
+ScavengerThread::~ScavengerThread() {
+  delete start_scavenging_semaphore_;
+  delete end_scavenging_semaphore_;
+  delete stop_semaphore_;
+}
+
+
+void ScavengerThread::Run() {
+  Isolate::SetIsolateThreadLocals(isolate_, NULL);
+  while (true) {
+    start_scavenging_semaphore_->Wait();
+
+    if (Acquire_Load(&stop_thread_)) {
+      stop_semaphore_->Signal();
+      return;
+    }
+
+    // Task 0 belongs to the main thread.
+    heap_->ScavengeInParallel(id_ + 1);
+    end_scavenging_semaphore_->Signal();
+  }
+}
+
+
+void ScavengerThread::Stop() {
+  Release_Store(&stop_thread_, static_cast<AtomicWord>(true));
+  start_scavenging_semaphore_->Signal();
+  stop_semaphore_->Wait();
+}
+
+
+void ScavengerThread::StartScavenging() {
+  start_scavenging_semaphore_->Signal();
+}
+
+
+void ScavengerThread::WaitForScavengerThread() {
+  end_scavenging_semaphore_->Wait();
+}
+
+} }  // namespace v8::internal
@@ -33,13 +33,16 @@
 #include "execution.h"
 #include "global-handles.h"
 #include "ic-inl.h"
+#include "log.h"
 #include "natives.h"
 #include "platform.h"
 #include "runtime.h"
 #include "serialize.h"
 #include "snapshot.h"
 #include "stub-cache.h"
+#include "v8conversions.h"
 #include "v8threads.h"
+#include "version.h"
 
 namespace v8 {
 namespace internal {
@@ -593,6 +596,7 @@ ExternalReferenceDecoder::~ExternalReferenceDecoder() {
 
 bool Serializer::serialization_enabled_ = false;
 bool Serializer::too_late_to_enable_now_ = false;
+volatile Atomic32 Serializer::relocatable_code_scope_depth_ = 0;
 
 
 Deserializer::Deserializer(SnapshotByteSource* source)
@@ -659,6 +663,63 @@ void Deserializer::DeserializePartial(Object** root) {
 }
 
 
+void Deserializer::DeserializeCode(Object** root,
+                                   Vector<Handle<Object> > attached) {
+  isolate_ = Isolate::Current();
+  for (int i = NEW_SPACE; i < kNumberOfSpaces; i++) {
+    ASSERT(reservations_[i] != kUninitializedReservation);
+  }
+  // The code and the shared function infos are all that is looked at after
+  // deserialization.
+  ASSERT_EQ(0, reservations_[NEW_SPACE]);
+  isolate_->heap()->ReserveSpace(reservations_, &high_water_[0]);
+  // Remember where the code and the shared function infos start.  Nothing
+  // is allocated in spaces that have no reservation.
+  Address code_start = reservations_[CODE_SPACE] > 0 ?
+      high_water_[CODE_SPACE] : NULL;
+  Address shared_start = reservations_[OLD_POINTER_SPACE] > 0 ?
+      high_water_[OLD_POINTER_SPACE] : NULL;
+  if (external_reference_decoder_ == NULL) {
+    external_reference_decoder_ = new ExternalReferenceDecoder();
+  }
+
+  attached_objects_ = attached;
+  VisitPointer(root);
+  attached_objects_ = Vector<Handle<Object> >();
+
+  Address code_end = reservations_[CODE_SPACE] > 0 ?
+      high_water_[CODE_SPACE] : NULL;
+  Address shared_end = reservations_[OLD_POINTER_SPACE] > 0 ?
+      high_water_[OLD_POINTER_SPACE] : NULL;
+  for (Address address = code_start; address < code_end; ) {
+    Code* code = Code::cast(HeapObject::FromAddress(address));
+    CPU::FlushICache(code->instruction_start(), code->instruction_size());
+    address += code->Size();
+  }
+
+  // Issue code events for the deserialized functions.  Logging can allocate,
+  // so collect them first.
+  if (isolate_->logger()->is_logging_code_events() && code_start < code_end) {
+    List<Handle<SharedFunctionInfo> > functions;
+    for (Address address = shared_start; address < shared_end; ) {
+      HeapObject* object = HeapObject::FromAddress(address);
+      if (object->IsSharedFunctionInfo()) {
+        functions.Add(Handle<SharedFunctionInfo>(
+            SharedFunctionInfo::cast(object), isolate_));
+      }
+      address += object->Size();
+    }
+    for (int i = 0; i < functions.length(); i++) {
+      Handle<Code> code(functions[i]->code(), isolate_);
+      Address address = code->address();
+      if (address >= code_start && address < code_end) {
+        LOG_CODE_EVENT(isolate_, LogExistingFunction(functions[i], code));
+      }
+    }
+  }
+}
+
+
 Deserializer::~Deserializer() {
   ASSERT(source_->AtEOF());
   if (external_reference_decoder_) {
@@ -744,6 +805,10 @@ void Deserializer::ReadChunk(Object** current,
             new_object = isolate->serialize_partial_snapshot_cache()           \
                 [cache_index];                                                 \
             emit_write_barrier = isolate->heap()->InNewSpace(new_object);      \
+          } else if (where == kAttachedReference) {                            \
+            int index = source_->GetInt();                                     \
+            new_object = *attached_objects_[index];                            \
+            emit_write_barrier = isolate->heap()->InNewSpace(new_object);      \
           } else if (where == kExternalReference) {                            \
             int skip = source_->GetInt();                                      \
             current = reinterpret_cast<Object**>(reinterpret_cast<Address>(    \
@@ -979,6 +1044,20 @@ void Deserializer::ReadChunk(Object** current,
                 kPlain,
                 kInnerPointer,
                 0)
+      // Find an object attached to serialized code and write a pointer to it
+      // to the current object.
+      CASE_STATEMENT(kAttachedReference, kPlain, kStartOfObject, 0)
+      CASE_BODY(kAttachedReference, kPlain, kStartOfObject, 0)
+      // Find an attached code object and write a pointer to its first
+      // instruction to the current code object.
+      CASE_STATEMENT(kAttachedReference, kFromCode, kInnerPointer, 0)
+      CASE_BODY(kAttachedReference, kFromCode, kInnerPointer, 0)
+#if V8_TARGET_ARCH_MIPS
+      // Find an attached object and write a pointer to it to the current
+      // code object.  Required only for MIPS.
+      CASE_STATEMENT(kAttachedReference, kFromCode, kStartOfObject, 0)
+      CASE_BODY(kAttachedReference, kFromCode, kStartOfObject, 0)
+#endif
       // Find an external reference and write a pointer to it to the current
       // object.
       CASE_STATEMENT(kExternalReference, kPlain, kStartOfObject, 0)
@@ -1050,8 +1129,9 @@ Serializer::Serializer(SnapshotByteSink* sink)
       root_index_wave_front_(0) {
   isolate_ = Isolate::Current();
   // The serializer is meant to be used only to generate initial heap images
-  // from a context in which there is only one isolate.
-  ASSERT(isolate_->IsDefaultIsolate());
+  // from a context in which there is only one isolate.  Code for the code
+  // cache can be serialized in any isolate.
+  ASSERT(!enabled() || isolate_->IsDefaultIsolate());
   for (int i = 0; i <= LAST_SPACE; i++) {
     fullness_[i] = 0;
   }
@@ -1352,7 +1432,7 @@ void PartialSerializer::SerializeObject(
 
 
 void Serializer::ObjectSerializer::Serialize() {
-  int space = Serializer::SpaceOfObject(object_);
+  int space = serializer_->SpaceOfObject(object_);
   int size = object_->Size();
 
   sink_->Put(kNewObject + reference_representation_ + space,
@@ -1617,6 +1697,495 @@ void Serializer::Pad() {
 }
 
 
+int CodeSerializer::SpaceOfObject(HeapObject* object) {
+  Heap* heap = isolate_->heap();
+  // The deserialized code is expected to be long-lived, so objects that are
+  // still in new space are tenured in the process.
+  if (heap->InNewSpace(object)) {
+    return heap->TargetSpaceId(object->map()->instance_type());
+  }
+  int space = Serializer::SpaceOfObject(object);
+  if (space == LO_SPACE) {
+    failed_ = true;
+    return OLD_POINTER_SPACE;
+  }
+  return space;
+}
+
+
+int CodeSerializer::EncodeExternalReference(Address addr) {
+  // Code that was not generated in a RelocatableCodeScope may refer to
+  // addresses that are not in the external reference table.
+  if (addr != NULL &&
+      external_reference_encoder_->NameOfAddress(addr) == NULL) {
+    failed_ = true;
+    return 0;
+  }
+  return Serializer::EncodeExternalReference(addr);
+}
+
+
+bool CodeSerializer::CanSerializeByValue(HeapObject* object) {
+  if (object->IsJSReceiver() || object->IsContext() || object->IsMap()) {
+    return false;
+  }
+  if (object->IsCode()) {
+    return Code::cast(object)->kind() == Code::FUNCTION;
+  }
+  if (object->IsExternalString()) return false;
+  if (object->IsForeign()) {
+    return Foreign::cast(object)->foreign_address() == NULL;
+  }
+  if (object->IsSharedFunctionInfo()) {
+    return SharedFunctionInfo::cast(object)->debug_info()->IsUndefined();
+  }
+  return !isolate_->heap()->lo_space()->Contains(object);
+}
+
+
+int CodeSerializer::AttachmentIndex(HeapObject* object) {
+  if (attachment_mapper_.IsMapped(object)) {
+    return attachment_mapper_.MappedTo(object);
+  }
+  if (object == script_) return Attach(object, kScriptAttachment, 0);
+
+  if (object->IsSymbol()) {
+    String* symbol = String::cast(object);
+    int length = symbol->length();
+    if (length >= 1 << 22) return kNotAttached;
+    String::FlatContent content = symbol->GetFlatContent();
+    if (!content.IsFlat()) return kNotAttached;
+    if (content.IsAscii()) {
+      int index = Attach(object, kAsciiSymbolAttachment, length);
+      Vector<const char> chars = content.ToAsciiVector();
+      for (int i = 0; i < length; i++) {
+        attachment_sink_->Put(chars[i], "AsciiSymbolChar");
+      }
+      return index;
+    } else {
+      int index = Attach(object, kTwoByteSymbolAttachment, length);
+      Vector<const uc16> chars = content.ToUC16Vector();
+      for (int i = 0; i < length; i++) {
+        attachment_sink_->Put(chars[i] & 0xff, "TwoByteSymbolCharLow");
+        attachment_sink_->Put(chars[i] >> 8, "TwoByteSymbolCharHigh");
+      }
+      return index;
+    }
+  }
+
+  if (object->IsCode()) {
+    Code* code = Code::cast(object);
+    // Full-codegen code is serialized along with its function, and
+    // optimized code is rejected by CanSerializeByValue.
+    if (code->kind() == Code::FUNCTION ||
+        code->kind() == Code::OPTIMIZED_FUNCTION) {
+      return kNotAttached;
+    }
+    Builtins* builtins = isolate_->builtins();
+    for (int i = 0; i < Builtins::builtin_count; i++) {
+      if (code == builtins->builtin(static_cast<Builtins::Name>(i))) {
+        return Attach(object, kBuiltinAttachment, i);
+      }
+    }
+    // Code stubs and IC stubs are looked up by their key in the
+    // deserializing process, so they need not be relocatable and keep
+    // their identity, which e.g. the patching of stack checks relies on.
+    Heap* heap = isolate_->heap();
+    Object* key = heap->code_stubs()->SlowReverseLookup(code);
+    if (key->IsNumber()) {
+      return Attach(object, kCodeStubAttachment, NumberToUint32(key));
+    }
+    key = heap->non_monomorphic_cache()->SlowReverseLookup(code);
+    if (key->IsNumber()) {
+      return Attach(object, kNonMonomorphicICAttachment, NumberToUint32(key));
+    }
+    failed_ = true;
+    return kNotAttached;
+  }
+  return kNotAttached;
+}
+
+
+int CodeSerializer::Attach(HeapObject* object,
+                           AttachmentKind kind,
+                           uint32_t value) {
+  int index = attachment_count_++;
+  attachment_mapper_.AddMapping(object, index);
+  attachment_sink_->Put(kind, "AttachmentKind");
+  switch (kind) {
+    case kScriptAttachment:
+      break;
+    case kAsciiSymbolAttachment:
+    case kTwoByteSymbolAttachment:
+    case kBuiltinAttachment:
+      attachment_sink_->PutInt(value, "AttachmentValue");
+      break;
+    case kCodeStubAttachment:
+    case kNonMonomorphicICAttachment:
+      for (int i = 0; i < 4; i++) {
+        attachment_sink_->Put((value >> (i * 8)) & 0xff, "AttachmentKey");
+      }
+      break;
+  }
+  return index;
+}
+
+
+void CodeSerializer::PutAttachedReference(int index,
+                                          HowToCode how_to_code,
+                                          WhereToPoint where_to_point,
+                                          int skip) {
+  bool supported =
+      (how_to_code == kPlain && where_to_point == kStartOfObject) ||
+      (how_to_code == kFromCode && where_to_point == kInnerPointer);
+#if V8_TARGET_ARCH_MIPS
+  supported = supported ||
+      (how_to_code == kFromCode && where_to_point == kStartOfObject);
+#endif
+  if (!supported) failed_ = true;
+  if (skip != 0) {
+    sink_->Put(kSkip, "SkipFromSerializeObject");
+    sink_->PutInt(skip, "SkipDistanceFromSerializeObject");
+  }
+  sink_->Put(kAttachedReference + how_to_code + where_to_point,
+             "AttachedReference");
+  sink_->PutInt(index, "attachment_index");
+}
+
+
+void CodeSerializer::SerializeObject(
+    Object* o,
+    HowToCode how_to_code,
+    WhereToPoint where_to_point,
+    int skip) {
+  CHECK(o->IsHeapObject());
+  HeapObject* heap_object = HeapObject::cast(o);
+
+  int root_index;
+  if (where_to_point == kStartOfObject &&
+      (root_index = RootIndex(heap_object, how_to_code)) != kInvalidRootIndex) {
+    PutRoot(root_index, heap_object, how_to_code, where_to_point, skip);
+    return;
+  }
+
+  if (address_mapper_.IsMapped(heap_object)) {
+    int space = SpaceOfObject(heap_object);
+    int address = address_mapper_.MappedTo(heap_object);
+    SerializeReferenceToPreviousObject(space,
+                                       address,
+                                       how_to_code,
+                                       where_to_point,
+                                       skip);
+    return;
+  }
+
+  int index = AttachmentIndex(heap_object);
+  if (index != kNotAttached) {
+    PutAttachedReference(index, how_to_code, where_to_point, skip);
+    return;
+  }
+
+  if (failed_ || !CanSerializeByValue(heap_object)) {
+    // The data is thrown away, but keep it well-formed until then.
+    failed_ = true;
+    PutRoot(Heap::kUndefinedValueRootIndex,
+            isolate_->heap()->undefined_value(),
+            kPlain,
+            kStartOfObject,
+            skip);
+    return;
+  }
+
+  if (skip != 0) {
+    sink_->Put(kSkip, "FlushPendingSkip");
+    sink_->PutInt(skip, "SkipDistance");
+  }
+
+  ObjectSerializer object_serializer(this,
+                                     heap_object,
+                                     sink_,
+                                     how_to_code,
+                                     where_to_point);
+  object_serializer.Serialize();
+}
+
+
+// FNV-1a, used for the checksum and the source hash of the code cache.
+static const uint32_t kFNVOffsetBasis = 2166136261u;
+static const uint32_t kFNVPrime = 16777619u;
+
+
+static uint32_t FNVHash(uint32_t hash, const byte* data, int length) {
+  for (int i = 0; i < length; i++) {
+    hash ^= data[i];
+    hash *= kFNVPrime;
+  }
+  return hash;
+}
+
+
+static uint32_t FNVHashWord(uint32_t hash, uint32_t word) {
+  for (int i = 0; i < 4; i++) {
+    hash ^= (word >> (i * 8)) & 0xff;
+    hash *= kFNVPrime;
+  }
+  return hash;
+}
+
+
+uint32_t CodeSerializer::VersionHash() {
+  uint32_t hash = kFNVOffsetBasis;
+  hash = FNVHashWord(hash, Version::GetMajor());
+  hash = FNVHashWord(hash, Version::GetMinor());
+  hash = FNVHashWord(hash, Version::GetBuild());
+  hash = FNVHashWord(hash, Version::GetPatch());
+  return hash;
+}
+
+
+uint32_t CodeSerializer::FlagsHash() {
+  uint32_t hash = kFNVOffsetBasis;
+  List<const char*>* args = FlagList::argv();
+  for (int i = 0; i < args->length(); i++) {
+    const char* arg = args->at(i);
+    hash = FNVHash(hash, reinterpret_cast<const byte*>(arg), StrLength(arg));
+    hash = FNVHashWord(hash, 0);
+    DeleteArray(arg);
+  }
+  delete args;
+
+  // Generated code also depends on the architecture and the CPU features.
+#if V8_TARGET_ARCH_IA32 || V8_TARGET_ARCH_X64
+  static const CpuFeature features[] =
+      { SSE2, SSE3, SSE4_1, CMOV, RDTSC, CPUID, SAHF };
+#elif V8_TARGET_ARCH_ARM
+  static const CpuFeature features[] =
+      { VFP2, VFP3, ARMv7, SUDIV, UNALIGNED_ACCESSES,
+        MOVW_MOVT_IMMEDIATE_LOADS };
+#elif V8_TARGET_ARCH_MIPS
+  static const CpuFeature features[] = { FPU };
+#endif
+  hash = FNVHashWord(hash, kPointerSize);
+  for (size_t i = 0; i < ARRAY_SIZE(features); i++) {
+    hash = FNVHashWord(hash, CpuFeatures::IsSupported(features[i]) ? 1 : 0);
+  }
+  return hash;
+}
+
+
+uint32_t CodeSerializer::SourceHash(String* source) {
+  // Unlike String::Hash(), this hashes all characters of long strings.
+  String::FlatContent content = source->GetFlatContent();
+  ASSERT(content.IsFlat());
+  uint32_t hash = FNVHashWord(kFNVOffsetBasis, source->length());
+  if (content.IsAscii()) {
+    Vector<const char> chars = content.ToAsciiVector();
+    hash = FNVHash(hash, reinterpret_cast<const byte*>(chars.start()),
+                   chars.length());
+  } else {
+    Vector<const uc16> chars = content.ToUC16Vector();
+    hash = FNVHash(hash, reinterpret_cast<const byte*>(chars.start()),
+                   chars.length() * sizeof(uc16));
+  }
+  return hash;
+}
+
+
+static void PutWord(List<byte>* data, uint32_t word) {
+  for (int i = 0; i < 4; i++) {
+    data->Add(static_cast<byte>((word >> (i * 8)) & 0xff));
+  }
+}
+
+
+static uint32_t GetWord(Vector<const byte> data, int index) {
+  const byte* bytes = data.start() + index * sizeof(uint32_t);
+  return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) |
+         (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+
+bool CodeSerializer::Serialize(Handle<SharedFunctionInfo> info,
+                               List<byte>* data) {
+  Isolate* isolate = info->GetIsolate();
+  Handle<Script> script(Script::cast(info->script()), isolate);
+  Handle<String> source(String::cast(script->source()), isolate);
+  FlattenString(source);
+
+  List<byte> attachments;
+  List<byte> payload;
+  int reservations[kNumberOfSpaces];
+  int attachment_count;
+  {
+    ListSnapshotSink sink(&payload);
+    ListSnapshotSink attachment_sink(&attachments);
+    CodeSerializer serializer(&sink, &attachment_sink, *script);
+    Object* root = *info;
+    serializer.VisitPointer(&root);
+    serializer.Pad();
+    if (serializer.failed_) return false;
+    ASSERT_EQ(0, serializer.CurrentAllocationAddress(NEW_SPACE));
+    for (int i = 0; i < kNumberOfSpaces; i++) {
+      if (!serializer.FitsOnOnePage(i)) return false;
+      reservations[i] = serializer.CurrentAllocationAddress(i);
+    }
+    attachment_count = serializer.attachment_count_;
+  }
+
+  uint32_t checksum = FNVHash(kFNVOffsetBasis,
+                              attachments.ToVector().start(),
+                              attachments.length());
+  checksum = FNVHash(checksum,
+                     payload.ToVector().start(),
+                     payload.length());
+
+  data->Clear();
+  PutWord(data, kMagicNumber);
+  PutWord(data, VersionHash());
+  PutWord(data, SourceHash(*source));
+  PutWord(data, FlagsHash());
+  for (int i = 0; i < kNumberOfSpaces; i++) {
+    PutWord(data, reservations[i]);
+  }
+  PutWord(data, attachment_count);
+  PutWord(data, attachments.length());
+  PutWord(data, payload.length());
+  PutWord(data, checksum);
+  ASSERT_EQ(kHeaderSize, data->length());
+  data->AddAll(attachments);
+  data->AddAll(payload);
+  return true;
+}
+
+
+Handle<Object> CodeSerializer::LookUpAttachment(Isolate* isolate,
+                                                SnapshotByteSource* source,
+                                                Handle<Script> script) {
+  Factory* factory = isolate->factory();
+  switch (source->Get()) {
+    case kScriptAttachment:
+      return script;
+    case kAsciiSymbolAttachment: {
+      int length = source->GetInt();
+      ScopedVector<char> chars(length);
+      source->CopyRaw(reinterpret_cast<byte*>(chars.start()), length);
+      return factory->LookupAsciiSymbol(Vector<const char>(chars.start(),
+                                                           length));
+    }
+    case kTwoByteSymbolAttachment: {
+      int length = source->GetInt();
+      ScopedVector<uc16> chars(length);
+      for (int i = 0; i < length; i++) {
+        int low = source->Get();
+        chars[i] = static_cast<uc16>(low | (source->Get() << 8));
+      }
+      return factory->LookupTwoByteSymbol(Vector<const uc16>(chars.start(),
+                                                             length));
+    }
+    case kBuiltinAttachment: {
+      int index = source->GetInt();
+      if (index >= Builtins::builtin_count) break;
+      return Handle<Code>(
+          isolate->builtins()->builtin(static_cast<Builtins::Name>(index)),
+          isolate);
+    }
+    case kCodeStubAttachment: {
+      uint32_t key = static_cast<uint32_t>(source->GetUnalignedInt());
+      source->Advance(4);
+      Handle<UnseededNumberDictionary> stubs = factory->code_stubs();
+      int entry = stubs->FindEntry(isolate, key);
+      if (entry == UnseededNumberDictionary::kNotFound) break;
+      return Handle<Object>(stubs->ValueAt(entry), isolate);
+    }
+    case kNonMonomorphicICAttachment: {
+      Code::Flags flags =
+          static_cast<Code::Flags>(source->GetUnalignedInt());
+      source->Advance(4);
+      Handle<UnseededNumberDictionary> cache =
+          factory->non_monomorphic_cache();
+      int entry = cache->FindEntry(isolate, flags);
+      if (entry != UnseededNumberDictionary::kNotFound) {
+        return Handle<Object>(cache->ValueAt(entry), isolate);
+      }
+      // The initial call ICs are easily recreated, the others are only
+      // created by the IC system after the code has run.
+      if (Code::ExtractICStateFromFlags(flags) != UNINITIALIZED) break;
+      int argc = Code::ExtractArgumentsCountFromFlags(flags);
+      Handle<Code> code;
+      switch (Code::ExtractKindFromFlags(flags)) {
+        case Code::CALL_IC: {
+          bool contextual = CallICBase::Contextual::decode(
+              Code::ExtractExtraICStateFromFlags(flags));
+          code = isolate->stub_cache()->ComputeCallInitialize(
+              argc,
+              contextual ? RelocInfo::CODE_TARGET_CONTEXT
+                         : RelocInfo::CODE_TARGET);
+          break;
+        }
+        case Code::KEYED_CALL_IC:
+          code = isolate->stub_cache()->ComputeKeyedCallInitialize(argc);
+          break;
+        default:
+          return Handle<Object>::null();
+      }
+      if (code->flags() != flags) break;
+      return code;
+    }
+  }
+  return Handle<Object>::null();
+}
+
+
+Handle<SharedFunctionInfo> CodeSerializer::Deserialize(
+    Isolate* isolate,
+    Vector<const byte> data,
+    Handle<Script> script) {
+  Handle<SharedFunctionInfo> null;
+  if (data.length() < kHeaderSize) return null;
+  Handle<String> source(String::cast(script->source()), isolate);
+  FlattenString(source);
+  if (GetWord(data, kMagicNumberOffset) != kMagicNumber ||
+      GetWord(data, kVersionHashOffset) != VersionHash() ||
+      GetWord(data, kSourceHashOffset) != SourceHash(*source) ||
+      GetWord(data, kFlagsHashOffset) != FlagsHash()) {
+    return null;
+  }
+  uint32_t attachments_length = GetWord(data, kAttachmentsLengthOffset);
+  uint32_t payload_length = GetWord(data, kPayloadLengthOffset);
+  if (attachments_length + payload_length !=
+      static_cast<uint32_t>(data.length() - kHeaderSize)) {
+    return null;
+  }
+  const byte* attachments = data.start() + kHeaderSize;
+  const byte* payload = attachments + attachments_length;
+  uint32_t checksum = FNVHash(kFNVOffsetBasis, attachments,
+                              attachments_length);
+  checksum = FNVHash(checksum, payload, payload_length);
+  if (GetWord(data, kChecksumOffset) != checksum) return null;
+
+  // Look up the attachments first, since no allocation may happen once the
+  // space for the deserialized objects has been reserved.
+  int attachment_count = GetWord(data, kAttachmentCountOffset);
+  List<Handle<Object> > attached(attachment_count);
+  SnapshotByteSource attachment_source(attachments, attachments_length);
+  for (int i = 0; i < attachment_count; i++) {
+    Handle<Object> object =
+        LookUpAttachment(isolate, &attachment_source, script);
+    if (object.is_null()) return null;
+    attached.Add(object);
+  }
+
+  SnapshotByteSource source_bytes(payload, payload_length);
+  Deserializer deserializer(&source_bytes);
+  for (int i = 0; i < kNumberOfSpaces; i++) {
+    deserializer.set_reservation(i, GetWord(data, kReservationsOffset + i));
+  }
+  Object* root;
+  deserializer.DeserializeCode(&root, attached.ToVector());
+  return Handle<SharedFunctionInfo>(SharedFunctionInfo::cast(root), isolate);
+}
+
+
 bool SnapshotByteSource::AtEOF() {
   if (0u + length_ - position_ > 2 * sizeof(uint32_t)) return false;
   for (int x = position_; x < length_; x++) {
@@ -28,6 +28,7 @@
 #ifndef V8_SERIALIZE_H_
 #define V8_SERIALIZE_H_
 
+#include "atomicops.h"
 #include "hashmap.h"
 
 namespace v8 {
@@ -220,7 +221,8 @@ class SerializerDeserializer: public ObjectVisitor {
     kExternalReference = 0xb,       // Pointer to an external reference.
     kSkip = 0xc,                    // Skip n bytes.
     kNop = 0xd,                     // Does nothing, used to pad.
-    // 0xe-0xf                         Free.
+    kAttachedReference = 0xe,       // Object is attached to the code cache.
+    // 0xf                             Free.
     kBackref = 0x10,                // Object is described relative to end.
     // 0x11-0x16                       One per space.
     kBackrefWithSkip = 0x18,        // Object is described relative to end.
@@ -328,6 +330,11 @@ class Deserializer: public SerializerDeserializer {
   // Deserialize a single object and the objects reachable from it.
   void DeserializePartial(Object** root);
 
+  // Deserialize the code of a script written by the CodeSerializer.  The
+  // attached objects are those the serializer left out because they are
+  // specific to a process, looked up again in this one.
+  void DeserializeCode(Object** root, Vector<Handle<Object> > attached);
+
   void set_reservation(int space_number, int reservation) {
     ASSERT(space_number >= 0);
     ASSERT(space_number <= LAST_SPACE);
@@ -385,6 +392,9 @@ class Deserializer: public SerializerDeserializer {
 
   ExternalReferenceDecoder* external_reference_decoder_;
 
+  // Objects referred to with kAttachedReference.
+  Vector<Handle<Object> > attached_objects_;
+
   DISALLOW_COPY_AND_ASSIGN(Deserializer);
 };
 
@@ -401,6 +411,21 @@ class SnapshotByteSink {
 };
 
 
+// A SnapshotByteSink that collects the bytes in a list.
+class ListSnapshotSink : public SnapshotByteSink {
+ public:
+  explicit ListSnapshotSink(List<byte>* data) : data_(data) { }
+  virtual ~ListSnapshotSink() { }
+  virtual void Put(int data, const char* description) {
+    data_->Add(static_cast<byte>(data));
+  }
+  virtual int Position() { return data_->length(); }
+
+ private:
+  List<byte>* data_;
+};
+
+
 // Mapping objects to their location after deserialization.
 // This is used during building, but not at runtime by V8.
 class SerializationAddressMapper {
@@ -466,6 +491,11 @@ class Serializer : public SerializerDeserializer {
     ASSERT(space < kNumberOfSpaces);
     return fullness_[space];
   }
+  // The deserializer reserves the space for each space in one go, so the
+  // objects serialized to a space have to fit on one page.
+  bool FitsOnOnePage(int space) {
+    return CurrentAllocationAddress(space) <= SpaceAreaSize(space);
+  }
 
   static void Enable() {
     if (!serialization_enabled_) {
@@ -479,6 +509,14 @@ class Serializer : public SerializerDeserializer {
   // going on.
   static void TooLateToEnableNow() { too_late_to_enable_now_ = true; }
   static bool enabled() { return serialization_enabled_; }
+  // Code generated for the snapshot or the code cache must be relocatable to
+  // another process: it has to record all external references and must not
+  // embed addresses that are specific to this one.  Unlike enabled(), this
+  // is also true while a RelocatableCodeScope is active.
+  static bool code_must_be_relocatable() {
+    return serialization_enabled_ ||
+           NoBarrier_Load(&relocatable_code_scope_depth_) > 0;
+  }
   SerializationAddressMapper* address_mapper() { return &address_mapper_; }
   void PutRoot(int index,
                HeapObject* object,
@@ -558,9 +596,9 @@ class Serializer : public SerializerDeserializer {
       int skip);
   void InitializeAllocators();
   // This will return the space for an object.
-  static int SpaceOfObject(HeapObject* object);
+  virtual int SpaceOfObject(HeapObject* object);
   int Allocate(int space, int size);
-  int EncodeExternalReference(Address addr) {
+  virtual int EncodeExternalReference(Address addr) {
     return external_reference_encoder_->Encode(addr);
   }
 
@@ -576,12 +614,14 @@ class Serializer : public SerializerDeserializer {
   static bool serialization_enabled_;
   // Did we already make use of the fact that serialization was not enabled?
   static bool too_late_to_enable_now_;
+  static volatile Atomic32 relocatable_code_scope_depth_;
   SerializationAddressMapper address_mapper_;
   intptr_t root_index_wave_front_;
   void Pad();
 
   friend class ObjectSerializer;
   friend class Deserializer;
+  friend class RelocatableCodeScope;
 
  private:
   DISALLOW_COPY_AND_ASSIGN(Serializer);
@@ -656,6 +696,121 @@ class StartupSerializer : public Serializer {
 };
 
 
+// While a RelocatableCodeScope is active, code is generated as if for the
+// snapshot, so that it can be written to the code cache.  Other threads and
+// isolates generating code in the meantime just get more conservative code.
+class RelocatableCodeScope BASE_EMBEDDED {
+ public:
+  RelocatableCodeScope() {
+    Barrier_AtomicIncrement(&Serializer::relocatable_code_scope_depth_, 1);
+  }
+  ~RelocatableCodeScope() {
+    Barrier_AtomicIncrement(&Serializer::relocatable_code_scope_depth_, -1);
+  }
+};
+
+
+// The CodeSerializer writes the code of a compiled script -- the tree of
+// SharedFunctionInfos with their full-codegen code -- to the code cache, a
+// byte blob that a later process can deserialize instead of compiling the
+// script.  Objects that are specific to the serializing process, like the
+// Script, symbols, builtins and code stubs, are not serialized but recorded
+// as attachments, which the deserializing process looks up in its own heap.
+// The blob starts with a header that makes sure it is only used for the same
+// source, V8 version, flags and CPU features.
+class CodeSerializer : public Serializer {
+ public:
+  // Serializes a script compiled in a RelocatableCodeScope to data.  Returns
+  // false if the code cannot be cached, e.g. because it refers to objects
+  // that only exist in this context, or is too large.
+  static bool Serialize(Handle<SharedFunctionInfo> info, List<byte>* data);
+
+  // Deserializes the code of the given script, which must have the same
+  // source as the serialized one.  Returns a null handle if the data was
+  // not produced for this source or by this configuration of V8.
+  static Handle<SharedFunctionInfo> Deserialize(Isolate* isolate,
+                                                Vector<const byte> data,
+                                                Handle<Script> script);
+
+  virtual void SerializeObject(Object* o,
+                               HowToCode how_to_code,
+                               WhereToPoint where_to_point,
+                               int skip);
+
+ private:
+  enum AttachmentKind {
+    kScriptAttachment,
+    kAsciiSymbolAttachment,
+    kTwoByteSymbolAttachment,
+    kBuiltinAttachment,
+    kCodeStubAttachment,
+    kNonMonomorphicICAttachment
+  };
+
+  // Layout of the header, in 32-bit words.
+  static const int kMagicNumberOffset = 0;
+  static const int kVersionHashOffset = 1;
+  static const int kSourceHashOffset = 2;
+  static const int kFlagsHashOffset = 3;
+  static const int kReservationsOffset = 4;
+  static const int kAttachmentCountOffset =
+      kReservationsOffset + kNumberOfSpaces;
+  static const int kAttachmentsLengthOffset = kAttachmentCountOffset + 1;
+  static const int kPayloadLengthOffset = kAttachmentsLengthOffset + 1;
+  static const int kChecksumOffset = kPayloadLengthOffset + 1;
+  static const int kHeaderWords = kChecksumOffset + 1;
+  static const int kHeaderSize = kHeaderWords * sizeof(uint32_t);
+
+  static const uint32_t kMagicNumber = 0xC0DECAC4;
+  static const int kNotAttached = -1;
+
+  CodeSerializer(SnapshotByteSink* sink,
+                 SnapshotByteSink* attachment_sink,
+                 Script* script)
+      : Serializer(sink),
+        attachment_sink_(attachment_sink),
+        script_(script),
+        attachment_count_(0),
+        failed_(false) {
+    set_root_index_wave_front(Heap::kStrongRootListLength);
+  }
+
+  virtual bool ShouldBeInThePartialSnapshotCache(HeapObject* o) {
+    return false;
+  }
+  virtual int SpaceOfObject(HeapObject* object);
+  virtual int EncodeExternalReference(Address addr);
+
+  // Returns false for objects that only make sense in the context that
+  // compiled the script, like JS objects, maps and optimized code.
+  bool CanSerializeByValue(HeapObject* object);
+  // Returns the index of an object in the attachments, attaching it first
+  // if necessary, or kNotAttached if it should be serialized by value.
+  int AttachmentIndex(HeapObject* object);
+  int Attach(HeapObject* object, AttachmentKind kind, uint32_t value);
+  void PutAttachedReference(int index,
+                            HowToCode how_to_code,
+                            WhereToPoint where_to_point,
+                            int skip);
+
+  static Handle<Object> LookUpAttachment(Isolate* isolate,
+                                         SnapshotByteSource* source,
+                                         Handle<Script> script);
+
+  static uint32_t VersionHash();
+  static uint32_t FlagsHash();
+  static uint32_t SourceHash(String* source);
+
+  SnapshotByteSink* attachment_sink_;
+  Script* script_;
+  SerializationAddressMapper attachment_mapper_;
+  int attachment_count_;
+  bool failed_;
+
+  DISALLOW_COPY_AND_ASSIGN(CodeSerializer);
+};
+
+
 } }  // namespace v8::internal
 
 #endif  // V8_SERIALIZE_H_
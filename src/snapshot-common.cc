@@ -129,4 +129,17 @@ Handle<Context> Snapshot::NewContextFromSnapshot() {
   return Handle<Context>(Context::cast(root));
 }
 
+
+void Snapshot::SplitFileList(const char* list,
+                             List<Vector<const char> >* files) {
+  while (*list != '\0') {
+    const char* end = strchr(list, ',');
+    int length = end == NULL ? StrLength(list)
+                             : static_cast<int>(end - list);
+    if (length > 0) files->Add(Vector<const char>(list, length));
+    list += length;
+    if (*list == ',') list++;
+  }
+}
+
 } }  // namespace v8::internal
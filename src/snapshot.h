@@ -52,6 +52,12 @@ class Snapshot {
   // successfully.
   static bool WriteToFile(const char* snapshot_file);
 
+  // Split a comma-separated list of file names, as passed to mksnapshot's
+  // --extra-code, into its non-empty elements.  The elements point into
+  // the list.
+  static void SplitFileList(const char* list,
+                            List<Vector<const char> >* files);
+
   static const byte* data() { return data_; }
   static int size() { return size_; }
   static int raw_size() { return raw_size_; }
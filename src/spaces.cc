@@ -448,6 +448,7 @@ MemoryChunk* MemoryChunk::Initialize(Heap* heap,
   chunk->slots_buffer_ = NULL;
   chunk->skip_list_ = NULL;
   chunk->write_barrier_counter_ = kWriteBarrierCounterGranularity;
+  chunk->parallel_sweeping_ = kParallelSweepingDone;
   chunk->ResetLiveBytes();
   Bitmap::Clear(chunk);
   chunk->initialize_scan_on_scavenge(false);
@@ -1178,11 +1179,13 @@ void NewSpace::UpdateAllocationInfo() {
   allocation_info_.top = to_space_.page_low();
   allocation_info_.limit = to_space_.page_high();
 
-  // Lower limit during incremental marking.
-  if (heap()->incremental_marking()->IsMarking() &&
-      inline_allocation_limit_step() != 0) {
-    Address new_limit =
-        allocation_info_.top + inline_allocation_limit_step();
+  // Lower limit during incremental marking and allocation sampling.
+  intptr_t step = InlineAllocationStep(
+      heap()->incremental_marking()->IsMarking()
+          ? inline_allocation_limit_step()
+          : 0);
+  if (step != 0) {
+    Address new_limit = allocation_info_.top + step;
     allocation_info_.limit = Min(new_limit, allocation_info_.limit);
   }
   ASSERT_SEMISPACE_ALLOCATION_INFO(allocation_info_, to_space_);
@@ -1234,30 +1237,41 @@ bool NewSpace::AddFreshPage() {
 
 
 MaybeObject* NewSpace::SlowAllocateRaw(int size_in_bytes) {
-  Address old_top = allocation_info_.top;
-  Address new_top = old_top + size_in_bytes;
-  Address high = to_space_.page_high();
-  if (allocation_info_.limit < high) {
-    // Incremental marking has lowered the limit to get a
-    // chance to do a step.
-    allocation_info_.limit = Min(
-        allocation_info_.limit + inline_allocation_limit_step_,
-        high);
-    int bytes_allocated = static_cast<int>(new_top - top_on_previous_step_);
-    heap()->incremental_marking()->Step(
-        bytes_allocated, IncrementalMarking::GC_VIA_STACK_GUARD);
-    top_on_previous_step_ = new_top;
-    return AllocateRaw(size_in_bytes);
-  } else if (AddFreshPage()) {
-    // Switched to new page. Try allocating again.
-    int bytes_allocated = static_cast<int>(old_top - top_on_previous_step_);
-    heap()->incremental_marking()->Step(
-        bytes_allocated, IncrementalMarking::GC_VIA_STACK_GUARD);
-    top_on_previous_step_ = to_space_.page_low();
-    return AllocateRaw(size_in_bytes);
-  } else {
-    return Failure::RetryAfterGC();
+  // Steps are taken until the object fits below the limit, and then the
+  // allocation is sampled once with all the bytes the steps covered.
+  intptr_t bytes_since_step = 0;
+  do {
+    Address old_top = allocation_info_.top;
+    Address new_top = old_top + size_in_bytes;
+    Address high = to_space_.page_high();
+    if (allocation_info_.limit < high) {
+      // Incremental marking or the allocation sampler has lowered the limit
+      // to get a chance to do a step.
+      allocation_info_.limit = Min(
+          allocation_info_.limit +
+              InlineAllocationStep(inline_allocation_limit_step_),
+          high);
+      int bytes_allocated = static_cast<int>(new_top - top_on_previous_step_);
+      heap()->incremental_marking()->Step(
+          bytes_allocated, IncrementalMarking::GC_VIA_STACK_GUARD);
+      top_on_previous_step_ = new_top;
+      bytes_since_step += bytes_allocated;
+    } else if (AddFreshPage()) {
+      // Switched to new page. Try allocating again.
+      int bytes_allocated = static_cast<int>(old_top - top_on_previous_step_);
+      heap()->incremental_marking()->Step(
+          bytes_allocated, IncrementalMarking::GC_VIA_STACK_GUARD);
+      top_on_previous_step_ = to_space_.page_low();
+      bytes_since_step += bytes_allocated;
+    } else {
+      return Failure::RetryAfterGC();
+    }
+  } while (allocation_info_.limit - allocation_info_.top < size_in_bytes);
+  MaybeObject* result = AllocateRaw(size_in_bytes);
+  if (allocation_sampling_step_ != 0) {
+    heap()->SampleAllocation(result, size_in_bytes, bytes_since_step);
   }
+  return result;
 }
 
 
@@ -1893,11 +1907,43 @@ void FreeListNode::set_next(FreeListNode* next) {
 
 
 FreeList::FreeList(PagedSpace* owner)
-    : owner_(owner), heap_(owner->heap()) {
+    : owner_(owner), heap_(owner->heap()), mutex_(OS::CreateMutex()) {
   Reset();
 }
 
 
+FreeList::~FreeList() {
+  delete mutex_;
+}
+
+
+void FreeList::ConcatenateList(FreeListNode** list, FreeListNode* other) {
+  if (other == NULL) return;
+  FreeListNode* tail = other;
+  while (tail->next() != NULL) tail = tail->next();
+  tail->set_next(*list);
+  *list = other;
+}
+
+
+intptr_t FreeList::Concatenate(FreeList* free_list) {
+  // This cannot deadlock: lists are only ever concatenated from a sweeper
+  // thread's private list into its shared list, and from there into the
+  // free list of the space, never in the reverse direction.
+  ScopedLock lock_target(mutex_);
+  ScopedLock lock_source(free_list->mutex());
+  intptr_t free_bytes = free_list->available();
+  ConcatenateList(&small_list_, free_list->small_list_);
+  ConcatenateList(&medium_list_, free_list->medium_list_);
+  ConcatenateList(&large_list_, free_list->large_list_);
+  ConcatenateList(&huge_list_, free_list->huge_list_);
+  available_ += free_list->available();
+  free_list->Reset();
+  ASSERT(IsVeryLong() || available_ == SumFreeLists());
+  return free_bytes;
+}
+
+
 void FreeList::Reset() {
   available_ = 0;
   small_list_ = NULL;
@@ -2306,8 +2352,33 @@ bool LargeObjectSpace::ReserveSpace(int bytes) {
 }
 
 
+bool PagedSpace::IsSweepingComplete() {
+  return IsLazySweepingComplete() &&
+      !heap()->mark_compact_collector()->IsConcurrentSweepingInProgress();
+}
+
+
 bool PagedSpace::AdvanceSweeper(intptr_t bytes_to_sweep) {
-  if (IsSweepingComplete()) return true;
+  MarkCompactCollector* collector = heap()->mark_compact_collector();
+  if (collector->IsConcurrentSweepingInProgress()) {
+    // Pick up the memory the sweeper threads have freed so far.  If that is
+    // not enough, sweep pages they have not claimed yet on this thread and
+    // only block once there is nothing left to claim.
+    intptr_t freed_bytes = collector->StealMemoryFromSweeperThreads(this);
+    if (freed_bytes < bytes_to_sweep) {
+      intptr_t swept_bytes = collector->SweepInParallel(
+          this, NULL, &free_list_, bytes_to_sweep - freed_bytes);
+      AddToAccountingStats(swept_bytes);
+      DecrementUnsweptFreeBytes(swept_bytes);
+      freed_bytes += swept_bytes;
+    }
+    if (freed_bytes < bytes_to_sweep) {
+      collector->WaitUntilSweepingCompleted();
+    }
+    return IsSweepingComplete();
+  }
+
+  if (IsLazySweepingComplete()) return true;
 
   intptr_t freed_bytes = 0;
   Page* p = first_unswept_page_;
@@ -2332,7 +2403,7 @@ bool PagedSpace::AdvanceSweeper(intptr_t bytes_to_sweep) {
 
   heap()->FreeQueuedChunks();
 
-  return IsSweepingComplete();
+  return IsLazySweepingComplete();
 }
 
 
@@ -2356,7 +2427,7 @@ HeapObject* PagedSpace::SlowAllocateRaw(int size_in_bytes) {
 
   // If there are unswept pages advance lazy sweeper then sweep one page before
   // allocating a new page.
-  if (first_unswept_page_->is_valid()) {
+  if (!IsSweepingComplete()) {
     AdvanceSweeper(size_in_bytes);
 
     // Retry the free list allocation.
@@ -29,6 +29,7 @@
 #define V8_SPACES_H_
 
 #include "allocation.h"
+#include "atomicops.h"
 #include "hashmap.h"
 #include "list.h"
 #include "log.h"
@@ -138,6 +139,21 @@ class MarkBit {
   inline bool Get() { return (*cell_ & mask_) != 0; }
   inline void Clear() { *cell_ &= ~mask_; }
 
+  // Sets the bit with a compare-and-swap on the whole cell so that marking
+  // threads setting neighbouring bits of the same cell do not lose updates.
+  // Returns false if the bit was already set.
+  inline bool AtomicSet() {
+    Atomic32* cell = reinterpret_cast<Atomic32*>(cell_);
+    Atomic32 old_value = NoBarrier_Load(cell);
+    while ((old_value & mask_) == 0) {
+      Atomic32 new_value = old_value | static_cast<Atomic32>(mask_);
+      Atomic32 result = NoBarrier_CompareAndSwap(cell, old_value, new_value);
+      if (result == old_value) return true;
+      old_value = result;
+    }
+    return false;
+  }
+
   inline bool data_only() { return data_only_; }
 
   inline MarkBit Next() {
@@ -480,11 +496,47 @@ class MemoryChunk {
     write_barrier_counter_ = counter;
   }
 
+  // State of a page with respect to the concurrent sweeper threads.  Pages
+  // are queued by the main thread in the pending state and claimed by
+  // exactly one thread (a sweeper thread or the main thread) before being
+  // swept.
+  enum ParallelSweepingState {
+    kParallelSweepingDone,
+    kParallelSweepingInProgress,
+    kParallelSweepingPending
+  };
+
+  intptr_t parallel_sweeping() {
+    return Acquire_Load(&parallel_sweeping_);
+  }
+
+  void set_parallel_sweeping(ParallelSweepingState state) {
+    Release_Store(&parallel_sweeping_, state);
+  }
+
+  // Atomically claims a pending page for sweeping.  Returns false if the
+  // page was not queued or another thread got to it first.
+  bool TryParallelSweeping() {
+    return NoBarrier_CompareAndSwap(&parallel_sweeping_,
+                                    kParallelSweepingPending,
+                                    kParallelSweepingInProgress) ==
+        kParallelSweepingPending;
+  }
+
 
   static void IncrementLiveBytesFromGC(Address address, int by) {
     MemoryChunk::FromAddress(address)->IncrementLiveBytes(by);
   }
 
+  // Variant of IncrementLiveBytesFromGC for the parallel marker, where
+  // several threads may account objects on the same chunk at once.
+  static void AtomicIncrementLiveBytesFromGC(Address address, int by) {
+    MemoryChunk* chunk = MemoryChunk::FromAddress(address);
+    STATIC_ASSERT(sizeof(chunk->live_byte_count_) == sizeof(Atomic32));
+    NoBarrier_AtomicIncrement(
+        reinterpret_cast<Atomic32*>(&chunk->live_byte_count_), by);
+  }
+
   static void IncrementLiveBytesFromMutator(Address address, int by);
 
   static const intptr_t kAlignment =
@@ -504,7 +556,8 @@ class MemoryChunk {
   static const size_t kWriteBarrierCounterOffset =
       kSlotsBufferOffset + kPointerSize + kPointerSize;
 
-  static const size_t kHeaderSize = kWriteBarrierCounterOffset + kPointerSize;
+  static const size_t kHeaderSize =
+      kWriteBarrierCounterOffset + kPointerSize + kPointerSize;
 
   static const int kBodyOffset =
       CODE_POINTER_ALIGN(kHeaderSize + Bitmap::kSize);
@@ -641,6 +694,8 @@ class MemoryChunk {
   SlotsBuffer* slots_buffer_;
   SkipList* skip_list_;
   intptr_t write_barrier_counter_;
+  // One of ParallelSweepingState, accessed atomically.
+  AtomicWord parallel_sweeping_;
 
   static MemoryChunk* Initialize(Heap* heap,
                                  Address base,
@@ -1364,6 +1419,14 @@ class FreeListNode: public HeapObject {
 class FreeList BASE_EMBEDDED {
  public:
   explicit FreeList(PagedSpace* owner);
+  ~FreeList();
+
+  // Moves all nodes of the given free list to the front of this one and
+  // returns the number of bytes that were moved.  The given free list is
+  // empty afterwards.  Both lists are locked during the operation, so this
+  // may be used to hand over memory between the sweeper threads and the
+  // main thread.
+  intptr_t Concatenate(FreeList* free_list);
 
   // Clear the free list.
   void Reset();
@@ -1420,9 +1483,17 @@ class FreeList BASE_EMBEDDED {
 
   FreeListNode* FindNodeFor(int size_in_bytes, int* node_size);
 
+  static void ConcatenateList(FreeListNode** list, FreeListNode* other);
+
+  Mutex* mutex() { return mutex_; }
+
   PagedSpace* owner_;
   Heap* heap_;
 
+  // Guards concurrent Concatenate operations.  Free and Allocate are not
+  // synchronized and must only be used by the thread owning the list.
+  Mutex* mutex_;
+
   // Total available bytes in all blocks on this free list.
   int available_;
 
@@ -1546,6 +1617,14 @@ class PagedSpace : public Space {
     free_list_.Reset();
   }
 
+  FreeList* free_list() { return &free_list_; }
+
+  // Accounts for memory that was added to the free list directly, e.g. by
+  // a concurrent sweeper thread, rather than through Free.
+  void AddToAccountingStats(intptr_t bytes) {
+    accounting_stats_.DeallocateBytes(bytes);
+  }
+
   // Set space allocation info.
   void SetTop(Address top, Address limit) {
     ASSERT(top == limit ||
@@ -1624,9 +1703,21 @@ class PagedSpace : public Space {
     unswept_free_bytes_ -= (p->area_size() - p->LiveBytes());
   }
 
+  void DecrementUnsweptFreeBytes(intptr_t by) {
+    unswept_free_bytes_ -= by;
+  }
+
+  void ResetUnsweptFreeBytes() {
+    unswept_free_bytes_ = 0;
+  }
+
   bool AdvanceSweeper(intptr_t bytes_to_sweep);
 
-  bool IsSweepingComplete() {
+  // Sweeping is complete when neither the lazy sweeper nor the concurrent
+  // sweeper threads have pages of this space left to sweep.
+  bool IsSweepingComplete();
+
+  bool IsLazySweepingComplete() {
     return !first_unswept_page_->is_valid();
   }
 
@@ -2093,7 +2184,8 @@ class NewSpace : public Space {
       to_space_(heap, kToSpace),
       from_space_(heap, kFromSpace),
       reservation_(),
-      inline_allocation_limit_step_(0) {}
+      inline_allocation_limit_step_(0),
+      allocation_sampling_step_(0) {}
 
   // Sets up the new space using the given chunk.
   bool SetUp(int reserved_semispace_size_, int max_semispace_size);
@@ -2215,14 +2307,15 @@ class NewSpace : public Space {
 
   void LowerInlineAllocationLimit(intptr_t step) {
     inline_allocation_limit_step_ = step;
-    if (step == 0) {
-      allocation_info_.limit = to_space_.page_high();
-    } else {
-      allocation_info_.limit = Min(
-          allocation_info_.top + inline_allocation_limit_step_,
-          allocation_info_.limit);
-    }
-    top_on_previous_step_ = allocation_info_.top;
+    UpdateInlineAllocationLimit();
+  }
+
+  // Lowers the limit so that allocations report to the heap profiler about
+  // every step bytes, including allocations from generated code. Zero stops
+  // reporting.
+  void SetAllocationSamplingStep(intptr_t step) {
+    allocation_sampling_step_ = step;
+    UpdateInlineAllocationLimit();
   }
 
   // Get the extent of the inactive semispace (for use as a marking stack,
@@ -2301,12 +2394,38 @@ class NewSpace : public Space {
     return inline_allocation_limit_step_;
   }
 
+  inline intptr_t allocation_sampling_step() {
+    return allocation_sampling_step_;
+  }
+
   SemiSpace* active_space() { return &to_space_; }
 
  private:
   // Update allocation info to match the current to-space page.
   void UpdateAllocationInfo();
 
+  // The distance between two consecutive lowered limits: the smaller of the
+  // incremental marking and allocation sampling steps that are in effect.
+  intptr_t InlineAllocationStep(intptr_t marking_step) {
+    if (marking_step == 0) return allocation_sampling_step_;
+    if (allocation_sampling_step_ == 0) return marking_step;
+    return Min(marking_step, allocation_sampling_step_);
+  }
+
+  // Recomputes the limit from the current top, so that a changed step
+  // takes effect with the next allocation rather than the next step.
+  void UpdateInlineAllocationLimit() {
+    intptr_t step = InlineAllocationStep(inline_allocation_limit_step_);
+    if (step == 0) {
+      allocation_info_.limit = to_space_.page_high();
+    } else {
+      allocation_info_.limit = Min(
+          allocation_info_.top + step,
+          to_space_.page_high());
+    }
+    top_on_previous_step_ = allocation_info_.top;
+  }
+
   Address chunk_base_;
   uintptr_t chunk_size_;
 
@@ -2332,6 +2451,10 @@ class NewSpace : public Space {
   // when all allocation is performed from inlined generated code.
   intptr_t inline_allocation_limit_step_;
 
+  // The allocation sampler of the heap profiler lowers the limit the same
+  // way to observe allocations performed from inlined generated code.
+  intptr_t allocation_sampling_step_;
+
   Address top_on_previous_step_;
 
   HistogramInfo* allocated_histogram_;
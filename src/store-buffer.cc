@@ -647,6 +647,14 @@ void StoreBuffer::IteratePointersToNewSpace(ObjectSlotCallback slot_callback) {
         } else {
           Page* page = reinterpret_cast<Page*>(chunk);
           PagedSpace* owner = reinterpret_cast<PagedSpace*>(page->owner());
+          // Scanning relies on free spaces being marked as such, so a page
+          // must not be scanned while a sweeper thread may be working on it.
+          MarkCompactCollector* collector = heap_->mark_compact_collector();
+          if (collector->IsConcurrentSweepingInProgress() &&
+              page->parallel_sweeping() !=
+                  MemoryChunk::kParallelSweepingDone) {
+            collector->WaitUntilSweepingCompleted();
+          }
           FindPointersToNewSpaceOnPage(
               owner,
               page,
@@ -206,34 +206,41 @@ class StringSearch : private StringSearchBase {
 // Single Character Pattern Search Strategy
 //---------------------------------------------------------------------
 
+// Returns the index of the first occurrence of the pattern character in
+// subject[index..limit[, or -1 if there is none.
+template <typename PatternChar, typename SubjectChar>
+inline int FindFirstCharacter(PatternChar pattern_char,
+                              Vector<const SubjectChar> subject,
+                              int index,
+                              int limit) {
+  if (sizeof(PatternChar) > sizeof(SubjectChar)) {
+    if (static_cast<uc16>(pattern_char) > String::kMaxAsciiCharCodeU) {
+      return -1;
+    }
+  }
+  if (sizeof(SubjectChar) == 1) {
+    const SubjectChar* pos = reinterpret_cast<const SubjectChar*>(
+        memchr(subject.start() + index, pattern_char, limit - index));
+    if (pos == NULL) return -1;
+    return static_cast<int>(pos - subject.start());
+  }
+  return FindCharacter(reinterpret_cast<const uc16*>(subject.start()),
+                       index,
+                       limit,
+                       static_cast<uc16>(pattern_char));
+}
+
+
 template <typename PatternChar, typename SubjectChar>
 int StringSearch<PatternChar, SubjectChar>::SingleCharSearch(
     StringSearch<PatternChar, SubjectChar>* search,
     Vector<const SubjectChar> subject,
     int index) {
   ASSERT_EQ(1, search->pattern_.length());
-  PatternChar pattern_first_char = search->pattern_[0];
-  int i = index;
-  if (sizeof(SubjectChar) == 1 && sizeof(PatternChar) == 1) {
-    const SubjectChar* pos = reinterpret_cast<const SubjectChar*>(
-        memchr(subject.start() + i,
-               pattern_first_char,
-               subject.length() - i));
-    if (pos == NULL) return -1;
-    return static_cast<int>(pos - subject.start());
-  } else {
-    if (sizeof(PatternChar) > sizeof(SubjectChar)) {
-      if (static_cast<uc16>(pattern_first_char) > String::kMaxAsciiCharCodeU) {
-        return -1;
-      }
-    }
-    SubjectChar search_char = static_cast<SubjectChar>(pattern_first_char);
-    int n = subject.length();
-    while (i < n) {
-      if (subject[i++] == search_char) return i - 1;
-    }
-    return -1;
-  }
+  return FindFirstCharacter(search->pattern_[0],
+                            subject,
+                            index,
+                            subject.length());
 }
 
 //---------------------------------------------------------------------
@@ -270,16 +277,9 @@ int StringSearch<PatternChar, SubjectChar>::LinearSearch(
   int i = index;
   int n = subject.length() - pattern_length;
   while (i <= n) {
-    if (sizeof(SubjectChar) == 1 && sizeof(PatternChar) == 1) {
-      const SubjectChar* pos = reinterpret_cast<const SubjectChar*>(
-          memchr(subject.start() + i,
-                 pattern_first_char,
-                 n - i + 1));
-      if (pos == NULL) return -1;
-      i = static_cast<int>(pos - subject.start()) + 1;
-    } else {
-      if (subject[i++] != pattern_first_char) continue;
-    }
+    i = FindFirstCharacter(pattern_first_char, subject, i, n + 1);
+    if (i == -1) return -1;
+    i++;
     // Loop extracted to separate function to allow using return to do
     // a deeper break.
     if (CharCompare(pattern.start() + 1,
@@ -521,18 +521,8 @@ int StringSearch<PatternChar, SubjectChar>::InitialSearch(
   for (int i = index, n = subject.length() - pattern_length; i <= n; i++) {
     badness++;
     if (badness <= 0) {
-      if (sizeof(SubjectChar) == 1 && sizeof(PatternChar) == 1) {
-        const SubjectChar* pos = reinterpret_cast<const SubjectChar*>(
-            memchr(subject.start() + i,
-                   pattern_first_char,
-                   n - i + 1));
-        if (pos == NULL) {
-          return -1;
-        }
-        i = static_cast<int>(pos - subject.start());
-      } else {
-        if (subject[i] != pattern_first_char) continue;
-      }
+      i = FindFirstCharacter(pattern_first_char, subject, i, n + 1);
+      if (i == -1) return -1;
       int j = 1;
       do {
         if (pattern[j] != subject[i + j]) {
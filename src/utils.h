@@ -35,6 +35,11 @@
 #include "globals.h"
 #include "checks.h"
 #include "allocation.h"
+#include "compiler-intrinsics.h"
+
+#ifdef V8_HOST_CAN_USE_SSE2
+#include <emmintrin.h>
+#endif
 
 namespace v8 {
 namespace internal {
@@ -763,31 +768,99 @@ class SequenceCollector : public Collector<T, growth_factor, max_growth> {
 };
 
 
-// Compare ASCII/16bit chars to ASCII/16bit chars.
+#ifdef V8_HOST_CAN_USE_SSE2
+// Load eight characters into the 16-bit lanes of an SSE2 register.
+inline __m128i LoadEightChars(const char* chars) {
+  return _mm_unpacklo_epi8(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(chars)),
+      _mm_setzero_si128());
+}
+
+
+inline __m128i LoadEightChars(const uint16_t* chars) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars));
+}
+#endif
+
+
+// Returns the index of the first character at which the ASCII/16bit chars
+// differ, or chars if they are equal.
 template <typename lchar, typename rchar>
-inline int CompareChars(const lchar* lhs, const rchar* rhs, int chars) {
-  const lchar* limit = lhs + chars;
-#ifdef V8_HOST_CAN_READ_UNALIGNED
-  if (sizeof(*lhs) == sizeof(*rhs)) {
+inline int FindFirstMismatch(const lchar* lhs, const rchar* rhs, int chars) {
+  int i = 0;
+#if defined(V8_HOST_CAN_USE_SSE2)
+  if (sizeof(*lhs) == 1 && sizeof(*rhs) == 1) {
+    // Compare 16 characters at a time.
+    for (; i <= chars - 16; i += 16) {
+      __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i));
+      __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(l, r)) != 0xffff) break;
+    }
+  } else {
+    // Compare 8 characters at a time, widening ASCII characters to 16 bits.
+    for (; i <= chars - 8; i += 8) {
+      __m128i l = LoadEightChars(lhs + i);
+      __m128i r = LoadEightChars(rhs + i);
+      if (_mm_movemask_epi8(_mm_cmpeq_epi16(l, r)) != 0xffff) break;
+    }
+  }
+#else
+  bool compare_words = sizeof(*lhs) == sizeof(*rhs);
+#ifndef V8_HOST_CAN_READ_UNALIGNED
+  // If this architecture isn't comfortable reading unaligned words then
+  // both strings have to be aligned to compare them blockwise.
+  const uintptr_t kAlignmentMask = sizeof(uintptr_t) - 1;  // NOLINT
+  uintptr_t lhs_addr = reinterpret_cast<uintptr_t>(lhs);
+  uintptr_t rhs_addr = reinterpret_cast<uintptr_t>(rhs);
+  if (((lhs_addr | rhs_addr) & kAlignmentMask) != 0) compare_words = false;
+#endif
+  if (compare_words) {
     // Number of characters in a uintptr_t.
     static const int kStepSize = sizeof(uintptr_t) / sizeof(*lhs);  // NOLINT
-    while (lhs <= limit - kStepSize) {
-      if (*reinterpret_cast<const uintptr_t*>(lhs) !=
-          *reinterpret_cast<const uintptr_t*>(rhs)) {
+    for (; i <= chars - kStepSize; i += kStepSize) {
+      if (*reinterpret_cast<const uintptr_t*>(lhs + i) !=
+          *reinterpret_cast<const uintptr_t*>(rhs + i)) {
         break;
       }
-      lhs += kStepSize;
-      rhs += kStepSize;
     }
   }
 #endif
-  while (lhs < limit) {
-    int r = static_cast<int>(*lhs) - static_cast<int>(*rhs);
-    if (r != 0) return r;
-    ++lhs;
-    ++rhs;
+  for (; i < chars; i++) {
+    if (lhs[i] != rhs[i]) break;
   }
-  return 0;
+  return i;
+}
+
+
+// Compare ASCII/16bit chars to ASCII/16bit chars.
+template <typename lchar, typename rchar>
+inline int CompareChars(const lchar* lhs, const rchar* rhs, int chars) {
+  int i = FindFirstMismatch(lhs, rhs, chars);
+  if (i == chars) return 0;
+  return static_cast<int>(lhs[i]) - static_cast<int>(rhs[i]);
+}
+
+
+// Returns the index of the first occurrence of the 16bit char c in
+// chars[start..end[, or -1 if there is none.
+inline int FindCharacter(const uint16_t* chars, int start, int end,
+                         uint16_t c) {
+  int i = start;
+#ifdef V8_HOST_CAN_USE_SSE2
+  __m128i pattern = _mm_set1_epi16(c);
+  for (; i <= end - 8; i += 8) {
+    int mask = _mm_movemask_epi8(
+        _mm_cmpeq_epi16(LoadEightChars(chars + i), pattern));
+    // Every matching character sets two bits in the mask.
+    if (mask != 0) {
+      return i + CompilerIntrinsics::CountTrailingZeros(mask) / 2;
+    }
+  }
+#endif
+  for (; i < end; i++) {
+    if (chars[i] == c) return i;
+  }
+  return -1;
 }
 
 
@@ -48,7 +48,14 @@ namespace internal {
   /* Total compilation times. */                                      \
   HT(compile, V8.Compile)                                             \
   HT(compile_eval, V8.CompileEval)                                    \
-  HT(compile_lazy, V8.CompileLazy)
+  HT(compile_lazy, V8.CompileLazy)                                    \
+  /* Regexp compilation times per tier. */                            \
+  HT(regexp_compile_bytecode, V8.RegExpCompileBytecode)               \
+  HT(regexp_compile_native, V8.RegExpCompileNative)                   \
+  /* Parallel recompilation timers. */                                \
+  HT(parallel_recompilation_queue_wait,                               \
+     V8.ParallelRecompilationQueueWait)                               \
+  HT(parallel_recompilation, V8.ParallelRecompilation)
 
 
 #define HISTOGRAM_PERCENTAGE_LIST(HP)                                 \
@@ -111,6 +118,13 @@ namespace internal {
   SC(compilation_cache_misses, V8.CompilationCacheMisses)             \
   SC(regexp_cache_hits, V8.RegExpCacheHits)                           \
   SC(regexp_cache_misses, V8.RegExpCacheMisses)                       \
+  SC(regexp_shared_cache_hits, V8.RegExpSharedCacheHits)              \
+  SC(regexp_shared_cache_misses, V8.RegExpSharedCacheMisses)          \
+  SC(regexp_bytecode_compiles, V8.RegExpBytecodeCompiles)             \
+  SC(regexp_native_compiles, V8.RegExpNativeCompiles)                 \
+  /* Deferred compiles minus tier-ups are native compiles saved. */   \
+  SC(regexp_deferred_compiles, V8.RegExpDeferredCompiles)             \
+  SC(regexp_tier_ups, V8.RegExpTierUps)                               \
   SC(string_ctor_calls, V8.StringConstructorCalls)                    \
   SC(string_ctor_conversions, V8.StringConstructorConversions)        \
   SC(string_ctor_cached_number, V8.StringConstructorCachedNumber)     \
@@ -238,6 +252,9 @@ namespace internal {
   SC(enum_cache_hits, V8.EnumCacheHits)                               \
   SC(enum_cache_misses, V8.EnumCacheMisses)                           \
   SC(zone_segment_bytes, V8.ZoneSegmentBytes)                         \
+  SC(zone_segment_pool_bytes, V8.ZoneSegmentPoolBytes)                \
+  SC(zone_segment_pool_hits, V8.ZoneSegmentPoolHits)                  \
+  SC(zone_segment_pool_misses, V8.ZoneSegmentPoolMisses)              \
   SC(compute_entry_frame, V8.ComputeEntryFrame)                       \
   SC(generic_binary_stub_calls, V8.GenericBinaryStubCalls)            \
   SC(generic_binary_stub_calls_regs, V8.GenericBinaryStubCallsRegs)   \
@@ -36,6 +36,7 @@
 #include "frames.h"
 #include "heap-profiler.h"
 #include "hydrogen.h"
+#include "jsregexp.h"
 #include "lithium-allocator.h"
 #include "log.h"
 #include "once.h"
@@ -113,6 +114,7 @@ void V8::TearDown() {
   delete isolate;
 
   ElementsAccessor::TearDown();
+  SharedRegExpCodeCache::TearDown();
   LOperand::TearDownCaches();
   RegisteredExtension::UnregisterAll();
 
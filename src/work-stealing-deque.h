@@ -0,0 +1,125 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef V8_WORK_STEALING_DEQUE_H_
+#define V8_WORK_STEALING_DEQUE_H_
+
+#include "allocation.h"
+#include "atomicops.h"
+#include "utils.h"
+
+namespace v8 {
+namespace internal {
+
+
+// A fixed-size work-stealing deque of pointer-sized elements (Chase and Lev,
+// "Dynamic Circular Work-Stealing Deque", without the growing).  The owning
+// thread pushes and pops at the top; other threads steal from the bottom.
+// Push fails when the deque is full; what to do with the element is left to
+// the client.
+template<typename T>
+class WorkStealingDeque {
+ public:
+  WorkStealingDeque() : array_(NULL), mask_(0), top_(0), bottom_(0) { }
+
+  ~WorkStealingDeque() { DeleteArray(array_); }
+
+  // The capacity must be a power of two.  Must not be called while other
+  // threads access the deque.
+  void Initialize(int capacity) {
+    ASSERT(IsPowerOf2(capacity));
+    if (array_ == NULL || mask_ != capacity - 1) {
+      DeleteArray(array_);
+      array_ = NewArray<T>(capacity);
+      mask_ = capacity - 1;
+    }
+    top_ = bottom_ = 0;
+  }
+
+  // May be called by any thread.
+  inline bool IsEmpty() {
+    return Acquire_Load(&bottom_) >= Acquire_Load(&top_);
+  }
+
+  // Returns false if the deque is full.  Only called by the owning thread.
+  inline bool Push(T element) {
+    AtomicWord top = NoBarrier_Load(&top_);
+    if (top - Acquire_Load(&bottom_) > mask_) return false;
+    array_[top & mask_] = element;
+    Release_Store(&top_, top + 1);
+    return true;
+  }
+
+  // Returns false if the deque is empty or the last element was stolen.
+  // Only called by the owning thread.
+  inline bool Pop(T* element) {
+    AtomicWord top = NoBarrier_Load(&top_) - 1;
+    NoBarrier_Store(&top_, top);
+    MemoryBarrier();
+    AtomicWord bottom = NoBarrier_Load(&bottom_);
+    if (top < bottom) {
+      NoBarrier_Store(&top_, bottom);
+      return false;
+    }
+    *element = array_[top & mask_];
+    if (top > bottom) return true;
+    // This is the last element; race the stealing threads for it.
+    bool won = Acquire_CompareAndSwap(&bottom_, bottom, bottom + 1) == bottom;
+    NoBarrier_Store(&top_, bottom + 1);
+    return won;
+  }
+
+  // Returns false if the deque is empty or another thread won the race for
+  // the bottom element.  May be called by any thread.
+  inline bool Steal(T* element) {
+    AtomicWord bottom = Acquire_Load(&bottom_);
+    MemoryBarrier();
+    AtomicWord top = Acquire_Load(&top_);
+    if (bottom >= top) return false;
+    T candidate = array_[bottom & mask_];
+    if (Acquire_CompareAndSwap(&bottom_, bottom, bottom + 1) != bottom) {
+      return false;
+    }
+    *element = candidate;
+    return true;
+  }
+
+ private:
+  T* array_;
+  AtomicWord mask_;
+  // Indices grow monotonically and are reduced modulo the capacity when
+  // the array is accessed.  The deque is empty when bottom_ >= top_.
+  volatile AtomicWord top_;
+  volatile AtomicWord bottom_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingDeque);
+};
+
+} }  // namespace v8::internal
+
+#endif  // V8_WORK_STEALING_DEQUE_H_
@@ -564,6 +564,12 @@ void Deoptimizer::DoComputeConstructStubFrame(TranslationIterator* iterator,
   output_offset -= kPointerSize;
   value = output_frame->GetFrameSlot(output_frame_size - kPointerSize);
   output_frame->SetFrameSlot(output_offset, value);
+  if (value == reinterpret_cast<intptr_t>(
+          isolate_->heap()->arguments_marker())) {
+    // The receiver is a captured object, materialize it into both slots.
+    AddObjectDuplication(top_address + output_offset,
+                         top_address + output_frame_size - kPointerSize);
+  }
   if (FLAG_trace_deopt) {
     PrintF("    0x%08" V8PRIxPTR ": [top + %d] <- 0x%08"
            V8PRIxPTR " ; allocated receiver\n",
@@ -676,9 +682,7 @@ void Deoptimizer::DoComputeAccessorStubFrame(TranslationIterator* iterator,
   }
 
   // Skip receiver.
-  Translation::Opcode opcode =
-      static_cast<Translation::Opcode>(iterator->Next());
-  iterator->Skip(Translation::NumberOfOperandsFor(opcode));
+  Translation::SkipValue(iterator);
 
   if (is_setter_stub_frame) {
     // The implicit return value was part of the artificial setter stub
@@ -357,7 +357,7 @@ void LCodeGen::WriteTranslation(LEnvironment* environment,
   if (environment == NULL) return;
 
   // The translation includes one command per value in the environment.
-  int translation_size = environment->values()->length();
+  int translation_size = environment->translation_size();
   // The output frame height does not include the parameters.
   int height = translation_size - environment->parameter_count();
 
@@ -409,40 +409,68 @@ void LCodeGen::WriteTranslation(LEnvironment* environment,
   }
 
   for (int i = 0; i < translation_size; ++i) {
-    LOperand* value = environment->values()->at(i);
-    // spilled_registers_ and spilled_double_registers_ are either
-    // both NULL or both set.
-    if (environment->spilled_registers() != NULL && value != NULL) {
-      if (value->IsRegister() &&
-          environment->spilled_registers()[value->index()] != NULL) {
-        translation->MarkDuplicate();
-        AddToTranslation(translation,
-                         environment->spilled_registers()[value->index()],
-                         environment->HasTaggedValueAt(i),
-                         environment->HasUint32ValueAt(i),
-                         *arguments_index,
-                         *arguments_count);
-      } else if (
-          value->IsDoubleRegister() &&
-          environment->spilled_double_registers()[value->index()] != NULL) {
-        translation->MarkDuplicate();
-        AddToTranslation(
-            translation,
-            environment->spilled_double_registers()[value->index()],
-            false,
-            false,
-            *arguments_index,
-            *arguments_count);
+    int object_index = environment->CapturedObjectIndexAt(i);
+    if (object_index >= 0) {
+      int first = environment->captured_object_first_value(object_index);
+      int length = environment->captured_object_length(object_index);
+      translation->BeginCapturedObject(
+          environment->captured_object_id(object_index), length);
+      for (int j = first; j < first + length; ++j) {
+        WriteTranslationValue(environment,
+                              translation,
+                              j,
+                              *arguments_index,
+                              *arguments_count);
       }
+    } else {
+      WriteTranslationValue(environment,
+                            translation,
+                            i,
+                            *arguments_index,
+                            *arguments_count);
     }
+  }
+}
 
-    AddToTranslation(translation,
-                     value,
-                     environment->HasTaggedValueAt(i),
-                     environment->HasUint32ValueAt(i),
-                     *arguments_index,
-                     *arguments_count);
+
+void LCodeGen::WriteTranslationValue(LEnvironment* environment,
+                                     Translation* translation,
+                                     int index,
+                                     int arguments_index,
+                                     int arguments_count) {
+  LOperand* value = environment->values()->at(index);
+  // spilled_registers_ and spilled_double_registers_ are either
+  // both NULL or both set.
+  if (environment->spilled_registers() != NULL && value != NULL) {
+    if (value->IsRegister() &&
+        environment->spilled_registers()[value->index()] != NULL) {
+      translation->MarkDuplicate();
+      AddToTranslation(translation,
+                       environment->spilled_registers()[value->index()],
+                       environment->HasTaggedValueAt(index),
+                       environment->HasUint32ValueAt(index),
+                       arguments_index,
+                       arguments_count);
+    } else if (
+        value->IsDoubleRegister() &&
+        environment->spilled_double_registers()[value->index()] != NULL) {
+      translation->MarkDuplicate();
+      AddToTranslation(
+          translation,
+          environment->spilled_double_registers()[value->index()],
+          false,
+          false,
+          arguments_index,
+          arguments_count);
+    }
   }
+
+  AddToTranslation(translation,
+                   value,
+                   environment->HasTaggedValueAt(index),
+                   environment->HasUint32ValueAt(index),
+                   arguments_index,
+                   arguments_count);
 }
 
 
@@ -4445,7 +4473,7 @@ void LCodeGen::DoCheckInstanceType(LCheckInstanceType* instr) {
 
 void LCodeGen::DoCheckFunction(LCheckFunction* instr) {
   Register reg = ToRegister(instr->value());
-  Handle<JSFunction> target = instr->hydrogen()->target();
+  Handle<HeapObject> target = instr->hydrogen()->target();
   if (isolate()->heap()->InNewSpace(*target)) {
     Handle<JSGlobalPropertyCell> cell =
         isolate()->factory()->NewJSGlobalPropertyCell(target);
@@ -4584,11 +4612,12 @@ void LCodeGen::DoAllocateObject(LAllocateObject* instr) {
          initial_map->unused_property_fields() -
          initial_map->inobject_properties() == 0);
 
-  // Allocate memory for the object.  The initial map might change when
-  // the constructor's prototype changes, but instance size and property
-  // counts remain unchanged (if slack tracking finished).
+  // Allocate memory for the object and the allocations folded into it.  The
+  // initial map might change when the constructor's prototype changes, but
+  // instance size and property counts remain unchanged (if slack tracking
+  // finished).
   ASSERT(!constructor->shared()->IsInobjectSlackTrackingInProgress());
-  __ AllocateInNewSpace(instance_size,
+  __ AllocateInNewSpace(instance_size + instr->hydrogen()->folded_size(),
                         result,
                         no_reg,
                         scratch,
@@ -4603,6 +4632,44 @@ void LCodeGen::DoAllocateObject(LAllocateObject* instr) {
     __ bind(&is_in_new_space);
   }
 
+  EmitInitializeObject(instr->hydrogen(), result, scratch);
+}
+
+
+void LCodeGen::DoDeferredAllocateObject(LAllocateObject* instr) {
+  Register result = ToRegister(instr->result());
+  Handle<JSFunction> constructor = instr->hydrogen()->constructor();
+  Handle<Map> initial_map(constructor->initial_map());
+  int size = initial_map->instance_size() + instr->hydrogen()->folded_size();
+
+  // TODO(3095996): Get rid of this. For now, we need to make the
+  // result register contain a valid pointer because it is already
+  // contained in the register pointer map.
+  __ Set(result, 0);
+
+  PushSafepointRegistersScope scope(this);
+  __ Push(Smi::FromInt(size));
+  CallRuntimeFromDeferred(Runtime::kAllocateInNewSpace, 1, instr);
+  __ StoreToSafepointRegisterSlot(result, rax);
+}
+
+
+void LCodeGen::DoInnerAllocateObject(LInnerAllocateObject* instr) {
+  Register result = ToRegister(instr->result());
+  Register base = ToRegister(instr->base());
+  Register scratch = ToRegister(instr->temp());
+  __ lea(result, Operand(base, instr->hydrogen()->folding_offset()));
+  EmitInitializeObject(instr->hydrogen(), result, scratch);
+}
+
+
+void LCodeGen::EmitInitializeObject(HAllocateObject* allocation,
+                                    Register result,
+                                    Register scratch) {
+  Handle<JSFunction> constructor = allocation->constructor();
+  Handle<Map> initial_map(constructor->initial_map());
+  int instance_size = initial_map->instance_size();
+
   // Load the initial map.
   Register map = scratch;
   __ LoadHeapObject(scratch, constructor);
@@ -4637,24 +4704,25 @@ void LCodeGen::DoAllocateObject(LAllocateObject* instr) {
       __ movq(FieldOperand(result, property_offset), scratch);
     }
   }
-}
-
 
-void LCodeGen::DoDeferredAllocateObject(LAllocateObject* instr) {
-  Register result = ToRegister(instr->result());
-  Handle<JSFunction> constructor = instr->hydrogen()->constructor();
-  Handle<Map> initial_map(constructor->initial_map());
-  int instance_size = initial_map->instance_size();
+  if (allocation->folded_size() != 0) {
+    EmitFreeSpaceFiller(result, instance_size, allocation->folded_size(),
+                        scratch);
+  }
+}
 
-  // TODO(3095996): Get rid of this. For now, we need to make the
-  // result register contain a valid pointer because it is already
-  // contained in the register pointer map.
-  __ Set(result, 0);
 
-  PushSafepointRegistersScope scope(this);
-  __ Push(Smi::FromInt(instance_size));
-  CallRuntimeFromDeferred(Runtime::kAllocateInNewSpace, 1, instr);
-  __ StoreToSafepointRegisterSlot(result, rax);
+void LCodeGen::EmitFreeSpaceFiller(Register object,
+                                   int offset,
+                                   int size,
+                                   Register scratch) {
+  // Smaller fillers would need the one and two pointer filler maps, but
+  // every folded allocation is at least as big as a JSObject header.
+  ASSERT(size > 2 * kPointerSize);
+  __ LoadRoot(scratch, Heap::kFreeSpaceMapRootIndex);
+  __ movq(FieldOperand(object, offset), scratch);
+  __ Move(FieldOperand(object, offset + FreeSpace::kSizeOffset),
+          Smi::FromInt(size));
 }
 
 
@@ -4807,17 +4875,17 @@ void LCodeGen::EmitDeepCopy(Handle<JSObject> object,
 }
 
 
-void LCodeGen::DoFastLiteral(LFastLiteral* instr) {
-  int size = instr->hydrogen()->total_size();
+void LCodeGen::EmitFastLiteralElementsKindCheck(HFastLiteral* literal,
+                                                LEnvironment* environment) {
   ElementsKind boilerplate_elements_kind =
-      instr->hydrogen()->boilerplate()->GetElementsKind();
+      literal->boilerplate()->GetElementsKind();
 
   // Deopt if the array literal boilerplate ElementsKind is of a type different
   // than the expected one. The check isn't necessary if the boilerplate has
   // already been converted to TERMINAL_FAST_ELEMENTS_KIND.
   if (CanTransitionToMoreGeneralFastElementsKind(
           boilerplate_elements_kind, true)) {
-    __ LoadHeapObject(rbx, instr->hydrogen()->boilerplate());
+    __ LoadHeapObject(rbx, literal->boilerplate());
     __ movq(rcx, FieldOperand(rbx, HeapObject::kMapOffset));
     // Load the map's "bit field 2".
     __ movb(rcx, FieldOperand(rcx, Map::kBitField2Offset));
@@ -4825,17 +4893,25 @@ void LCodeGen::DoFastLiteral(LFastLiteral* instr) {
     __ and_(rcx, Immediate(Map::kElementsKindMask));
     __ cmpb(rcx, Immediate(boilerplate_elements_kind <<
                            Map::kElementsKindShift));
-    DeoptimizeIf(not_equal, instr->environment());
+    DeoptimizeIf(not_equal, environment);
   }
+}
 
-  // Allocate all objects that are part of the literal in one big
-  // allocation. This avoids multiple limit checks.
+
+void LCodeGen::DoFastLiteral(LFastLiteral* instr) {
+  int size = instr->hydrogen()->total_size();
+  int folded_size = instr->hydrogen()->folded_size();
+  EmitFastLiteralElementsKindCheck(instr->hydrogen(), instr->environment());
+
+  // Allocate all objects that are part of the literal, and the allocations
+  // folded into it, in one big allocation. This avoids multiple limit checks.
   Label allocated, runtime_allocate;
-  __ AllocateInNewSpace(size, rax, rcx, rdx, &runtime_allocate, TAG_OBJECT);
+  __ AllocateInNewSpace(size + folded_size, rax, rcx, rdx, &runtime_allocate,
+                        TAG_OBJECT);
   __ jmp(&allocated);
 
   __ bind(&runtime_allocate);
-  __ Push(Smi::FromInt(size));
+  __ Push(Smi::FromInt(size + folded_size));
   CallRuntime(Runtime::kAllocateInNewSpace, 1, instr);
 
   __ bind(&allocated);
@@ -4843,6 +4919,26 @@ void LCodeGen::DoFastLiteral(LFastLiteral* instr) {
   __ LoadHeapObject(rbx, instr->hydrogen()->boilerplate());
   EmitDeepCopy(instr->hydrogen()->boilerplate(), rax, rbx, &offset);
   ASSERT_EQ(size, offset);
+  if (folded_size != 0) EmitFreeSpaceFiller(rax, size, folded_size, rcx);
+}
+
+
+void LCodeGen::DoInnerFastLiteral(LInnerFastLiteral* instr) {
+  Register base = ToRegister(instr->base());
+  ASSERT(base.is(rdx));
+  ASSERT(ToRegister(instr->result()).is(rax));
+  int size = instr->hydrogen()->total_size();
+  int folded_size = instr->hydrogen()->folded_size();
+  int folding_offset = instr->hydrogen()->folding_offset();
+  EmitFastLiteralElementsKindCheck(instr->hydrogen(), instr->environment());
+
+  // The memory for the literal has been reserved by the allocation base.
+  int offset = folding_offset;
+  __ LoadHeapObject(rbx, instr->hydrogen()->boilerplate());
+  EmitDeepCopy(instr->hydrogen()->boilerplate(), base, rbx, &offset);
+  ASSERT_EQ(folding_offset + size, offset);
+  __ lea(rax, Operand(base, folding_offset));
+  if (folded_size != 0) EmitFreeSpaceFiller(rax, size, folded_size, rcx);
 }
 
 
@@ -105,6 +105,8 @@ class LCodeGen;
   V(HasCachedArrayIndexAndBranch)               \
   V(HasInstanceTypeAndBranch)                   \
   V(In)                                         \
+  V(InnerAllocateObject)                        \
+  V(InnerFastLiteral)                           \
   V(InstanceOf)                                 \
   V(InstanceOfKnownGlobal)                      \
   V(InstructionGap)                             \
@@ -2202,6 +2204,21 @@ class LAllocateObject: public LTemplateInstruction<1, 0, 1> {
 };
 
 
+class LInnerAllocateObject: public LTemplateInstruction<1, 1, 1> {
+ public:
+  LInnerAllocateObject(LOperand* base, LOperand* temp) {
+    inputs_[0] = base;
+    temps_[0] = temp;
+  }
+
+  LOperand* base() { return inputs_[0]; }
+  LOperand* temp() { return temps_[0]; }
+
+  DECLARE_CONCRETE_INSTRUCTION(InnerAllocateObject, "inner-allocate-object")
+  DECLARE_HYDROGEN_ACCESSOR(AllocateObject)
+};
+
+
 class LFastLiteral: public LTemplateInstruction<1, 0, 0> {
  public:
   DECLARE_CONCRETE_INSTRUCTION(FastLiteral, "fast-literal")
@@ -2209,6 +2226,21 @@ class LFastLiteral: public LTemplateInstruction<1, 0, 0> {
 };
 
 
+class LInnerFastLiteral: public LTemplateInstruction<1, 1, 2> {
+ public:
+  LInnerFastLiteral(LOperand* base, LOperand* temp1, LOperand* temp2) {
+    inputs_[0] = base;
+    temps_[0] = temp1;
+    temps_[1] = temp2;
+  }
+
+  LOperand* base() { return inputs_[0]; }
+
+  DECLARE_CONCRETE_INSTRUCTION(InnerFastLiteral, "inner-fast-literal")
+  DECLARE_HYDROGEN_ACCESSOR(FastLiteral)
+};
+
+
 class LArrayLiteral: public LTemplateInstruction<1, 0, 0> {
  public:
   DECLARE_CONCRETE_INSTRUCTION(ArrayLiteral, "array-literal")
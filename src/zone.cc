@@ -87,7 +87,11 @@ ZoneScope::~ZoneScope() {
 // Creates a new segment, sets it size, and pushes it to the front
 // of the segment chain. Returns the new segment.
 Segment* Zone::NewSegment(int size) {
-  Segment* result = reinterpret_cast<Segment*>(Malloced::New(size));
+  Segment* result =
+      reinterpret_cast<Segment*>(isolate_->zone_segment_pool()->Allocate(size));
+  if (result == NULL) {
+    result = reinterpret_cast<Segment*>(Malloced::New(size));
+  }
   adjust_segment_bytes_allocated(size);
   if (result != NULL) {
     result->Initialize(segment_head_, size);
@@ -100,7 +104,9 @@ Segment* Zone::NewSegment(int size) {
 // Deletes the given segment. Does not touch the segment chain.
 void Zone::DeleteSegment(Segment* segment, int size) {
   adjust_segment_bytes_allocated(-size);
-  Malloced::Delete(segment);
+  if (!isolate_->zone_segment_pool()->Free(segment, size)) {
+    Malloced::Delete(segment);
+  }
 }
 
 
@@ -196,6 +202,9 @@ Address Zone::NewExpand(int size) {
     // requested size.
     new_size = Max(kSegmentOverhead + size, kMaximumSegmentSize);
   }
+  if (new_size <= kMaximumSegmentSize && ZoneSegmentPool::enabled()) {
+    new_size = ZoneSegmentPool::SizeClassFor(kSegmentOverhead + size, old_size);
+  }
   Segment* segment = NewSegment(new_size);
   if (segment == NULL) {
     V8::FatalProcessOutOfMemory("Zone");
@@ -216,4 +225,96 @@ Address Zone::NewExpand(int size) {
 }
 
 
+ZoneSegmentPool::ZoneSegmentPool(Isolate* isolate)
+    : isolate_(isolate),
+      mutex_(OS::CreateMutex()),
+      pooled_bytes_(0),
+      hits_(0),
+      misses_(0) {
+  for (int i = 0; i < kNumberOfSizeClasses; i++) free_lists_[i] = NULL;
+}
+
+
+ZoneSegmentPool::~ZoneSegmentPool() {
+  Clear();
+  delete mutex_;
+}
+
+
+bool ZoneSegmentPool::enabled() {
+  return FLAG_zone_segment_pool_size > 0;
+}
+
+
+int ZoneSegmentPool::SizeClassFor(int size, int old_size) {
+  ASSERT(size <= Zone::kMaximumSegmentSize);
+  int size_class = Zone::kMinimumSegmentSize;
+  while (size_class < Zone::kMaximumSegmentSize &&
+         (size_class < size || size_class <= old_size)) {
+    size_class <<= 1;
+  }
+  return size_class;
+}
+
+
+int ZoneSegmentPool::SizeClassIndex(int size) {
+  STATIC_ASSERT(Zone::kMinimumSegmentSize << (kNumberOfSizeClasses - 1) ==
+                Zone::kMaximumSegmentSize);
+  if (size < Zone::kMinimumSegmentSize ||
+      size > Zone::kMaximumSegmentSize ||
+      !IsPowerOf2(size)) {
+    return -1;
+  }
+  return WhichPowerOf2(size) - WhichPowerOf2(Zone::kMinimumSegmentSize);
+}
+
+
+void* ZoneSegmentPool::Allocate(int size) {
+  int index = SizeClassIndex(size);
+  if (index < 0 || !enabled()) return NULL;
+  ScopedLock lock(mutex_);
+  Counters* counters = isolate_->counters();
+  Segment* segment = free_lists_[index];
+  if (segment == NULL) {
+    misses_++;
+    counters->zone_segment_pool_misses()->Increment();
+    return NULL;
+  }
+  free_lists_[index] = segment->next();
+  pooled_bytes_ -= size;
+  hits_++;
+  counters->zone_segment_pool_hits()->Increment();
+  counters->zone_segment_pool_bytes()->Set(pooled_bytes_);
+  return segment;
+}
+
+
+bool ZoneSegmentPool::Free(void* segment, int size) {
+  int index = SizeClassIndex(size);
+  if (index < 0 || !enabled()) return false;
+  ScopedLock lock(mutex_);
+  if (pooled_bytes_ + size > FLAG_zone_segment_pool_size * KB) return false;
+  Segment* free_segment = reinterpret_cast<Segment*>(segment);
+  free_segment->Initialize(free_lists_[index], size);
+  free_lists_[index] = free_segment;
+  pooled_bytes_ += size;
+  isolate_->counters()->zone_segment_pool_bytes()->Set(pooled_bytes_);
+  return true;
+}
+
+
+void ZoneSegmentPool::Clear() {
+  ScopedLock lock(mutex_);
+  for (int i = 0; i < kNumberOfSizeClasses; i++) {
+    Segment* segment = free_lists_[i];
+    while (segment != NULL) {
+      Segment* next = segment->next();
+      Malloced::Delete(segment);
+      segment = next;
+    }
+    free_lists_[i] = NULL;
+  }
+  pooled_bytes_ = 0;
+}
+
 } }  // namespace v8::internal
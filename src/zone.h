@@ -48,6 +48,7 @@ enum ZoneScopeMode {
 
 class Segment;
 class Isolate;
+class Mutex;
 
 // The Zone supports very fast allocation of small chunks of
 // memory. The chunks cannot be deallocated individually, but instead
@@ -93,6 +94,7 @@ class Zone {
  private:
   friend class Isolate;
   friend class ZoneScope;
+  friend class ZoneSegmentPool;
 
   // All pointers returned from New() have this alignment.  In addition, if the
   // object being allocated has a size that is divisible by 8 then its alignment
@@ -142,6 +144,59 @@ class Zone {
 };
 
 
+// A pool of free zone segments shared by all zones of an isolate, so that
+// zones that are created and deleted over and over again (parser, Hydrogen,
+// Lithium, irregexp) do not have to go through malloc() and free() for
+// each of their segments.  Segments are pooled in power-of-two size classes
+// between the minimum and the maximum segment size, and the pool holds at
+// most --zone-segment-pool-size kBytes.  The pool is thread-safe, because
+// the zones of the parallel recompilation thread use it too.
+class ZoneSegmentPool {
+ public:
+  explicit ZoneSegmentPool(Isolate* isolate);
+  ~ZoneSegmentPool();
+
+  // Whether zones should allocate their segments in the size classes of
+  // the pool.
+  static bool enabled();
+
+  // Returns the smallest size class that is larger than 'old_size' and
+  // can hold 'size' bytes.  The size must not be larger than the maximum
+  // segment size.
+  static int SizeClassFor(int size, int old_size);
+
+  // Returns a free segment of 'size' bytes, or NULL if the pool has none.
+  void* Allocate(int size);
+
+  // Takes a segment of 'size' bytes into the pool.  Returns false if the
+  // segment is not of a size class or the pool is full, in which case the
+  // caller still owns the segment.
+  bool Free(void* segment, int size);
+
+  // Releases all pooled segments.
+  void Clear();
+
+  int pooled_bytes() const { return pooled_bytes_; }
+  int hits() const { return hits_; }
+  int misses() const { return misses_; }
+
+  static const int kNumberOfSizeClasses = 8;
+
+ private:
+  // Returns the index of the size class of exactly 'size' bytes, or -1.
+  static int SizeClassIndex(int size);
+
+  Isolate* isolate_;
+  Mutex* mutex_;
+  Segment* free_lists_[kNumberOfSizeClasses];
+  int pooled_bytes_;
+  int hits_;
+  int misses_;
+
+  DISALLOW_COPY_AND_ASSIGN(ZoneSegmentPool);
+};
+
+
 // ZoneObject is an abstraction that helps define classes of objects
 // allocated in the Zone. Use it as a base class; see ast.h.
 class ZoneObject {
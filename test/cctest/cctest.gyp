@@ -73,6 +73,7 @@
         'test-hashmap.cc',
         'test-heap.cc',
         'test-heap-profiler.cc',
+        'test-json.cc',
         'test-list.cc',
         'test-liveedit.cc',
         'test-lock.cc',
@@ -95,7 +96,8 @@
         'test-unbound-queue.cc',
         'test-utils.cc',
         'test-version.cc',
-        'test-weakmaps.cc'
+        'test-weakmaps.cc',
+        'test-zone.cc'
       ],
       'conditions': [
         ['v8_target_arch=="ia32"', {
@@ -35,6 +35,7 @@
 #include "disassembler.h"
 #include "execution.h"
 #include "factory.h"
+#include "optimizing-compiler-thread.h"
 #include "platform.h"
 #include "cctest.h"
 
@@ -431,3 +432,33 @@ TEST(SplitConstantsInFullCompiler) {
   CheckCodeForUnsafeLiteral(GetJSFunction(env->Global(), "f"));
 }
 #endif
+
+
+TEST(RecompilationQueueOrder) {
+  // Only the ordering is tested, so the compilers are just tags.
+  OptimizingCompiler* a = reinterpret_cast<OptimizingCompiler*>(0x10);
+  OptimizingCompiler* b = reinterpret_cast<OptimizingCompiler*>(0x20);
+  OptimizingCompiler* c = reinterpret_cast<OptimizingCompiler*>(0x30);
+  OptimizingCompiler* d = reinterpret_cast<OptimizingCompiler*>(0x40);
+  OptimizingCompiler* e = reinterpret_cast<OptimizingCompiler*>(0x50);
+
+  RecompilationQueue queue;
+  CHECK(queue.IsEmpty());
+  queue.Enqueue(a, 2, 100, 0);
+  queue.Enqueue(b, 5, 500, 0);
+  queue.Enqueue(c, 5, 50, 0);
+  queue.Enqueue(d, 2, 100, 0);
+  queue.Enqueue(e, 9, 1000, 0);
+  CHECK_EQ(5, queue.length());
+
+  // Hotter functions first, then smaller ones, then in queueing order.
+  OptimizingCompiler* expected[] = { e, c, b, a, d };
+  for (int i = 0; i < 5; i++) {
+    RecompilationQueue::Job job;
+    CHECK(queue.Dequeue(&job));
+    CHECK_EQ(expected[i], job.compiler);
+  }
+  CHECK(queue.IsEmpty());
+  RecompilationQueue::Job job;
+  CHECK(!queue.Dequeue(&job));
+}
@@ -397,3 +397,28 @@ TEST(DeleteCpuProfileDifferentTokens) {
   CHECK_EQ(0, CpuProfiler::GetProfilesCount());
   CHECK_EQ(NULL, v8::CpuProfiler::FindProfile(uid3));
 }
+
+
+TEST(RecordSamplesWithSamplingInterval) {
+  // The ticker picks up the interval when the VM sets up its logger.
+  i::FLAG_prof_sampling_interval = 250;
+  InitializeVM();
+  TestSetup test_setup;
+  v8::HandleScope scope;
+
+  CpuProfiler::StartProfiling("sampled", true);
+  CompileRun(
+      "var start = Date.now(), n = 0;\n"
+      "while (Date.now() - start < 200) ++n;\n");
+  CpuProfile* profile = CpuProfiler::StopProfiling("sampled");
+  CHECK_NE(NULL, profile);
+
+  CHECK_GT(profile->samples_count(), 0);
+  for (int i = 0; i < profile->samples_count(); ++i) {
+    CHECK_NE(NULL, profile->sample(i));
+    if (i > 0) {
+      CHECK(profile->sample_timestamp(i - 1) <=
+            profile->sample_timestamp(i));
+    }
+  }
+}
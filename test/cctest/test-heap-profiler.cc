@@ -639,6 +639,79 @@ TEST(HeapSnapshotJSONSerializationAborting) {
   CHECK_EQ(0, stream.eos_signaled());
 }
 
+TEST(HeapSnapshotStreaming) {
+  v8::HandleScope scope;
+  LocalContext env;
+  CompileRun(
+      "function A(s) { this.s = s; }\n"
+      "function B(x) { this.x = x; }\n"
+      "var a = new A('streamed');\n"
+      "var b = new B(a);");
+  TestJSONStream stream;
+  CHECK(v8::HeapProfiler::TakeStreamingSnapshot(v8_str("streaming"),
+                                                &stream));
+  CHECK_GT(stream.size(), 0);
+  CHECK_EQ(1, stream.eos_signaled());
+  // The snapshot is not retained.
+  CHECK_EQ(0, v8::HeapProfiler::GetSnapshotsCount());
+  i::ScopedVector<char> json(stream.size());
+  stream.WriteTo(json);
+
+  // Verify that snapshot string is valid JSON.
+  AsciiResource json_res(json);
+  v8::Local<v8::String> json_string = v8::String::NewExternal(&json_res);
+  env->Global()->Set(v8_str("json_snapshot"), json_string);
+  v8::Local<v8::Value> snapshot_parse_result = CompileRun(
+      "var parsed = JSON.parse(json_snapshot); true;");
+  CHECK(!snapshot_parse_result.IsEmpty());
+
+  // Every node is streamed once and every edge connects streamed nodes.
+  v8::Local<v8::Value> consistency_result = CompileRun(
+      "var meta = parsed.snapshot.meta;\n"
+      "var node_fields_count = meta.node_fields.length;\n"
+      "var edge_fields_count = meta.edge_fields.length;\n"
+      "var node_id_offset = meta.node_fields.indexOf('id');\n"
+      "var node_name_offset = meta.node_fields.indexOf('name');\n"
+      "var edge_type_offset = meta.edge_fields.indexOf('type');\n"
+      "var edge_name_offset = meta.edge_fields.indexOf('name_or_index');\n"
+      "var edge_from_offset = meta.edge_fields.indexOf('from_node');\n"
+      "var edge_to_offset = meta.edge_fields.indexOf('to_node');\n"
+      "var property_type ="
+      "    meta.edge_types[edge_type_offset].indexOf('property');\n"
+      "var names = {};\n"
+      "var consistent ="
+      "    parsed.node_count * node_fields_count === parsed.nodes.length &&"
+      "    parsed.edge_count * edge_fields_count === parsed.edges.length;\n"
+      "for (var i = 0; i < parsed.nodes.length; i += node_fields_count) {\n"
+      "  var id = parsed.nodes[i + node_id_offset];\n"
+      "  if (id in names) consistent = false;\n"
+      "  names[id] = parsed.strings[parsed.nodes[i + node_name_offset]];\n"
+      "}\n"
+      "var found_b_x_a = false;\n"
+      "for (var i = 0; i < parsed.edges.length; i += edge_fields_count) {\n"
+      "  var from = parsed.edges[i + edge_from_offset];\n"
+      "  var to = parsed.edges[i + edge_to_offset];\n"
+      "  if (!(from in names) || !(to in names)) consistent = false;\n"
+      "  if (parsed.edges[i + edge_type_offset] === property_type &&\n"
+      "      parsed.strings[parsed.edges[i + edge_name_offset]] === 'x' &&\n"
+      "      names[from] === 'B' && names[to] === 'A') {\n"
+      "    found_b_x_a = true;\n"
+      "  }\n"
+      "}\n"
+      "consistent && found_b_x_a;");
+  CHECK(consistency_result->BooleanValue());
+}
+
+
+TEST(HeapSnapshotStreamingAborting) {
+  v8::HandleScope scope;
+  LocalContext env;
+  TestJSONStream stream(5);
+  CHECK(!v8::HeapProfiler::TakeStreamingSnapshot(v8_str("abort"), &stream));
+  CHECK_GT(stream.size(), 0);
+  CHECK_EQ(0, stream.eos_signaled());
+}
+
 namespace {
 
 class TestStatsStream : public v8::OutputStream {
@@ -1681,3 +1754,68 @@ TEST(MapHasDescriptorsAndTransitions) {
       map, v8::HeapGraphEdge::kInternal, "transitions");
   CHECK_EQ(NULL, own_transitions);
 }
+
+
+static const v8::AllocationProfileNode* FindAllocationSite(
+    const v8::AllocationProfileNode* node, const char* name) {
+  v8::String::AsciiValue node_name(node->GetFunctionName());
+  if (strcmp(name, *node_name) == 0) return node;
+  for (int i = 0; i < node->GetChildrenCount(); ++i) {
+    const v8::AllocationProfileNode* site =
+        FindAllocationSite(node->GetChild(i), name);
+    if (site != NULL) return site;
+  }
+  return NULL;
+}
+
+
+TEST(AllocationSampling) {
+  v8::HandleScope scope;
+  LocalContext env;
+
+  CHECK_EQ(NULL, v8::HeapProfiler::GetAllocationProfile());
+  v8::HeapProfiler::StartAllocationSampling(1024);
+  // The next kilobyte of new space allocation already reaches the sampler.
+  i::NewSpace* new_space = HEAP->new_space();
+  CHECK_LE(*new_space->allocation_limit_address() -
+               *new_space->allocation_top_address(),
+           1024);
+  CompileRun(
+      "function allocateGarbage() {\n"
+      "  for (var i = 0; i < 10000; ++i) var a = [i, i];\n"
+      "}\n"
+      "var retained = [];\n"
+      "function allocateRetained() {\n"
+      "  for (var i = 0; i < 10000; ++i) retained.push({ x: i });\n"
+      "}\n"
+      "allocateGarbage();\n"
+      "allocateRetained();\n");
+  const v8::AllocationProfileNode* root =
+      v8::HeapProfiler::GetAllocationProfile();
+  CHECK_NE(NULL, root);
+  const v8::AllocationProfileNode* garbage =
+      FindAllocationSite(root, "allocateGarbage");
+  CHECK_NE(NULL, garbage);
+  const v8::AllocationProfileNode* retained =
+      FindAllocationSite(root, "allocateRetained");
+  CHECK_NE(NULL, retained);
+  CHECK_EQ(1, garbage->GetLineNumber());
+  CHECK_EQ(5, retained->GetLineNumber());
+  CHECK_GT(garbage->GetSamplesCount(), 0);
+  CHECK_GT(retained->GetSamplesCount(), 0);
+  CHECK_GE(root->GetTotalAllocatedSize(),
+           garbage->GetTotalAllocatedSize() +
+           retained->GetTotalAllocatedSize());
+  // Scavenges while the functions run may already have collected some of
+  // the sampled garbage.
+  CHECK_LE(garbage->GetSelfLiveSize(), garbage->GetSelfAllocatedSize());
+  CHECK_LE(retained->GetSelfLiveSize(), retained->GetSelfAllocatedSize());
+
+  HEAP->CollectAllGarbage(i::Heap::kNoGCFlags);
+  CHECK_LT(garbage->GetSelfLiveSize(), garbage->GetSelfAllocatedSize());
+  CHECK_GT(retained->GetSelfLiveSize(), 0);
+  CHECK_LE(root->GetTotalLiveSize(), root->GetTotalAllocatedSize());
+
+  v8::HeapProfiler::StopAllocationSampling();
+  CHECK_EQ(NULL, v8::HeapProfiler::GetAllocationProfile());
+}
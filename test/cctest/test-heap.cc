@@ -1207,6 +1207,10 @@ TEST(TestSizeOfObjects) {
   HEAP->CollectAllGarbage(Heap::kNoGCFlags);
   HEAP->CollectAllGarbage(Heap::kNoGCFlags);
   HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  MarkCompactCollector* collector = HEAP->mark_compact_collector();
+  if (collector->IsConcurrentSweepingInProgress()) {
+    collector->WaitUntilSweepingCompleted();
+  }
   CHECK(HEAP->old_pointer_space()->IsSweepingComplete());
   int initial_size = static_cast<int>(HEAP->SizeOfObjects());
 
@@ -1238,6 +1242,141 @@ TEST(TestSizeOfObjects) {
 }
 
 
+// Walks the objects of the pages of a space that was swept conservatively,
+// which the heap iterators refuse to do.  Conservative sweeping leaves dead
+// objects in place and writes free-space objects over the memory it
+// reclaims, so the pages still parse.  Counts the live and dead test arrays
+// (told apart by the marker in their first element) and the free-space
+// bytes found outside the linear allocation area.
+static void WalkSweptPages(PagedSpace* space,
+                           int length,
+                           Smi* live_marker,
+                           Smi* dead_marker,
+                           int* live_arrays,
+                           int* dead_arrays,
+                           intptr_t* free_bytes) {
+  *live_arrays = 0;
+  *dead_arrays = 0;
+  *free_bytes = 0;
+  PageIterator it(space);
+  while (it.has_next()) {
+    Page* p = it.next();
+    Address current = p->area_start();
+    while (current < p->area_end()) {
+      if (current == space->top() && current != space->limit()) {
+        current = space->limit();
+        continue;
+      }
+      HeapObject* object = HeapObject::FromAddress(current);
+      int size = object->Size();
+      CHECK_GT(size, 0);
+      if (object->IsFiller()) {
+        *free_bytes += size;
+      } else if (object->IsFixedArray() &&
+                 FixedArray::cast(object)->length() == length) {
+        Object* marker = FixedArray::cast(object)->get(0);
+        if (marker == live_marker) ++*live_arrays;
+        if (marker == dead_marker) ++*dead_arrays;
+      }
+      current += size;
+    }
+    CHECK_EQ(p->area_end(), current);
+  }
+}
+
+
+TEST(ConcurrentSweeping) {
+  i::FLAG_concurrent_sweeping = true;
+  i::FLAG_sweeper_threads = 2;
+  // Keep the sweeping conservative and the pages in place.
+  i::FLAG_expose_gc = false;
+  i::FLAG_never_compact = true;
+  InitializeVM();
+  MarkCompactCollector* collector = HEAP->mark_compact_collector();
+  CHECK(collector->AreSweeperThreadsActivated());
+  PagedSpace* space = HEAP->old_pointer_space();
+
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  if (collector->IsConcurrentSweepingInProgress()) {
+    collector->WaitUntilSweepingCompleted();
+  }
+  CHECK(space->IsSweepingComplete());
+  int initial_size = static_cast<int>(HEAP->SizeOfObjects());
+
+  v8::HandleScope scope;
+  const int kSurvivors = 2000;
+  const int kLength = 100;
+  Smi* live_marker = Smi::FromInt(0x11fe);
+  Smi* dead_marker = Smi::FromInt(0xdead);
+  int array_size = FixedArray::SizeFor(kLength);
+  Handle<FixedArray> survivors = FACTORY->NewFixedArray(kSurvivors, TENURED);
+  {
+    // Interleave surviving and dead arrays over several old-space pages so
+    // that every page ends up fragmented and is handed to the sweepers.
+    v8::HandleScope inner_scope;
+    AlwaysAllocateScope always_allocate;
+    for (int i = 0; i < 2 * kSurvivors; i++) {
+      Handle<FixedArray> array = FACTORY->NewFixedArray(kLength, TENURED);
+      if (i % 2 == 0) {
+        array->set(0, live_marker);
+        survivors->set(i / 2, *array);
+      } else {
+        array->set(0, dead_marker);
+      }
+    }
+  }
+
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  CHECK(collector->IsConcurrentSweepingInProgress());
+  collector->WaitUntilSweepingCompleted();
+  CHECK(!collector->IsConcurrentSweepingInProgress());
+  CHECK(space->IsSweepingComplete());
+
+  // Every free list the sweepers filled must have been merged into the
+  // space's free list and accounted for exactly once.
+#ifdef DEBUG
+  CHECK_EQ(static_cast<int>(space->free_list()->SumFreeLists()),
+           static_cast<int>(space->free_list()->available()));
+#endif
+  intptr_t listed_bytes = 0;
+  PageIterator it(space);
+  while (it.has_next()) {
+    FreeList::SizeStats sizes;
+    space->CountFreeListItems(it.next(), &sizes);
+    listed_bytes += sizes.Total();
+  }
+  CHECK_EQ(static_cast<int>(space->Available()),
+           static_cast<int>(listed_bytes));
+
+  // The memory on the free list must be free space on the pages, and every
+  // dead array must have been reclaimed, since each leaves a gap that is
+  // too large for the sweepers to ignore.
+  int live_arrays, dead_arrays;
+  intptr_t free_bytes;
+  WalkSweptPages(space, kLength, live_marker, dead_marker,
+                 &live_arrays, &dead_arrays, &free_bytes);
+  CHECK_EQ(kSurvivors, live_arrays);
+  CHECK_EQ(0, dead_arrays);
+  CHECK_LE(static_cast<int>(listed_bytes), static_cast<int>(free_bytes));
+  CHECK_GE(static_cast<int>(listed_bytes), kSurvivors * array_size / 2);
+  CHECK_EQ(initial_size + survivors->Size() + kSurvivors * array_size,
+           static_cast<int>(HEAP->SizeOfObjects()));
+  CHECK_LE(space->Size() + space->Available() + space->Waste(),
+           space->Capacity());
+
+  // The reclaimed holes must be reusable without growing the space.
+  intptr_t capacity = space->Capacity();
+  {
+    AlwaysAllocateScope always_allocate;
+    for (int i = 0; i < kSurvivors / 2; i++) {
+      HEAP->AllocateFixedArray(kLength, TENURED)->ToObjectChecked();
+    }
+  }
+  CHECK_EQ(static_cast<int>(capacity), static_cast<int>(space->Capacity()));
+}
+
+
 TEST(TestSizeOfObjectsVsHeapIteratorPrecision) {
   InitializeVM();
   HEAP->EnsureHeapIsIterable();
@@ -2311,3 +2450,52 @@ TEST(Regression144230) {
   USE(global->SetProperty(*name, *call_function, NONE, kNonStrictMode));
   CompileRun("call();");
 }
+
+
+TEST(ParallelScavenge) {
+  FLAG_parallel_scavenge = true;
+  FLAG_scavenger_threads = 3;
+  InitializeVM();
+  CHECK(ISOLATE->scavenger_threads() != NULL);
+  v8::HandleScope scope;
+
+  CompileRun("var root = [];"
+             "for (var i = 0; i < 5000; i++) {"
+             "  root.push({ index: i, name: 'o' + i, values: [i + 0.5],"
+             "              children: [i, [i, i + 1]] });"
+             "}"
+             "for (var i = 0; i < root.length; i++) {"
+             "  root[i].next = root[(i * 7) % root.length];"
+             "}");
+  CHECK(!HEAP->incremental_marking()->IsMarking());
+
+  // The first scavenge copies the graph within new space, the second one
+  // promotes it.
+  HEAP->CollectGarbage(NEW_SPACE);
+  HEAP->CollectGarbage(NEW_SPACE);
+  Handle<Object> root =
+      v8::Utils::OpenHandle(*env->Global()->Get(v8_str("root")));
+  CHECK(!HEAP->InNewSpace(*root));
+
+  // Pointers from the promoted graph to new objects go through the store
+  // buffer.
+  CompileRun("for (var i = 0; i < root.length; i++) {"
+             "  root[i].fresh = { index: i, name: 'f' + i };"
+             "}");
+  HEAP->CollectGarbage(NEW_SPACE);
+
+  v8::Handle<v8::Value> result =
+      CompileRun("var ok = true;"
+                 "for (var i = 0; i < root.length; i++) {"
+                 "  var o = root[i];"
+                 "  ok = ok && o.index == i && o.name == 'o' + i &&"
+                 "       o.values[0] == i + 0.5 &&"
+                 "       o.children[1][1] == i + 1 &&"
+                 "       o.next.index == (i * 7) % root.length &&"
+                 "       o.fresh.index == i && o.fresh.name == 'f' + i;"
+                 "}"
+                 "ok;");
+  CHECK(result->IsTrue());
+  HEAP->CollectAllGarbage(Heap::kMakeHeapIterableMask);
+  CHECK(CompileRun("root[4999].fresh.name")->Equals(v8_str("f4999")));
+}
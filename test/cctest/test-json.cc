@@ -0,0 +1,128 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "v8.h"
+
+#include "cctest.h"
+#include "json-parser.h"
+
+using namespace v8::internal;
+
+
+static int ScanJsonStringCharactersSlow(const char* chars,
+                                        int start,
+                                        int end) {
+  for (int i = start; i < end; i++) {
+    if (chars[i] == '"' || chars[i] == '\\' || chars[i] < 0x20) return i;
+  }
+  return end;
+}
+
+
+TEST(ScanJsonStringCharacters) {
+  static const int kLength = 80;
+  static const char kSpecials[] = { '"', '\\', '\0', '\n', 0x1f };
+  char chars[kLength];
+  for (int i = 0; i < kLength; i++) chars[i] = 'a' + i % 26;
+  CHECK_EQ(kLength, ScanJsonStringCharacters(chars, 0, kLength));
+  for (size_t s = 0; s < ARRAY_SIZE(kSpecials); s++) {
+    for (int position = 0; position < kLength; position++) {
+      char saved = chars[position];
+      chars[position] = kSpecials[s];
+      for (int start = 0; start < kLength; start += 7) {
+        for (int end = start; end <= kLength; end += 5) {
+          CHECK_EQ(ScanJsonStringCharactersSlow(chars, start, end),
+                   ScanJsonStringCharacters(chars, start, end));
+        }
+      }
+      chars[position] = saved;
+    }
+  }
+  // Space and DEL are copied unchanged.
+  chars[3] = ' ';
+  chars[40] = 0x7f;
+  CHECK_EQ(kLength, ScanJsonStringCharacters(chars, 0, kLength));
+}
+
+
+static v8::Local<v8::Value> ParseJson(v8::Handle<v8::String> payload) {
+  v8::Local<v8::Object> json =
+      v8::Context::GetCurrent()->Global()->Get(v8_str("JSON")).As<v8::Object>();
+  v8::Local<v8::Function> parse =
+      json->Get(v8_str("parse")).As<v8::Function>();
+  v8::Handle<v8::Value> args[] = { payload };
+  v8::Local<v8::Value> result = parse->Call(json, 1, args);
+  CHECK(!result.IsEmpty());
+  return result;
+}
+
+
+// Parses a large payload with the block scanning and with the character by
+// character scanning, and checks that both produce the original values.
+// This only checks correctness; no throughput is measured.
+TEST(JsonParseLargePayload) {
+  v8::HandleScope scope;
+  LocalContext context;
+  v8::Local<v8::String> payload = CompileRun(
+      "var text = '';"
+      "for (var i = 0; i < 4; i++) {"
+      "  text += 'Lorem ipsum dolor sit amet, consectetur adipiscing elit, ';"
+      "}"
+      "var items = [];"
+      "for (var i = 0; i < 4000; i++) {"
+      "  items.push({ id: i, name: 'item' + i, text: text + i,"
+      "               escaped: 'tab\\there, quote \\\"' + text + '\\\"',"
+      "               tags: ['alpha', 'beta', 'gamma'] });"
+      "}"
+      "JSON.stringify(items);")->ToString();
+  CHECK_GT(payload->Length(), 1024 * 1024);
+
+  bool saved_flag = FLAG_json_vector_scan;
+  FLAG_json_vector_scan = false;
+  context->Global()->Set(v8_str("scalar_result"), ParseJson(payload));
+  FLAG_json_vector_scan = true;
+  context->Global()->Set(v8_str("vector_result"), ParseJson(payload));
+  FLAG_json_vector_scan = saved_flag;
+
+  const char* kChecks[] = {
+    "result.length === 4000",
+    "result[3999].id === 3999",
+    "result[3999].name === 'item3999'",
+    "result[3999].text === text + 3999",
+    "result[17].escaped === 'tab\\there, quote \\\"' + text + '\\\"'",
+    "result[17].tags.join() === 'alpha,beta,gamma'",
+    "JSON.stringify(result) === JSON.stringify(items)"
+  };
+  for (size_t i = 0; i < ARRAY_SIZE(kChecks); i++) {
+    EmbeddedVector<char, 256> source;
+    OS::SNPrintF(source, "var result = scalar_result; %s", kChecks[i]);
+    CHECK(CompileRun(source.start())->BooleanValue());
+    OS::SNPrintF(source, "var result = vector_result; %s", kChecks[i]);
+    CHECK(CompileRun(source.start())->BooleanValue());
+  }
+}
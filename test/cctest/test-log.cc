@@ -11,6 +11,7 @@
 
 #include "v8.h"
 #include "log.h"
+#include "compilation-cache.h"
 #include "cpu-profiler.h"
 #include "natives.h"
 #include "v8threads.h"
@@ -469,6 +470,191 @@ TEST(IsLoggingPreserved) {
 }
 
 
+// Binary logs contain NUL bytes, so strstr can't be used to search them.
+static const char* MemStr(const char* s1, int n, const char* s2) {
+  int length = i::StrLength(s2);
+  for (int i = 0; i + length <= n; i++) {
+    if (memcmp(s1 + i, s2, length) == 0) return s1 + i;
+  }
+  return NULL;
+}
+
+
+TEST(BinaryLog) {
+  i::FLAG_log_binary = true;
+  {
+    ScopedLoggerInitializer initialize_logger(false);
+    LOGGER->StringEvent("test-binary-start", "");
+    CompileRun("var a = (function(x) { return x + 1; })(10);");
+    LOGGER->StringEvent("test-binary-stop", "");
+
+    bool exists = false;
+    i::Vector<const char> log(
+        i::ReadFile(initialize_logger.StopLoggingGetTempFile(), &exists, true));
+    CHECK(exists);
+    const int kMagicLength = i::StrLength(i::Log::kBinaryLogMagic);
+    CHECK_GT(log.length(), kMagicLength);
+    CHECK_EQ(0, memcmp(log.start(), i::Log::kBinaryLogMagic, kMagicLength));
+    CHECK_EQ(i::Log::kBinaryLogVersion, log[kMagicLength]);
+    // The version message has no binary encoding.
+    CHECK_EQ(i::Log::kTextRecordTag, log[kMagicLength + 1]);
+    const char* start =
+        MemStr(log.start(), log.length(), "test-binary-start,");
+    CHECK_NE(NULL, start);
+    const char* stop = MemStr(log.start(), log.length(), "test-binary-stop,");
+    CHECK_NE(NULL, stop);
+    CHECK_GT(stop, start);
+    log.Dispose();
+  }
+  i::FLAG_log_binary = false;
+}
+
+
+#ifdef __linux__
+
+TEST(PerfMap) {
+  i::FLAG_perf_map = true;
+  {
+    ScopedLoggerInitializer initialize_logger(false);
+    CompileRun("function perfMapTest() { return 42; }\n"
+               "perfMapTest();");
+    LOGGER->TearDown();
+  }
+  i::FLAG_perf_map = false;
+
+  EmbeddedVector<char, 64> file_name;
+  i::OS::SNPrintF(file_name, "/tmp/perf-%d.map",
+                  i::OS::GetCurrentProcessId());
+  bool exists = false;
+  i::Vector<const char> map(i::ReadFile(file_name.start(), &exists, true));
+  CHECK(exists);
+  // Lines are "<start> <size> <name>", with hexadecimal start and size.
+  const char* entry = StrNStr(map.start(), "perfMapTest", map.length());
+  CHECK_NE(NULL, entry);
+  const char* line = entry;
+  while (line > map.start() && line[-1] != '\n') --line;
+  uintptr_t start = 0;
+  unsigned size = 0;
+  CHECK_EQ(2, sscanf(line, "%" V8PRIxPTR " %x ", &start, &size));
+  CHECK_NE(0, start);
+  CHECK_GT(size, 0);
+  map.Dispose();
+  remove(file_name.start());
+}
+
+
+// Implemented in the test-alloc.cc test suite.
+void SimulateFullSpace(i::PagedSpace* space);
+
+
+template <typename T>
+static T ReadJitDumpField(const i::Vector<const char>& dump, int offset) {
+  CHECK_LE(offset + static_cast<int>(sizeof(T)), dump.length());
+  T value;
+  memcpy(&value, dump.start() + offset, sizeof(value));
+  return value;
+}
+
+
+TEST(PerfJitDump) {
+  // Only turn on the dump, so that nothing else enables code event logging.
+  i::FLAG_perf_jitdump = true;
+  {
+    v8::HandleScope scope;
+    LocalContext env;
+    CompileRun("function perfJitDumpTest() { return 42; }\n"
+               "perfJitDumpTest();");
+    // Spread new code over several code space pages and compact them.
+    i::FLAG_stress_compaction = true;
+    for (int i = 0; i < 10; ++i) {
+      {
+        i::AlwaysAllocateScope always_allocate;
+        SimulateFullSpace(HEAP->code_space());
+        CompileRun("(function() { return 42; })();");
+      }
+      ISOLATE->compilation_cache()->Clear();
+    }
+    HEAP->CollectAllAvailableGarbage("PerfJitDump");
+    i::FLAG_stress_compaction = false;
+    LOGGER->TearDown();
+  }
+  i::FLAG_perf_jitdump = false;
+
+  EmbeddedVector<char, 64> file_name;
+  i::OS::SNPrintF(file_name, "jit-%d.dump", i::OS::GetCurrentProcessId());
+  bool exists = false;
+  i::Vector<const char> dump(i::ReadFile(file_name.start(), &exists, true));
+  CHECK(exists);
+
+  // The header is magic, version, header size, ELF machine, a reserved
+  // word, process id, timestamp and flags.
+  CHECK(ReadJitDumpField<uint32_t>(dump, 0) == 0x4A695444);
+  CHECK(ReadJitDumpField<uint32_t>(dump, 4) == 1);
+  int header_size = ReadJitDumpField<uint32_t>(dump, 8);
+  CHECK_EQ(40, header_size);
+  CHECK_EQ(i::OS::GetCurrentProcessId(),
+           static_cast<int>(ReadJitDumpField<uint32_t>(dump, 20)));
+
+  // Records start with id, size and timestamp. Code loads are followed by
+  // process and thread id, vma, code address, code size, code id, the name
+  // and the code. Code moves have a new vma and code address instead.
+  const uint32_t kCodeLoad = 0, kCodeMove = 1, kCodeClose = 3;
+  const int kCodeLoadSize = 56, kCodeMoveSize = 64, kCodeCloseSize = 16;
+  int loads = 0, builtin_loads = 0, test_loads = 0, moves = 0;
+  bool closed = false;
+  uint64_t last_timestamp = 0;
+  int pos = header_size;
+  while (pos < dump.length()) {
+    CHECK(!closed);
+    uint32_t id = ReadJitDumpField<uint32_t>(dump, pos);
+    int size = ReadJitDumpField<uint32_t>(dump, pos + 4);
+    uint64_t timestamp = ReadJitDumpField<uint64_t>(dump, pos + 8);
+    CHECK(last_timestamp <= timestamp);
+    last_timestamp = timestamp;
+    CHECK_LE(pos + size, dump.length());
+    if (id == kCodeLoad) {
+      uint64_t vma = ReadJitDumpField<uint64_t>(dump, pos + 24);
+      uint64_t code_size = ReadJitDumpField<uint64_t>(dump, pos + 40);
+      uint64_t code_id = ReadJitDumpField<uint64_t>(dump, pos + 48);
+      CHECK(vma != 0);
+      CHECK(code_id == static_cast<uint64_t>(loads));
+      const char* name = dump.start() + pos + kCodeLoadSize;
+      int name_length = StrLength(name);
+      CHECK(static_cast<uint64_t>(size) ==
+            kCodeLoadSize + name_length + 1 + code_size);
+      if (strncmp(name, "Builtin:", 8) == 0) ++builtin_loads;
+      if (strstr(name, "perfJitDumpTest") != NULL) ++test_loads;
+      ++loads;
+    } else if (id == kCodeMove) {
+      CHECK_EQ(kCodeMoveSize, size);
+      uint64_t vma = ReadJitDumpField<uint64_t>(dump, pos + 24);
+      uint64_t old_address = ReadJitDumpField<uint64_t>(dump, pos + 32);
+      uint64_t new_address = ReadJitDumpField<uint64_t>(dump, pos + 40);
+      uint64_t code_id = ReadJitDumpField<uint64_t>(dump, pos + 56);
+      CHECK(vma == new_address);
+      CHECK(old_address != new_address);
+      CHECK(code_id < static_cast<uint64_t>(loads));
+      ++moves;
+    } else {
+      CHECK(id == kCodeClose);
+      CHECK_EQ(kCodeCloseSize, size);
+      closed = true;
+    }
+    pos += size;
+  }
+  CHECK_EQ(dump.length(), pos);
+  CHECK(closed);
+  // Code that existed before the first script ran must be in the dump too.
+  CHECK_GT(builtin_loads, 0);
+  CHECK_GT(test_loads, 0);
+  CHECK_GT(moves, 0);
+  dump.Dispose();
+  remove(file_name.start());
+}
+
+#endif  // __linux__
+
+
 typedef i::NativesCollection<i::TEST> TestSources;
 
 
@@ -77,6 +77,78 @@ TEST(MarkingDeque) {
 }
 
 
+TEST(ParallelMarkingDeque) {
+  ParallelMarkingDeque s;
+  s.Initialize(16);
+  CHECK(s.IsEmpty());
+  CHECK_EQ(NULL, s.Pop());
+  CHECK_EQ(NULL, s.Steal());
+
+  Address address = NULL;
+  for (int i = 0; i < 16; i++) {
+    s.PushBlack(HeapObject::FromAddress(address));
+    address += kPointerSize;
+  }
+  CHECK(!s.overflowed());
+
+  // The owner pops from the top, other threads steal from the bottom.
+  CHECK_EQ(address - kPointerSize, s.Pop()->address());
+  CHECK_EQ(NULL, s.Steal()->address());
+  for (int i = 1; i < 15; i++) {
+    CHECK_EQ(reinterpret_cast<Address>(NULL) + i * kPointerSize,
+             s.Steal()->address());
+  }
+  CHECK(s.IsEmpty());
+  CHECK_EQ(NULL, s.Pop());
+  CHECK_EQ(NULL, s.Steal());
+}
+
+
+static void BuildAndCheckGraphWithGC() {
+  v8::HandleScope scope;
+  const char* source =
+      "var root = [];"
+      "for (var i = 0; i < 20000; i++) {"
+      "  root.push({ index: i, name: 'o' + i, children: [i, [i, i + 1]] });"
+      "}"
+      "for (var i = 0; i < root.length; i++) {"
+      "  root[i].next = root[(i * 7) % root.length];"
+      "}";
+  v8::Script::Compile(v8::String::New(source))->Run();
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  HEAP->CollectAllGarbage(Heap::kMakeHeapIterableMask);
+  const char* check =
+      "var ok = true;"
+      "for (var i = 0; i < root.length; i++) {"
+      "  var o = root[i];"
+      "  ok = ok && o.index == i && o.name == 'o' + i &&"
+      "       o.children[1][1] == i + 1 &&"
+      "       o.next.index == (i * 7) % root.length;"
+      "}"
+      "ok;";
+  CHECK(v8::Script::Compile(v8::String::New(check))->Run()->IsTrue());
+}
+
+
+TEST(ParallelMarking) {
+  FLAG_parallel_marking = true;
+  FLAG_marking_threads = 3;
+  InitializeVM();
+  CHECK(Isolate::Current()->marking_threads() != NULL);
+  BuildAndCheckGraphWithGC();
+}
+
+
+TEST(ParallelMarkingWithOverflow) {
+  FLAG_parallel_marking = true;
+  FLAG_marking_threads = 2;
+  FLAG_force_marking_deque_overflows = true;
+  InitializeVM();
+  CHECK(Isolate::Current()->marking_threads() != NULL);
+  BuildAndCheckGraphWithGC();
+}
+
+
 TEST(Promotion) {
   // This test requires compaction. If compaction is turned off, we
   // skip the entire test.
@@ -531,6 +603,9 @@ TEST(BootUpMemoryUse) {
   // Avoid flakiness.
   FLAG_crankshaft = false;
   FLAG_parallel_recompilation = false;
+  FLAG_concurrent_sweeping = false;
+  FLAG_parallel_marking = false;
+  FLAG_parallel_scavenge = false;
 
   // Only Linux has the proc filesystem and only if it is mapped.  If it's not
   // there we just skip the test.
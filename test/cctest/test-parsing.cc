@@ -1261,3 +1261,166 @@ TEST(PreparserStrictOctal) {
   CHECK_EQ("SyntaxError: Octal literals are not allowed in strict mode.",
            *exception);
 }
+
+
+// Delivers a UTF-8 source in chunks of at most chunk_size bytes.
+class ChunkedSource : public v8::ScriptSourceStream {
+ public:
+  ChunkedSource(const char* data, size_t length, size_t chunk_size)
+      : data_(data), length_(length), chunk_size_(chunk_size), pos_(0) { }
+
+  virtual size_t GetMoreData(const char** chunk) {
+    size_t length = i::Min(chunk_size_, length_ - pos_);
+    *chunk = data_ + pos_;
+    pos_ += length;
+    return length;
+  }
+
+ private:
+  const char* data_;
+  size_t length_;
+  size_t chunk_size_;
+  size_t pos_;
+};
+
+
+TEST(ChunkedUtf8CharacterStream) {
+  v8::HandleScope scope;
+  LocalContext env;
+
+  // All BMP characters followed by a surrogate pair and invalid or
+  // truncated sequences.
+  static const int kMaxUC16Char = unibrow::Utf8::kMaxThreeByteChar;
+  static const int kBufferSize = 3 * (kMaxUC16Char + 1) + 16;
+  char* buffer = i::NewArray<char>(kBufferSize);
+  unsigned length = 0;
+  for (int i = 0; i <= kMaxUC16Char; i++) {
+    length += unibrow::Utf8::Encode(buffer + length,
+                                    i,
+                                    unibrow::Utf16::kNoPreviousCharacter);
+  }
+  const char kTail[] = "\xF0\x9F\x98\x80" "\xE0\x41" "\x80" "\xF8" "\xE2\x82";
+  memcpy(buffer + length, kTail, sizeof(kTail) - 1);
+  length += sizeof(kTail) - 1;
+
+  static const size_t kChunkSizes[] = { 1, 2, 3, 5, 7, 1024 };
+  for (size_t k = 0; k < ARRAY_SIZE(kChunkSizes); k++) {
+    i::Utf8ToUtf16CharacterStream expected(
+        reinterpret_cast<const i::byte*>(buffer), length);
+    ChunkedSource source(buffer, length, kChunkSizes[k]);
+    i::ChunkedUtf8ToUtf16CharacterStream stream(&source);
+    int32_t c;
+    do {
+      c = expected.Advance();
+      CHECK_EQ(c, stream.Advance());
+      CHECK_EQ(static_cast<int>(expected.pos()),
+               static_cast<int>(stream.pos()));
+    } while (c >= 0);
+    // The source ends in 'A' followed by four bad characters.
+    stream.PushBack(c);
+    for (int i = 0; i < 4; i++) stream.PushBack(0xFFFD);
+    stream.PushBack('A');
+    CHECK_EQ(static_cast<int>(expected.pos()) - 6,
+             static_cast<int>(stream.pos()));
+    CHECK_EQ('A', stream.Advance());
+    CHECK_EQ(0xFFFD, stream.Advance());
+
+    i::Handle<i::String> decoded = stream.Finish();
+    CHECK(decoded->IsSeqTwoByteString());
+    CHECK_EQ(static_cast<int>(expected.pos()) - 1, decoded->length());
+    CHECK_EQ(kMaxUC16Char, decoded->Get(kMaxUC16Char));
+    CHECK_EQ(0xD83D, decoded->Get(kMaxUC16Char + 1));
+    CHECK_EQ(0xDE00, decoded->Get(kMaxUC16Char + 2));
+    CHECK_EQ(0xFFFD, decoded->Get(kMaxUC16Char + 3));
+    CHECK_EQ('A', decoded->Get(kMaxUC16Char + 4));
+  }
+
+  // Seeking forward fetches the chunks that are skipped.
+  const char* str = "case default const {THIS\nPART\nSKIPPED} do";
+  for (size_t chunk_size = 1; chunk_size < 8; chunk_size++) {
+    ChunkedSource source(str, strlen(str), chunk_size);
+    i::ChunkedUtf8ToUtf16CharacterStream stream(&source);
+    CHECK_EQ('c', stream.Advance());
+    CHECK_EQ(29, static_cast<int>(stream.SeekForward(29)));
+    CHECK_EQ('S', stream.Advance());
+    CHECK_EQ(10, static_cast<int>(stream.SeekForward(20)));
+    CHECK_EQ(-1, stream.Advance());
+    // An all-ASCII source is materialized as a one-byte string.
+    i::Handle<i::String> decoded = stream.Finish();
+    CHECK(decoded->IsSeqAsciiString());
+    CHECK(decoded->IsEqualTo(i::CStrVector(str)));
+  }
+  i::DeleteArray(buffer);
+}
+
+
+TEST(StreamedPreparsing) {
+  v8::V8::Initialize();
+  int marker;
+  i::Isolate::Current()->stack_guard()->SetStackLimit(
+      reinterpret_cast<uintptr_t>(&marker) - 128 * 1024);
+
+  const char* source =
+      "var x = '\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80';"
+      "function foo(a) { return function nolazy(b) { return a + b; } }"
+      "function bar(a) { if (a) return function lazy(b) { return b; } }";
+  int source_length = i::StrLength(source);
+  v8::ScriptData* expected =
+      v8::ScriptData::PreCompile(source, source_length);
+  CHECK(!expected->HasError());
+  for (size_t chunk_size = 1; chunk_size < 16; chunk_size += 3) {
+    ChunkedSource stream(source, source_length, chunk_size);
+    v8::ScriptData* data = v8::ScriptData::PreCompile(&stream);
+    CHECK(!data->HasError());
+    CHECK_EQ(expected->Length(), data->Length());
+    CHECK_EQ(0, memcmp(expected->Data(), data->Data(), data->Length()));
+    delete data;
+  }
+  delete expected;
+
+  const char* error_source = "var x = '\xE2\x82\xAC'; var y = z w;";
+  ChunkedSource error_stream(error_source, strlen(error_source), 2);
+  v8::ScriptData* error_data = v8::ScriptData::PreCompile(&error_stream);
+  CHECK(error_data->HasError());
+  i::Scanner::Location location =
+      reinterpret_cast<i::ScriptDataImpl*>(error_data)->MessageLocation();
+  // Error is at "w", location 23..24 in UTF-16 code units.
+  CHECK_EQ(23, location.beg_pos);
+  CHECK_EQ(24, location.end_pos);
+  delete error_data;
+}
+
+
+TEST(StreamedScriptCompile) {
+  v8::HandleScope scope;
+  LocalContext env;
+
+  const char* source =
+      "var s = '\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80';\n"
+      "function lazy(a) { return a + s.length; }\n"
+      "lazy(10);";
+  for (size_t chunk_size = 1; chunk_size < 64; chunk_size *= 2) {
+    ChunkedSource stream(source, strlen(source), chunk_size);
+    v8::Local<v8::Script> script =
+        v8::Script::Compile(&stream, NULL);
+    CHECK(!script.IsEmpty());
+    CHECK_EQ(14, script->Run()->Int32Value());
+    // The lazily compiled function is found in the complete source.
+    v8::Local<v8::Value> text = CompileRun("lazy.toString()");
+    CHECK_EQ(v8_str("function lazy(a) { return a + s.length; }"), text);
+    CHECK_EQ(0xE9, CompileRun("s.charCodeAt(0)")->Int32Value());
+    CHECK_EQ(0xD83D, CompileRun("s.charCodeAt(2)")->Int32Value());
+  }
+
+  // Syntax errors are reported against the complete source.
+  const char* error_source = "var ok = 1;\nvar error = \xE2\x82\xAC +;\n// end";
+  ChunkedSource error_stream(error_source, strlen(error_source), 3);
+  v8::ScriptOrigin origin(v8_str("streamed.js"));
+  v8::TryCatch try_catch;
+  CHECK(v8::Script::New(&error_stream, &origin).IsEmpty());
+  CHECK(try_catch.HasCaught());
+  v8::Local<v8::Message> message = try_catch.Message();
+  CHECK_EQ(2, message->GetLineNumber());
+  CHECK_EQ(v8_str("var error = \xE2\x82\xAC +;"), message->GetSourceLine());
+  CHECK_EQ(v8_str("streamed.js"), message->GetScriptResourceName());
+}
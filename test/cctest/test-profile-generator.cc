@@ -638,6 +638,217 @@ TEST(RecordTickSample) {
 }
 
 
+namespace {
+
+class TestTraceStream : public v8::OutputStream {
+ public:
+  virtual void EndOfStream() { }
+  virtual int GetChunkSize() { return 16; }
+  virtual WriteResult WriteAsciiChunk(char* data, int size) {
+    for (int i = 0; i < size; ++i) buffer_.Add(data[i]);
+    return kContinue;
+  }
+  const i::List<char>& buffer() const { return buffer_; }
+ private:
+  i::List<char> buffer_;
+};
+
+
+// Decodes the numbers of a trace written by CpuProfile::SerializeTrace.
+class TestTraceReader {
+ public:
+  explicit TestTraceReader(const i::List<char>& buffer)
+      : buffer_(buffer), pos_(0) { }
+
+  bool ReadMagic(const char* magic) {
+    for (; *magic != '\0'; ++magic) {
+      if (pos_ >= buffer_.length() || buffer_[pos_++] != *magic) return false;
+    }
+    return true;
+  }
+  uint64_t ReadVarint() {
+    uint64_t value = 0;
+    int shift = 0;
+    uint8_t b;
+    do {
+      CHECK_LT(pos_, buffer_.length());
+      b = static_cast<uint8_t>(buffer_[pos_++]);
+      value |= static_cast<uint64_t>(b & 0x7f) << shift;
+      shift += 7;
+    } while ((b & 0x80) != 0);
+    return value;
+  }
+  int ReadInt() { return static_cast<int>(ReadVarint()); }
+  int64_t ReadSignedVarint() {
+    uint64_t value = ReadVarint();
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+  }
+  void Skip(int bytes) {
+    pos_ += bytes;
+    CHECK_LE(pos_, buffer_.length());
+  }
+  const char* current() const { return &buffer_[pos_]; }
+  bool at_end() const { return pos_ == buffer_.length(); }
+
+ private:
+  const i::List<char>& buffer_;
+  int pos_;
+};
+
+}  // namespace
+
+
+TEST(RecordSamples) {
+  TestSetup test_setup;
+  CpuProfilesCollection profiles;
+  profiles.StartProfiling("", 1, true);
+  ProfileGenerator generator(&profiles);
+  CodeEntry* entry1 = generator.NewCodeEntry(i::Logger::FUNCTION_TAG, "aaa");
+  CodeEntry* entry2 = generator.NewCodeEntry(i::Logger::FUNCTION_TAG, "bbb");
+  generator.code_map()->AddCode(ToAddress(0x1500), entry1, 0x200);
+  generator.code_map()->AddCode(ToAddress(0x1700), entry2, 0x100);
+
+  // We are building the following calls tree:
+  //      -> aaa         - sample1, sample3
+  //  aaa -> bbb         - sample2
+  TickSample sample1;
+  sample1.pc = ToAddress(0x1600);
+  sample1.frames_count = 0;
+  sample1.timestamp = 100;
+  generator.RecordTickSample(sample1);
+  TickSample sample2;
+  sample2.pc = ToAddress(0x1780);
+  sample2.stack[0] = ToAddress(0x1620);
+  sample2.frames_count = 1;
+  sample2.timestamp = 250;
+  generator.RecordTickSample(sample2);
+  TickSample sample3;
+  sample3.pc = ToAddress(0x1510);
+  sample3.frames_count = 0;
+  sample3.timestamp = 300;
+  generator.RecordTickSample(sample3);
+
+  CpuProfile* profile =
+      profiles.StopProfiling(TokenEnumerator::kNoSecurityToken, "", 1);
+  CHECK_NE(NULL, profile);
+  ProfileTreeTestHelper top_down_test_helper(profile->top_down());
+  ProfileNode* node1 = top_down_test_helper.Walk(entry1);
+  CHECK_NE(NULL, node1);
+  ProfileNode* node2 = top_down_test_helper.Walk(entry1, entry2);
+  CHECK_NE(NULL, node2);
+  CHECK_EQ(3, profile->samples_count());
+  CHECK_EQ(node1, profile->sample(0));
+  CHECK_EQ(node2, profile->sample(1));
+  CHECK_EQ(node1, profile->sample(2));
+  CHECK_EQ(100, static_cast<int>(profile->sample_timestamp(0)));
+  CHECK_EQ(250, static_cast<int>(profile->sample_timestamp(1)));
+  CHECK_EQ(300, static_cast<int>(profile->sample_timestamp(2)));
+
+  TestTraceStream stream;
+  profile->SerializeTrace(&stream);
+  TestTraceReader reader(stream.buffer());
+  CHECK(reader.ReadMagic("v8cputrace"));
+  CHECK_EQ(1, reader.ReadInt());
+  i::List<Vector<const char> > strings;
+  int strings_count = reader.ReadInt();
+  for (int i = 0; i < strings_count; ++i) {
+    int length = reader.ReadInt();
+    strings.Add(Vector<const char>(reader.current(), length));
+    reader.Skip(length);
+  }
+  // Keep the parent and the name of every node.
+  i::List<int> parents;
+  i::List<int> names;
+  int nodes_count = reader.ReadInt();
+  for (int i = 0; i < nodes_count; ++i) {
+    int parent = reader.ReadInt() - 1;
+    CHECK_LT(parent, i);
+    parents.Add(parent);
+    CHECK_LT(reader.ReadInt(), strings_count);
+    int name = reader.ReadInt();
+    CHECK_LT(name, strings_count);
+    names.Add(name);
+    CHECK_LT(reader.ReadInt(), strings_count);
+    reader.ReadInt();
+  }
+  CHECK_EQ(-1, parents[0]);
+  // Samples must come out in order, pointing at aaa, aaa -> bbb and aaa.
+  CHECK_EQ(profile->samples_count(), reader.ReadInt());
+  int64_t timestamp = static_cast<int64_t>(reader.ReadVarint());
+  const int64_t kTimestamps[] = { 100, 250, 300 };
+  int sample_nodes[3];
+  for (int i = 0; i < profile->samples_count(); ++i) {
+    int node = reader.ReadInt();
+    CHECK_LT(node, nodes_count);
+    sample_nodes[i] = node;
+    int64_t previous_timestamp = timestamp;
+    timestamp += reader.ReadSignedVarint();
+    CHECK(timestamp == kTimestamps[i]);
+    if (i > 0) CHECK(previous_timestamp < timestamp);
+  }
+  CHECK(reader.at_end());
+  CHECK_EQ(sample_nodes[0], sample_nodes[2]);
+  CHECK_EQ(0, parents[sample_nodes[0]]);
+  CHECK_EQ(sample_nodes[0], parents[sample_nodes[1]]);
+  Vector<const char> name1 = strings[names[sample_nodes[0]]];
+  CHECK_EQ(3, name1.length());
+  CHECK_EQ(0, strncmp("aaa", name1.start(), 3));
+  Vector<const char> name2 = strings[names[sample_nodes[1]]];
+  CHECK_EQ(3, name2.length());
+  CHECK_EQ(0, strncmp("bbb", name2.start(), 3));
+}
+
+
+TEST(RecordSamplesFilteredClone) {
+  const int token0 = 0, token1 = 1;
+  CodeEntry entry1(i::Logger::FUNCTION_TAG, "", "aaa", "", 0, token0);
+  CodeEntry entry2(i::Logger::FUNCTION_TAG, "", "bbb", "", 0, token1);
+  CpuProfile profile("", 1, true);
+  CodeEntry* e1_path[] = {&entry1};
+  Vector<CodeEntry*> e1_path_vec(
+      e1_path, sizeof(e1_path) / sizeof(e1_path[0]));
+  CodeEntry* e2_e1_path[] = {&entry2, &entry1};
+  Vector<CodeEntry*> e2_e1_path_vec(
+      e2_e1_path, sizeof(e2_e1_path) / sizeof(e2_e1_path[0]));
+  profile.AddPath(e1_path_vec, 100);
+  profile.AddPath(e2_e1_path_vec, 250);
+  profile.AddPath(e1_path_vec, 300);
+  profile.CalculateTotalTicks();
+
+  {
+    // Samples of bbb go to aaa, the node its ticks are attributed to.
+    CpuProfile* clone = profile.FilteredClone(token0);
+    ProfileTreeTestHelper helper(clone->top_down());
+    ProfileNode* node1 = helper.Walk(&entry1);
+    CHECK_NE(NULL, node1);
+    CHECK_EQ(NULL, helper.Walk(&entry1, &entry2));
+    CHECK_EQ(3, clone->samples_count());
+    for (int i = 0; i < clone->samples_count(); ++i) {
+      CHECK_EQ(node1, clone->sample(i));
+      CHECK(clone->sample_timestamp(i) == profile.sample_timestamp(i));
+    }
+    delete clone;
+  }
+
+  {
+    // Samples of aaa go to the root, bbb moves up in its place.
+    CpuProfile* clone = profile.FilteredClone(token1);
+    ProfileTreeTestHelper helper(clone->top_down());
+    CHECK_EQ(NULL, helper.Walk(&entry1));
+    ProfileNode* node2 = helper.Walk(&entry2);
+    CHECK_NE(NULL, node2);
+    CHECK_EQ(3, clone->samples_count());
+    CHECK_EQ(clone->top_down()->root(), clone->sample(0));
+    CHECK_EQ(node2, clone->sample(1));
+    CHECK_EQ(clone->top_down()->root(), clone->sample(2));
+    for (int i = 0; i < clone->samples_count(); ++i) {
+      CHECK(clone->sample_timestamp(i) == profile.sample_timestamp(i));
+    }
+    delete clone;
+  }
+}
+
+
 TEST(SampleRateCalculator) {
   const double kSamplingIntervalMs = i::Logger::kSamplingIntervalMs;
 
@@ -523,6 +523,7 @@ static RegExpNode* Compile(const char* input, bool multiline, bool is_ascii) {
                         pattern,
                         sample_subject,
                         is_ascii,
+                        false,
                         isolate->runtime_zone());
   return compile_data.node;
 }
@@ -1415,6 +1416,115 @@ TEST(MacroAssembler) {
 #endif  // V8_INTERPRETED_REGEXP
 
 
+static Handle<ByteArray> NewBytecode(int length) {
+  Handle<ByteArray> bytecode = FACTORY->NewByteArray(length);
+  for (int i = 0; i < length; i++) bytecode->set(i, static_cast<byte>(i));
+  return bytecode;
+}
+
+
+TEST(SharedRegExpCodeCache) {
+  V8::Initialize(NULL);
+  int entries = SharedRegExpCodeCache::entries();
+  int size = SharedRegExpCodeCache::size();
+  JSRegExp::Flags flags(JSRegExp::IGNORE_CASE);
+  int num_registers;
+  {
+    Isolate* isolate = Isolate::Current();
+    HandleScope scope(isolate);
+    Handle<String> source =
+        isolate->factory()->NewStringFromAscii(CStrVector("^foo"));
+    CHECK(SharedRegExpCodeCache::Lookup(
+        isolate, source, flags, true, &num_registers).is_null());
+    SharedRegExpCodeCache::Insert(
+        source, flags, true, NewBytecode(100), 2);
+    CHECK_EQ(entries + 1, SharedRegExpCodeCache::entries());
+    CHECK_LT(size, SharedRegExpCodeCache::size());
+    // Inserting the same key again is a no-op.
+    SharedRegExpCodeCache::Insert(
+        source, flags, true, NewBytecode(100), 2);
+    CHECK_EQ(entries + 1, SharedRegExpCodeCache::entries());
+  }
+
+  // Another isolate gets its own copy of the bytecode.
+  v8::Isolate* other = v8::Isolate::New();
+  other->Enter();
+  {
+    v8::HandleScope handle_scope;
+    LocalContext env;
+    Isolate* isolate = Isolate::Current();
+    Factory* factory = isolate->factory();
+    Handle<String> source = factory->NewStringFromAscii(CStrVector("^foo"));
+    Handle<ByteArray> bytecode = SharedRegExpCodeCache::Lookup(
+        isolate, source, flags, true, &num_registers);
+    CHECK(!bytecode.is_null());
+    CHECK_EQ(2, num_registers);
+    CHECK(!isolate->heap()->InNewSpace(*bytecode));
+    CHECK_EQ(100, bytecode->length());
+    for (int i = 0; i < 100; i++) CHECK_EQ(i, bytecode->get(i));
+
+    // Flags, encoding and pattern are all part of the key.
+    JSRegExp::Flags other_flags(JSRegExp::MULTILINE);
+    CHECK(SharedRegExpCodeCache::Lookup(
+        isolate, source, other_flags, true, &num_registers).is_null());
+    CHECK(SharedRegExpCodeCache::Lookup(
+        isolate, source, flags, false, &num_registers).is_null());
+    Handle<String> other_source =
+        factory->NewStringFromAscii(CStrVector("^fo"));
+    CHECK(SharedRegExpCodeCache::Lookup(
+        isolate, other_source, flags, true, &num_registers).is_null());
+  }
+  other->Exit();
+  other->Dispose();
+}
+
+
+#ifndef V8_INTERPRETED_REGEXP
+
+TEST(RegExpTierUp) {
+  bool saved_tier_up = FLAG_regexp_tier_up;
+  int saved_tier_up_ticks = FLAG_regexp_tier_up_ticks;
+  FLAG_regexp_tier_up = true;
+  FLAG_regexp_tier_up_ticks = 2;
+  v8::HandleScope scope;
+  LocalContext env;
+  CompileRun("var re = /a(b+)c/;");
+  Handle<JSRegExp> re = v8::Utils::OpenHandle(
+      *v8::Handle<v8::RegExp>::Cast(env->Global()->Get(v8_str("re"))));
+
+  // The first executions run the interpreter.
+  CHECK(CompileRun("re.exec('xabbbc')[1] == 'bbb'")->BooleanValue());
+  CHECK(re->DataAt(JSRegExp::kIrregexpASCIIBytecodeIndex)->IsByteArray());
+  CHECK(re->DataAt(JSRegExp::kIrregexpASCIICodeIndex)->IsSmi());
+  CHECK(CompileRun("re.exec('abc')[1] == 'b'")->BooleanValue());
+  CHECK(re->DataAt(JSRegExp::kIrregexpASCIICodeIndex)->IsSmi());
+  CHECK_EQ(0, Smi::cast(
+      re->DataAt(JSRegExp::kIrregexpTicksUntilTierUpIndex))->value());
+
+  // A hot regexp is compiled to native code and drops its bytecode.
+  CHECK(CompileRun("re.exec('xabbc')[1] == 'bb'")->BooleanValue());
+  CHECK(re->DataAt(JSRegExp::kIrregexpASCIICodeIndex)->IsCode());
+  CHECK(re->DataAt(JSRegExp::kIrregexpASCIIBytecodeIndex)->IsSmi());
+  CHECK_EQ(JSRegExp::kTieredUpValue, Smi::cast(
+      re->DataAt(JSRegExp::kIrregexpTicksUntilTierUpIndex))->value());
+  CHECK(CompileRun("re.exec('xac') == null")->BooleanValue());
+  CHECK(CompileRun("'abcabbc'.replace(/(b+)/g, '[$1]') == 'a[b]ca[bb]c'")->
+            BooleanValue());
+
+  // Without tier-up regexps are compiled to native code right away.
+  FLAG_regexp_tier_up = false;
+  CompileRun("var re2 = /x(y+)z/; re2.exec('xyyz');");
+  Handle<JSRegExp> re2 = v8::Utils::OpenHandle(
+      *v8::Handle<v8::RegExp>::Cast(env->Global()->Get(v8_str("re2"))));
+  CHECK(re2->DataAt(JSRegExp::kIrregexpASCIICodeIndex)->IsCode());
+  CHECK(re2->DataAt(JSRegExp::kIrregexpASCIIBytecodeIndex)->IsSmi());
+  FLAG_regexp_tier_up = saved_tier_up;
+  FLAG_regexp_tier_up_ticks = saved_tier_up_ticks;
+}
+
+#endif  // V8_INTERPRETED_REGEXP
+
+
 TEST(AddInverseToTable) {
   v8::internal::V8::Initialize(NULL);
   static const int kLimit = 1000;
@@ -489,99 +489,291 @@ DEPENDENT_TEST(PartialDeserialization, PartialSerialization) {
 }
 
 
-TEST(ContextSerialization) {
-  if (!Snapshot::HaveASnapshotToStartFrom()) {
-    Serializer::Enable();
-    v8::V8::Initialize();
+// Serializes a fresh context into FLAG_testing_serialization_file, after
+// running extra_source in it if that is not NULL.
+static void SerializeContext(const char* extra_source) {
+  Serializer::Enable();
+  v8::V8::Initialize();
 
-    v8::Persistent<v8::Context> env = v8::Context::New();
-    ASSERT(!env.IsEmpty());
-    env->Enter();
-    // Make sure all builtin scripts are cached.
-    { HandleScope scope;
-      for (int i = 0; i < Natives::GetBuiltinsCount(); i++) {
-        Isolate::Current()->bootstrapper()->NativesSourceLookup(i);
-      }
+  v8::Persistent<v8::Context> env = v8::Context::New();
+  ASSERT(!env.IsEmpty());
+  env->Enter();
+  if (extra_source != NULL) {
+    v8::HandleScope scope;
+    CompileRun(extra_source);
+  }
+  // Make sure all builtin scripts are cached.
+  { HandleScope scope;
+    for (int i = 0; i < Natives::GetBuiltinsCount(); i++) {
+      Isolate::Current()->bootstrapper()->NativesSourceLookup(i);
     }
-    // If we don't do this then we end up with a stray root pointing at the
-    // context even after we have disposed of env.
-    HEAP->CollectAllGarbage(Heap::kNoGCFlags);
+  }
+  // If we don't do this then we end up with a stray root pointing at the
+  // context even after we have disposed of env.
+  HEAP->CollectAllGarbage(Heap::kNoGCFlags);
 
-    int file_name_length = StrLength(FLAG_testing_serialization_file) + 10;
-    Vector<char> startup_name = Vector<char>::New(file_name_length + 1);
-    OS::SNPrintF(startup_name, "%s.startup", FLAG_testing_serialization_file);
+  int file_name_length = StrLength(FLAG_testing_serialization_file) + 10;
+  Vector<char> startup_name = Vector<char>::New(file_name_length + 1);
+  OS::SNPrintF(startup_name, "%s.startup", FLAG_testing_serialization_file);
 
-    env->Exit();
+  env->Exit();
 
-    Object* raw_context = *(v8::Utils::OpenHandle(*env));
+  Object* raw_context = *(v8::Utils::OpenHandle(*env));
 
-    env.Dispose();
+  env.Dispose();
 
-    FileByteSink startup_sink(startup_name.start());
-    StartupSerializer startup_serializer(&startup_sink);
-    startup_serializer.SerializeStrongReferences();
+  FileByteSink startup_sink(startup_name.start());
+  StartupSerializer startup_serializer(&startup_sink);
+  startup_serializer.SerializeStrongReferences();
+
+  FileByteSink partial_sink(FLAG_testing_serialization_file);
+  PartialSerializer p_ser(&startup_serializer, &partial_sink);
+  p_ser.Serialize(&raw_context);
+  startup_serializer.SerializeWeakReferences();
+
+  partial_sink.WriteSpaceUsed(
+      p_ser.CurrentAllocationAddress(NEW_SPACE),
+      p_ser.CurrentAllocationAddress(OLD_POINTER_SPACE),
+      p_ser.CurrentAllocationAddress(OLD_DATA_SPACE),
+      p_ser.CurrentAllocationAddress(CODE_SPACE),
+      p_ser.CurrentAllocationAddress(MAP_SPACE),
+      p_ser.CurrentAllocationAddress(CELL_SPACE));
+
+  startup_sink.WriteSpaceUsed(
+      startup_serializer.CurrentAllocationAddress(NEW_SPACE),
+      startup_serializer.CurrentAllocationAddress(OLD_POINTER_SPACE),
+      startup_serializer.CurrentAllocationAddress(OLD_DATA_SPACE),
+      startup_serializer.CurrentAllocationAddress(CODE_SPACE),
+      startup_serializer.CurrentAllocationAddress(MAP_SPACE),
+      startup_serializer.CurrentAllocationAddress(CELL_SPACE));
+  startup_name.Dispose();
+}
 
-    FileByteSink partial_sink(FLAG_testing_serialization_file);
-    PartialSerializer p_ser(&startup_serializer, &partial_sink);
-    p_ser.Serialize(&raw_context);
-    startup_serializer.SerializeWeakReferences();
 
-    partial_sink.WriteSpaceUsed(
-        p_ser.CurrentAllocationAddress(NEW_SPACE),
-        p_ser.CurrentAllocationAddress(OLD_POINTER_SPACE),
-        p_ser.CurrentAllocationAddress(OLD_DATA_SPACE),
-        p_ser.CurrentAllocationAddress(CODE_SPACE),
-        p_ser.CurrentAllocationAddress(MAP_SPACE),
-        p_ser.CurrentAllocationAddress(CELL_SPACE));
+// Initializes the VM from the startup snapshot written by SerializeContext
+// and returns the raw context snapshot.
+static byte* ReadContextSnapshot(int* snapshot_size) {
+  int file_name_length = StrLength(FLAG_testing_serialization_file) + 10;
+  Vector<char> startup_name = Vector<char>::New(file_name_length + 1);
+  OS::SNPrintF(startup_name, "%s.startup", FLAG_testing_serialization_file);
 
-    startup_sink.WriteSpaceUsed(
-        startup_serializer.CurrentAllocationAddress(NEW_SPACE),
-        startup_serializer.CurrentAllocationAddress(OLD_POINTER_SPACE),
-        startup_serializer.CurrentAllocationAddress(OLD_DATA_SPACE),
-        startup_serializer.CurrentAllocationAddress(CODE_SPACE),
-        startup_serializer.CurrentAllocationAddress(MAP_SPACE),
-        startup_serializer.CurrentAllocationAddress(CELL_SPACE));
-    startup_name.Dispose();
+  CHECK(Snapshot::Initialize(startup_name.start()));
+  startup_name.Dispose();
+
+  return ReadBytes(FLAG_testing_serialization_file, snapshot_size);
+}
+
+
+static Context* DeserializeContext(byte* snapshot, int snapshot_size) {
+  Object* root;
+  SnapshotByteSource source(snapshot, snapshot_size);
+  Deserializer deserializer(&source);
+  ReserveSpaceForSnapshot(&deserializer, FLAG_testing_serialization_file);
+  deserializer.DeserializePartial(&root);
+  CHECK(root->IsContext());
+  return Context::cast(root);
+}
+
+
+TEST(ContextSerialization) {
+  if (!Snapshot::HaveASnapshotToStartFrom()) {
+    SerializeContext(NULL);
   }
 }
 
 
 DEPENDENT_TEST(ContextDeserialization, ContextSerialization) {
   if (!Snapshot::HaveASnapshotToStartFrom()) {
-    int file_name_length = StrLength(FLAG_testing_serialization_file) + 10;
-    Vector<char> startup_name = Vector<char>::New(file_name_length + 1);
-    OS::SNPrintF(startup_name, "%s.startup", FLAG_testing_serialization_file);
+    int snapshot_size = 0;
+    byte* snapshot = ReadContextSnapshot(&snapshot_size);
 
-    CHECK(Snapshot::Initialize(startup_name.start()));
-    startup_name.Dispose();
+    Object* root = DeserializeContext(snapshot, snapshot_size);
+    v8::HandleScope handle_scope;
+    Handle<Object> root_handle(root);
+
+    Object* root2 = DeserializeContext(snapshot, snapshot_size);
+    CHECK(*root_handle != root2);
+  }
+}
 
-    const char* file_name = FLAG_testing_serialization_file;
 
+TEST(CustomContextSerialization) {
+  if (!Snapshot::HaveASnapshotToStartFrom()) {
+    // Set up some application state, as mksnapshot --extra-code does.
+    SerializeContext(
+        "var o = [];"
+        "function Point(x, y) { this.x = x; this.y = y; }"
+        "Point.prototype.sum = function() { return this.x + this.y; };"
+        "for (var i = 0; i < 5; i++) o.push(new Point(i, 1));"
+        "var s = o.map(function(p) { return p.sum(); }).join(',');"
+        "var n = o[4].sum();");
+  }
+}
+
+
+static Object* GetGlobalProperty(Context* context, const char* name) {
+  String* symbol = *FACTORY->LookupAsciiSymbol(name);
+  return context->global_object()->GetProperty(symbol)->ToObjectUnchecked();
+}
+
+
+DEPENDENT_TEST(CustomContextDeserialization, CustomContextSerialization) {
+  if (!Snapshot::HaveASnapshotToStartFrom()) {
     int snapshot_size = 0;
-    byte* snapshot = ReadBytes(file_name, &snapshot_size);
+    byte* snapshot = ReadContextSnapshot(&snapshot_size);
 
-    Object* root;
-    {
-      SnapshotByteSource source(snapshot, snapshot_size);
-      Deserializer deserializer(&source);
-      ReserveSpaceForSnapshot(&deserializer, file_name);
-      deserializer.DeserializePartial(&root);
-      CHECK(root->IsContext());
-    }
     v8::HandleScope handle_scope;
-    Handle<Object> root_handle(root);
+    Handle<Context> context(DeserializeContext(snapshot, snapshot_size));
+
+    // The objects set up by the application code are in the context.
+    Handle<Object> o(GetGlobalProperty(*context, "o"));
+    CHECK(o->IsJSArray());
+    CHECK_EQ(Smi::FromInt(5), JSArray::cast(*o)->length());
+    CHECK_EQ(Smi::FromInt(5), GetGlobalProperty(*context, "n"));
+    Handle<Object> s(GetGlobalProperty(*context, "s"));
+    CHECK(s->IsString());
+    CHECK(String::cast(*s)->IsEqualTo(CStrVector("1,2,3,4,5")));
+    Handle<Object> point(GetGlobalProperty(*context, "Point"));
+    CHECK(point->IsJSFunction());
+    CHECK(JSFunction::cast(*point)->shared()->is_compiled());
+  }
+}
 
 
-    Object* root2;
-    {
-      SnapshotByteSource source(snapshot, snapshot_size);
-      Deserializer deserializer(&source);
-      ReserveSpaceForSnapshot(&deserializer, file_name);
-      deserializer.DeserializePartial(&root2);
-      CHECK(root2->IsContext());
-      CHECK(*root_handle != root2);
-    }
+static void CheckFileList(const char* list,
+                          const char** expected,
+                          int expected_count) {
+  List<Vector<const char> > files;
+  Snapshot::SplitFileList(list, &files);
+  CHECK_EQ(expected_count, files.length());
+  for (int i = 0; i < expected_count; i++) {
+    CHECK(files[i].length() == StrLength(expected[i]));
+    CHECK_EQ(0, strncmp(expected[i], files[i].start(), files[i].length()));
+  }
+}
+
+
+TEST(ExtraCodeFileList) {
+  const char* one[] = { "lib.js" };
+  CheckFileList("lib.js", one, 1);
+
+  // Files are kept in the order given; empty elements are skipped.
+  const char* three[] = { "a.js", "dir/b.js", "c.js" };
+  CheckFileList("a.js,dir/b.js,c.js", three, 3);
+  CheckFileList(",a.js,,dir/b.js,c.js,", three, 3);
+
+  CheckFileList("", NULL, 0);
+  CheckFileList(",,", NULL, 0);
+}
+
+
+static const char* kCodeCacheSource =
+    "function f(x) { return x + 1; }\n"
+    "var o = { a: 1, b: 'two' };\n"
+    "function g() {\n"
+    "  var s = 0;\n"
+    "  for (var i = 0; i < 10; i++) s += f(i);\n"
+    "  return s;\n"
+    "}\n"
+    "g() + o.a + o.b.length;";
+
+
+static v8::CodeCacheData* ProduceCodeCache(const char* source) {
+  LocalContext env;
+  v8::HandleScope scope;
+  v8::ScriptOrigin origin(v8_str("code-cache.js"));
+  return v8::CodeCacheData::Produce(v8_str(source), &origin);
+}
+
+
+static v8::Local<v8::Value> RunFromCodeCache(const char* source,
+                                             v8::CodeCacheData* data) {
+  v8::ScriptOrigin origin(v8_str("code-cache.js"));
+  v8::Local<v8::Script> script =
+      v8::Script::NewFromCodeCache(v8_str(source), &origin, data);
+  return script->Run();
+}
+
+
+TEST(CodeCacheProduceAndConsume) {
+  v8::V8::Initialize();
+  v8::CodeCacheData* data = ProduceCodeCache(kCodeCacheSource);
+  CHECK(data != NULL);
+  CHECK_GT(data->Length(), 0);
+
+  // Copy the data, as an embedder reading it from a file would.
+  v8::CodeCacheData* copy = v8::CodeCacheData::New(data->Data(),
+                                                   data->Length());
+  delete data;
+  {
+    LocalContext env;
+    v8::HandleScope scope;
+    v8::Local<v8::Value> result = RunFromCodeCache(kCodeCacheSource, copy);
+    CHECK(!copy->Rejected());
+    CHECK_EQ(59, result->Int32Value());
+    // The lazily compiled functions still work.
+    CHECK_EQ(3, CompileRun("f(2)")->Int32Value());
+    CHECK_EQ(55, CompileRun("g()")->Int32Value());
+  }
+  delete copy;
+}
+
+
+TEST(CodeCacheRejectsOtherSource) {
+  v8::V8::Initialize();
+  v8::CodeCacheData* data = ProduceCodeCache(kCodeCacheSource);
+  CHECK(data != NULL);
+  {
+    LocalContext env;
+    v8::HandleScope scope;
+    v8::Local<v8::Value> result = RunFromCodeCache("6 * 7", data);
+    CHECK(data->Rejected());
+    CHECK_EQ(42, result->Int32Value());
+  }
+  delete data;
+}
+
+
+TEST(CodeCacheRejectsCorruptedData) {
+  v8::V8::Initialize();
+  v8::CodeCacheData* data = ProduceCodeCache(kCodeCacheSource);
+  CHECK(data != NULL);
+  int length = data->Length();
+  char* bytes = NewArray<char>(length);
+  memcpy(bytes, data->Data(), length);
+  delete data;
+  bytes[length - 8] ^= 0x55;
+  v8::CodeCacheData* corrupted = v8::CodeCacheData::New(bytes, length);
+  DeleteArray(bytes);
+  {
+    LocalContext env;
+    v8::HandleScope scope;
+    v8::Local<v8::Value> result =
+        RunFromCodeCache(kCodeCacheSource, corrupted);
+    CHECK(corrupted->Rejected());
+    CHECK_EQ(59, result->Int32Value());
+  }
+  delete corrupted;
+}
+
+
+TEST(CodeCacheInOtherIsolate) {
+  v8::V8::Initialize();
+  v8::CodeCacheData* data = ProduceCodeCache(kCodeCacheSource);
+  CHECK(data != NULL);
+
+  v8::Isolate* isolate = v8::Isolate::New();
+  {
+    v8::Isolate::Scope isolate_scope(isolate);
+    LocalContext env;
+    v8::HandleScope scope;
+    v8::Local<v8::Value> result = RunFromCodeCache(kCodeCacheSource, data);
+    CHECK(!data->Rejected());
+    CHECK_EQ(59, result->Int32Value());
+    CHECK_EQ(55, CompileRun("g()")->Int32Value());
   }
+  isolate->Dispose();
+  delete data;
 }
 
 
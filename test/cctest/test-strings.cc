@@ -715,3 +715,38 @@ TEST(IsAscii) {
   CHECK(String::IsAscii(static_cast<char*>(NULL), 0));
   CHECK(String::IsAscii(static_cast<uc16*>(NULL), 0));
 }
+
+
+// Searches and compares large one-byte and two-byte strings, which take the
+// block-wise paths.
+TEST(SearchAndCompareLargeStrings) {
+  v8::HandleScope scope;
+  LocalContext context;
+  static const char* kPrefixes[] = { "", "\\u1234" };
+  for (int i = 0; i < 2; i++) {
+    EmbeddedVector<char, 1024> setup;
+    // A 1 MB subject with a line break every 64 characters and a marker at
+    // the end.
+    OS::SNPrintF(setup,
+        "var line = '%s';"
+        "while (line.length < 63) line += 'abcdefghijklmnopqrstuvwxyz';"
+        "line = line.substring(0, 63) + '\\n';"
+        "var subject = line;"
+        "while (subject.length < 1024 * 1024) subject += subject;"
+        "subject += 'marker';"
+        "var other = (subject + 'x').substring(0, subject.length);"
+        "var different = subject.substring(0, subject.length - 1) + 'R';",
+        kPrefixes[i]);
+    CompileRun(setup.start());
+    CHECK_EQ(-1, CompileRun("subject.indexOf('!')")->Int32Value());
+    CHECK_EQ(1024 * 1024,
+             CompileRun("subject.indexOf('marker')")->Int32Value());
+    CHECK_EQ(63, CompileRun("subject.indexOf('\\n')")->Int32Value());
+    CHECK_EQ(1024 * 1024 + 5,
+             CompileRun("subject.lastIndexOf('r')")->Int32Value());
+    CHECK_EQ(16385, CompileRun("subject.split('\\n').length")->Int32Value());
+    CHECK(CompileRun("subject == other")->BooleanValue());
+    CHECK(!CompileRun("subject == different")->BooleanValue());
+    CHECK(CompileRun("subject > different")->BooleanValue());
+  }
+}
@@ -223,3 +223,73 @@ TEST(SequenceCollectorRegression) {
   CHECK_EQ(0, strncmp("0123456789012345678901234567890123",
                       seq.start(), seq.length()));
 }
+
+
+template <typename lchar, typename rchar>
+static void TestCompareChars(Vector<lchar> lhs, Vector<rchar> rhs) {
+  int length = lhs.length();
+  for (int i = 0; i < length; i++) {
+    lhs[i] = static_cast<lchar>('a' + i % 26);
+    rhs[i] = static_cast<rchar>('a' + i % 26);
+  }
+  for (int start = 0; start < 20; start++) {
+    CHECK_EQ(0, CompareChars(lhs.start() + start,
+                             rhs.start() + start,
+                             length - start));
+  }
+  for (int i = 0; i < length; i++) {
+    rhs[i] = static_cast<rchar>(lhs[i] + 1);
+    for (int start = 0; start <= i; start += 3) {
+      CHECK_EQ(i - start, FindFirstMismatch(lhs.start() + start,
+                                            rhs.start() + start,
+                                            length - start));
+      CHECK_EQ(-1, CompareChars(lhs.start() + start,
+                                rhs.start() + start,
+                                length - start));
+      CHECK_EQ(0, CompareChars(lhs.start() + start,
+                               rhs.start() + start,
+                               i - start));
+    }
+    rhs[i] = static_cast<rchar>(lhs[i]);
+  }
+}
+
+
+TEST(CompareChars) {
+  static const int kLength = 100;
+  char ascii1[kLength];
+  char ascii2[kLength];
+  uc16 two_byte1[kLength];
+  uc16 two_byte2[kLength];
+  TestCompareChars(Vector<char>(ascii1, kLength),
+                   Vector<char>(ascii2, kLength));
+  TestCompareChars(Vector<uc16>(two_byte1, kLength),
+                   Vector<uc16>(two_byte2, kLength));
+  TestCompareChars(Vector<char>(ascii1, kLength),
+                   Vector<uc16>(two_byte1, kLength));
+  TestCompareChars(Vector<uc16>(two_byte1, kLength),
+                   Vector<char>(ascii1, kLength));
+}
+
+
+TEST(FindCharacter) {
+  static const int kLength = 100;
+  uc16 chars[kLength];
+  for (int i = 0; i < kLength; i++) chars[i] = 0x100 + i % 7;
+  CHECK_EQ(-1, FindCharacter(chars, 0, kLength, 0x1234));
+  for (int i = 0; i < kLength; i++) {
+    chars[i] = 0x1234;
+    for (int start = 0; start < kLength; start += 5) {
+      for (int end = start; end <= kLength; end += 3) {
+        int expected = (start <= i && i < end) ? i : -1;
+        CHECK_EQ(expected, FindCharacter(chars, start, end, 0x1234));
+      }
+    }
+    chars[i] = 0x100 + i % 7;
+  }
+  // Only whole characters match.
+  chars[10] = 0x3412;
+  chars[11] = 0x0012;
+  CHECK_EQ(-1, FindCharacter(chars, 0, kLength, 0x1234));
+  CHECK_EQ(-1, FindCharacter(chars, 0, kLength, 0x1200));
+}
@@ -0,0 +1,115 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <stdlib.h>
+
+#include "v8.h"
+#include "cctest.h"
+#include "zone-inl.h"
+
+using namespace v8::internal;
+
+
+TEST(ZoneSegmentPoolSizeClasses) {
+  // Segment sizes double with each expansion, between 8 KB and 1 MB.
+  CHECK_EQ(8 * KB, ZoneSegmentPool::SizeClassFor(100, 0));
+  CHECK_EQ(16 * KB, ZoneSegmentPool::SizeClassFor(100, 8 * KB));
+  CHECK_EQ(64 * KB, ZoneSegmentPool::SizeClassFor(40 * KB, 8 * KB));
+  CHECK_EQ(1 * MB, ZoneSegmentPool::SizeClassFor(100, 1 * MB));
+  CHECK_EQ(1 * MB, ZoneSegmentPool::SizeClassFor(1 * MB, 0));
+}
+
+
+TEST(ZoneSegmentPoolAllocateAndFree) {
+  V8::Initialize(NULL);
+  ZoneSegmentPool* pool = Isolate::Current()->zone_segment_pool();
+  int saved_pool_size = FLAG_zone_segment_pool_size;
+  FLAG_zone_segment_pool_size = 32;
+  pool->Clear();
+
+  void* first = Malloced::New(16 * KB);
+  void* second = Malloced::New(16 * KB);
+  void* third = Malloced::New(16 * KB);
+  CHECK(pool->Free(first, 16 * KB));
+  CHECK(pool->Free(second, 16 * KB));
+  CHECK_EQ(32 * KB, pool->pooled_bytes());
+  // The pool is full.
+  CHECK(!pool->Free(third, 16 * KB));
+  // Only size classes are pooled.
+  CHECK(!pool->Free(third, 12 * KB));
+
+  int hits = pool->hits();
+  int misses = pool->misses();
+  CHECK_EQ(NULL, pool->Allocate(8 * KB));
+  CHECK_EQ(misses + 1, pool->misses());
+  CHECK_EQ(second, pool->Allocate(16 * KB));
+  CHECK_EQ(first, pool->Allocate(16 * KB));
+  CHECK_EQ(hits + 2, pool->hits());
+  CHECK_EQ(0, pool->pooled_bytes());
+
+  Malloced::Delete(first);
+  Malloced::Delete(second);
+  Malloced::Delete(third);
+  FLAG_zone_segment_pool_size = saved_pool_size;
+}
+
+
+static void AllocateInZone(Zone* zone, int size) {
+  ZoneScope zone_scope(zone, DELETE_ON_EXIT);
+  for (int allocated = 0; allocated < size; allocated += 1 * KB) {
+    memset(zone->New(1 * KB), 0, 1 * KB);
+  }
+}
+
+
+TEST(ZoneSegmentPoolReuse) {
+  V8::Initialize(NULL);
+  Isolate* isolate = Isolate::Current();
+  ZoneSegmentPool* pool = isolate->zone_segment_pool();
+  int saved_pool_size = FLAG_zone_segment_pool_size;
+  pool->Clear();
+
+  Zone zone(isolate);
+  AllocateInZone(&zone, 512 * KB);
+  // All segments but the one the zone keeps have been returned.
+  int pooled_bytes = pool->pooled_bytes();
+  CHECK_GT(pooled_bytes, 0);
+
+  // Allocating the same amount again is served from the pool.
+  int hits = pool->hits();
+  AllocateInZone(&zone, 512 * KB);
+  CHECK_GT(pool->hits(), hits);
+  CHECK_EQ(pooled_bytes, pool->pooled_bytes());
+
+  // Without the pool, segments go back to malloc.
+  FLAG_zone_segment_pool_size = 0;
+  pool->Clear();
+  AllocateInZone(&zone, 512 * KB);
+  CHECK_EQ(0, pool->pooled_bytes());
+  FLAG_zone_segment_pool_size = saved_pool_size;
+}
@@ -0,0 +1,162 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax
+
+// Bounds checks on loop induction variables are removed or hoisted out of
+// the loop.  Check that out of bounds accesses are still caught.
+
+function test(f, expected, args) {
+  for (var i = 0; i < 3; i++) assertEquals(expected, f.apply(null, args));
+  %OptimizeFunctionOnNextCall(f);
+  assertEquals(expected, f.apply(null, args));
+}
+
+var a = [];
+for (var i = 0; i < 10; i++) a[i] = i + 1;
+var ta = new Int32Array(10);
+for (var i = 0; i < 10; i++) ta[i] = i + 1;
+
+function sum(a) {
+  var s = 0;
+  for (var i = 0; i < a.length; i++) s += a[i];
+  return s;
+}
+test(sum, 55, [a]);
+test(sum, 55, [ta]);
+
+function sum_to(a, n) {
+  var s = 0;
+  for (var i = 0; i < n; i++) s += a[i];
+  return s;
+}
+test(sum_to, 15, [a, 5]);
+assertEquals(55, sum_to(a, 10));
+assertTrue(isNaN(sum_to(a, 11)));
+assertEquals(0, sum_to(a, 0));
+assertEquals(0, sum_to(a, -5));
+test(sum_to, 15, [ta, 5]);
+assertTrue(isNaN(sum_to(ta, 11)));
+
+function sum_inclusive(a) {
+  var s = 0;
+  for (var i = 0; i <= a.length; i++) s += a[i];
+  return s;
+}
+test(sum_inclusive, NaN, [a]);
+
+function sum_from(a, start) {
+  var s = 0;
+  for (var i = start; i < a.length; i++) s += a[i];
+  return s;
+}
+test(sum_from, 52, [a, 2]);
+assertTrue(isNaN(sum_from(a, -1)));
+
+function sum_reverse(a) {
+  var s = 0;
+  for (var i = a.length - 1; i >= 0; i--) s += a[i];
+  return s;
+}
+test(sum_reverse, 55, [a]);
+test(sum_reverse, 55, [ta]);
+
+function sum_reverse_from(a, start) {
+  var s = 0;
+  for (var i = start; i >= 0; i--) s += a[i];
+  return s;
+}
+test(sum_reverse_from, 6, [a, 2]);
+assertTrue(isNaN(sum_reverse_from(a, 10)));
+
+function products(a) {
+  var s = 0;
+  for (var i = 0; i < a.length - 1; i++) s += a[i] * a[i + 1];
+  return s;
+}
+test(products, 330, [a]);
+test(products, 330, [ta]);
+
+function sum_even(a) {
+  var s = 0;
+  for (var i = 0; i < a.length; i += 2) s += a[i];
+  return s;
+}
+test(sum_even, 25, [a]);
+
+function sum_shrinking(a) {
+  var s = 0;
+  for (var i = 0; i < a.length; i++) {
+    s += a[i];
+    if (i == 5) a.length = 3;
+  }
+  return s;
+}
+for (var k = 0; k < 3; k++) assertEquals(21, sum_shrinking(a.slice(0)));
+%OptimizeFunctionOnNextCall(sum_shrinking);
+assertEquals(21, sum_shrinking(a.slice(0)));
+
+function sum_matrix(a, n) {
+  var s = 0;
+  for (var i = 0; i < n; i++) {
+    for (var j = 0; j < n; j++) s += a[i * n + j] + a[i];
+  }
+  return s;
+}
+test(sum_matrix, 63, [a, 3]);
+assertTrue(isNaN(sum_matrix(a, 4)));
+
+// Equality compares against the induction variable do not bound it.
+function sum_nonzero(a, n) {
+  var s = 0;
+  for (var i = n; i >= 0; i--) {
+    if (0 != i) s += a[i];
+  }
+  return s;
+}
+test(sum_nonzero, 54, [a, 9]);
+assertTrue(isNaN(sum_nonzero(a, 10)));
+
+function sum_nonzero_left(a, n) {
+  var s = 0;
+  for (var i = n; i >= 0; i--) {
+    if (i != 0) s += a[i];
+  }
+  return s;
+}
+test(sum_nonzero_left, 54, [a, 9]);
+assertTrue(isNaN(sum_nonzero_left(a, 10)));
+
+function pick(a, k) {
+  var s = 0;
+  for (var i = 0; i <= k; i++) {
+    if (k == i) s += a[i];
+  }
+  return s;
+}
+test(pick, 3, [a, 2]);
+assertTrue(isNaN(pick(a, 10)));
@@ -0,0 +1,93 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax --expose-gc --expose-debug-as debug
+
+// Test that inlined allocations folded into a single allocation produce
+// properly initialized objects that survive garbage collections.
+
+function Point(x, y) {
+  this.x = x;
+  this.y = y;
+}
+
+function Pair(first, second) {
+  this.first = first;
+  this.second = second;
+}
+
+function makePairs(i) {
+  var p = new Point(i, i + 1);
+  var q = new Point(i + 2, i + 3);
+  return new Pair(new Pair(p, q), { index: i, list: [i, 1, 2] });
+}
+
+function checkPairs(pairs, i) {
+  assertEquals(i, pairs.first.first.x);
+  assertEquals(i + 1, pairs.first.first.y);
+  assertEquals(i + 2, pairs.first.second.x);
+  assertEquals(i + 3, pairs.first.second.y);
+  assertEquals(i, pairs.second.index);
+  assertEquals([i, 1, 2], pairs.second.list);
+}
+
+var kept = [];
+for (var i = 0; i < 5; i++) checkPairs(makePairs(i), i);
+%OptimizeFunctionOnNextCall(makePairs);
+for (var i = 0; i < 50000; i++) {
+  var pairs = makePairs(i);
+  checkPairs(pairs, i);
+  if (i % 1000 == 0) kept.push(pairs);
+}
+gc();
+for (var i = 0; i < kept.length; i++) checkPairs(kept[i], i * 1000);
+
+
+// Test that the heap stays iterable when deoptimizing in between two folded
+// allocations.
+
+function Node(value) {
+  this.value = value;
+  this.next = null;
+}
+
+function makeNodes(o) {
+  var first = new Node(1);
+  var value = o.value;
+  var second = new Node(value);
+  first.next = second;
+  return first;
+}
+
+for (var i = 0; i < 5; i++) makeNodes({ value: 2 });
+%OptimizeFunctionOnNextCall(makeNodes);
+assertEquals(2, makeNodes({ value: 2 }).next.value);
+var nodes = [];
+for (var i = 0; i < 10; i++) nodes.push(makeNodes({ other: 0, value: i }));
+for (var i = 0; i < nodes.length; i++) assertEquals(i, nodes[i].next.value);
+// Finding the referencing objects iterates the whole heap.
+assertEquals(1, debug.MakeMirror(nodes[0]).referencedBy().length);
@@ -0,0 +1,201 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax --use-escape-analysis
+
+// Test scalar replacement of allocations that do not escape.
+
+function Point(x, y) {
+  this.x = x;
+  this.y = y;
+}
+
+(function testConstructor() {
+  function sum(a, b) {
+    var p = new Point(a, b);
+    return p.x + p.y;
+  }
+  assertEquals(3, sum(1, 2));
+  assertEquals(7, sum(3, 4));
+  %OptimizeFunctionOnNextCall(sum);
+  assertEquals(11, sum(5, 6));
+  assertEquals(2.5, sum(1, 1.5));
+  assertEquals("ab", sum("a", "b"));
+})();
+
+
+(function testLiteral() {
+  function f(a) {
+    var o = { x: 1, y: 2 };
+    o.x = a;
+    return o.x * o.y;
+  }
+  assertEquals(2, f(1));
+  assertEquals(4, f(2));
+  %OptimizeFunctionOnNextCall(f);
+  assertEquals(6, f(3));
+  assertEquals(1, f(0.5));
+})();
+
+
+(function testMerge() {
+  function f(c, a, b) {
+    var p = new Point(0, 0);
+    if (c) {
+      p.x = a;
+    } else {
+      p.x = b;
+      p.y = a;
+    }
+    return p.x - p.y;
+  }
+  assertEquals(1, f(true, 1, 2));
+  assertEquals(1, f(false, 1, 2));
+  %OptimizeFunctionOnNextCall(f);
+  assertEquals(3, f(true, 3, 4));
+  assertEquals(1, f(false, 3, 4));
+})();
+
+
+(function testLoop() {
+  function f(n) {
+    var p = new Point(1, 2);
+    var sum = 0;
+    for (var i = 0; i < n; i++) sum += p.x + p.y;
+    return sum;
+  }
+  assertEquals(3, f(1));
+  assertEquals(6, f(2));
+  %OptimizeFunctionOnNextCall(f);
+  assertEquals(30, f(10));
+})();
+
+
+(function testStoreInLoop() {
+  // The object is allocated outside of the loop and stored to inside.
+  function f(n) {
+    var p = new Point(0, 0);
+    for (var i = 0; i < n; i++) p.x += i;
+    return p.x;
+  }
+  assertEquals(0, f(1));
+  assertEquals(1, f(2));
+  %OptimizeFunctionOnNextCall(f);
+  assertEquals(45, f(10));
+})();
+
+
+(function testEscape() {
+  // The object escapes into a variable of the outer function.
+  var result;
+  function g(p, d) {
+    if (d) result = p;
+  }
+  function f(a, b, d) {
+    var p = new Point(a, b);
+    p.x = a + 0.5;
+    g(p, d);
+    return p.x + p.y;
+  }
+  assertEquals(4.5, f(1, 3, false));
+  assertEquals(6.5, f(2, 4, false));
+  %OptimizeFunctionOnNextCall(f);
+  assertEquals(8.5, f(3, 5, false));
+  assertEquals(10.5, f(4, 6, true));
+  assertTrue(result instanceof Point);
+  assertEquals(4.5, result.x);
+  assertEquals(6, result.y);
+})();
+
+
+(function testLazyDeoptimization() {
+  // The object, including its double field, has to be materialized when the
+  // function is deoptimized while it is live.
+  function g(d) {
+    if (d) %DeoptimizeFunction(f);
+  }
+  function f(a, b, d) {
+    var p = new Point(a, b);
+    p.x = a + 0.5;
+    g(d);
+    return p.x + p.y;
+  }
+  assertEquals(4.5, f(1, 3, false));
+  assertEquals(6.5, f(2, 4, false));
+  %OptimizeFunctionOnNextCall(f);
+  assertEquals(8.5, f(3, 5, false));
+  assertEquals(10.5, f(4, 6, true));
+})();
+
+
+(function testDeoptimizationFieldRead() {
+  // A deopt after the object is live; its fields are read afterwards.
+  var o = { v: 1 };
+  function f(a, b) {
+    var p = new Point(a, b);
+    var t = o.v;
+    return p.x + p.y + t;
+  }
+  assertEquals(4, f(1, 2));
+  assertEquals(8, f(3, 4));
+  %OptimizeFunctionOnNextCall(f);
+  assertEquals(12, f(5, 6));
+  o = { w: 1, v: 2 };
+  assertEquals(13, f(5, 6));
+})();
+
+
+(function testGetter() {
+  function Box(v) { this.v = v; }
+  Box.prototype = { get doubled() { return this.v * 2; } };
+  function f(v) {
+    var b = new Box(v);
+    return b.doubled;
+  }
+  assertEquals(2, f(1));
+  assertEquals(4, f(2));
+  %OptimizeFunctionOnNextCall(f);
+  assertEquals(6, f(3));
+})();
+
+
+(function testPrototypeChange() {
+  // Replacing the prototype changes the initial map of the constructor.
+  function C(x) { this.x = x; }
+  C.prototype.get = function() { return this.x; };
+  function f(x) {
+    var c = new C(x);
+    return c.get();
+  }
+  assertEquals(1, f(1));
+  assertEquals(2, f(2));
+  %OptimizeFunctionOnNextCall(f);
+  assertEquals(3, f(3));
+  C.prototype = { get: function() { return -this.x; } };
+  assertEquals(-4, f(4));
+  assertEquals(-5, f(5));
+})();
@@ -0,0 +1,201 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax
+
+// Test loops whose first iteration is peeled.
+
+function test(f, expected, args) {
+  for (var i = 0; i < 3; i++) assertEquals(expected, f.apply(null, args));
+  %OptimizeFunctionOnNextCall(f);
+  assertEquals(expected, f.apply(null, args));
+}
+
+function break_first(n) {
+  var s = 0;
+  for (var i = 0; i < n; i++) {
+    if (i == 0) break;
+    s++;
+  }
+  return s;
+}
+test(break_first, 0, [5]);
+
+function continue_first(n) {
+  var s = 0;
+  for (var i = 0; i < n; i++) {
+    if (i == 0) continue;
+    s += i;
+  }
+  return s;
+}
+test(continue_first, 10, [5]);
+
+function return_first(n) {
+  var i = 0;
+  while (i < n) {
+    if (i == 0) return "first";
+    i++;
+  }
+  return "none";
+}
+test(return_first, "first", [5]);
+assertEquals("none", return_first(0));
+
+function no_condition() {
+  var i = 0;
+  for (;;) {
+    if (++i > 3) break;
+  }
+  return i;
+}
+test(no_condition, 4, []);
+
+function while_true() {
+  var i = 0;
+  while (true) {
+    i++;
+    if (i == 7) break;
+  }
+  return i;
+}
+test(while_true, 7, []);
+
+function zero_iterations(n) {
+  var s = 1;
+  while (n-- > 0) s *= 2;
+  return s;
+}
+test(zero_iterations, 1, [0]);
+assertEquals(8, zero_iterations(3));
+
+function labeled(n) {
+  var s = 0;
+  outer: for (var i = 0; i < n; i++) {
+    for (var j = 0; j < n; j++) {
+      if (j > i) continue outer;
+      if (j == 3) break outer;
+      s++;
+    }
+  }
+  return s;
+}
+test(labeled, 9, [6]);
+
+function closures(n) {
+  var fs = [];
+  for (var i = 0; i < n; i++) fs.push(function() { return i; });
+  var s = 0;
+  for (var j = 0; j < fs.length; j++) s += fs[j]();
+  return s;
+}
+test(closures, 9, [3]);
+
+function switch_in_loop(n) {
+  var s = "";
+  for (var i = 0; i < n; i++) {
+    switch (i) {
+      case 0: s += "a"; break;
+      case 1: s += "b"; continue;
+      default: s += "c";
+    }
+    s += ".";
+  }
+  return s;
+}
+test(switch_in_loop, "a.bc.", [3]);
+
+function sum(a) {
+  var s = 0;
+  for (var i = 0; i < a.length; i++) s += a[i];
+  return s;
+}
+function sum_twice(a) { return sum(a) + sum(a); }
+test(sum_twice, 12, [[1, 2, 3]]);
+test(sum, 6, [[1, 2, 3]]);
+assertEquals("0ab", sum(["a", "b"]));
+assertEquals(3.5, sum([1.5, 2]));
+
+// The elements kind transitions of the first iteration make those of the
+// remaining iterations redundant.
+function increment(a, n) {
+  for (var i = 0; i < n; i++) a[i] = a[i] + 0.5;
+  return a;
+}
+for (var i = 0; i < 3; i++) {
+  increment([1, 2, 3], 3);
+  increment([1.5, 2.5], 2);
+}
+%OptimizeFunctionOnNextCall(increment);
+assertEquals([1.5, 2.5, 3.5], increment([1, 2, 3], 3));
+assertEquals([1, 2, 3], increment([1, 2, 3], 0));
+assertEquals([2, 3], increment([1.5, 2.5], 2));
+
+function accumulate(a, n) {
+  for (var i = 1; i < n; i++) a[i] = a[i - 1] + 0.5;
+  return a[n - 1];
+}
+for (var i = 0; i < 3; i++) {
+  accumulate([1, 2, 3, 4], 4);
+  accumulate([1.5, 2, 3, 4], 4);
+}
+%OptimizeFunctionOnNextCall(accumulate);
+assertEquals(2.5, accumulate([1, 2, 3, 4], 4));
+assertEquals(3, accumulate([1.5, 2, 3, 4], 4));
+assertEquals(undefined, accumulate([1, 2, 3, 4], 0));
+
+// Loops are not peeled in OSR compiles. An outer loop enclosing the OSR
+// loop would otherwise build the OSR entry twice.
+function osr_nested(n) {
+  var s = 0;
+  for (var i = 0; i < n; i++) {
+    for (var j = 0; j < n; j++) {
+      s += j;
+      if (i == 1 && j == 5) %OptimizeFunctionOnNextCall(osr_nested, "osr");
+    }
+  }
+  return s;
+}
+assertEquals(450, osr_nested(10));
+
+function osr_nested_while(n) {
+  var s = 0;
+  var i = 0;
+  while (i < n) {
+    var j = 0;
+    while (j < n) {
+      s += i;
+      if (i == 2 && j == 1) {
+        %OptimizeFunctionOnNextCall(osr_nested_while, "osr");
+      }
+      j++;
+    }
+    i++;
+  }
+  return s;
+}
+assertEquals(450, osr_nested_while(10));
@@ -0,0 +1,104 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax --expose-gc
+
+// Test that stores into young objects, literals and their backing stores
+// without write barriers keep the stored values alive across garbage
+// collections.
+
+function Box(value) {
+  this.value = value;
+  this.other = null;
+}
+
+function makeBoxes(a, b) {
+  var first = new Box(a);
+  var second = new Box(b);
+  // Interleaved stores into two young allocations.
+  first.other = second;
+  second.other = first;
+  var literal = { box: first, list: [a, b, first] };
+  literal.box = second;
+  return literal;
+}
+
+function checkBoxes(literal, a, b) {
+  assertEquals(b, literal.box.value);
+  assertEquals(a, literal.box.other.value);
+  assertSame(literal.box, literal.box.other.other);
+  assertEquals(a, literal.list[0]);
+  assertEquals(b, literal.list[1]);
+  assertSame(literal.box.other, literal.list[2]);
+}
+
+function makeValue(i) {
+  return { index: i, name: "value" + i };
+}
+
+for (var i = 0; i < 5; i++) {
+  checkBoxes(makeBoxes(makeValue(i), makeValue(i + 1)), makeValue(i),
+             makeValue(i + 1));
+}
+%OptimizeFunctionOnNextCall(makeBoxes);
+var kept = [];
+for (var i = 0; i < 20000; i++) {
+  var a = makeValue(i);
+  var b = makeValue(i + 1);
+  var literal = makeBoxes(a, b);
+  assertSame(a, literal.list[0]);
+  if (i % 1000 == 0) kept.push([literal, a, b]);
+}
+gc();
+for (var i = 0; i < kept.length; i++) {
+  checkBoxes(kept[i][0], kept[i][1], kept[i][2]);
+}
+
+
+// Test that an allocation is no longer young after a loop that might
+// trigger a garbage collection.
+
+function fillAfterLoop(n) {
+  var box = new Box(null);
+  for (var i = 0; i < n; i++) {
+    box.value = makeValue(i);
+  }
+  box.other = makeValue(n);
+  return box;
+}
+
+for (var i = 0; i < 5; i++) fillAfterLoop(3);
+%OptimizeFunctionOnNextCall(fillAfterLoop);
+var boxes = [];
+for (var i = 0; i < 10; i++) {
+  boxes.push(fillAfterLoop(1000));
+  gc();
+}
+for (var i = 0; i < boxes.length; i++) {
+  assertEquals(999, boxes[i].value.index);
+  assertEquals(1000, boxes[i].other.index);
+}
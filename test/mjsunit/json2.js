@@ -0,0 +1,117 @@
+// Copyright 2012 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Flags: --allow-natives-syntax
+
+// Test JSON.stringify with a single argument, which is handled by the native
+// serializer, against the JavaScript serializer that is used when a
+// replacer is given.
+
+function TestStringify(expected, value) {
+  assertEquals(expected, JSON.stringify(value));
+  assertEquals(expected, JSON.stringify(value, null));
+}
+
+TestStringify(undefined, undefined);
+TestStringify(undefined, function() { });
+TestStringify("null", null);
+TestStringify("true", true);
+TestStringify("false", false);
+TestStringify("0", -0);
+TestStringify("-1.5", -1.5);
+TestStringify("null", NaN);
+TestStringify("null", -Infinity);
+TestStringify('"\\"\\\\\\b\\f\\n\\r\\t\\u0000\\u001f\u007f"',
+              "\"\\\b\f\n\r\t\u0000\u001f\u007f");
+TestStringify('"ሴ\\né"', "ሴ\né");
+TestStringify('{"a":"x","b":"ሴ"}', { a: "x", b: "ሴ" });
+
+TestStringify("[]", []);
+TestStringify("[1,2,3]", [1, 2, 3]);
+TestStringify("[1.5,null,null]", [1.5, , NaN]);
+TestStringify('[null,1,"x",null,null]', [, 1, "x", undefined, function() { }]);
+TestStringify('{"a":1,"c":[{"d":null}],"e":"f"}',
+              { a: 1, b: undefined, c: [{ d: null }], e: "f", g: Math.sin });
+
+// Non-enumerable properties are skipped.
+var object = { a: 1 };
+Object.defineProperty(object, "b", { value: 2, enumerable: false });
+TestStringify('{"a":1}', object);
+
+// Dictionary-mode objects keep their enumeration order.
+object = {};
+for (var i = 0; i < 100; i++) object["p" + i] = i;
+delete object.p0;
+assertFalse(%HasFastProperties(object));
+var expected = [];
+for (var i = 1; i < 100; i++) expected.push('"p' + i + '":' + i);
+TestStringify("{" + expected.join(",") + "}", object);
+
+// Elements of objects come before named properties.
+TestStringify('{"1":2,"a":1}', { a: 1, 1: 2 });
+TestStringify('{"0":1,"1":2}', (function() { return arguments; })(1, 2));
+
+// Getters, toJSON and wrappers run user code.
+object = { a: 1 };
+Object.defineProperty(object, "b", { get: function() { return 2; },
+                                     enumerable: true });
+TestStringify('{"a":1,"b":2}', object);
+TestStringify('{"a":42}', { a: { toJSON: function() { return 42; } } });
+TestStringify('"1970-01-01T00:00:00.000Z"', new Date(0));
+TestStringify('["s",3,false]',
+              [new String("s"), new Number(3), new Boolean(false)]);
+var wrapper = new Number(3);
+wrapper.valueOf = function() { return 4; };
+TestStringify("[4]", [wrapper]);
+
+// Holes read through the prototype chain.
+Array.prototype[1] = "p";
+TestStringify('[0,"p",2]', [0, , 2]);
+TestStringify('[0.5,"p",2.5]', [0.5, , 2.5]);
+delete Array.prototype[1];
+Object.prototype.toJSON = function() { return "o"; };
+TestStringify('"o"', [1]);
+TestStringify('"o"', function() { });
+delete Object.prototype.toJSON;
+
+// Errors are the same as in the JavaScript serializer.
+object = { a: [] };
+object.a.push(object);
+assertThrows(function() { JSON.stringify(object); }, TypeError);
+var deep = [];
+for (var i = 0, nested = deep; i < 100000; i++) nested = nested[0] = [];
+assertThrows(function() { JSON.stringify(deep); }, RangeError);
+
+// The output buffer grows and changes its encoding as needed.
+var long_string = "";
+for (var i = 0; i < 1000; i++) long_string += "abc\n";
+var array = [];
+for (var i = 0; i < 100; i++) array.push({ s: long_string, i: i });
+TestStringify(JSON.stringify(array, null), array);
+array.push("ሴ");
+TestStringify(JSON.stringify(array, null), array);
@@ -299,6 +299,65 @@
 })();
 
 
+(function testBinaryLogReader() {
+  function bytesOf(str) {
+    var bytes = [];
+    for (var i = 0; i < str.length; ++i) bytes.push(str.charCodeAt(i));
+    return bytes;
+  }
+  var log = [].concat(
+      bytesOf('v8binlog'), [2],
+      // Event names.
+      bytesOf('N'), [32, 3],
+      bytesOf('code-move\0'), bytesOf('code-delete\0'), bytesOf('Function\0'),
+      // code-creation,Function,0x1000,0x80,"f",0x2a8,~
+      bytesOf('C'), [11, 2, 0x80, 0x20, 0x80, 0x01, 0xa8, 0x05],
+      bytesOf('~\0f\0'),
+      // code-creation,Function,0x1100,3,"a ""b"""
+      bytesOf('C'), [13, 2, 0x80, 0x22, 3, 0], bytesOf('a ""b""\0'),
+      // code-move,0x1000,0x1200
+      bytesOf('M'), [5, 0, 0x80, 0x20, 0x80, 0x24],
+      // tick,0x1210,0x7f00,0,0x1100,0,overflow,0x1208,0x1220
+      bytesOf('t'), [12, 0x90, 0x24, 0x80, 0xfe, 0x01, 2, 0x80, 0x22, 0, 2,
+                     15, 48],
+      // code-delete,0x1200
+      bytesOf('D'), [3, 1, 0x80, 0x24],
+      // code-creation,Function,0x1300,4,"long" cut short by the VM.
+      bytesOf('C'), [9, 2, 0x80, 0x26, 4, 0], bytesOf('long'),
+      bytesOf('T'), [12], bytesOf('profiler,end\n'.substr(0, 12)));
+
+  var records = [];
+  function recorder(name) {
+    return function() {
+      records.push([name].concat(Array.prototype.slice.call(arguments)));
+    };
+  }
+  var reader = new LogReader({
+      'code-creation': { parsers: [null, parseInt, parseInt, null, 'var-args'],
+          processor: recorder('code-creation') },
+      'code-move': { parsers: [parseInt, parseInt],
+          processor: recorder('code-move') },
+      'code-delete': { parsers: [parseInt],
+          processor: recorder('code-delete') },
+      'tick': { parsers: [parseInt, parseInt, parseInt, parseInt, parseInt,
+                          'var-args'],
+          processor: recorder('tick') },
+      'profiler': { parsers: [null], processor: recorder('profiler') }});
+  assertTrue(LogReader.isBinaryLog(String.fromCharCode.apply(null, log)));
+  assertFalse(LogReader.isBinaryLog('v8-version,3,14,5,0,0'));
+  reader.processBinaryLog(log);
+  assertEquals([
+      ['code-creation', 'Function', 0x1000, 0x80, 'f', ['0x2a8', '~']],
+      ['code-creation', 'Function', 0x1100, 3, 'a "b"', []],
+      ['code-move', 0x1000, 0x1200],
+      ['tick', 0x1210, 0x7f00, 0, 0x1100, 0,
+       ['overflow', '0x1208', '0x1220']],
+      ['code-delete', 0x1200],
+      ['code-creation', 'Function', 0x1300, 4, 'long', []],
+      ['profiler', 'end']], records);
+})();
+
+
 function CppEntriesProviderMock() {
 };
 
@@ -140,6 +140,13 @@
                 ],
               },
               'conditions': [
+                ['v8_extra_snapshot_code!=""', {
+                  'variables': {
+                    'mksnapshot_flags': [
+                      '--extra-code', '<(v8_extra_snapshot_code)',
+                    ],
+                  },
+                }],
                 ['v8_target_arch=="arm"', {
                   # The following rules should be consistent with chromium's
                   # common.gypi and V8's runtime rule to ensure they all generate
@@ -353,6 +360,7 @@
             '../../src/isolate.cc',
             '../../src/isolate.h',
             '../../src/json-parser.h',
+            '../../src/json-stringifier.h',
             '../../src/jsregexp.cc',
             '../../src/jsregexp.h',
             '../../src/lazy-instance.h',
@@ -376,6 +384,8 @@
             '../../src/macro-assembler.h',
             '../../src/mark-compact.cc',
             '../../src/mark-compact.h',
+            '../../src/marking-thread.cc',
+            '../../src/marking-thread.h',
             '../../src/messages.cc',
             '../../src/messages.h',
             '../../src/natives.h',
@@ -431,6 +441,8 @@
             '../../src/scanner-character-streams.h',
             '../../src/scanner.cc',
             '../../src/scanner.h',
+            '../../src/scavenger-thread.cc',
+            '../../src/scavenger-thread.h',
             '../../src/scopeinfo.cc',
             '../../src/scopeinfo.h',
             '../../src/scopes.cc',
@@ -455,6 +467,8 @@
             '../../src/strtod.h',
             '../../src/stub-cache.cc',
             '../../src/stub-cache.h',
+            '../../src/sweeper-thread.cc',
+            '../../src/sweeper-thread.h',
             '../../src/token.cc',
             '../../src/token.h',
             '../../src/transitions-inl.h',
@@ -489,6 +503,7 @@
             '../../src/version.h',
             '../../src/vm-state-inl.h',
             '../../src/vm-state.h',
+            '../../src/work-stealing-deque.h',
             '../../src/zone-inl.h',
             '../../src/zone.cc',
             '../../src/zone.h',
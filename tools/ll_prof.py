@@ -298,6 +298,48 @@ class CodeInfo(object):
     self.header_size = header_size
 
 
+class BinaryLogReader(object):
+  """V8 binary log (--log-binary) reader.
+
+  Only text records are of interest here, all other records are skipped.
+  """
+
+  _MAGIC = "v8binlog"
+  _VERSION = 2
+
+  def __init__(self, log):
+    self.log = log
+    self.log_pos = len(BinaryLogReader._MAGIC)
+    version = self._ReadVarint()
+    assert version == BinaryLogReader._VERSION, \
+        "Unsupported binary log version %d" % version
+
+  @staticmethod
+  def IsBinaryLog(log):
+    return log.startswith(BinaryLogReader._MAGIC)
+
+  def TextLines(self):
+    while self.log_pos < len(self.log):
+      tag = self.log[self.log_pos]
+      self.log_pos += 1
+      # Every record carries the length of its fields.
+      length = self._ReadVarint()
+      if tag == "T":
+        yield self.log[self.log_pos:self.log_pos + length]
+      self.log_pos += length
+
+  def _ReadVarint(self):
+    value = 0
+    shift = 0
+    while True:
+      byte = ord(self.log[self.log_pos])
+      self.log_pos += 1
+      value |= (byte & 0x7f) << shift
+      shift += 7
+      if not byte & 0x80:
+        return value
+
+
 class SnapshotLogReader(object):
   """V8 snapshot log reader."""
 
@@ -311,7 +353,12 @@ class SnapshotLogReader(object):
     log = open(self.log_name, "r")
     try:
       snapshot_pos_to_name = {}
-      for line in log:
+      contents = log.read()
+      if BinaryLogReader.IsBinaryLog(contents):
+        lines = BinaryLogReader(contents).TextLines()
+      else:
+        lines = contents.splitlines()
+      for line in lines:
         match = SnapshotLogReader._SNAPSHOT_CODE_NAME_RE.match(line)
         if match:
           pos = int(match.group(1))
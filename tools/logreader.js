@@ -87,6 +87,162 @@ LogReader.prototype.processLogLine = function(line) {
 };
 
 
+/**
+ * Magic string a binary log (written with --log-binary) starts with.
+ */
+LogReader.BINARY_LOG_MAGIC = 'v8binlog';
+
+
+/**
+ * Returns whether the log contents, or its first line, come from a binary
+ * log.
+ *
+ * @param {string} contents Beginning of the log.
+ * @return {boolean} True for a binary log.
+ */
+LogReader.isBinaryLog = function(contents) {
+  var magic = LogReader.BINARY_LOG_MAGIC;
+  return contents.substr(0, magic.length) == magic;
+};
+
+
+/**
+ * Processes a binary log. Records are converted into the same fields the
+ * text log has, and dispatched in the same way.
+ *
+ * @param {Uint8Array|Array.<number>} bytes Log contents.
+ */
+LogReader.prototype.processBinaryLog = function(bytes) {
+  var pos = LogReader.BINARY_LOG_MAGIC.length;
+  // End of the log, then of the current record once one is being read.
+  var end = bytes.length;
+  var names = [];
+
+  function readVarint() {
+    var value = 0;
+    var scale = 1;
+    var b;
+    do {
+      if (pos >= end) throw new Error('truncated binary log record');
+      b = bytes[pos++];
+      value += (b & 0x7f) * scale;
+      scale *= 128;
+    } while (b & 0x80);
+    return value;
+  }
+
+  function readSignedVarint() {
+    var value = readVarint();
+    return value % 2 ? -(value + 1) / 2 : value / 2;
+  }
+
+  function readString(length) {
+    var stringEnd = pos + length;
+    var str = '';
+    for (; pos < stringEnd; ++pos) {
+      str += String.fromCharCode(bytes[pos]);
+    }
+    try {
+      // Names are UTF-8 encoded.
+      return decodeURIComponent(escape(str));
+    } catch (e) {
+      return str;
+    }
+  }
+
+  function readCString() {
+    var length = 0;
+    while (pos + length < end && bytes[pos + length] != 0) ++length;
+    var str = readString(length);
+    ++pos;  // Skip the terminator.
+    return str;
+  }
+
+  function readAddress() {
+    return '0x' + readVarint().toString(16);
+  }
+
+  function readEventName() {
+    var name = names[readVarint()];
+    if (name === undefined) throw new Error('unknown binary log event');
+    return name;
+  }
+
+  var version = readVarint();
+  if (version != 2) {
+    this.printError('unsupported binary log version ' + version);
+    return;
+  }
+  var logEnd = end;
+  while (pos < logEnd) {
+    var fields;
+    var tag = String.fromCharCode(bytes[pos++]);
+    // Records that did not fit into the VM's buffer are cut short, the
+    // length always tells where the next record starts.
+    end = logEnd;
+    var length = readVarint();
+    var recordEnd = Math.min(pos + length, logEnd);
+    end = recordEnd;
+    switch (tag) {
+      case 'T':
+        this.processLog_(readString(recordEnd - pos).split('\n'));
+        pos = recordEnd;
+        continue;
+      case 'N':
+        var count = readVarint();
+        names = [];
+        for (var i = 0; i < count; ++i) names.push(readCString());
+        pos = recordEnd;
+        continue;
+      case 'C':
+        var type = readEventName();
+        var start = readAddress();
+        var size = String(readVarint());
+        var func = readVarint();
+        var state = func ? readCString() : null;
+        // Quotes are escaped the same way as in the text log.
+        var name = readCString().replace(CsvParser.DOUBLE_QUOTE_RE_, '"');
+        fields = ['code-creation', type, start, size, name];
+        if (func) fields.push('0x' + func.toString(16), state);
+        break;
+      case 'M':
+        fields = [readEventName(), readAddress(), readAddress()];
+        break;
+      case 'D':
+        fields = [readEventName(), readAddress()];
+        break;
+      case 't':
+        var pc = readVarint();
+        var sp = readAddress();
+        var flags = bytes[pos++];
+        var tos = readAddress();
+        var vmState = String(readVarint());
+        fields = ['tick', '0x' + pc.toString(16), sp, String(flags & 1), tos,
+                  vmState];
+        if (flags & 2) fields.push('overflow');
+        var frame = pc;
+        for (var i = 0, n = readVarint(); i < n; ++i) {
+          frame += readSignedVarint();
+          fields.push('0x' + frame.toString(16));
+        }
+        break;
+      default:
+        this.printError('unknown binary log record ' + tag);
+        pos = recordEnd;
+        continue;
+    }
+    pos = recordEnd;
+    try {
+      this.dispatchLogRow_(fields);
+    } catch (e) {
+      this.printError('record ' + (this.lineNum_ + 1) + ': ' +
+                      (e.message || e));
+    }
+    ++this.lineNum_;
+  }
+};
+
+
 /**
  * Processes stack record.
  *
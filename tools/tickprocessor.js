@@ -57,6 +57,19 @@ function readFile(fileName) {
 }
 
 
+/**
+ * Reads a binary log using shell's 'readbuffer' function.
+ */
+function readBinaryFile(fileName) {
+  try {
+    return new Uint8Array(readbuffer(fileName));
+  } catch (e) {
+    print(fileName + ': ' + (e.message || e));
+    throw e;
+  }
+}
+
+
 /**
  * Parser for dynamic code optimization state.
  */
@@ -135,7 +148,11 @@ SnapshotLogProcessor.prototype.processSnapshotPosition = function(addr, pos) {
 
 SnapshotLogProcessor.prototype.processLogFile = function(fileName) {
   var contents = readFile(fileName);
-  this.processLogChunk(contents);
+  if (LogReader.isBinaryLog(contents)) {
+    this.processBinaryLog(readBinaryFile(fileName));
+  } else {
+    this.processLogChunk(contents);
+  }
 };
 
 
@@ -278,9 +295,15 @@ TickProcessor.prototype.isJsCode = function(name) {
 
 TickProcessor.prototype.processLogFile = function(fileName) {
   this.lastLogFileName_ = fileName;
-  var line;
-  while (line = readline()) {
+  var line = readline();
+  if (line && LogReader.isBinaryLog(line)) {
+    // Binary logs can't be read line by line from the standard input.
+    this.processBinaryLog(readBinaryFile(fileName));
+    return;
+  }
+  while (line) {
     this.processLogLine(line);
+    line = readline();
   }
 };
 
@@ -289,7 +312,11 @@ TickProcessor.prototype.processLogFileInTest = function(fileName) {
    // Hack file name to avoid dealing with platform specifics.
   this.lastLogFileName_ = 'v8.log';
   var contents = readFile(fileName);
-  this.processLogChunk(contents);
+  if (LogReader.isBinaryLog(contents)) {
+    this.processBinaryLog(readBinaryFile(fileName));
+  } else {
+    this.processLogChunk(contents);
+  }
 };
 
 